@@ -0,0 +1,37 @@
+/*!
+ * \file BenchAllocations.h
+ * \brief Definition of the class BenchAllocations
+ * \date 2016-11-10
+ * \author f.souliers
+ */
+
+#ifndef BENCHALLOCATIONS_H_
+#define BENCHALLOCATIONS_H_
+
+#include <QString>
+
+/*!
+ * \class BenchAllocations
+ * \brief Counts the heap allocations of the whole process, so that each measure also gives its number of allocations
+ *
+ * With the GNU C library, every call to malloc, calloc and realloc is counted (including the ones of operator new and
+ * of the Qt containers). Elsewhere, only operator new is replaced and counted. The counter is only read as a
+ * difference between two instants: the allocations of the other threads running meanwhile are counted too.
+ */
+class BenchAllocations
+{
+public:
+	/*!
+	 * \brief Number of allocations since the start of the process
+	 * \return the number of allocations
+	 */
+	static qint64 getNbAllocations();
+
+	/*!
+	 * \brief Which allocations are counted, written with the results
+	 * \return "malloc" or "operator_new"
+	 */
+	static QString getScope();
+};
+
+#endif /* BENCHALLOCATIONS_H_ */
@@ -0,0 +1,91 @@
+/*!
+ * \file BenchAnalysisRunner.h
+ * \brief Definition of the class BenchAnalysisRunner
+ * \date 2016-10-18
+ * \author f.souliers
+ */
+
+#ifndef BENCHANALYSISRUNNER_H_
+#define BENCHANALYSISRUNNER_H_
+
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+#include "BenchStats.h"
+
+/*!
+ * \class BenchAnalysisRunner
+ * \brief Runs the whole analysis of a configuration file and measures each of its phases
+ *
+ * The phases measured are the same as the ones executed by Rekkix in batch mode:
+ * - clear : release of the matrix of the previous run (ModelSngReqMatrix::clear)
+ * - config_load : reading and checking the configuration file (ModelConfiguration::setFile)
+ * - parse_wall : parsing of every configured file, parse_&lt;format&gt; being the cumulated parsing time of the
+ *   files of a given format
+ * - merge : update of the files with their accepted requirements
+ * - compute_coverage : ModelSngReqMatrix::computeCoverage, createResults and publishCoverage
+ * - snapshot : ModelSngReqMatrix::createSnapshot, including the building of the impact index
+ * - impact_all_reqs : downstream impacts of every requirement (see AnalysisImpactIndex)
+ * - search_as_you_type : prefix, substring and regular expression searches of one typed character (see AnalysisSearchIndex)
+ * - report_&lt;writer&gt; : building of each report configured in the <i>outputs</i> section
+ * - export_sqlite : export of the snapshot into a database, in a temporary directory (see AnalysisSqliteExport)
+ * - update_one_file : re-analysis of the first configured file alone, as done in watch mode (removal of its
+ *   previous contributions, parsing, merge and incremental ModelSngReqMatrix::computeCoverage)
+ *
+ * Each phase also gives its number of heap allocations (see BenchAllocations).
+ *
+ * The parsing is realized by a pool limited to a given number of threads, so that the scalability of the
+ * analysis can be measured with 1..N threads.
+ */
+class BenchAnalysisRunner
+{
+public:
+	/*!
+	 * \brief Constructor of the class
+	 * \param[in] p_configFilePath  configuration file analyzed by each run
+	 */
+	BenchAnalysisRunner(const QString& p_configFilePath);
+
+	/*!
+	 * \brief Destructor of the class, does nothing special
+	 */
+	virtual ~BenchAnalysisRunner();
+
+	/*!
+	 * \brief Runs the benchmark for each given number of threads
+	 * \param[in] p_threadCounts  numbers of parsing threads to be measured
+	 * \param[in] p_nbWarmups  number of runs not recorded before the measures (warm file system cache)
+	 * \param[in] p_nbRepeats  number of recorded runs for each number of threads
+	 * \param[out] p_results  machine readable results (one entry per number of threads)
+	 * \param[out] p_errMsg  description of the error if any
+	 * \return
+	 * - true if every run succeeded
+	 * - false if the configuration cannot be analyzed (see p_errMsg)
+	 */
+	bool run(const QVector<int>& p_threadCounts, int p_nbWarmups, int p_nbRepeats, QJsonObject& p_results, QString& p_errMsg);
+
+private:
+	/*!
+	 * \typedef phaseStats_t
+	 * \brief Statistics of each phase, the key is the name of the phase
+	 */
+	typedef QMap<QString, BenchStats> phaseStats_t;
+
+	QString __configFilePath;  //!< Configuration file analyzed by each run
+	int __nbFiles;  //!< Number of files parsed during the last run
+	int __nbRequirements;  //!< Number of requirements known by the matrix after the last run
+	int __nbErrors;  //!< Number of analysis errors raised by the last run
+
+	/*!
+	 * \brief Runs the whole analysis once
+	 * \param[in] p_nbThreads  maximum number of parsing threads
+	 * \param[inout] p_stats  statistics to which the durations of this run are added
+	 * \param[out] p_errMsg  description of the error if any
+	 * \return true if the run succeeded, false else
+	 */
+	bool __runOnce(int p_nbThreads, phaseStats_t& p_stats, QString& p_errMsg);
+};
+
+#endif /* BENCHANALYSISRUNNER_H_ */
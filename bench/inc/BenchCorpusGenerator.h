@@ -0,0 +1,155 @@
+/*!
+ * \file BenchCorpusGenerator.h
+ * \brief Definition of the class BenchCorpusGenerator
+ * \date 2016-10-18
+ * \author f.souliers
+ */
+
+#ifndef BENCHCORPUSGENERATOR_H_
+#define BENCHCORPUSGENERATOR_H_
+
+#include <random>
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*!
+ * \class BenchCorpusGenerator
+ * \brief Generates a synthetic set of requirement documents and the configuration file describing it
+ *
+ * The generated documents are organized in three levels (eg specification, design, tests): the
+ * requirements of a level cover some requirements of the level above. Every supported format (docx, odt,
+ * pdf, txt) can be generated so that each parser of Rekkix is exercised.
+ *
+ * The generation is driven by a seed so the same parameters always lead to the same corpus, which is
+ * mandatory to compare benchmark results between two versions of the software.
+ */
+class BenchCorpusGenerator
+{
+public:
+	/*!
+	 * \brief Parameters of the corpus
+	 */
+	typedef struct
+	{
+		int nbDocx;  //!< Number of MS Word documents
+		int nbOdt;  //!< Number of LibreOffice documents
+		int nbPdf;  //!< Number of pdf documents
+		int nbTxt;  //!< Number of plain text documents
+		int nbReqsPerFile;  //!< Number of requirements defined in each document
+		int compositionDepth;  //!< Length of the chains of composite requirements (0 means no composite requirement)
+		double coverageRatio;  //!< Probability for a requirement to be covered by a requirement of the level below
+		int nbDuplicates;  //!< Number of requirements defined a second time in another document
+		int nbCycles;  //!< Number of pairs of requirements composing each other
+		int nbFillerLines;  //!< Number of lines of description written after each requirement
+		quint32 seed;  //!< Seed of the pseudo random generator
+	} parameters_t;
+
+	/*!
+	 * \brief Default parameters: a small mixed corpus
+	 * \return A parameter set usable as is
+	 */
+	static parameters_t defaultParameters();
+
+	/*!
+	 * \brief Constructor of the class
+	 * \param[in] p_params  parameters of the corpus to be generated
+	 */
+	BenchCorpusGenerator(const parameters_t& p_params);
+
+	/*!
+	 * \brief Destructor of the class, does nothing special
+	 */
+	virtual ~BenchCorpusGenerator();
+
+	/*!
+	 * \brief Generates the documents and the configuration file into a directory
+	 *
+	 * The directory is created if needed. The configuration file is named corpus.ini and the paths it
+	 * contains are relative to it.
+	 * \param[in] p_outDir  directory in which the corpus is written
+	 * \param[out] p_configFilePath  path of the generated configuration file
+	 * \param[out] p_errMsg  description of the error if any
+	 * \return
+	 * - true if every file has been written
+	 * - false else (see p_errMsg)
+	 */
+	bool generate(const QString& p_outDir, QString& p_configFilePath, QString& p_errMsg);
+
+private:
+	/*!
+	 * \brief Description of one generated requirement
+	 */
+	typedef struct
+	{
+		QString id;  //!< Identifier written in the document
+		QStringList composedOf;  //!< Requirements composing this one
+		QStringList covers;  //!< Upstream requirements covered by this one
+	} genReq_t;
+
+	/*!
+	 * \brief Description of one generated document
+	 */
+	typedef struct
+	{
+		QString id;  //!< File id, as used in the configuration
+		QString format;  //!< docx, odt, pdf or txt
+		int level;  //!< 0 for the top level documents
+		QVector<genReq_t> reqs;  //!< Requirements written in the document
+	} genDoc_t;
+
+	parameters_t __params;  //!< Parameters of the corpus
+	std::mt19937 __rng;  //!< Pseudo random generator, seeded with parameters_t::seed
+	QVector<genDoc_t> __docs;  //!< Documents of the corpus, built before being written
+
+	static const int NB_LEVELS = 3;  //!< Number of levels of documents
+
+	/*!
+	 * \brief Builds the in-memory description of the corpus (__docs)
+	 */
+	void __buildCorpus();
+
+	/*!
+	 * \brief Builds the paragraphs of a document (requirement definitions, lists and description lines)
+	 * \param[in] p_doc  document to be rendered
+	 * \return the list of paragraphs, in the order they must appear in the document
+	 */
+	QStringList __getParagraphs(const genDoc_t& p_doc);
+
+	/*!
+	 * \brief Picks a random integer in [0 ; p_max[
+	 * \param[in] p_max  exclusive upper bound, must be strictly positive
+	 * \return the random integer
+	 */
+	int __randInt(int p_max);
+
+	bool __writeTxt(const QString& p_path, const QStringList& p_paragraphs, QString& p_errMsg);
+	bool __writeDocx(const QString& p_path, const QStringList& p_paragraphs, QString& p_errMsg);
+	bool __writeOdt(const QString& p_path, const QStringList& p_paragraphs, QString& p_errMsg);
+	bool __writePdf(const QString& p_path, const QStringList& p_paragraphs, QString& p_errMsg);
+
+	/*!
+	 * \brief Writes a zip archive (docx and odt are zip files)
+	 * \param[in] p_path  path of the archive
+	 * \param[in] p_names  names of the items in the archive
+	 * \param[in] p_contents  contents of the items, in the same order as p_names
+	 * \param[out] p_errMsg  description of the error if any
+	 * \return true if the archive has been written, false else
+	 */
+	bool __writeZip(const QString& p_path,
+	                const QStringList& p_names,
+	                const QVector<QByteArray>& p_contents,
+	                QString& p_errMsg);
+
+	/*!
+	 * \brief Writes the ini configuration file describing the corpus
+	 * \param[in] p_path  path of the configuration file
+	 * \param[out] p_errMsg  description of the error if any
+	 * \return true if the file has been written, false else
+	 */
+	bool __writeConfiguration(const QString& p_path, QString& p_errMsg);
+};
+
+#endif /* BENCHCORPUSGENERATOR_H_ */
@@ -0,0 +1,92 @@
+/*!
+ * \file BenchMicroKernels.h
+ * \brief Definition of the class BenchMicroKernels
+ * \date 2016-10-19
+ * \author f.souliers
+ */
+
+#ifndef BENCHMICROKERNELS_H_
+#define BENCHMICROKERNELS_H_
+
+#include <functional>
+
+#include <QJsonObject>
+#include <QString>
+#include <QTemporaryDir>
+
+#include "BenchStats.h"
+
+/*!
+ * \class BenchMicroKernels
+ * \brief Focused measures of the hot kernels of the analysis
+ *
+ * Each kernel is measured in isolation, with its own input data prepared outside of the timed section:
+ * - regex_req_definition : RequirementFileAbstract::_hasStoredAnyRequirementDefinition on typical lines
+ * - zip_read : RequirementFileAbstractZipped::_readTextDataFromZippedFormat on a docx file
+ * - xml_dom / xml_stream : extraction of the paragraphs of word/document.xml with QDomDocument (as done by the
+ *   parsers) and with QXmlStreamReader
+ * - cmp_loop_deep / cmp_loop_wide : Requirement::hasLoopInComposingReqs on a chain and on a flat composition
+ * - coverage_deep / coverage_wide : Requirement::getCoverage on the same graphs
+ * - matrix_insert_contention : ModelSngReqMatrix insertions from several threads at the same time
+ * - matrix_clear : ModelSngReqMatrix::clear of the requirements inserted by matrix_insert_contention
+ *
+ * The number of heap allocations of each kernel is given with its durations (see BenchAllocations).
+ *
+ * Every kernel is run p_nbWarmups times (not recorded, so that caches, allocators and files are warm) and
+ * then p_nbRepeats times. The data sets are generated with a fixed seed so that the measures are
+ * reproducible.
+ */
+class BenchMicroKernels
+{
+public:
+	/*!
+	 * \brief Constructor of the class
+	 * \param[in] p_size  size of the data sets (number of lines, of requirements, of nodes in graphs)
+	 * \param[in] p_nbWarmups  number of runs of each kernel before recording
+	 * \param[in] p_nbRepeats  number of recorded runs of each kernel
+	 */
+	BenchMicroKernels(int p_size, int p_nbWarmups, int p_nbRepeats);
+
+	/*!
+	 * \brief Destructor of the class, does nothing special
+	 */
+	virtual ~BenchMicroKernels();
+
+	/*!
+	 * \brief Runs every kernel
+	 * \param[out] p_results  machine readable results (one entry per kernel)
+	 * \param[out] p_errMsg  description of the error if any
+	 * \return true if every kernel could be run, false else
+	 */
+	bool run(QJsonObject& p_results, QString& p_errMsg);
+
+private:
+	int __size;  //!< Size of the data sets
+	int __nbWarmups;  //!< Number of runs not recorded
+	int __nbRepeats;  //!< Number of recorded runs
+	QTemporaryDir __workDir;  //!< Directory of the generated files, removed with the object
+
+	/*!
+	 * \brief Measures a kernel
+	 * \param[in] p_setup  preparation of the data, called before each run and not timed (may be empty)
+	 * \param[in] p_kernel  code measured
+	 * \return the statistics of the recorded runs
+	 */
+	BenchStats __measure(std::function<void()> p_setup, std::function<void()> p_kernel);
+
+	/*!
+	 * \brief Builds the json entry of a kernel
+	 * \param[in] p_stats  statistics of the kernel
+	 * \param[in] p_nbItems  number of items (lines, nodes, bytes ...) processed by one run
+	 * \param[in] p_itemName  name of the items
+	 * \return the json object of the kernel, with the time per item computed from the median
+	 */
+	QJsonObject __toJson(const BenchStats& p_stats, qint64 p_nbItems, const QString& p_itemName);
+
+	bool __runRegexKernel(QJsonObject& p_results, QString& p_errMsg);
+	bool __runZipAndXmlKernels(QJsonObject& p_results, QString& p_errMsg);
+	bool __runGraphKernels(QJsonObject& p_results, QString& p_errMsg);
+	bool __runMatrixContentionKernel(QJsonObject& p_results, QString& p_errMsg);
+};
+
+#endif /* BENCHMICROKERNELS_H_ */
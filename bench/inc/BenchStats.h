@@ -0,0 +1,126 @@
+/*!
+ * \file BenchStats.h
+ * \brief Definition of the class BenchStats
+ * \date 2016-10-18
+ * \author f.souliers
+ */
+
+#ifndef BENCHSTATS_H_
+#define BENCHSTATS_H_
+
+#include <QJsonObject>
+#include <QVector>
+
+/*!
+ * \class BenchStats
+ * \brief Set of duration samples (in nanoseconds) measured for one benchmarked item
+ *
+ * Each repetition of a measure adds one sample; the statistics are computed on demand so that the
+ * measurement loop itself only appends a value to a vector. Warm-up runs must simply not be added.
+ */
+class BenchStats
+{
+public:
+	/*!
+	 * \brief Constructor of the class, does nothing special
+	 */
+	BenchStats();
+
+	/*!
+	 * \brief Destructor of the class, does nothing special
+	 */
+	virtual ~BenchStats();
+
+	/*!
+	 * \brief Adds a new sample
+	 * \param[in] p_ns  duration measured, in nanoseconds
+	 */
+	void addSample(qint64 p_ns)
+	{
+		__samples.append(p_ns);
+	}
+
+	/*!
+	 * \brief Adds a new sample with the number of heap allocations it made (see BenchAllocations)
+	 * \param[in] p_ns  duration measured, in nanoseconds
+	 * \param[in] p_nbAllocations  number of allocations during the measure
+	 */
+	void addSample(qint64 p_ns, qint64 p_nbAllocations)
+	{
+		__samples.append(p_ns);
+		__nbAllocations.append(p_nbAllocations);
+	}
+
+	/*!
+	 * \brief Getter for the number of samples
+	 * \return the number of samples added so far
+	 */
+	int count() const
+	{
+		return (__samples.count());
+	}
+
+	/*!
+	 * \brief Minimal value of the samples
+	 * \return the minimal duration (ns), 0 if there is no sample
+	 */
+	qint64 min() const;
+
+	/*!
+	 * \brief Maximal value of the samples
+	 * \return the maximal duration (ns), 0 if there is no sample
+	 */
+	qint64 max() const;
+
+	/*!
+	 * \brief Median value of the samples
+	 * \return the median duration (ns), 0 if there is no sample
+	 */
+	qint64 median() const;
+
+	/*!
+	 * \brief Average value of the samples
+	 * \return the mean duration (ns), 0 if there is no sample
+	 */
+	double mean() const;
+
+	/*!
+	 * \brief Standard deviation of the samples
+	 * \return the standard deviation (ns), 0 if there are less than 2 samples
+	 */
+	double stddev() const;
+
+	/*!
+	 * \brief Percentile of the samples (nearest rank method)
+	 * \param[in] p_percent  percentile required, in ]0 ; 100]
+	 * \return the duration (ns) below which p_percent % of the samples are, 0 if there is no sample
+	 */
+	qint64 percentile(double p_percent) const;
+
+	/*!
+	 * \brief Builds the machine readable representation of the statistics
+	 * \return
+	 * A json object containing the number of samples, min, median, mean, standard deviation, 95th percentile
+	 * and max values (in milliseconds), and the median number of allocations if they have been counted
+	 */
+	QJsonObject toJson() const;
+
+private:
+	/*!
+	 * \brief Raw samples, in nanoseconds, in the order they have been measured
+	 */
+	QVector<qint64> __samples;
+
+	/*!
+	 * \brief Numbers of heap allocations of the samples, empty if they have not been counted
+	 */
+	QVector<qint64> __nbAllocations;
+
+	/*!
+	 * \brief Builds a sorted copy of the samples
+	 * \return the samples sorted in ascending order
+	 */
+	QVector<qint64> __getSortedSamples() const;
+};
+
+#endif /* BENCHSTATS_H_ */
@@ -0,0 +1,58 @@
+# rekkix benchmark harness
+# released under the terms of the GNU General Public License
+#
+# Console tool used to generate synthetic corpora and to measure the analysis engine of rekkix
+# (configuration loading, parsing, merge, coverage computation and report generation).
+# The engine sources are shared with rekkix.pro through rekkix_core.pri.
+
+CONFIG += release
+VERSION = 0.6.0
+
+TEMPLATE = app
+CONFIG -= debug_and_release debug_and_release_target
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+CONFIG(debug, debug|release):TARGET = rekkix_bench_dbg
+CONFIG(release, debug|release):TARGET = rekkix_bench
+
+# gui is needed to write the pdf files of the synthetic corpus (QPdfWriter), no widget is used
+QT += core gui xml
+
+# Included folders at compile time
+INCLUDEPATH += ./inc
+DEPENDPATH += ./srcxx ./inc
+
+# Preprocessor defines (-D directives)
+DEFINES += APP_VERSION=\\\"$$VERSION\\\"
+
+CONFIG(debug, debug|release):DEFINES -= QT_NO_DEBUG_OUTPUT
+CONFIG(release, debug|release):DEFINES += QT_NO_DEBUG_OUTPUT 
+
+# all objects are generated at the same place
+OBJECTS_DIR = ./obj
+MOC_DIR = ./moc
+RCC_DIR = ./rcc
+
+# output folder 
+win32:DESTDIR = ./bin/windows
+unix:DESTDIR = ./bin/linux
+macx:DESTDIR = ./bin/macx
+
+# Analysis engine, report generation and third party libraries
+include(../rekkix_core.pri)
+
+# headers
+HEADERS += ./inc/BenchAllocations.h \
+           ./inc/BenchAnalysisRunner.h \
+           ./inc/BenchCorpusGenerator.h \
+           ./inc/BenchMicroKernels.h \
+           ./inc/BenchStats.h
+
+# sources
+SOURCES += ./srcxx/BenchAllocations.cpp \
+           ./srcxx/BenchAnalysisRunner.cpp \
+           ./srcxx/BenchCorpusGenerator.cpp \
+           ./srcxx/BenchMicroKernels.cpp \
+           ./srcxx/BenchStats.cpp \
+           ./srcxx/main_bench.cpp
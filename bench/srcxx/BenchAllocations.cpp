@@ -0,0 +1,74 @@
+/*!
+ * \file BenchAllocations.cpp
+ * \brief Implementation of the class BenchAllocations
+ * \date 2016-11-10
+ * \author f.souliers
+ */
+
+#include <cstdlib>
+#include <new>
+
+#include <QAtomicInteger>
+
+#include "BenchAllocations.h"
+
+/*!
+ * \brief Allocations counted so far, statically initialized: allocations happen before main
+ */
+static QBasicAtomicInteger<qint64> nbAllocations = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+#if defined(__GLIBC__)
+
+// The C library allows the program to replace its allocator : the calls are counted then given to the original one
+extern "C" void* __libc_malloc(size_t p_size);
+extern "C" void* __libc_calloc(size_t p_nb, size_t p_size);
+extern "C" void* __libc_realloc(void* p_ptr, size_t p_size);
+
+extern "C" void* malloc(size_t p_size)
+{
+	nbAllocations.fetchAndAddRelaxed(1);
+	return (__libc_malloc(p_size));
+}
+
+extern "C" void* calloc(size_t p_nb, size_t p_size)
+{
+	nbAllocations.fetchAndAddRelaxed(1);
+	return (__libc_calloc(p_nb, p_size));
+}
+
+extern "C" void* realloc(void* p_ptr, size_t p_size)
+{
+	nbAllocations.fetchAndAddRelaxed(1);
+	return (__libc_realloc(p_ptr, p_size));
+}
+
+static const char* ALLOCATIONS_SCOPE = "malloc";  //!< Every allocation is counted
+
+#else
+
+void* operator new(std::size_t p_size)
+{
+	nbAllocations.fetchAndAddRelaxed(1);
+	void* p = std::malloc(p_size == 0 ? 1 : p_size);
+	if (!p) throw std::bad_alloc();
+	return (p);
+}
+
+void operator delete(void* p_ptr) noexcept
+{
+	std::free(p_ptr);
+}
+
+static const char* ALLOCATIONS_SCOPE = "operator_new";  //!< The Qt containers allocate with malloc, not counted
+
+#endif
+
+qint64 BenchAllocations::getNbAllocations()
+{
+	return (nbAllocations.load());
+}
+
+QString BenchAllocations::getScope()
+{
+	return (QString(ALLOCATIONS_SCOPE));
+}
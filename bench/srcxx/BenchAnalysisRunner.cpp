@@ -0,0 +1,281 @@
+/*!
+ * \file BenchAnalysisRunner.cpp
+ * \brief Implementation of the class BenchAnalysisRunner
+ * \date 2016-10-18
+ * \author f.souliers
+ */
+
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QRunnable>
+#include <QTemporaryDir>
+#include <QThreadPool>
+
+#include "AnalysisSqliteExport.h"
+#include "BenchAllocations.h"
+#include "BenchAnalysisRunner.h"
+#include "FactoryReport.h"
+#include "FactoryRequirementFile.h"
+#include "ModelConfiguration.h"
+#include "ModelConfigurationErrors.h"
+#include "ModelSngAnalysisErrors.h"
+#include "ModelSngReqMatrix.h"
+
+/*!
+ * \brief Parsing of one file in the thread pool, the duration is cumulated by format
+ */
+class BenchParseTask : public QRunnable
+{
+public:
+	BenchParseTask(RequirementFileAbstractPtr p_file,
+	               const QString& p_format,
+	               QMutex* p_mutex,
+	               QMap<QString, qint64>* p_durationsByFormat)
+		: QRunnable(), __file(p_file), __format(p_format), __mutex(p_mutex), __durationsByFormat(p_durationsByFormat)
+	{
+	}
+
+	void run() Q_DECL_OVERRIDE
+	{
+		QElapsedTimer t;
+		t.start();
+		__file->parseFile();
+		qint64 ns = t.nsecsElapsed();
+
+		QMutexLocker l(__mutex);
+		(*__durationsByFormat)[__format] += ns;
+	}
+
+private:
+	RequirementFileAbstractPtr __file;
+	QString __format;
+	QMutex* __mutex;
+	QMap<QString, qint64>* __durationsByFormat;
+};
+
+BenchAnalysisRunner::BenchAnalysisRunner(const QString& p_configFilePath)
+	: __configFilePath(p_configFilePath), __nbFiles(0), __nbRequirements(0), __nbErrors(0)
+{
+}
+
+BenchAnalysisRunner::~BenchAnalysisRunner()
+{
+}
+
+bool BenchAnalysisRunner::__runOnce(int p_nbThreads, phaseStats_t& p_stats, QString& p_errMsg)
+{
+	// Phase 0 : release of the previous run (the first run has nothing to release)
+	QElapsedTimer t;
+	t.start();
+	qint64 allocs = BenchAllocations::getNbAllocations();
+	ModelSngReqMatrix::instance().clear();
+	ModelSngAnalysisErrors::instance().clear();
+	p_stats["clear"].addSample(t.nsecsElapsed(), BenchAllocations::getNbAllocations() - allocs);
+
+	// Phase 1 : configuration
+	ModelConfiguration cnfModel;
+	ModelConfigurationErrors cnfErrorsModel;
+	t.start();
+	allocs = BenchAllocations::getNbAllocations();
+	cnfModel.setFile(__configFilePath.toStdString().c_str(), cnfErrorsModel);
+	p_stats["config_load"].addSample(t.nsecsElapsed(), BenchAllocations::getNbAllocations() - allocs);
+
+	if (cnfErrorsModel.hasSignificantError())
+	{
+		p_errMsg = QString("configuration errors in %1 :").arg(__configFilePath);
+		cnfErrorsModel.appendErrorString(p_errMsg);
+		return (false);
+	}
+
+	// Phase 2 : parsing, the files are created the same way Rekkix does
+	QVector<RequirementFileAbstractPtr> registeredFiles;
+	QVector<QString> formats;
+	foreach(ModelConfiguration::CnfFileAttributesMap_t cnfFile, cnfModel.getConfiguredRequirementFiles())
+	{
+		RequirementFileAbstractPtr f = FactoryRequirementFile::getRequirementFile(cnfFile);
+		if (f)
+		{
+			QString format = cnfFile[ModelConfiguration::REQFILE_ATTR_PARSER];
+			if (format.isEmpty()) format = QFileInfo(cnfFile[ModelConfiguration::REQFILE_ATTR_PATH]).suffix().toLower();
+
+			registeredFiles.append(f);
+			formats.append(format);
+			ModelSngReqMatrix::instance().addRequirementFile(f);
+		}
+	}
+	__nbFiles = registeredFiles.count();
+
+	QMutex durationsMutex;
+	QMap<QString, qint64> durationsByFormat;
+	QThreadPool pool;
+	pool.setMaxThreadCount(p_nbThreads);
+
+	t.restart();
+	allocs = BenchAllocations::getNbAllocations();
+	for (int i = 0 ; i < registeredFiles.count() ; ++i)
+	{
+		pool.start(new BenchParseTask(registeredFiles[i], formats[i], &durationsMutex, &durationsByFormat));
+	}
+	pool.waitForDone();
+	p_stats["parse_wall"].addSample(t.nsecsElapsed(), BenchAllocations::getNbAllocations() - allocs);
+
+	QMap<QString, qint64>::const_iterator it_d;
+	for (it_d = durationsByFormat.constBegin() ; it_d != durationsByFormat.constEnd() ; ++it_d)
+	{
+		p_stats["parse_" + it_d.key()].addSample(it_d.value());
+	}
+
+	// Phase 3 : merge of the recorded contributions into the matrix (done by the waiter thread in Rekkix)
+	t.restart();
+	allocs = BenchAllocations::getNbAllocations();
+	foreach(RequirementFileAbstractPtr f, registeredFiles)
+	{
+		ModelSngReqMatrix::instance().mergeRequirementFile(f);
+	}
+	p_stats["merge"].addSample(t.nsecsElapsed(), BenchAllocations::getNbAllocations() - allocs);
+
+	// Phase 4 : coverage
+	t.restart();
+	allocs = BenchAllocations::getNbAllocations();
+	ModelSngReqMatrix::instance().computeCoverage();
+	ModelSngReqMatrix::instance().publishCoverage(ModelSngReqMatrix::instance().createResults());
+	p_stats["compute_coverage"].addSample(t.nsecsElapsed(), BenchAllocations::getNbAllocations() - allocs);
+
+	// Phase 5 : snapshot with its impact index, then the downstream impacts of every requirement
+	t.restart();
+	allocs = BenchAllocations::getNbAllocations();
+	AnalysisSnapshotPtr snapshot = ModelSngReqMatrix::instance().createSnapshot();
+	p_stats["snapshot"].addSample(t.nsecsElapsed(), BenchAllocations::getNbAllocations() - allocs);
+
+	t.restart();
+	allocs = BenchAllocations::getNbAllocations();
+	foreach(QString id, snapshot->getRequirementIds())
+	{
+		snapshot->getImpactIndex().getImpactedRequirements(id, AnalysisImpactIndex::DOWNSTREAM);
+	}
+	p_stats["impact_all_reqs"].addSample(t.nsecsElapsed(), BenchAllocations::getNbAllocations() - allocs);
+
+	// As-you-type searches: the successive prefixes of the last id, in the 3 modes
+	QStringList reqIds = snapshot->getRequirementIds();
+	if (!reqIds.isEmpty())
+	{
+		QString typed = reqIds.last();
+		t.restart();
+		allocs = BenchAllocations::getNbAllocations();
+		for (int len = 1 ; len <= typed.length() ; len++)
+		{
+			snapshot->getSearchIndex().search(typed.left(len), AnalysisSearchIndex::PREFIX, 1000);
+			snapshot->getSearchIndex().search(typed.left(len), AnalysisSearchIndex::SUBSTRING, 1000);
+			snapshot->getSearchIndex().search(QRegularExpression::escape(typed.left(len)), AnalysisSearchIndex::REGEX, 1000);
+		}
+		p_stats["search_as_you_type"].addSample(t.nsecsElapsed() / typed.length(), (BenchAllocations::getNbAllocations() - allocs) / typed.length());
+	}
+
+	// Phase 6 : reports, only built in memory so the disk does not interfere with the measure
+	QDateTime reportTimestamp = QDateTime::currentDateTime();
+	foreach(ModelConfiguration::CnfFileAttributesMap_t outFileDescription, cnfModel.getOutputFiles())
+	{
+		QString writer = outFileDescription[ModelConfiguration::OUTPUT_ATTR_WRITER];
+		if (writer == ModelConfiguration::OUTPUT_ATTR_VALUE_SNAPSHOT || writer == ModelConfiguration::OUTPUT_ATTR_VALUE_SQLITE) continue;
+
+		t.restart();
+		allocs = BenchAllocations::getNbAllocations();
+		QString report = FactoryReport::buildReport(outFileDescription, reportTimestamp);
+		p_stats["report_" + outFileDescription[ModelConfiguration::OUTPUT_ATTR_WRITER]].addSample(t.nsecsElapsed(), BenchAllocations::getNbAllocations() - allocs);
+
+		if (report.isEmpty())
+		{
+			p_errMsg = QString("empty report for writer %1").arg(outFileDescription[ModelConfiguration::OUTPUT_ATTR_WRITER]);
+			return (false);
+		}
+	}
+
+	// The SQLite export cannot be built in memory, it is written in a temporary directory
+	QTemporaryDir exportDir;
+	t.restart();
+	allocs = BenchAllocations::getNbAllocations();
+	if (!AnalysisSqliteExport::write(*snapshot, exportDir.path() + "/export.sqlite", p_errMsg)) return (false);
+	p_stats["export_sqlite"].addSample(t.nsecsElapsed(), BenchAllocations::getNbAllocations() - allocs);
+
+	__nbRequirements = ModelSngReqMatrix::instance().getNbRequirements();
+	__nbErrors = ModelSngAnalysisErrors::instance().getNbErrors();
+
+	// Phase 7 : update of one file, as done in watch mode
+	RequirementFileAbstractPtr f = NULL;
+	if (!registeredFiles.isEmpty())
+	{
+		t.restart();
+		allocs = BenchAllocations::getNbAllocations();
+		f = FactoryRequirementFile::getRequirementFile(cnfModel.getConfiguredRequirementFiles().value(registeredFiles.first()->getFileId()));
+	}
+	if (f)
+	{
+		QVector<RequirementFileAbstractPtr> updatedFiles;
+		updatedFiles.append(f);
+		QVector<RequirementFileAbstractPtr> keptFiles = ModelSngReqMatrix::instance().prepareRequirementFilesUpdate(updatedFiles);
+		foreach(RequirementFileAbstractPtr p, keptFiles)
+		{
+			ModelSngReqMatrix::instance().mergeRequirementFile(p);
+		}
+		f->parseFile();
+		ModelSngReqMatrix::instance().mergeRequirementFile(f);
+		ModelSngReqMatrix::instance().computeCoverage();
+		ModelSngReqMatrix::instance().publishCoverage(ModelSngReqMatrix::instance().createResults());
+		p_stats["update_one_file"].addSample(t.nsecsElapsed(), BenchAllocations::getNbAllocations() - allocs);
+	}
+
+	return (true);
+}
+
+bool BenchAnalysisRunner::run(const QVector<int>& p_threadCounts, int p_nbWarmups, int p_nbRepeats, QJsonObject& p_results, QString& p_errMsg)
+{
+	QJsonArray runs;
+	foreach(int nbThreads, p_threadCounts)
+	{
+		phaseStats_t stats;
+		for (int r = 0 ; r < p_nbWarmups ; ++r)
+		{
+			phaseStats_t ignored;
+			if (!__runOnce(nbThreads, ignored, p_errMsg)) return (false);
+		}
+
+		for (int r = 0 ; r < p_nbRepeats ; ++r)
+		{
+			qDebug() << "BenchAnalysisRunner::run : " << nbThreads << " thread(s), run " << r + 1 << "/" << p_nbRepeats;
+			if (!__runOnce(nbThreads, stats, p_errMsg)) return (false);
+		}
+
+		QJsonObject phases;
+		phaseStats_t::const_iterator it;
+		for (it = stats.constBegin() ; it != stats.constEnd() ; ++it)
+		{
+			phases.insert(it.key(), it.value().toJson());
+		}
+
+		QJsonObject oneRun;
+		oneRun.insert("threads", nbThreads);
+		oneRun.insert("phases", phases);
+		runs.append(oneRun);
+	}
+
+	// Leave the singletons empty, the parsers are deleted here
+	ModelSngReqMatrix::instance().clear();
+	ModelSngAnalysisErrors::instance().clear();
+
+	p_results.insert("config", __configFilePath);
+	p_results.insert("warmups", p_nbWarmups);
+	p_results.insert("repeats", p_nbRepeats);
+	p_results.insert("files", __nbFiles);
+	p_results.insert("requirements", __nbRequirements);
+	p_results.insert("errors", __nbErrors);
+	p_results.insert("allocations_scope", BenchAllocations::getScope());
+	p_results.insert("runs", runs);
+
+	return (true);
+}
@@ -0,0 +1,413 @@
+/*!
+ * \file BenchCorpusGenerator.cpp
+ * \brief Implementation of the class BenchCorpusGenerator
+ * \date 2016-10-18
+ * \author f.souliers
+ */
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFont>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QTextStream>
+
+#include "zip.h"
+
+#include "BenchCorpusGenerator.h"
+#include "ModelConfiguration.h"
+
+static const QString CORPUS_CONFIG_FILE_NAME = "corpus.ini";  //!< Name of the generated configuration file
+static const QString CORPUS_REQ_REGEX = "^(?<req_id>DOC[0-9]+_REQ[0-9]+)$";  //!< req_regex of every generated file
+static const QString CORPUS_CMP_REGEX = "^Composite of\\s*:\\s*(?<req_lst>.*)$";  //!< cmp_regex of every generated file
+static const QString CORPUS_COV_REGEX = "^Covers\\s*:\\s*(?<req_lst>.*)$";  //!< cov_regex of every generated file
+static const QString CORPUS_LIST_SEPARATOR = ",";  //!< separator used in the lists of requirements
+
+//! Words used to build the description lines
+static const char* FILLER_WORDS[] = { "the", "system", "shall", "provide", "a", "means", "to", "monitor",
+                                      "every", "configured", "input", "and", "report", "any", "failure",
+                                      "within", "one", "second", "after", "its", "detection", "operator" };
+static const int NB_FILLER_WORDS = sizeof(FILLER_WORDS) / sizeof(FILLER_WORDS[0]);
+
+BenchCorpusGenerator::parameters_t BenchCorpusGenerator::defaultParameters()
+{
+	parameters_t p;
+	p.nbDocx = 4;
+	p.nbOdt = 4;
+	p.nbPdf = 2;
+	p.nbTxt = 6;
+	p.nbReqsPerFile = 200;
+	p.compositionDepth = 2;
+	p.coverageRatio = 0.8;
+	p.nbDuplicates = 5;
+	p.nbCycles = 2;
+	p.nbFillerLines = 3;
+	p.seed = 42;
+	return (p);
+}
+
+BenchCorpusGenerator::BenchCorpusGenerator(const parameters_t& p_params)
+	: __params(p_params), __rng(p_params.seed)
+{
+}
+
+BenchCorpusGenerator::~BenchCorpusGenerator()
+{
+}
+
+int BenchCorpusGenerator::__randInt(int p_max)
+{
+	std::uniform_int_distribution<int> d(0, p_max - 1);
+	return (d(__rng));
+}
+
+void BenchCorpusGenerator::__buildCorpus()
+{
+	__docs.clear();
+
+	// Step 1 : the documents, formats are interleaved so every level contains several formats
+	QStringList formats;
+	for (int i = 0 ; i < __params.nbDocx ; ++i) formats << "docx";
+	for (int i = 0 ; i < __params.nbOdt ; ++i) formats << "odt";
+	for (int i = 0 ; i < __params.nbPdf ; ++i) formats << "pdf";
+	for (int i = 0 ; i < __params.nbTxt ; ++i) formats << "txt";
+	std::shuffle(formats.begin(), formats.end(), __rng);
+
+	int nbFiles = formats.count();
+	QVector<QVector<int>> docsByLevel(NB_LEVELS);
+	for (int i = 0 ; i < nbFiles ; ++i)
+	{
+		genDoc_t d;
+		d.id = QString("DOC%1").arg(i);
+		d.format = formats[i];
+		d.level = (i * NB_LEVELS) / nbFiles;
+		docsByLevel[d.level].append(i);
+
+		for (int k = 0 ; k < __params.nbReqsPerFile ; ++k)
+		{
+			genReq_t r;
+			r.id = QString("%1_REQ%2").arg(d.id).arg(k);
+			d.reqs.append(r);
+		}
+
+		// Composition chains: in each group of (depth + 1) requirements, each one is composed of the next one
+		if (__params.compositionDepth > 0)
+		{
+			int groupSize = __params.compositionDepth + 1;
+			for (int k = 0 ; k + 1 < d.reqs.count() ; ++k)
+			{
+				if ((k % groupSize) < __params.compositionDepth)
+				{
+					d.reqs[k].composedOf << d.reqs[k + 1].id;
+				}
+			}
+		}
+
+		__docs.append(d);
+	}
+
+	// Step 2 : coverage, each requirement of a level may be covered by a requirement of the level below
+	std::uniform_real_distribution<double> proba(0.0, 1.0);
+	for (int lvl = 0 ; lvl + 1 < NB_LEVELS ; ++lvl)
+	{
+		if (docsByLevel[lvl + 1].isEmpty()) continue;
+
+		foreach(int upIdx, docsByLevel[lvl])
+		{
+			for (int k = 0 ; k < __docs[upIdx].reqs.count() ; ++k)
+			{
+				if (proba(__rng) >= __params.coverageRatio) continue;
+
+				int dwnIdx = docsByLevel[lvl + 1][__randInt(docsByLevel[lvl + 1].count())];
+				if (__docs[dwnIdx].reqs.isEmpty()) continue;
+
+				int dwnReq = __randInt(__docs[dwnIdx].reqs.count());
+				__docs[dwnIdx].reqs[dwnReq].covers << __docs[upIdx].reqs[k].id;
+			}
+		}
+	}
+
+	// Step 3 : inconsistencies that must be detected by the analysis
+	if (nbFiles > 1 && __params.nbReqsPerFile > 0)
+	{
+		for (int i = 0 ; i < __params.nbDuplicates ; ++i)
+		{
+			int f = __randInt(nbFiles);
+			int g = (f + 1 + __randInt(nbFiles - 1)) % nbFiles;
+			genReq_t r;
+			r.id = __docs[g].reqs[__randInt(__docs[g].reqs.count())].id;
+			__docs[f].reqs.append(r);
+		}
+	}
+
+	if (nbFiles > 0 && __params.nbReqsPerFile > 1)
+	{
+		for (int i = 0 ; i < __params.nbCycles ; ++i)
+		{
+			genDoc_t& d = __docs[__randInt(nbFiles)];
+			int a = __randInt(__params.nbReqsPerFile);
+			int b = (a + 1 + __randInt(__params.nbReqsPerFile - 1)) % __params.nbReqsPerFile;
+			d.reqs[a].composedOf << d.reqs[b].id;
+			d.reqs[b].composedOf << d.reqs[a].id;
+		}
+	}
+}
+
+QStringList BenchCorpusGenerator::__getParagraphs(const genDoc_t& p_doc)
+{
+	QStringList paragraphs;
+	paragraphs << QString("Synthetic document %1").arg(p_doc.id);
+
+	foreach(genReq_t r, p_doc.reqs)
+	{
+		paragraphs << r.id;
+		if (!r.composedOf.isEmpty())
+		{
+			paragraphs << QString("Composite of : %1").arg(r.composedOf.join(CORPUS_LIST_SEPARATOR + " "));
+		}
+		if (!r.covers.isEmpty())
+		{
+			paragraphs << QString("Covers : %1").arg(r.covers.join(CORPUS_LIST_SEPARATOR + " "));
+		}
+
+		for (int l = 0 ; l < __params.nbFillerLines ; ++l)
+		{
+			QStringList words;
+			int nbWords = 6 + __randInt(10);
+			for (int w = 0 ; w < nbWords ; ++w)
+			{
+				words << FILLER_WORDS[__randInt(NB_FILLER_WORDS)];
+			}
+			paragraphs << words.join(" ");
+		}
+	}
+
+	return (paragraphs);
+}
+
+bool BenchCorpusGenerator::generate(const QString& p_outDir, QString& p_configFilePath, QString& p_errMsg)
+{
+	QDir outDir(p_outDir);
+	if (!outDir.mkpath("."))
+	{
+		p_errMsg = QString("unable to create directory %1").arg(p_outDir);
+		return (false);
+	}
+
+	__buildCorpus();
+
+	foreach(genDoc_t d, __docs)
+	{
+		QString path = outDir.absoluteFilePath(d.id + "." + d.format);
+		QStringList paragraphs = __getParagraphs(d);
+		bool ok;
+
+		if (d.format == "docx")
+		{
+			ok = __writeDocx(path, paragraphs, p_errMsg);
+		}
+		else if (d.format == "odt")
+		{
+			ok = __writeOdt(path, paragraphs, p_errMsg);
+		}
+		else if (d.format == "pdf")
+		{
+			ok = __writePdf(path, paragraphs, p_errMsg);
+		}
+		else
+		{
+			ok = __writeTxt(path, paragraphs, p_errMsg);
+		}
+
+		if (!ok) return (false);
+	}
+
+	p_configFilePath = outDir.absoluteFilePath(CORPUS_CONFIG_FILE_NAME);
+	return (__writeConfiguration(p_configFilePath, p_errMsg));
+}
+
+bool BenchCorpusGenerator::__writeTxt(const QString& p_path, const QStringList& p_paragraphs, QString& p_errMsg)
+{
+	QFile f(p_path);
+	if (!f.open(QIODevice::WriteOnly | QIODevice::Text))
+	{
+		p_errMsg = QString("unable to open %1").arg(p_path);
+		return (false);
+	}
+
+	QTextStream out(&f);
+	out.setCodec("UTF-8");
+	foreach(QString p, p_paragraphs)
+	{
+		out << p << "\n";
+	}
+	f.close();
+
+	return (true);
+}
+
+bool BenchCorpusGenerator::__writeDocx(const QString& p_path, const QStringList& p_paragraphs, QString& p_errMsg)
+{
+	QString xml;
+	xml += "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n";
+	xml += "<w:document xmlns:w=\"http://schemas.openxmlformats.org/wordprocessingml/2006/main\"><w:body>";
+	foreach(QString p, p_paragraphs)
+	{
+		xml += "<w:p><w:r><w:t>" + p.toHtmlEscaped() + "</w:t></w:r></w:p>";
+	}
+	xml += "</w:body></w:document>";
+
+	QString contentTypes;
+	contentTypes += "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n";
+	contentTypes += "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">";
+	contentTypes += "<Override PartName=\"/word/document.xml\" ";
+	contentTypes += "ContentType=\"application/vnd.openxmlformats-officedocument.wordprocessingml.document.main+xml\"/>";
+	contentTypes += "</Types>";
+
+	QVector<QByteArray> contents;
+	contents << contentTypes.toUtf8() << xml.toUtf8();
+	return (__writeZip(p_path, QStringList() << "[Content_Types].xml" << "word/document.xml", contents, p_errMsg));
+}
+
+bool BenchCorpusGenerator::__writeOdt(const QString& p_path, const QStringList& p_paragraphs, QString& p_errMsg)
+{
+	QString xml;
+	xml += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	xml += "<office:document-content xmlns:office=\"urn:oasis:names:tc:opendocument:xmlns:office:1.0\" ";
+	xml += "xmlns:text=\"urn:oasis:names:tc:opendocument:xmlns:text:1.0\" office:version=\"1.2\">";
+	xml += "<office:body><office:text>";
+	foreach(QString p, p_paragraphs)
+	{
+		xml += "<text:p>" + p.toHtmlEscaped() + "</text:p>";
+	}
+	xml += "</office:text></office:body></office:document-content>";
+
+	QVector<QByteArray> contents;
+	contents << QByteArray("application/vnd.oasis.opendocument.text") << xml.toUtf8();
+	return (__writeZip(p_path, QStringList() << "mimetype" << "content.xml", contents, p_errMsg));
+}
+
+bool BenchCorpusGenerator::__writePdf(const QString& p_path, const QStringList& p_paragraphs, QString& p_errMsg)
+{
+	QPdfWriter writer(p_path);
+	writer.setPageSize(QPagedPaintDevice::A4);
+	writer.setResolution(300);
+
+	QPainter painter;
+	if (!painter.begin(&writer))
+	{
+		p_errMsg = QString("unable to open %1").arg(p_path);
+		return (false);
+	}
+
+	QFont font("Helvetica");
+	font.setPointSize(10);
+	painter.setFont(font);
+
+	int lineHeight = painter.fontMetrics().height();
+	int pageHeight = writer.height();
+	int y = lineHeight;
+	foreach(QString p, p_paragraphs)
+	{
+		if (y + lineHeight > pageHeight)
+		{
+			writer.newPage();
+			y = lineHeight;
+		}
+		painter.drawText(0, y, p);
+		y += lineHeight;
+	}
+	painter.end();
+
+	return (true);
+}
+
+bool BenchCorpusGenerator::__writeZip(const QString& p_path,
+                                      const QStringList& p_names,
+                                      const QVector<QByteArray>& p_contents,
+                                      QString& p_errMsg)
+{
+	int err = 0;
+	zip_t* za = zip_open(p_path.toStdString().c_str(), ZIP_CREATE | ZIP_TRUNCATE, &err);
+	if (!za)
+	{
+		p_errMsg = QString("zip_open failed for %1 (error %2)").arg(p_path).arg(err);
+		return (false);
+	}
+
+	// libzip reads the buffers when closing the archive: p_contents must stay alive until zip_close
+	for (int i = 0 ; i < p_names.count() ; ++i)
+	{
+		zip_source_t* src = zip_source_buffer(za, p_contents[i].constData(), p_contents[i].size(), 0);
+		if (!src || zip_file_add(za, p_names[i].toStdString().c_str(), src, ZIP_FL_OVERWRITE) < 0)
+		{
+			if (src) zip_source_free(src);
+			p_errMsg = QString("unable to add %1 into %2 : %3").arg(p_names[i]).arg(p_path).arg(zip_strerror(za));
+			zip_discard(za);
+			return (false);
+		}
+	}
+
+	if (zip_close(za) < 0)
+	{
+		p_errMsg = QString("zip_close failed for %1 : %2").arg(p_path).arg(zip_strerror(za));
+		zip_discard(za);
+		return (false);
+	}
+
+	return (true);
+}
+
+bool BenchCorpusGenerator::__writeConfiguration(const QString& p_path, QString& p_errMsg)
+{
+	QFile f(p_path);
+	if (!f.open(QIODevice::WriteOnly | QIODevice::Text))
+	{
+		p_errMsg = QString("unable to open %1").arg(p_path);
+		return (false);
+	}
+
+	// In the ini format, backslashes of the quoted values must be escaped
+	auto iniValue = [](QString v) -> QString
+	{
+		return ("\"" + v.replace("\\", "\\\\") + "\"");
+	};
+
+	QTextStream out(&f);
+	out.setCodec("UTF-8");
+	out << "; Synthetic corpus generated by rekkix_bench (seed " << __params.seed << ")\n\n";
+	out << "[files]\n";
+	foreach(genDoc_t d, __docs)
+	{
+		QString yes = ModelConfiguration::REQFILE_ATTR_VALUE_YES;
+		QString no = ModelConfiguration::REQFILE_ATTR_VALUE_NO;
+
+		out << "\n; " << d.id << " (level " << d.level << ")\n";
+		out << d.id << "\\" << ModelConfiguration::REQFILE_ATTR_PATH << "=" << iniValue("./" + d.id + "." + d.format) << "\n";
+		out << d.id << "\\" << ModelConfiguration::REQFILE_ATTR_PARSER << "=" << iniValue(d.format) << "\n";
+		out << d.id << "\\" << ModelConfiguration::REQFILE_ATTR_REQREGEX << "=" << iniValue(CORPUS_REQ_REGEX) << "\n";
+		out << d.id << "\\" << ModelConfiguration::REQFILE_ATTR_CMPREGEX << "=" << iniValue(CORPUS_CMP_REGEX) << "\n";
+		out << d.id << "\\" << ModelConfiguration::REQFILE_ATTR_CMPSEPARATOR << "=" << iniValue(CORPUS_LIST_SEPARATOR) << "\n";
+		out << d.id << "\\" << ModelConfiguration::REQFILE_ATTR_COVREGEX << "=" << iniValue(CORPUS_COV_REGEX) << "\n";
+		out << d.id << "\\" << ModelConfiguration::REQFILE_ATTR_COVSEPARATOR << "=" << iniValue(CORPUS_LIST_SEPARATOR) << "\n";
+		out << d.id << "\\" << ModelConfiguration::REQFILE_ATTR_HASDWN << "=" << iniValue(d.level + 1 < NB_LEVELS ? yes : no) << "\n";
+		out << d.id << "\\" << ModelConfiguration::REQFILE_ATTR_HASUP << "=" << iniValue(d.level > 0 ? yes : no) << "\n";
+	}
+
+	out << "\n[outputs]\n";
+	out << "output_html\\" << ModelConfiguration::OUTPUT_ATTR_PATH << "="
+	    << iniValue("./corpus_" + ModelConfiguration::OUTPUT_STR_TIMESTAMP + ".html") << "\n";
+	out << "output_html\\" << ModelConfiguration::OUTPUT_ATTR_WRITER << "=" << iniValue(ModelConfiguration::OUTPUT_ATTR_VALUE_HTML) << "\n";
+	out << "\n";
+	out << "output_csv\\" << ModelConfiguration::OUTPUT_ATTR_DELIMITER << "=" << iniValue(";") << "\n";
+	out << "output_csv\\" << ModelConfiguration::OUTPUT_ATTR_PATH << "="
+	    << iniValue("./corpus_" + ModelConfiguration::OUTPUT_STR_TIMESTAMP + ".csv") << "\n";
+	out << "output_csv\\" << ModelConfiguration::OUTPUT_ATTR_WRITER << "=" << iniValue(ModelConfiguration::OUTPUT_ATTR_VALUE_CSV) << "\n";
+	f.close();
+
+	qDebug() << "BenchCorpusGenerator::__writeConfiguration : " << __docs.count() << " files described in " << p_path;
+	return (true);
+}
@@ -0,0 +1,447 @@
+/*!
+ * \file BenchMicroKernels.cpp
+ * \brief Implementation of the class BenchMicroKernels
+ * \date 2016-10-19
+ * \author f.souliers
+ */
+
+#include <QDebug>
+#include <QDir>
+#include <QDomDocument>
+#include <QDomElement>
+#include <QElapsedTimer>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QXmlStreamReader>
+
+#include "BenchAllocations.h"
+#include "BenchCorpusGenerator.h"
+#include "BenchMicroKernels.h"
+#include "ModelSngAnalysisErrors.h"
+#include "ModelSngReqMatrix.h"
+#include "Requirement.h"
+#include "RequirementFile_docx.h"
+#include "RequirementFile_txt.h"
+
+static const int MAX_DEEP_CHAIN = 1000;  //!< Recursive kernels: the length of the chains is bounded to protect the stack
+
+/*!
+ * \brief Gives access to the protected matching kernel of the txt parser
+ */
+class BenchTxtProbe : public RequirementFile_txt
+{
+public:
+	BenchTxtProbe(const ModelConfiguration::CnfFileAttributesMap_t& p_cnfFile) : RequirementFile_txt(p_cnfFile)
+	{
+	}
+
+	bool hasStoredAnyRequirementDefinition(const QString& p_text, QString& p_reqfound, bool& p_reqAcceptable)
+	{
+		return (_hasStoredAnyRequirementDefinition(p_text, p_reqfound, p_reqAcceptable, _contributions, getFileId()));
+	}
+};
+
+/*!
+ * \brief Gives access to the protected unzipping kernel of the docx parser
+ */
+class BenchDocxProbe : public RequirementFile_docx
+{
+public:
+	BenchDocxProbe(const ModelConfiguration::CnfFileAttributesMap_t& p_cnfFile) : RequirementFile_docx(p_cnfFile)
+	{
+	}
+
+	void readTextDataFromZippedFormat(QString* p_textData)
+	{
+		_readTextDataFromZippedFormat(p_textData);
+	}
+};
+
+/*!
+ * \brief Runs a function in a thread pool
+ */
+class BenchFunctionTask : public QRunnable
+{
+public:
+	BenchFunctionTask(std::function<void()> p_f) : QRunnable(), __f(p_f)
+	{
+	}
+
+	void run() Q_DECL_OVERRIDE
+	{
+		__f();
+	}
+
+private:
+	std::function<void()> __f;
+};
+
+/*!
+ * \brief Builds the configuration of a probe file, using the same patterns as the synthetic corpus
+ */
+static ModelConfiguration::CnfFileAttributesMap_t getProbeConfiguration(const QString& p_id, const QString& p_path)
+{
+	ModelConfiguration::CnfFileAttributesMap_t cnf;
+	cnf[ModelConfiguration::REQFILE_ATTR_ID] = p_id;
+	cnf[ModelConfiguration::REQFILE_ATTR_PATH] = p_path;
+	cnf[ModelConfiguration::REQFILE_ATTR_REQREGEX] = "^(?<req_id>DOC[0-9]+_REQ[0-9]+)$";
+	cnf[ModelConfiguration::REQFILE_ATTR_HASDWN] = ModelConfiguration::REQFILE_ATTR_VALUE_YES;
+	cnf[ModelConfiguration::REQFILE_ATTR_HASUP] = ModelConfiguration::REQFILE_ATTR_VALUE_NO;
+	return (cnf);
+}
+
+BenchMicroKernels::BenchMicroKernels(int p_size, int p_nbWarmups, int p_nbRepeats)
+	: __size(qMax(1, p_size)), __nbWarmups(qMax(0, p_nbWarmups)), __nbRepeats(qMax(1, p_nbRepeats))
+{
+}
+
+BenchMicroKernels::~BenchMicroKernels()
+{
+}
+
+BenchStats BenchMicroKernels::__measure(std::function<void()> p_setup, std::function<void()> p_kernel)
+{
+	BenchStats stats;
+	QElapsedTimer t;
+
+	for (int i = 0 ; i < __nbWarmups + __nbRepeats ; ++i)
+	{
+		if (p_setup) p_setup();
+
+		qint64 allocs = BenchAllocations::getNbAllocations();
+		t.start();
+		p_kernel();
+		qint64 ns = t.nsecsElapsed();
+		allocs = BenchAllocations::getNbAllocations() - allocs;
+
+		if (i >= __nbWarmups) stats.addSample(ns, allocs);
+	}
+
+	return (stats);
+}
+
+QJsonObject BenchMicroKernels::__toJson(const BenchStats& p_stats, qint64 p_nbItems, const QString& p_itemName)
+{
+	QJsonObject o = p_stats.toJson();
+	o.insert("items", p_nbItems);
+	o.insert("item", p_itemName);
+	o.insert("ns_per_item", p_nbItems > 0 ? static_cast<double>(p_stats.median()) / p_nbItems : 0.0);
+	return (o);
+}
+
+bool BenchMicroKernels::__runRegexKernel(QJsonObject& p_results, QString& /*p_errMsg*/)
+{
+	// Typical content of a document: one requirement definition every 5 lines, the other lines being
+	// lists of requirements or description
+	QStringList lines;
+	for (int i = 0 ; i < __size ; ++i)
+	{
+		switch (i % 5)
+		{
+			case 0:
+				lines << QString("DOC0_REQ%1").arg(i);
+				break;
+			case 1:
+				lines << QString("Covers : DOC1_REQ%1, DOC1_REQ%2").arg(i).arg(i + 1);
+				break;
+			default:
+				lines << "The system shall provide a means to monitor every configured input and report any failure";
+				break;
+		}
+	}
+
+	BenchTxtProbe probe(getProbeConfiguration("MICRO", ""));
+	auto setup = [&probe]()
+	{
+		ModelSngReqMatrix::instance().clear();
+		ModelSngAnalysisErrors::instance().clear();
+		probe.setRunId(ModelSngReqMatrix::instance().getRunId());
+		probe.clearParsingResults();
+	};
+	auto kernel = [&lines, &probe]()
+	{
+		QString reqFound;
+		bool acceptable;
+		foreach(const QString& l, lines)
+		{
+			probe.hasStoredAnyRequirementDefinition(l, reqFound, acceptable);
+		}
+		ModelSngReqMatrix::instance().mergeRequirementFile(&probe);
+	};
+
+	p_results.insert("regex_req_definition", __toJson(__measure(setup, kernel), lines.count(), "line"));
+	setup();
+
+	return (true);
+}
+
+bool BenchMicroKernels::__runZipAndXmlKernels(QJsonObject& p_results, QString& p_errMsg)
+{
+	if (!__workDir.isValid())
+	{
+		p_errMsg = "unable to create a temporary directory";
+		return (false);
+	}
+
+	// A single docx file, __size requirements
+	BenchCorpusGenerator::parameters_t params = BenchCorpusGenerator::defaultParameters();
+	params.nbDocx = 1;
+	params.nbOdt = 0;
+	params.nbPdf = 0;
+	params.nbTxt = 0;
+	params.nbReqsPerFile = __size;
+	params.nbDuplicates = 0;
+	params.nbCycles = 0;
+
+	BenchCorpusGenerator generator(params);
+	QString configFilePath;
+	if (!generator.generate(__workDir.path(), configFilePath, p_errMsg)) return (false);
+
+	BenchDocxProbe probe(getProbeConfiguration("MICRO", QDir(__workDir.path()).absoluteFilePath("DOC0.docx")));
+
+	// zip_read
+	QString text;
+	auto zipKernel = [&probe, &text]()
+	{
+		probe.readTextDataFromZippedFormat(&text);
+	};
+	BenchStats zipStats = __measure(std::function<void()>(), zipKernel);
+	if (text.isEmpty())
+	{
+		p_errMsg = "unable to read the generated docx file";
+		return (false);
+	}
+	p_results.insert("zip_read", __toJson(zipStats, text.toUtf8().size(), "byte"));
+
+	// xml_dom : same walk as RequirementFile_docx::_extractTextUnits
+	int nbDomParagraphs = 0;
+	auto domKernel = [&text, &nbDomParagraphs]()
+	{
+		QDomDocument doc;
+		doc.setContent(text, true);
+		nbDomParagraphs = 0;
+		QDomElement body = doc.documentElement().firstChildElement("body");
+		for (QDomElement elt = body.firstChildElement("p") ; !elt.isNull() ; elt = elt.nextSiblingElement("p"))
+		{
+			for (QDomNode n = elt.firstChild() ; !n.isNull() ; n = n.nextSibling())
+			{
+				if (n.isElement() && n.toElement().tagName() == "del") elt.removeChild(n);
+			}
+			QString data = elt.text();
+			if (!data.isEmpty()) nbDomParagraphs++;
+		}
+	};
+
+	// xml_stream : paragraphs are rebuilt from the character events, ignoring deleted text
+	int nbStreamParagraphs = 0;
+	auto streamKernel = [&text, &nbStreamParagraphs]()
+	{
+		QXmlStreamReader xr(text);
+		QString data;
+		bool inParagraph = false;
+		int delDepth = 0;
+		nbStreamParagraphs = 0;
+		while (!xr.atEnd())
+		{
+			switch (xr.readNext())
+			{
+				case QXmlStreamReader::StartElement:
+					if (xr.name() == QLatin1String("p"))
+					{
+						inParagraph = true;
+						data.clear();
+					}
+					else if (xr.name() == QLatin1String("del"))
+					{
+						delDepth++;
+					}
+					break;
+				case QXmlStreamReader::EndElement:
+					if (xr.name() == QLatin1String("p"))
+					{
+						inParagraph = false;
+						if (!data.isEmpty()) nbStreamParagraphs++;
+					}
+					else if (xr.name() == QLatin1String("del"))
+					{
+						delDepth--;
+					}
+					break;
+				case QXmlStreamReader::Characters:
+					if (inParagraph && delDepth == 0) data += xr.text();
+					break;
+				default:
+					break;
+			}
+		}
+	};
+
+	BenchStats domStats = __measure(std::function<void()>(), domKernel);
+	BenchStats streamStats = __measure(std::function<void()>(), streamKernel);
+	if (nbDomParagraphs != nbStreamParagraphs)
+	{
+		p_errMsg = QString("xml kernels disagree : %1 paragraphs with QDomDocument, %2 with QXmlStreamReader").arg(nbDomParagraphs).arg(nbStreamParagraphs);
+		return (false);
+	}
+	p_results.insert("xml_dom", __toJson(domStats, nbDomParagraphs, "paragraph"));
+	p_results.insert("xml_stream", __toJson(streamStats, nbStreamParagraphs, "paragraph"));
+
+	return (true);
+}
+
+bool BenchMicroKernels::__runGraphKernels(QJsonObject& p_results, QString& /*p_errMsg*/)
+{
+	BenchTxtProbe location(getProbeConfiguration("MICRO", ""));
+	Requirement cover("MICRO_COVER", Requirement::Defined, "MICRO");
+	QVector<Requirement> nodes;
+
+	// Deep graph : node i is composed of node i+1, the last one is covered
+	int deepSize = qMin(__size, MAX_DEEP_CHAIN);
+	auto buildDeep = [&nodes, &location, &cover, deepSize]()
+	{
+		nodes.clear();
+		nodes.reserve(deepSize);  // no reallocation, so pointers to the nodes stay valid
+		for (int i = 0 ; i < deepSize ; ++i)
+		{
+			nodes.append(Requirement(QString("DOC0_REQ%1").arg(i), Requirement::Defined, "MICRO"));
+			nodes[i].setLocation(&location);
+		}
+		for (int i = 0 ; i + 1 < deepSize ; ++i)
+		{
+			nodes[i].addComposingRequirement(&nodes[i + 1]);
+			nodes[i + 1].setParent(&nodes[i]);
+		}
+		nodes.last().setDownstreamRequirement(&cover);
+	};
+
+	// Wide graph : node 0 is composed of all the other nodes, half of them are covered
+	int wideSize = __size;
+	auto buildWide = [&nodes, &location, &cover, wideSize]()
+	{
+		nodes.clear();
+		nodes.reserve(wideSize + 1);
+		for (int i = 0 ; i <= wideSize ; ++i)
+		{
+			nodes.append(Requirement(QString("DOC0_REQ%1").arg(i), Requirement::Defined, "MICRO"));
+			nodes[i].setLocation(&location);
+		}
+		for (int i = 1 ; i <= wideSize ; ++i)
+		{
+			nodes[0].addComposingRequirement(&nodes[i]);
+			nodes[i].setParent(&nodes[0]);
+			if (i % 2 == 0) nodes[i].setDownstreamRequirement(&cover);
+		}
+	};
+
+	auto loopKernel = [&nodes]()
+	{
+		QString chain;
+		nodes[0].hasLoopInComposingReqs(chain);
+	};
+	auto consistency = [&nodes]()
+	{
+		nodes[0].computeConsistency();
+	};
+	auto coverageKernel = [&nodes]()
+	{
+		nodes[0].getCoverage();
+	};
+
+	buildDeep();
+	p_results.insert("cmp_loop_deep", __toJson(__measure(std::function<void()>(), loopKernel), deepSize, "node"));
+	p_results.insert("coverage_deep", __toJson(__measure([&]() { buildDeep(); consistency(); }, coverageKernel), deepSize, "node"));
+
+	buildWide();
+	p_results.insert("cmp_loop_wide", __toJson(__measure(std::function<void()>(), loopKernel), wideSize, "node"));
+	p_results.insert("coverage_wide", __toJson(__measure([&]() { buildWide(); consistency(); }, coverageKernel), wideSize, "node"));
+
+	nodes.clear();
+	ModelSngAnalysisErrors::instance().clear();
+
+	return (true);
+}
+
+bool BenchMicroKernels::__runMatrixContentionKernel(QJsonObject& p_results, QString& /*p_errMsg*/)
+{
+	int nbThreads = qMax(2, QThread::idealThreadCount());
+	int nbReqsPerThread = qMax(1, __size / nbThreads);
+
+	// One location per thread, as if each thread was parsing its own file
+	QVector<BenchTxtProbe*> locations;
+	for (int t = 0 ; t < nbThreads ; ++t)
+	{
+		locations.append(new BenchTxtProbe(getProbeConfiguration(QString("DOC%1").arg(t), "")));
+	}
+
+	auto setup = []()
+	{
+		ModelSngReqMatrix::instance().clear();
+		ModelSngAnalysisErrors::instance().clear();
+	};
+	auto kernel = [&locations, nbThreads, nbReqsPerThread]()
+	{
+		QThreadPool pool;
+		pool.setMaxThreadCount(nbThreads);
+		for (int t = 0 ; t < nbThreads ; ++t)
+		{
+			BenchTxtProbe* location = locations[t];
+			pool.start(new BenchFunctionTask([location, t, nbReqsPerThread]()
+			{
+				for (int i = 0 ; i < nbReqsPerThread ; ++i)
+				{
+					QString id = QString("DOC%1_REQ%2").arg(t).arg(i);
+					Requirement r(id, Requirement::Defined, location->getFileId());
+					r.setLocation(location);
+					int runId = ModelSngReqMatrix::instance().getRunId();
+					ModelSngReqMatrix::instance().addDefinedRequirement(location->getFileId(), r, runId);
+
+					Requirement c(QString("DOC%1_REQ%2").arg(t).arg(i + nbReqsPerThread), Requirement::Expected, id);
+					ModelSngReqMatrix::instance().addExpectedCompositeRequirement(location->getFileId(), id, c, runId);
+				}
+			}));
+		}
+		pool.waitForDone();
+	};
+
+	QJsonObject o = __toJson(__measure(setup, kernel), nbThreads * nbReqsPerThread, "requirement");
+	o.insert("threads", nbThreads);
+	p_results.insert("matrix_insert_contention", o);
+
+	// Release of the same matrix, the requirements of the run being released as a whole
+	auto fill = [&setup, &kernel]()
+	{
+		setup();
+		kernel();
+	};
+	p_results.insert("matrix_clear", __toJson(__measure(fill, setup), nbThreads * nbReqsPerThread, "requirement"));
+
+	setup();
+	qDeleteAll(locations);
+
+	return (true);
+}
+
+bool BenchMicroKernels::run(QJsonObject& p_results, QString& p_errMsg)
+{
+	QJsonObject kernels;
+
+	qDebug() << "BenchMicroKernels::run : regex";
+	if (!__runRegexKernel(kernels, p_errMsg)) return (false);
+
+	qDebug() << "BenchMicroKernels::run : zip & xml";
+	if (!__runZipAndXmlKernels(kernels, p_errMsg)) return (false);
+
+	qDebug() << "BenchMicroKernels::run : graphs";
+	if (!__runGraphKernels(kernels, p_errMsg)) return (false);
+
+	qDebug() << "BenchMicroKernels::run : matrix contention";
+	if (!__runMatrixContentionKernel(kernels, p_errMsg)) return (false);
+
+	p_results.insert("size", __size);
+	p_results.insert("warmups", __nbWarmups);
+	p_results.insert("repeats", __nbRepeats);
+	p_results.insert("kernels", kernels);
+
+	return (true);
+}
@@ -0,0 +1,112 @@
+/*!
+ * \file BenchStats.cpp
+ * \brief Implementation of the class BenchStats
+ * \date 2016-10-18
+ * \author f.souliers
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "BenchStats.h"
+
+static const double NS_PER_MS = 1000000.0;  //!< Conversion factor used for the json output
+
+BenchStats::BenchStats()
+{
+}
+
+BenchStats::~BenchStats()
+{
+}
+
+QVector<qint64> BenchStats::__getSortedSamples() const
+{
+	QVector<qint64> sorted(__samples);
+	std::sort(sorted.begin(), sorted.end());
+	return (sorted);
+}
+
+qint64 BenchStats::min() const
+{
+	if (__samples.isEmpty()) return (0);
+	return (*std::min_element(__samples.begin(), __samples.end()));
+}
+
+qint64 BenchStats::max() const
+{
+	if (__samples.isEmpty()) return (0);
+	return (*std::max_element(__samples.begin(), __samples.end()));
+}
+
+qint64 BenchStats::median() const
+{
+	if (__samples.isEmpty()) return (0);
+
+	QVector<qint64> sorted = __getSortedSamples();
+	int n = sorted.count();
+	if (n % 2 == 1)
+	{
+		return (sorted[n / 2]);
+	}
+	else
+	{
+		return ((sorted[n / 2 - 1] + sorted[n / 2]) / 2);
+	}
+}
+
+double BenchStats::mean() const
+{
+	if (__samples.isEmpty()) return (0.0);
+
+	double sum = 0.0;
+	foreach(qint64 s, __samples)
+	{
+		sum += s;
+	}
+	return (sum / __samples.count());
+}
+
+double BenchStats::stddev() const
+{
+	if (__samples.count() < 2) return (0.0);
+
+	double m = mean();
+	double sumSq = 0.0;
+	foreach(qint64 s, __samples)
+	{
+		sumSq += (s - m) * (s - m);
+	}
+	return (std::sqrt(sumSq / (__samples.count() - 1)));
+}
+
+qint64 BenchStats::percentile(double p_percent) const
+{
+	if (__samples.isEmpty()) return (0);
+
+	QVector<qint64> sorted = __getSortedSamples();
+	int rank = static_cast<int>(std::ceil(p_percent / 100.0 * sorted.count()));
+	rank = qBound(1, rank, sorted.count());
+	return (sorted[rank - 1]);
+}
+
+QJsonObject BenchStats::toJson() const
+{
+	QJsonObject o;
+	o.insert("samples", count());
+	o.insert("min_ms", min() / NS_PER_MS);
+	o.insert("median_ms", median() / NS_PER_MS);
+	o.insert("mean_ms", mean() / NS_PER_MS);
+	o.insert("stddev_ms", stddev() / NS_PER_MS);
+	o.insert("p95_ms", percentile(95.0) / NS_PER_MS);
+	o.insert("max_ms", max() / NS_PER_MS);
+
+	if (!__nbAllocations.isEmpty())
+	{
+		QVector<qint64> sorted(__nbAllocations);
+		std::sort(sorted.begin(), sorted.end());
+		o.insert("allocations", static_cast<double>(sorted[sorted.count() / 2]));
+	}
+
+	return (o);
+}
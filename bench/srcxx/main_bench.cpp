@@ -0,0 +1,201 @@
+/*!
+ * \file main_bench.cpp
+ * \brief start of the benchmark harness
+ * \date 2016-10-18
+ * \author f.souliers
+ *
+ * Commands:
+ * - generate : writes a synthetic corpus and its configuration file
+ * - run : measures the analysis of an existing configuration file
+ * - e2e : generate then run
+ * - micro : measures the hot kernels of the analysis in isolation
+ */
+
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+#include "BenchAnalysisRunner.h"
+#include "BenchCorpusGenerator.h"
+#include "BenchMicroKernels.h"
+
+#ifndef APP_VERSION
+#define APP_VERSION "UNEXPECTED APP VERSION"
+#endif
+
+static const QString CMD_GENERATE = "generate";  //!< Command generating a corpus
+static const QString CMD_RUN = "run";  //!< Command measuring the analysis of a configuration file
+static const QString CMD_E2E = "e2e";  //!< Command generating a corpus and measuring its analysis
+static const QString CMD_MICRO = "micro";  //!< Command measuring the kernels of the analysis
+
+/*!
+ * \brief Reads the parameters of the corpus from the command line, default values are used for missing options
+ */
+static BenchCorpusGenerator::parameters_t readCorpusParameters(const QCommandLineParser& p_parser)
+{
+	BenchCorpusGenerator::parameters_t p = BenchCorpusGenerator::defaultParameters();
+
+	if (p_parser.isSet("docx")) p.nbDocx = p_parser.value("docx").toInt();
+	if (p_parser.isSet("odt")) p.nbOdt = p_parser.value("odt").toInt();
+	if (p_parser.isSet("pdf")) p.nbPdf = p_parser.value("pdf").toInt();
+	if (p_parser.isSet("txt")) p.nbTxt = p_parser.value("txt").toInt();
+	if (p_parser.isSet("reqs")) p.nbReqsPerFile = p_parser.value("reqs").toInt();
+	if (p_parser.isSet("depth")) p.compositionDepth = p_parser.value("depth").toInt();
+	if (p_parser.isSet("coverage")) p.coverageRatio = p_parser.value("coverage").toDouble();
+	if (p_parser.isSet("duplicates")) p.nbDuplicates = p_parser.value("duplicates").toInt();
+	if (p_parser.isSet("cycles")) p.nbCycles = p_parser.value("cycles").toInt();
+	if (p_parser.isSet("filler")) p.nbFillerLines = p_parser.value("filler").toInt();
+	if (p_parser.isSet("seed")) p.seed = p_parser.value("seed").toUInt();
+
+	return (p);
+}
+
+/*!
+ * \brief Reads the list of thread counts ("1,2,4"), by default 1 up to the number of cores (powers of 2)
+ */
+static QVector<int> readThreadCounts(const QCommandLineParser& p_parser)
+{
+	QVector<int> threadCounts;
+	if (p_parser.isSet("threads"))
+	{
+		foreach(QString s, p_parser.value("threads").split(",", QString::SkipEmptyParts))
+		{
+			int n = s.trimmed().toInt();
+			if (n > 0) threadCounts.append(n);
+		}
+	}
+
+	if (threadCounts.isEmpty())
+	{
+		int maxThreads = qMax(1, QThread::idealThreadCount());
+		for (int n = 1 ; n < maxThreads ; n *= 2)
+		{
+			threadCounts.append(n);
+		}
+		threadCounts.append(maxThreads);
+	}
+
+	return (threadCounts);
+}
+
+/*!
+ * \brief Writes the json results into the file given by --json, or on stdout if not set
+ */
+static bool writeResults(const QCommandLineParser& p_parser, const QJsonObject& p_results)
+{
+	QByteArray json = QJsonDocument(p_results).toJson(QJsonDocument::Indented);
+
+	if (!p_parser.isSet("json"))
+	{
+		fprintf(stdout, "%s\n", json.constData());
+		return (true);
+	}
+
+	QFile f(p_parser.value("json"));
+	if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		fprintf(stderr, "unable to open %s\n", p_parser.value("json").toStdString().c_str());
+		return (false);
+	}
+	f.write(json);
+	f.close();
+
+	return (true);
+}
+
+int main(int argc, char *argv[])
+{
+	Q_INIT_RESOURCE(rekkix);  // Corresponding to rekkix.qrc (report templates)
+
+	QGuiApplication app(argc, argv);
+	app.setApplicationName("rekkix_bench");
+	app.setApplicationVersion(APP_VERSION);
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Rekkix benchmark harness");
+	parser.addHelpOption();
+	parser.addVersionOption();
+	parser.addPositionalArgument("command", QString("%1 | %2 | %3 | %4").arg(CMD_GENERATE).arg(CMD_RUN).arg(CMD_E2E).arg(CMD_MICRO));
+	parser.addOptions({
+		{ "out", "Directory of the generated corpus.", "dir", "./bench_corpus" },
+		{ "docx", "Number of docx documents.", "n" },
+		{ "odt", "Number of odt documents.", "n" },
+		{ "pdf", "Number of pdf documents.", "n" },
+		{ "txt", "Number of txt documents.", "n" },
+		{ "reqs", "Number of requirements per document.", "n" },
+		{ "depth", "Length of the chains of composite requirements.", "n" },
+		{ "coverage", "Probability for a requirement to be covered [0;1].", "ratio" },
+		{ "duplicates", "Number of requirements defined twice.", "n" },
+		{ "cycles", "Number of composition cycles.", "n" },
+		{ "filler", "Number of description lines per requirement.", "n" },
+		{ "seed", "Seed of the corpus generator.", "n" },
+		{ "config", "Configuration file to be analyzed (command run).", "file" },
+		{ "threads", "Comma separated numbers of parsing threads, eg 1,2,4.", "list" },
+		{ "warmup", "Number of runs not recorded before the measures.", "n", "1" },
+		{ "repeat", "Number of recorded runs (for each number of threads).", "n", "3" },
+		{ "size", "Size of the data sets of the micro benchmarks.", "n", "5000" },
+		{ "json", "Output file of the results (stdout if not set).", "file" }
+	});
+	parser.process(app);
+
+	QStringList args = parser.positionalArguments();
+	if (args.count() != 1 || (args[0] != CMD_GENERATE && args[0] != CMD_RUN && args[0] != CMD_E2E && args[0] != CMD_MICRO))
+	{
+		fprintf(stderr, "%s\n", parser.helpText().toStdString().c_str());
+		return (EXIT_FAILURE);
+	}
+	QString command = args[0];
+	int nbWarmups = qMax(0, parser.value("warmup").toInt());
+	int nbRepeats = qMax(1, parser.value("repeat").toInt());
+
+	QString errMsg;
+	QJsonObject results;
+
+	// Micro benchmarks do not depend on any configuration
+	if (command == CMD_MICRO)
+	{
+		BenchMicroKernels kernels(parser.value("size").toInt(), nbWarmups, nbRepeats);
+		if (!kernels.run(results, errMsg))
+		{
+			fprintf(stderr, "micro benchmark failed : %s\n", errMsg.toStdString().c_str());
+			return (EXIT_FAILURE);
+		}
+
+		return (writeResults(parser, results) ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	// Corpus generation
+	QString configFilePath = parser.value("config");
+	if (command == CMD_GENERATE || command == CMD_E2E)
+	{
+		BenchCorpusGenerator generator(readCorpusParameters(parser));
+		if (!generator.generate(parser.value("out"), configFilePath, errMsg))
+		{
+			fprintf(stderr, "corpus generation failed : %s\n", errMsg.toStdString().c_str());
+			return (EXIT_FAILURE);
+		}
+		fprintf(stderr, "corpus generated : %s\n", configFilePath.toStdString().c_str());
+
+		if (command == CMD_GENERATE) return (EXIT_SUCCESS);
+	}
+
+	// Measures
+	if (configFilePath.isEmpty())
+	{
+		fprintf(stderr, "--config is mandatory for the command %s\n", CMD_RUN.toStdString().c_str());
+		return (EXIT_FAILURE);
+	}
+
+	BenchAnalysisRunner runner(configFilePath);
+	if (!runner.run(readThreadCounts(parser), nbWarmups, nbRepeats, results, errMsg))
+	{
+		fprintf(stderr, "benchmark failed : %s\n", errMsg.toStdString().c_str());
+		return (EXIT_FAILURE);
+	}
+
+	return (writeResults(parser, results) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -17,6 +17,11 @@
  * The requirement analysis is performed just after the files are parsed (so every defined requirement is
  * known). During this phase, many errors can be detected (requirement used by another one and defined
  * nowhere, requirement defined several times, etc ...).
+ *
+ * An error is raised by the parsers and the matrix, often under a lock, and many of them are never displayed (see
+ * AnalysisErrorStore): it is then only a code and the arguments of its message, the message being translated and
+ * formatted only when it is displayed or written (see getDescription). The arguments are mostly the ids and paths
+ * already known by the caller, shared rather than copied.
  */
 class AnalysisError
 {
@@ -42,6 +47,44 @@ public:
 		CONTENT  //!< The content of a requirement is incorrect
 	} category_t;
 
+	/*!
+	 * \typedef code_t
+	 * \brief Kind of error, tells which message describes it and which arguments the message is built with
+	 */
+	typedef enum e_code
+	{
+		UNKNOWN,  //!< No description
+		FILE_OPEN_FAILED,  //!< A file cannot be opened (path)
+		PDF_NOT_ENOUGH_PAGES,  //!< A PDF file has less pages than the ones to skip (path, number of pages)
+		TREE_NO_FILE,  //!< A tree has no file (path of the tree)
+		DOCX_SET_CONTENT_FAILED,  //!< The XML of a DOCX file is invalid (line, column, message)
+		DOCX_NODE_NOT_FOUND,  //!< A node is missing from the XML of a DOCX file (node)
+		ODT_SET_CONTENT_FAILED,  //!< The XML of an ODT file is invalid (line, column, message)
+		ODT_NODE_NOT_FOUND,  //!< A node is missing from the XML of an ODT file (node)
+		ZIP_OPEN_FAILED,  //!< A zipped file cannot be opened (path, zip error)
+		ZIP_LOCATE_FAILED,  //!< The document is missing from a zipped file (name of the document)
+		ZIP_OPEN_INDEX_FAILED,  //!< The document of a zipped file cannot be opened
+		ZIP_READ_FAILED,  //!< The document of a zipped file cannot be read (cycles, zip error, message)
+		REQ_STATE_UNDEFINED,  //!< A parser gave a requirement without state
+		REQ_REDEFINED,  //!< A requirement is defined twice (requirement, location of the first definition)
+		COMPOSITION_OF_UNDEFINED,  //!< A requirement composes an undefined one (composing requirement, part of the document)
+		COVERAGE_OF_UNDEFINED,  //!< A requirement covers an undefined one (covered requirement, part of the document)
+		MULTIPLE_COVERAGE,  //!< A requirement is covered twice (covered requirement, first one, second one, part of the document)
+		DOWNSTREAM_NOT_CONFIGURED,  //!< Two documents are linked but the upstream one has no downstream
+		                            //!< document configured (number of links, upstream, downstream, example)
+		UPSTREAM_NOT_CONFIGURED,  //!< Two documents are linked but the downstream one has no upstream
+		                          //!< document configured (number of links, upstream, downstream, example)
+		STREAMS_NOT_CONFIGURED,  //!< Two documents are linked but none of them has the link configured
+		                         //!< (number of links, upstream, downstream, example)
+		REQ_EXPECTED_UNDEFINED,  //!< A requirement is expected but defined nowhere (requirement)
+		COVERAGE_LOOP,  //!< The coverage of a requirement loops (requirement, chain)
+		COMPOSITION_LOOP,  //!< The composition of a requirement loops (requirement, chain)
+		COMPOSED_OF_INVALID,  //!< A requirement is composed of invalid ones (requirement, invalid ones)
+		ERRORS_NOT_DETAILED  //!< Errors counted but not kept (number of errors, see AnalysisErrorStore)
+	} code_t;
+
+	static const int MAX_ARGUMENTS = 4;  //!< Number of arguments of the longest message (saved in AnalysisSnapshot)
+
 	/*!
 	 * \brief Constructor of an AnalysisError
 	 * \param[in] severity     The severity to be set at initialization, see AnalysisError::severity_t
@@ -49,7 +92,8 @@ public:
 	 * \param[in] location     The location where the error has been detected, by default it's nowhere in space.
 	 *                         Such location is the ID of the file where the error has been detected, see
 	 *                         ModelConfiguration::REQFILE_ATTR_ID
-	 * \param[in] description  The description of the error to be displayed on screen or printed in the reports
+	 * \param[in] code         The kind of error, see AnalysisError::code_t
+	 * \param[in] arg1 .. arg4  The arguments of the message of the code, in its order (see AnalysisError::code_t)
 	 *
 	 * Once the error has been created, there is no way to modify its attributes : it has to be instantiated with
 	 * the whole required information at one time.
@@ -60,7 +104,11 @@ public:
 	AnalysisError(const severity_t& severity = WARNING,
 	              const category_t& category = CONTENT,
 	              const QString& location = "",
-	              const QString& description = "");
+	              const code_t& code = UNKNOWN,
+	              const QString& arg1 = QString(),
+	              const QString& arg2 = QString(),
+	              const QString& arg3 = QString(),
+	              const QString& arg4 = QString());
 
 	/*!
 	 * \brief Destructor of an AnalysisError
@@ -108,20 +156,38 @@ public:
 	}
 
 	/*!
-	 * \brief getter for description of the error
-	 * \return The method returns a QString representing a description of the error. This description must be
-	 *         created as a translatable string with QObject::trUtf8.
+	 * \brief getter for code attribute
+	 * \return The method returns the code it has been created with
 	 */
-	QString getDescription() const
+	code_t getCode() const
 	{
-		return (__description);
+		return (__code);
 	}
 
+	/*!
+	 * \brief getter for an argument of the message
+	 * \param[in] p_index  index of the argument, from 0 to MAX_ARGUMENTS - 1
+	 * \return The method returns the argument, an empty string if the code has less arguments
+	 */
+	QString getArgument(int p_index) const
+	{
+		return (__args[p_index]);
+	}
+
+	/*!
+	 * \brief getter for description of the error
+	 * \return The method returns a QString representing a description of the error, the translated message of
+	 *         its code formatted with its arguments. It is built at each call: only call it to display or write
+	 *         the error.
+	 */
+	QString getDescription() const;
+
 private:
 	severity_t __severity;
 	category_t __category;
 	QString __location;
-	QString __description;
+	code_t __code;
+	QString __args[MAX_ARGUMENTS];
 };
 
 /*!
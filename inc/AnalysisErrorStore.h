@@ -0,0 +1,170 @@
+/*!
+ * \file AnalysisErrorStore.h
+ * \brief Definition of the class AnalysisErrorStore
+ * \date 2016-11-11
+ * \author f.souliers
+ */
+
+#ifndef ANALYSISERRORSTORE_H_
+#define ANALYSISERRORSTORE_H_
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "AnalysisError.h"
+
+/*!
+ * \class AnalysisErrorStore
+ * \brief Storage of the errors of an analysis, grouped by kind and location
+ *
+ * A misconfigured project easily raises the same error for every requirement (eg a wrong regular expression: every
+ * requirement is expected but defined nowhere). The errors of the same kind (severity, category and code) raised at the
+ * same location are then a group: every error is counted, but only the first ones of each group are kept as
+ * examples, so the display and the reports stay readable whatever the number of errors.
+ *
+ * The groups are indexed by location, severity and category, and the errors are counted the same way, so that
+ * filtering or counting never walks through all of them.
+ *
+ * The store is not protected against simultaneous accesses (see ModelSngAnalysisErrors).
+ */
+class AnalysisErrorStore
+{
+public:
+	static const int MAX_EXAMPLES_BY_GROUP;  //!< Number of errors kept for each group
+
+	/*!
+	 * \brief Errors of the same kind raised at the same location
+	 */
+	typedef struct
+	{
+		AnalysisError::severity_t severity;  //!< Severity of the errors of the group
+		AnalysisError::category_t category;  //!< Category of the errors of the group
+		AnalysisError::code_t code;  //!< Code of the errors of the group
+		QString location;  //!< Location of the errors of the group
+		int nbErrors;  //!< Number of errors of the group, the ones not kept included
+		QVector<AnalysisError> examples;  //!< First errors of the group, at most MAX_EXAMPLES_BY_GROUP
+	} group_t;
+
+	/*!
+	 * \brief Constructor of the class, the store is empty
+	 */
+	AnalysisErrorStore();
+
+	/*!
+	 * \brief Destructor of the class, does nothing special
+	 */
+	virtual ~AnalysisErrorStore();
+
+	/*!
+	 * \brief Adds an error to its group
+	 * \param[in] p_error  the error
+	 * \param[out] p_group  index of the group of the error in getGroups, if not NULL
+	 * \return true if the error is kept as an example of its group, false if it is only counted
+	 */
+	bool add(const AnalysisError& p_error, int* p_group = NULL);
+
+	/*!
+	 * \brief Forgets all the errors
+	 */
+	void clear();
+
+	/*!
+	 * \brief Getter for the groups
+	 * \return the groups, in the order of their first error
+	 */
+	const QVector<group_t>& getGroups() const
+	{
+		return (__groups);
+	}
+
+	/*!
+	 * \brief Getter for the groups of a location
+	 * \param[in] p_location  the location (see AnalysisError::getLocation)
+	 * \return the indexes of the groups in getGroups
+	 */
+	QVector<int> getGroupsOfLocation(const QString& p_location) const
+	{
+		return (__groupsByLocation.value(p_location));
+	}
+
+	/*!
+	 * \brief Getter for the groups of a severity
+	 * \param[in] p_severity  the severity
+	 * \return the indexes of the groups in getGroups
+	 */
+	const QVector<int>& getGroupsOfSeverity(AnalysisError::severity_t p_severity) const
+	{
+		return (__groupsBySeverity[p_severity]);
+	}
+
+	/*!
+	 * \brief Getter for the groups of a category
+	 * \param[in] p_category  the category
+	 * \return the indexes of the groups in getGroups
+	 */
+	const QVector<int>& getGroupsOfCategory(AnalysisError::category_t p_category) const
+	{
+		return (__groupsByCategory[p_category]);
+	}
+
+	/*!
+	 * \brief Getter for the number of errors
+	 * \return the number of errors added since the last clear, the ones not kept included
+	 */
+	int getNbErrors() const
+	{
+		return (__nbErrors);
+	}
+
+	/*!
+	 * \brief Getter for the number of errors of a location
+	 * \param[in] p_location  the location (see AnalysisError::getLocation)
+	 * \return the number of errors raised at this location, the ones not kept included
+	 */
+	int getNbErrorsOfLocation(const QString& p_location) const
+	{
+		return (__nbErrorsByLocation.value(p_location));
+	}
+
+	/*!
+	 * \brief Getter for the number of errors of a severity
+	 * \param[in] p_severity  the severity
+	 * \return the number of errors of this severity, the ones not kept included
+	 */
+	int getNbErrorsOfSeverity(AnalysisError::severity_t p_severity) const
+	{
+		return (__nbErrorsBySeverity[p_severity]);
+	}
+
+	/*!
+	 * \brief Getter for the number of errors of a category
+	 * \param[in] p_category  the category
+	 * \return the number of errors of this category, the ones not kept included
+	 */
+	int getNbErrorsOfCategory(AnalysisError::category_t p_category) const
+	{
+		return (__nbErrorsByCategory[p_category]);
+	}
+
+private:
+	static const int NB_SEVERITIES = AnalysisError::ERROR + 1;  //!< Number of values of AnalysisError::severity_t
+	static const int NB_CATEGORIES = AnalysisError::CONTENT + 1;  //!< Number of values of AnalysisError::category_t
+
+	/*!
+	 * \brief Key of the group of an error
+	 */
+	static QString __getGroupKey(const AnalysisError& p_error);
+
+	QVector<group_t> __groups;  //!< Groups, in the order of their first error
+	QHash<QString, int> __groupByKey;  //!< Index of the groups in __groups, by key (see __getGroupKey)
+	QHash<QString, QVector<int>> __groupsByLocation;  //!< Index of the groups in __groups, by location
+	QVector<int> __groupsBySeverity[NB_SEVERITIES];  //!< Index of the groups in __groups, by severity
+	QVector<int> __groupsByCategory[NB_CATEGORIES];  //!< Index of the groups in __groups, by category
+	int __nbErrors;  //!< Number of errors
+	QHash<QString, int> __nbErrorsByLocation;  //!< Number of errors by location
+	int __nbErrorsBySeverity[NB_SEVERITIES];  //!< Number of errors by severity
+	int __nbErrorsByCategory[NB_CATEGORIES];  //!< Number of errors by category
+};
+
+#endif /* ANALYSISERRORSTORE_H_ */
@@ -0,0 +1,145 @@
+/*!
+ * \file AnalysisImpactIndex.h
+ * \brief Definition of the class AnalysisImpactIndex
+ * \date 2016-10-28
+ * \author f.souliers
+ */
+
+#ifndef ANALYSISIMPACTINDEX_H_
+#define ANALYSISIMPACTINDEX_H_
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class AnalysisSnapshot;
+
+/*!
+ * \class AnalysisImpactIndex
+ * \brief Precomputed reachability between requirements, answering impact analysis queries without walking the links
+ *
+ * Changing a requirement impacts:
+ * - downstream: the requirement covering it and the requirements composing it, then transitively theirs
+ * - upstream: the requirements it covers and the requirements it is composing, then transitively theirs
+ *
+ * Each direction is a graph indexed once, when the snapshot is built:
+ * 1. the strongly connected components (cycles of links, which are analysis errors but may exist) are merged,
+ *    giving a DAG (Tarjan's algorithm, iterative so that long chains do not overflow the stack)
+ * 2. the components are numbered in post-order of a depth-first search of the DAG: the components reachable
+ *    through the spanning forest of a component form the interval of numbers ending at its own
+ * 3. the label of a component is the union of its own interval and of the labels of its successors, as a
+ *    sorted list of disjoint intervals
+ *
+ * As the traceability links are almost a forest (a requirement has one downstream requirement at most), the
+ * labels nearly always hold a single interval. The impacted requirements are then enumerated directly from
+ * the labels (the cost only depends on the size of the answer) and "is B impacted by A" is a binary search.
+ */
+class AnalysisImpactIndex
+{
+public:
+	/*!
+	 * \brief Directions in which the impacts are followed
+	 */
+	typedef enum
+	{
+		DOWNSTREAM = 0x1,  //!< Covering and composing requirements
+		UPSTREAM = 0x2,  //!< Covered and composite requirements
+		BOTH = DOWNSTREAM | UPSTREAM  //!< Union of the downstream and upstream impacts
+	} Direction;
+
+	/*!
+	 * \brief Constructor, the index is empty until built
+	 */
+	AnalysisImpactIndex();
+
+	/*!
+	 * \brief Destructor, does nothing special
+	 */
+	virtual ~AnalysisImpactIndex();
+
+	/*!
+	 * \brief Builds the index from the links of the requirements of a snapshot
+	 * \param[in] p_snapshot  the snapshot, with all its requirements added
+	 */
+	void build(const AnalysisSnapshot& p_snapshot);
+
+	/*!
+	 * \brief Getter for the requirements transitively impacted by the modification of a requirement
+	 * \param[in] p_id  id of the modified requirement
+	 * \param[in] p_direction  direction of the impacts
+	 * \return the ids of the impacted requirements, sorted, without p_id itself (empty if p_id is unknown)
+	 */
+	QStringList getImpactedRequirements(const QString& p_id, Direction p_direction) const;
+
+	/*!
+	 * \brief Tells whether a requirement is transitively impacted by the modification of another one
+	 * \param[in] p_modifiedId  id of the modified requirement
+	 * \param[in] p_id  id of the requirement that may be impacted
+	 * \param[in] p_direction  direction of the impacts
+	 * \return true if p_id is impacted (a requirement is never considered as impacted by itself)
+	 */
+	bool isImpacted(const QString& p_modifiedId, const QString& p_id, Direction p_direction) const;
+
+	/*!
+	 * \brief Converts a direction to its name, as used by the query server ("down", "up" or "all")
+	 * \param[in] p_direction  the direction
+	 * \return the name of the direction
+	 */
+	static QString directionToString(Direction p_direction);
+
+	/*!
+	 * \brief Converts a name to a direction
+	 * \param[in] p_name  "down", "up" or "all"
+	 * \param[out] p_ok  set to false if the name is unknown, true else
+	 * \return the direction, BOTH if the name is unknown
+	 */
+	static Direction stringToDirection(const QString& p_name, bool* p_ok = NULL);
+
+private:
+	/*!
+	 * \brief Reachability in one direction
+	 */
+	typedef struct
+	{
+		QVector<int> componentByNode;  //!< Strongly connected component of each requirement
+		QVector<int> nodeOffsetsByComponent;  //!< Requirements of component c are nodes[nodeOffsets[c] .. nodeOffsets[c+1][
+		QVector<int> nodes;  //!< Requirements, grouped by component
+		QVector<int> postByComponent;  //!< Post-order number of each component
+		QVector<int> componentByPost;  //!< Component of each post-order number
+		QVector<int> labelOffsetsByComponent;  //!< Intervals of component c are intervals[labelOffsets[c] .. labelOffsets[c+1][
+		QVector<int> intervals;  //!< Bounds of the intervals of post-order numbers (first, last, first, last ...)
+	} reachability_t;
+
+	/*!
+	 * \brief Builds the reachability of a graph
+	 * \param[in] p_offsets  successors of node n are p_successors[p_offsets[n] .. p_offsets[n+1][
+	 * \param[in] p_successors  successors of the nodes
+	 * \param[out] p_reach  the reachability
+	 */
+	static void __buildReachability(const QVector<int>& p_offsets, const QVector<int>& p_successors, reachability_t& p_reach);
+
+	/*!
+	 * \brief Appends the requirements reachable from a node
+	 * \param[in] p_reach  reachability of the direction
+	 * \param[in] p_node  the node
+	 * \param[in,out] p_nodes  the reachable nodes are appended to it, including p_node
+	 */
+	static void __appendReachableNodes(const reachability_t& p_reach, int p_node, QVector<int>& p_nodes);
+
+	/*!
+	 * \brief Tells whether a node is reachable from another one
+	 * \param[in] p_reach  reachability of the direction
+	 * \param[in] p_from  the starting node
+	 * \param[in] p_to  the node that may be reachable
+	 * \return true if p_to is reachable
+	 */
+	static bool __isReachable(const reachability_t& p_reach, int p_from, int p_to);
+
+	QStringList __ids;  //!< Ids of the requirements, sorted, the index of an id being its node number
+	QHash<QString, int> __nodeById;  //!< Node number of each id
+	reachability_t __downstream;  //!< Reachability of the downstream impacts
+	reachability_t __upstream;  //!< Reachability of the upstream impacts
+};
+
+#endif /* ANALYSISIMPACTINDEX_H_ */
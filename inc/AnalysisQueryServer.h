@@ -0,0 +1,160 @@
+/*!
+ * \file AnalysisQueryServer.h
+ * \brief Definition of the class AnalysisQueryServer
+ * \date 2016-10-26
+ * \author f.souliers
+ */
+
+#ifndef ANALYSISQUERYSERVER_H_
+#define ANALYSISQUERYSERVER_H_
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QMutex>
+#include <QObject>
+#include <QQueue>
+#include <QString>
+#include <QThreadPool>
+
+#include "AnalysisSnapshot.h"
+
+/*!
+ * \class AnalysisQueryServer
+ * \brief Local server answering traceability queries about the last analysis (used by rekkix --serve)
+ *
+ * The server listens on a local socket (Unix domain socket, or named pipe under Windows) and answers from the
+ * current AnalysisSnapshot. The protocol is line oriented: each request is one line of UTF-8 text, each answer
+ * is one line holding a compact JSON object whose "status" is "ok" or "error" (then with a "message").
+ * The requests are:
+ * - <i>req &lt;id&gt;</i> : the requirement (file, consistency, coverage and direct links)
+ * - <i>coveredby &lt;id&gt;</i> : the requirement covering &lt;id&gt; (its downstream requirement)
+ * - <i>covers &lt;id&gt;</i> : the requirements covered by &lt;id&gt; (its upstream requirements)
+ * - <i>impact &lt;id&gt; [down|up|all]</i> : the requirements transitively impacted by &lt;id&gt; (see AnalysisImpactIndex)
+ * - <i>search prefix|contains|regex &lt;text&gt;</i> : the ids of the requirements matching the text (see AnalysisSearchIndex)
+ * - <i>file &lt;id&gt;</i> : the file (coverage, numbers of requirements and errors, linked documents)
+ * - <i>files</i> : the ids of the files
+ * - <i>status</i> : the run, the date and the size of the snapshot
+ *
+ * A request only takes lookups in the snapshot and its indexes. The snapshot is never modified, so answering only needs
+ * to hold the shared pointer to it: a new analysis replaces the snapshot (see setSnapshot) without waiting
+ * for the clients, which finish their request with the previous one. The server is meant to live in its own
+ * thread so that the queries are not delayed by the analysis running in the main one.
+ *
+ * The sockets are only read and written by the thread of the server, the requests are answered by a small pool of
+ * threads (a regular expression search may be long): the requests of a client are answered one after the other, in
+ * the order they have been received, and a client sending too many requests is not read until they are answered.
+ */
+class AnalysisQueryServer : public QObject
+{
+	Q_OBJECT
+
+public:
+	/*!
+	 * \brief Name of the server when none is given on the command line
+	 */
+	static const QString DEFAULT_SERVER_NAME;
+
+	/*!
+	 * \brief Constructor, the server does not listen until listen is called
+	 * \param[in] p_parent  parent of the object (Qt ownership)
+	 */
+	AnalysisQueryServer(QObject* p_parent = Q_NULLPTR);
+
+	/*!
+	 * \brief Destructor, waits for the requests being answered (the connections are children of the server)
+	 */
+	virtual ~AnalysisQueryServer();
+
+	/*!
+	 * \brief Replaces the snapshot the queries are answered from, thread-safe
+	 * \param[in] p  the new snapshot
+	 */
+	void setSnapshot(AnalysisSnapshotPtr p);
+
+	/*!
+	 * \brief Getter for the current snapshot, thread-safe
+	 * \return the snapshot, may be null if no analysis has been published yet
+	 */
+	AnalysisSnapshotPtr getSnapshot() const;
+
+	/*!
+	 * \brief Answers one request, thread-safe
+	 * \param[in] p_request  the request, without its end of line
+	 * \return the answer, without its end of line
+	 */
+	QByteArray answer(const QByteArray& p_request) const;
+
+public slots:
+	/*!
+	 * \brief Starts listening, an existing socket with the same name (eg left by a crash) is removed first
+	 * \param[in] p_serverName  name of the local socket
+	 * \return
+	 * - true if the server is listening
+	 * - false else (the reason is displayed with qDebug)
+	 */
+	bool listen(const QString& p_serverName);
+
+	/*!
+	 * \brief Stops listening and closes the connections
+	 */
+	void close();
+
+private slots:
+	/*!
+	 * \brief Called by QLocalServer for each new client
+	 */
+	void slt_newConnection();
+
+	/*!
+	 * \brief Called by __queryPool once a request has been answered, sends the answer and answers the next request
+	 * \param[in] p_clientId  client of the request, nothing is sent if it has disconnected meanwhile
+	 * \param[in] p_answer  the answer, without its end of line
+	 */
+	void slt_answered(int p_clientId, const QByteArray& p_answer);
+
+private:
+	/*!
+	 * \brief Connection of a client and its requests not answered yet (thread of the server only)
+	 */
+	typedef struct
+	{
+		QLocalSocket* socket;  //!< Connection of the client
+		QQueue<QByteArray> requests;  //!< Requests received and not answered yet, an empty one stands for a line too long
+		bool isAnswering;  //!< Is a request of the client being answered by __queryPool
+	} client_t;
+
+	/*!
+	 * \brief Queues the complete requests received from a client, then answers the first one
+	 *
+	 * A line longer than the maximum length of a request is answered by an error as soon as the maximum is
+	 * exceeded, then dropped up to its end of line: the client stays connected. The socket is not read anymore
+	 * while too many requests of the client are waiting for their answer.
+	 * \param[in] p_clientId  the client
+	 */
+	void __readRequests(int p_clientId);
+
+	/*!
+	 * \brief Starts answering the first request waiting of a client, unless one of its requests is being answered
+	 * \param[in] p_clientId  the client
+	 */
+	void __answerNext(int p_clientId);
+
+	/*!
+	 * \brief Builds an error answer
+	 * \param[in] p_message  reason of the error
+	 * \return the answer
+	 */
+	static QJsonObject __error(const QString& p_message);
+
+	QLocalServer* __server;  //!< Server, child of this object so that it moves to the same thread
+	QThreadPool __queryPool;  //!< Threads answering the requests, so that a long one does not delay the other clients
+	QHash<int, client_t> __clients;  //!< Connected clients, by id (thread of the server only)
+	int __nextClientId;  //!< Id of the next client
+	mutable QMutex __snapshotMutex;  //!< Protects the pointer to the snapshot, not the snapshot itself
+	AnalysisSnapshotPtr __snapshot;  //!< Snapshot the queries are answered from
+};
+
+#endif /* ANALYSISQUERYSERVER_H_ */
@@ -0,0 +1,126 @@
+/*!
+ * \file AnalysisSearchIndex.h
+ * \brief Definition of the class AnalysisSearchIndex
+ * \date 2016-10-31
+ * \author f.souliers
+ */
+
+#ifndef ANALYSISSEARCHINDEX_H_
+#define ANALYSISSEARCHINDEX_H_
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*!
+ * \class AnalysisSearchIndex
+ * \brief Index of the requirement ids, searching them by prefix, substring or regular expression (case insensitive)
+ *
+ * The ids are stored once, sorted by their case folded form, and designated by their position in this array:
+ * - a prefix search is a binary search followed by the ids sharing the prefix
+ * - a substring search intersects the lists of the ids containing each trigram of the searched text (the
+ *   lists are sorted, so the intersection is a merge), then checks the few remaining candidates. A text
+ *   shorter than a trigram is searched by scanning the ids, which stops as soon as enough are found
+ * - a regular expression search uses the trigrams of its longest literal part when there is one, and checks
+ *   the candidates with the expression
+ *
+ * The trigram lists are built by several threads, each one taking a slice of the sorted ids: concatenating the
+ * lists of the slices in order keeps them sorted.
+ */
+class AnalysisSearchIndex
+{
+public:
+	/*!
+	 * \brief Kinds of search
+	 */
+	typedef enum
+	{
+		PREFIX,  //!< Ids starting with the text
+		SUBSTRING,  //!< Ids containing the text
+		REGEX  //!< Ids matching the regular expression (anywhere in the id unless anchored)
+	} Mode;
+
+	/*!
+	 * \brief Constructor, the index is empty until built
+	 */
+	AnalysisSearchIndex();
+
+	/*!
+	 * \brief Destructor, does nothing special
+	 */
+	virtual ~AnalysisSearchIndex();
+
+	/*!
+	 * \brief Builds the index
+	 * \param[in] p_ids  ids of the requirements, in any order
+	 */
+	void build(const QStringList& p_ids);
+
+	/*!
+	 * \brief Searches requirement ids
+	 * \param[in] p_text  searched text or regular expression
+	 * \param[in] p_mode  kind of search
+	 * \param[in] p_maxResults  maximum number of ids returned
+	 * \param[out] p_isTruncated  set to true if more ids match than returned, may be NULL
+	 * \return the matching ids, sorted (case insensitive), empty if p_text is empty or is an invalid expression
+	 */
+	QStringList search(const QString& p_text, Mode p_mode, int p_maxResults, bool* p_isTruncated = NULL) const;
+
+	/*!
+	 * \brief Getter for the number of indexed ids
+	 * \return the number of ids
+	 */
+	int getNbIds() const
+	{
+		return (__ids.count());
+	}
+
+	/*!
+	 * \brief Converts a name to a kind of search, as used by the query server
+	 * \param[in] p_name  "prefix", "contains" or "regex"
+	 * \param[out] p_ok  set to false if the name is unknown, true else
+	 * \return the kind of search, SUBSTRING if the name is unknown
+	 */
+	static Mode stringToMode(const QString& p_name, bool* p_ok = NULL);
+
+private:
+	/*!
+	 * \brief Key of a trigram: the 3 UTF-16 code units of the case folded text
+	 * \param[in] p_text  the text
+	 * \param[in] p_pos  position of the trigram in the text
+	 * \return the key
+	 */
+	static quint64 __trigramKey(const QString& p_text, int p_pos)
+	{
+		return ((quint64(p_text[p_pos].unicode()) << 32) | (quint64(p_text[p_pos + 1].unicode()) << 16) | quint64(p_text[p_pos + 2].unicode()));
+	}
+
+	/*!
+	 * \brief Candidates containing all the trigrams of a case folded text (at least 3 characters long)
+	 * \param[in] p_foldedText  the text
+	 * \return the positions of the candidates, sorted
+	 */
+	QVector<int> __candidates(const QString& p_foldedText) const;
+
+	/*!
+	 * \brief Longest part of a regular expression that must be found as is in any matching text
+	 * \param[in] p_pattern  the regular expression
+	 * \return the literal part, case folded, empty if there is none (eg alternatives)
+	 */
+	static QString __longestLiteral(const QString& p_pattern);
+
+	/*!
+	 * \brief Skips an escape that is not a literal (class, assertion, back reference, character code)
+	 * \param[in] p_pattern  the regular expression
+	 * \param[in] p_index  index of the escaped character, following the backslash
+	 * \return the index of the last character of the escape, its operand included
+	 */
+	static int __skipEscape(const QString& p_pattern, int p_index);
+
+	QStringList __ids;  //!< Ids, sorted by their case folded form
+	QStringList __foldedIds;  //!< Case folded ids, sorted
+	QHash<quint64, QVector<int> > __positionsByTrigram;  //!< Positions (in __ids) of the ids containing each trigram, sorted
+};
+
+#endif /* ANALYSISSEARCHINDEX_H_ */
@@ -0,0 +1,241 @@
+/*!
+ * \file AnalysisSnapshot.h
+ * \brief Definition of the class AnalysisSnapshot
+ * \date 2016-10-26
+ * \author f.souliers
+ */
+
+#ifndef ANALYSISSNAPSHOT_H_
+#define ANALYSISSNAPSHOT_H_
+
+#include <QDateTime>
+#include <QHash>
+#include <QMap>
+#include <QMetaType>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "AnalysisError.h"
+#include "AnalysisImpactIndex.h"
+#include "AnalysisSearchIndex.h"
+
+class AnalysisSnapshot;
+
+/*!
+ * \typedef AnalysisSnapshotPtr
+ * \brief Shared pointer to a snapshot, which cannot be modified anymore
+ */
+typedef QSharedPointer<const AnalysisSnapshot> AnalysisSnapshotPtr;
+
+/*!
+ * \class AnalysisSnapshot
+ * \brief Copy of the results of an analysis that can be read by any thread (see AnalysisQueryServer)
+ *
+ * The requirements of ModelSngReqMatrix point to each other and are modified by the next analysis: they cannot
+ * be read outside of the main thread. A snapshot only contains values (ids instead of pointers), it is built
+ * once at the end of an analysis (see ModelSngReqMatrix::createSnapshot) and never modified afterwards: it is
+ * shared as a pointer to a const object, and replaced as a whole by the snapshot of the next analysis.
+ *
+ * A snapshot can be saved to a file (writer <i>snapshot</i> of the <i>outputs</i> section) and loaded back,
+ * eg to be compared with a baseline (see AnalysisSnapshotDiff). The file holds a compressed QDataStream
+ * starting with a magic number and a format version.
+ */
+class AnalysisSnapshot
+{
+public:
+	/*!
+	 * \brief Requirement as known at the end of the analysis
+	 */
+	typedef struct
+	{
+		QString id;  //!< Id of the requirement
+		QString fileId;  //!< File defining the requirement, empty if it is only expected
+		QString expectedBy;  //!< Location quoting the requirement (see Requirement::getExpectedBy)
+		bool isConsistent;  //!< See Requirement::isConsistent
+		bool mustBeCovered;  //!< See Requirement::mustBeCovered
+		double coverage;  //!< Coverage, Requirement::COVERAGE_INVALID_VALUE if inconsistent
+		QString downstreamId;  //!< Requirement covering this one, empty if not covered
+		QStringList upstreamIds;  //!< Requirements covered by this one
+		QStringList composingIds;  //!< Requirements composing this one
+		QStringList compositeIds;  //!< Requirements composed of this one
+	} requirement_t;
+
+	/*!
+	 * \brief Requirement file as known at the end of the analysis
+	 */
+	typedef struct
+	{
+		QString id;  //!< Id of the file
+		QString path;  //!< Path of the file
+		int nbRequirements;  //!< Number of requirements defined in the file
+		int nbErrors;  //!< Number of analysis errors located in the file
+		bool mustHaveDownstreamDocuments;  //!< See RequirementFileAbstract::mustHaveDownstreamDocuments
+		double coverage;  //!< Average coverage, Requirement::COVERAGE_INVALID_VALUE if a requirement is inconsistent
+		QStringList upstreamDocuments;  //!< Ids of the upstream documents
+		QStringList downstreamDocuments;  //!< Ids of the downstream documents
+	} file_t;
+
+	/*!
+	 * \brief Constructor, the snapshot is empty until the requirements and files are added
+	 * \param[in] p_runId  analysis run the snapshot is built from (see ModelSngReqMatrix::getRunId)
+	 */
+	AnalysisSnapshot(int p_runId);
+
+	/*!
+	 * \brief Destructor, does nothing special
+	 */
+	virtual ~AnalysisSnapshot();
+
+	/*!
+	 * \brief Adds a requirement, only while the snapshot is being built
+	 * \param[in] p_req  the requirement
+	 */
+	void addRequirement(const requirement_t& p_req);
+
+	/*!
+	 * \brief Adds a file, only while the snapshot is being built
+	 * \param[in] p_file  the file
+	 */
+	void addFile(const file_t& p_file);
+
+	/*!
+	 * \brief Adds the errors of the analysis, only while the snapshot is being built
+	 * \param[in] p_errors  the errors
+	 */
+	void addErrors(const QVector<AnalysisError>& p_errors)
+	{
+		__errors += p_errors;
+	}
+
+	/*!
+	 * \brief Getter for the errors of the analysis
+	 * \return the errors, in the order they have been found
+	 */
+	const QVector<AnalysisError>& getErrors() const
+	{
+		return (__errors);
+	}
+
+	/*!
+	 * \brief Saves the snapshot (without its indexes, which are built again when needed)
+	 * \param[in] p_path  path of the file, overwritten if it exists
+	 * \return
+	 * - true if the file has been written
+	 * - false if it could not be opened
+	 */
+	bool save(const QString& p_path) const;
+
+	/*!
+	 * \brief Loads a snapshot saved by save
+	 * \param[in] p_path  path of the file
+	 * \param[out] p_errMsg  reason of the failure, if any
+	 * \return the snapshot (without its indexes), null if the file cannot be read or has an unknown format
+	 */
+	static AnalysisSnapshotPtr load(const QString& p_path, QString& p_errMsg);
+
+	/*!
+	 * \brief Getter for a requirement
+	 * \param[in] p_id  id of the requirement
+	 * \return the requirement, NULL if unknown
+	 */
+	const requirement_t* getRequirement(const QString& p_id) const;
+
+	/*!
+	 * \brief Getter for the ids of the requirements
+	 * \return the ids, sorted
+	 */
+	QStringList getRequirementIds() const;
+
+	/*!
+	 * \brief Builds the impact index, once all the requirements have been added
+	 */
+	void buildImpactIndex()
+	{
+		__impactIndex.build(*this);
+	}
+
+	/*!
+	 * \brief Getter for the impact index
+	 * \return the index, empty if buildImpactIndex has not been called
+	 */
+	const AnalysisImpactIndex& getImpactIndex() const
+	{
+		return (__impactIndex);
+	}
+
+	/*!
+	 * \brief Builds the index searching the ids of the requirements, once all of them have been added
+	 */
+	void buildSearchIndex()
+	{
+		__searchIndex.build(__reqsById.keys());
+	}
+
+	/*!
+	 * \brief Getter for the search index
+	 * \return the index, empty if buildSearchIndex has not been called
+	 */
+	const AnalysisSearchIndex& getSearchIndex() const
+	{
+		return (__searchIndex);
+	}
+
+	/*!
+	 * \brief Getter for a file
+	 * \param[in] p_id  id of the file
+	 * \return the file, NULL if unknown
+	 */
+	const file_t* getFile(const QString& p_id) const;
+
+	/*!
+	 * \brief Getter for the ids of the files
+	 * \return the ids, sorted
+	 */
+	QStringList getFileIds() const
+	{
+		return (__filesById.keys());
+	}
+
+	/*!
+	 * \brief Getter for the number of requirements
+	 * \return the number of requirements (defined or expected)
+	 */
+	int getNbRequirements() const
+	{
+		return (__reqsById.count());
+	}
+
+	/*!
+	 * \brief Getter for the analysis run the snapshot is built from
+	 * \return the identifier of the run
+	 */
+	int getRunId() const
+	{
+		return (__runId);
+	}
+
+	/*!
+	 * \brief Getter for the date of the snapshot
+	 * \return the date the snapshot has been created
+	 */
+	QDateTime getCreationDate() const
+	{
+		return (__creationDate);
+	}
+
+private:
+	int __runId;  //!< Analysis run the snapshot is built from
+	QDateTime __creationDate;  //!< Date of the creation of the snapshot
+	QHash<QString, requirement_t> __reqsById;  //!< Requirements, by id
+	QMap<QString, file_t> __filesById;  //!< Files, by id
+	AnalysisImpactIndex __impactIndex;  //!< Transitive impacts between the requirements
+	AnalysisSearchIndex __searchIndex;  //!< Search of the ids of the requirements
+	QVector<AnalysisError> __errors;  //!< Errors of the analysis
+};
+
+// A snapshot built by a worker thread is handed over to the main thread by a queued call
+Q_DECLARE_METATYPE(AnalysisSnapshotPtr)
+
+#endif /* ANALYSISSNAPSHOT_H_ */
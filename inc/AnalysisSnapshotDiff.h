@@ -0,0 +1,154 @@
+/*!
+ * \file AnalysisSnapshotDiff.h
+ * \brief Definition of the class AnalysisSnapshotDiff
+ * \date 2016-11-02
+ * \author f.souliers
+ */
+
+#ifndef ANALYSISSNAPSHOTDIFF_H_
+#define ANALYSISSNAPSHOTDIFF_H_
+
+#include <QDateTime>
+#include <QString>
+#include <QVector>
+
+#include "AnalysisSnapshot.h"
+
+/*!
+ * \class AnalysisSnapshotDiff
+ * \brief Changes between two analyses (typically a saved baseline and the current analysis, see rekkix --diff)
+ *
+ * The requirements, the files and the errors of both snapshots are taken in the order of their ids and
+ * compared by a single merge of the two sorted sequences: once sorted, the comparison is linear in the number
+ * of items, whatever the number of changes.
+ */
+class AnalysisSnapshotDiff
+{
+public:
+	/*!
+	 * \brief Kinds of change, in the order they are reported
+	 */
+	typedef enum
+	{
+		REQ_ADDED,  //!< Requirement unknown by the baseline
+		REQ_REMOVED,  //!< Requirement unknown by the current analysis
+		REQ_FILE_CHANGED,  //!< Requirement defined in another file (or not defined anymore, or defined at last)
+		REQ_COVERAGE_DROPPED,  //!< Coverage of the requirement decreased or became invalid
+		REQ_COVERAGE_RAISED,  //!< Coverage of the requirement increased or became valid
+		REQ_LINKS_CHANGED,  //!< Covering, covered, composing or composite requirements changed
+		FILE_ADDED,  //!< File unknown by the baseline
+		FILE_REMOVED,  //!< File unknown by the current analysis
+		FILE_COVERAGE_DROPPED,  //!< Coverage of the file decreased or became invalid
+		FILE_COVERAGE_RAISED,  //!< Coverage of the file increased or became valid
+		ERROR_ADDED,  //!< Error not found by the baseline
+		ERROR_REMOVED,  //!< Error not found anymore
+		NB_CHANGE_KINDS  //!< Number of kinds, not a kind
+	} ChangeKind;
+
+	/*!
+	 * \brief One change
+	 */
+	typedef struct
+	{
+		ChangeKind kind;  //!< Kind of change
+		QString item;  //!< Id of the requirement or the file, severity and category of an error
+		QString location;  //!< File of the requirement or the error
+		QString before;  //!< Value in the baseline, empty if added
+		QString after;  //!< Value in the current analysis, empty if removed
+	} change_t;
+
+	/*!
+	 * \brief Constructor, there is no change until compute is called
+	 */
+	AnalysisSnapshotDiff();
+
+	/*!
+	 * \brief Destructor, does nothing special
+	 */
+	virtual ~AnalysisSnapshotDiff();
+
+	/*!
+	 * \brief Computes the changes between two analyses, replacing the previous ones
+	 * \param[in] p_baseline  the reference analysis
+	 * \param[in] p_current  the analysis compared to the reference
+	 */
+	void compute(const AnalysisSnapshot& p_baseline, const AnalysisSnapshot& p_current);
+
+	/*!
+	 * \brief Getter for the changes
+	 * \return the changes, by kind then in the order of their items
+	 */
+	const QVector<change_t>& getChanges() const
+	{
+		return (__changes);
+	}
+
+	/*!
+	 * \brief Getter for the number of changes of a kind
+	 * \param[in] p_kind  the kind of change
+	 * \return the number of changes
+	 */
+	int getNbChanges(ChangeKind p_kind) const
+	{
+		return (__nbChangesByKind[p_kind]);
+	}
+
+	/*!
+	 * \brief Getter for the date of the baseline
+	 * \return the date of the baseline analysis
+	 */
+	QDateTime getBaselineDate() const
+	{
+		return (__baselineDate);
+	}
+
+	/*!
+	 * \brief Getter for the date of the current analysis
+	 * \return the date of the compared analysis
+	 */
+	QDateTime getCurrentDate() const
+	{
+		return (__currentDate);
+	}
+
+	/*!
+	 * \brief Converts a kind of change to a text, as displayed in the reports
+	 * \param[in] p_kind  the kind of change
+	 * \return the translated text
+	 */
+	static QString kindToString(ChangeKind p_kind);
+
+	/*!
+	 * \brief Summary of the numbers of changes by kind, as displayed in the reports and on the console
+	 * \return the translated text, one line by kind of change found
+	 */
+	QStringList getSummary() const;
+
+private:
+	/*!
+	 * \brief Compares the requirements
+	 */
+	void __compareRequirements(const AnalysisSnapshot& p_baseline, const AnalysisSnapshot& p_current);
+
+	/*!
+	 * \brief Compares the files
+	 */
+	void __compareFiles(const AnalysisSnapshot& p_baseline, const AnalysisSnapshot& p_current);
+
+	/*!
+	 * \brief Compares the errors
+	 */
+	void __compareErrors(const AnalysisSnapshot& p_baseline, const AnalysisSnapshot& p_current);
+
+	/*!
+	 * \brief Records a change
+	 */
+	void __addChange(ChangeKind p_kind, const QString& p_item, const QString& p_location, const QString& p_before, const QString& p_after);
+
+	QVector<change_t> __changes;  //!< Changes found
+	QVector<int> __nbChangesByKind;  //!< Number of changes of each kind
+	QDateTime __baselineDate;  //!< Date of the baseline analysis
+	QDateTime __currentDate;  //!< Date of the compared analysis
+};
+
+#endif /* ANALYSISSNAPSHOTDIFF_H_ */
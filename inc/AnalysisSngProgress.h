@@ -0,0 +1,104 @@
+/*!
+ * \file AnalysisSngProgress.h
+ * \brief Definition of the class AnalysisSngProgress
+ * \date 2016-10-21
+ * \author f.souliers
+ */
+
+#ifndef ANALYSISSNGPROGRESS_H_
+#define ANALYSISSNGPROGRESS_H_
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QString>
+
+/*!
+ * \class AnalysisSngProgress
+ * \brief Singleton aggregating the progress of the parsing threads, weighted by the size of the files
+ *
+ * Each file weighs its size in bytes. The parsers report the part of their file they have processed (see
+ * RequirementFileAbstract::_reportProgress), which is converted into bytes and added here with a simple
+ * atomic operation: no lock is taken by the parsing threads.
+ *
+ * The GUI (or the batch mode) polls this object at its own pace (see Rekkix::slt_refreshProgress) so the
+ * number of updates does not depend on the number of files or lines parsed.
+ */
+class AnalysisSngProgress
+{
+public:
+	/*!
+	 * \brief Snapshot of the progress
+	 */
+	typedef struct
+	{
+		qint64 processedBytes;  //!< Bytes processed so far
+		qint64 totalBytes;  //!< Bytes to be processed by the whole analysis
+		double ratio;  //!< processedBytes / totalBytes, in [0 ; 1]
+		double bytesPerSecond;  //!< Average throughput since the beginning of the analysis
+		double remainingSeconds;  //!< Estimated remaining time, negative if it cannot be estimated yet
+	} progress_t;
+
+	/*!
+	 * \brief Instance getter for the singleton object
+	 * \return The reference of the instance
+	 */
+	static AnalysisSngProgress& instance()
+	{
+		static AnalysisSngProgress r;
+		return (r);
+	}
+
+	/*!
+	 * \brief Destructor, does nothing special
+	 */
+	virtual ~AnalysisSngProgress();
+
+	/*!
+	 * \brief Resets the counters at the beginning of an analysis
+	 * \param[in] p_totalBytes  sum of the sizes of the files to be parsed
+	 */
+	void start(qint64 p_totalBytes);
+
+	/*!
+	 * \brief Adds processed bytes, thread-safe and lock-free
+	 * \param[in] p_bytes  number of bytes processed since the last call for the calling file
+	 */
+	void addProcessedBytes(qint64 p_bytes)
+	{
+		__processedBytes.fetchAndAddRelaxed(p_bytes);
+	}
+
+	/*!
+	 * \brief Corrects the bytes to be processed, thread-safe and lock-free
+	 * \param[in] p_bytes  difference between the size of a file known once parsed and the one given to start
+	 */
+	void addTotalBytes(qint64 p_bytes)
+	{
+		__totalBytes.fetchAndAddRelaxed(p_bytes);
+	}
+
+	/*!
+	 * \brief Computes the current progress, throughput and estimated remaining time
+	 * \return the snapshot of the progress
+	 */
+	progress_t getProgress() const;
+
+	/*!
+	 * \brief Human readable form of the throughput and of the remaining time (eg "2.4 Mo/s, reste 12 s")
+	 * \param[in] p  snapshot of the progress
+	 * \return the string to be displayed
+	 */
+	static QString toString(const progress_t& p);
+
+private:
+	/*!
+	 * \brief Constructor, does nothing special
+	 */
+	AnalysisSngProgress();
+
+	QAtomicInteger<qint64> __processedBytes;  //!< Bytes processed, updated by the parsing threads
+	QAtomicInteger<qint64> __totalBytes;  //!< Bytes to be processed
+	QElapsedTimer __elapsed;  //!< Time elapsed since the beginning of the analysis
+};
+
+#endif /* ANALYSISSNGPROGRESS_H_ */
@@ -0,0 +1,171 @@
+/*!
+ * \file AnalysisSngScheduler.h
+ * \brief Definition of the class AnalysisSngScheduler
+ * \date 2016-11-07
+ * \author f.souliers
+ */
+
+#ifndef ANALYSISSNGSCHEDULER_H_
+#define ANALYSISSNGSCHEDULER_H_
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include "RequirementFileAbstract.h"
+
+/*!
+ * \class AnalysisSngScheduler
+ * \brief Singleton ordering the parsing of the files by decreasing estimated cost, and comparing the estimations with
+ *        the actual durations
+ *
+ * The parsing threads are started one after the other as soon as a slot is free (see AnalysisSngStarterThread):
+ * starting the longest files first (LPT, longest processing time first) keeps a long file from being started when
+ * all the others are done, the duration of the analysis then being close to the duration of its longest file
+ * instead of the sum of the last ones.
+ *
+ * The cost of a file is estimated from:
+ * - the duration of its previous parsing, scaled by the evolution of its size, when it is known
+ * - else its size and its format, each format having its own cost by byte, learnt from the previous analyses
+ *
+ * The durations of the previous analyses are kept on disk from one run to another (in the cache location of the
+ * user, it can be deleted at any time). Each run compares the predicted and actual durations of its files and of
+ * the whole parsing (see getSummary and getJobsTable).
+ */
+class AnalysisSngScheduler
+{
+public:
+	/*!
+	 * \brief One parsing of the current run
+	 */
+	typedef struct
+	{
+		QString fileId;  //!< Id of the file
+		QString documentKey;  //!< Key of the document in the history (see AnalysisSngTextCache::getDocumentKey)
+		QString format;  //!< Format of the text units of the file (see RequirementFileAbstract::getTextUnitsFormat)
+		qint64 sizeBytes;  //!< Size of the file
+		qint64 predictedUs;  //!< Estimated duration of the parsing
+		qint64 actualUs;  //!< Measured duration of the parsing, -1 while the file is not parsed
+		bool isTextExtracted;  //!< Has the text been extracted, rather than read from AnalysisSngTextCache ?
+		bool isFromHistory;  //!< Is the estimation based on a previous parsing of the file ?
+	} job_t;
+
+	/*!
+	 * \brief Instance getter for the singleton object
+	 * \return The reference of the instance
+	 */
+	static AnalysisSngScheduler& instance()
+	{
+		static AnalysisSngScheduler r;
+		return (r);
+	}
+
+	/*!
+	 * \brief Destructor, does nothing special
+	 */
+	virtual ~AnalysisSngScheduler();
+
+	/*!
+	 * \brief Estimates the duration of the parsing of a file
+	 * \param[in] p_file  the file
+	 * \return the estimated duration, in microseconds
+	 */
+	qint64 predictCost(RequirementFileAbstractPtr p_file);
+
+	/*!
+	 * \brief Orders files by decreasing estimated cost, without recording anything
+	 * \param[in] p_files  the files
+	 * \return the files, the most expensive first
+	 */
+	QVector<RequirementFileAbstractPtr> orderLongestFirst(const QVector<RequirementFileAbstractPtr>& p_files);
+
+	/*!
+	 * \brief Begins a run: orders its files and estimates its duration
+	 * \param[in] p_files  the files to be parsed
+	 * \param[in] p_nbWorkers  number of parsing threads
+	 * \return the files, in the order they must be started
+	 */
+	QVector<RequirementFileAbstractPtr> startRun(const QVector<RequirementFileAbstractPtr>& p_files, int p_nbWorkers);
+
+	/*!
+	 * \brief Records the duration of the parsing of a file of the current run (thread-safe)
+	 * \param[in] p_file  the parsed file
+	 */
+	void recordActualCost(RequirementFileAbstractPtr p_file);
+
+	/*!
+	 * \brief Ends the current run: measures its duration and learns from its files for the next runs
+	 */
+	void endRun();
+
+	/*!
+	 * \brief Comparison of the predicted and actual durations of the last run
+	 * \return the translated text, on one line
+	 */
+	QString getSummary() const;
+
+	/*!
+	 * \brief Predicted and actual durations of each file of the last run, in the order they have been started
+	 * \return the table, one line by file
+	 */
+	QString getJobsTable() const;
+
+	/*!
+	 * \brief Getter for the jobs of the last run
+	 * \return the jobs, in the order they have been started
+	 */
+	QVector<job_t> getJobs() const;
+
+private:
+	/*!
+	 * \brief Last known parsing of a document
+	 */
+	typedef struct
+	{
+		qint64 sizeBytes;  //!< Size of the document when it has been parsed
+		qint64 durationUs;  //!< Duration of the parsing
+	} history_t;
+
+	/*!
+	 * \brief Constructor, the history is loaded the first time it is needed
+	 */
+	AnalysisSngScheduler();
+
+	/*!
+	 * \brief Estimates the duration of the parsing of a file, __mutex being locked
+	 * \param[in] p_file  the file
+	 * \param[out] p_isFromHistory  set to true if a previous parsing of the file is known
+	 * \return the estimated duration, in microseconds
+	 */
+	qint64 __predictCost(RequirementFileAbstractPtr p_file, bool* p_isFromHistory = NULL);
+
+	/*!
+	 * \brief Cost by byte of a format, learnt or by default
+	 */
+	double __getNsPerByte(const QString& p_format) const;
+
+	/*!
+	 * \brief Loads the history from the disk, once
+	 */
+	void __loadHistory();
+
+	/*!
+	 * \brief Writes the history on the disk
+	 */
+	void __saveHistory() const;
+
+	mutable QMutex __mutex;  //!< Protects all the attributes
+	bool __isHistoryLoaded;  //!< Has the history been loaded ?
+	QHash<QString, history_t> __historyByDocument;  //!< Last parsing of each document (see AnalysisSngTextCache::getDocumentKey)
+	QHash<QString, double> __nsPerByteByFormat;  //!< Learnt cost by byte of each format
+	QVector<job_t> __jobs;  //!< Jobs of the current (or last) run, in the order they are started
+	QHash<RequirementFileAbstractPtr, int> __jobIndexByFile;  //!< Index of the job of each file of the current run
+	int __nbWorkers;  //!< Number of parsing threads of the current run
+	qint64 __predictedMakespanUs;  //!< Estimated duration of the parsing of the current run
+	qint64 __actualMakespanUs;  //!< Measured duration of the parsing of the last run, -1 while it runs
+	QElapsedTimer __runTimer;  //!< Started with the current run
+};
+
+#endif /* ANALYSISSNGSCHEDULER_H_ */
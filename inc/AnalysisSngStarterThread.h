@@ -8,6 +8,7 @@
 #ifndef ANALYSISSNGSTARTERTHREAD_H_
 #define ANALYSISSNGSTARTERTHREAD_H_
 
+#include <QMutex>
 #include <QVector>
 #include <QThread>
 #include <QSemaphore>
@@ -17,6 +18,15 @@
 /*!
  * \class AnalysisSngStarterThread
  * \brief Thread used to start all the file parsing thread out of the Qt main loop
+ *
+ * The files are started in the order they have been registered, each one as soon as a parsing slot is free
+ * (Rekkix registers them by decreasing estimated cost, see AnalysisSngScheduler).
+ *
+ * The thread can be stopped with QThread::requestInterruption while it is waiting for a free slot (see
+ * Rekkix::slt_cancelAnalysis), the remaining files are then never started.
+ *
+ * A file splitting its parsing between several threads (see RequirementFile_tree) borrows the slots left idle
+ * (see borrowSlots), so that the parsing threads never exceed the configured number.
  */
 class AnalysisSngStarterThread : public QThread, public QSemaphore
 {
@@ -41,10 +51,13 @@ public:
 	/*!
 	 * \brief Setter for the __registeredFiles attribute
 	 * \param[in] p_files   Vector of files for which a thread ending is expected
+	 * \param[in] p_runId   identifier of the analysis run of the files (see ModelSngReqMatrix::getRunId)
 	 */
-	void setRegisteredFiles(const QVector<RequirementFileAbstractPtr>& p_files)
+	void setRegisteredFiles(const QVector<RequirementFileAbstractPtr>& p_files, int p_runId)
 	{
+		QMutexLocker l(&__slotsMutex) ;
 		__registeredFiles = p_files ;
+		__runId = p_runId ;
 	}
 
 	/*!
@@ -53,6 +66,34 @@ public:
 	 */
 	void run() Q_DECL_OVERRIDE ;
 
+	/*!
+	 * \brief Takes back every available resource of the semaphore, so a new analysis starts from 0
+	 *
+	 * Must be called while the thread is not running (the resources released by the previous analysis
+	 * would otherwise allow more parallel parsing threads than configured).
+	 */
+	void reset()
+	{
+		QMutexLocker l(&__slotsMutex) ;
+		__runId = -1 ;
+		acquire(available()) ;
+	}
+
+	/*!
+	 * \brief Takes parsing slots left idle, without waiting, for the extra threads of a file being parsed
+	 * \param[in] p_max  maximum number of slots
+	 * \param[in] p_runId  analysis run of the file, nothing is borrowed if it is not the current one
+	 * \return the number of slots borrowed, to be given back by giveBackSlots
+	 */
+	int borrowSlots(int p_max, int p_runId) ;
+
+	/*!
+	 * \brief Gives back slots taken by borrowSlots
+	 * \param[in] p_nb  number of slots
+	 * \param[in] p_runId  analysis run of the file: the slots of a cancelled run are not given to the next one
+	 */
+	void giveBackSlots(int p_nb, int p_runId) ;
+
 private:
 
 	/*!
@@ -65,6 +106,16 @@ private:
 	 */
 	QVector<RequirementFileAbstractPtr> __registeredFiles ;
 
+	/*!
+	 * \brief Run whose files are started, -1 once reset (see borrowSlots)
+	 */
+	int __runId ;
+
+	/*!
+	 * \brief Protects __runId, so that no slot is borrowed or given back across a reset
+	 */
+	QMutex __slotsMutex ;
+
 };
 
 #endif /* ANALYSISSNGSTARTERTHREAD_H_ */
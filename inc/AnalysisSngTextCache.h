@@ -0,0 +1,208 @@
+/*!
+ * \file AnalysisSngTextCache.h
+ * \brief Definition of the class AnalysisSngTextCache
+ * \date 2016-11-04
+ * \author f.souliers
+ */
+
+#ifndef ANALYSISSNGTEXTCACHE_H_
+#define ANALYSISSNGTEXTCACHE_H_
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QWaitCondition>
+
+/*!
+ * \class AnalysisSngTextCache
+ * \brief Singleton sharing the text units extracted from the documents between the analyses of a process
+ *
+ * Several configurations often reference the same documents (see Rekkix::loadFilesAndRunBatch). Unzipping and
+ * decoding a document is most of the cost of its parsing, whereas its text units (see
+ * RequirementFileAbstract::_extractTextUnits) do not depend on the regular expressions of the configuration: they
+ * are kept here, so each physical document is only extracted once.
+ *
+ * The cache has two levels, both disabled by default (acquire then always fails and the documents are extracted
+ * for each analysis):
+ * - in memory (see setEnabled), a document is identified by its canonical path and the format of its units (see
+ *   RequirementFileAbstract::getTextUnitsFormat), and its units are only used while its size and date of
+ *   modification are the ones it had when its extraction began
+ * - on disk (see setPersistent), a document is identified by the hash of its content and the format of its units:
+ *   changing the regular expressions of a configuration, moving a document or copying it does not require its
+ *   extraction again, whereas any change of its content or of its parser does. Each entry is a file holding the
+ *   compressed units, written atomically: the directory can be deleted at any time. Once the entries exceed the size
+ *   given to setPersistent, the oldest ones are removed (see __prune)
+ *
+ * When a thread asks for a document being extracted by another thread, it waits for the end of this extraction
+ * instead of extracting it again.
+ */
+class AnalysisSngTextCache
+{
+public:
+	/*!
+	 * \brief Instance getter for the singleton object
+	 * \return The reference of the instance
+	 */
+	static AnalysisSngTextCache& instance()
+	{
+		static AnalysisSngTextCache r;
+		return (r);
+	}
+
+	/*!
+	 * \brief Destructor, does nothing special
+	 */
+	virtual ~AnalysisSngTextCache();
+
+	/*!
+	 * \brief Enables or disables the cache in memory, the documents already extracted are forgotten when disabled
+	 * \param[in] p_enabled  true to share the extracted documents
+	 */
+	void setEnabled(bool p_enabled);
+
+	/*!
+	 * \brief Enables or disables the cache on disk
+	 * \param[in] p_persistent  true to keep the extracted documents from one run to another
+	 * \param[in] p_maxSizeBytes  size of the entries over which the oldest ones are removed
+	 * \param[in] p_directory  directory of the entries, getDefaultDirectory() if empty
+	 */
+	void setPersistent(bool p_persistent, qint64 p_maxSizeBytes, const QString& p_directory = QString());
+
+	/*!
+	 * \brief Default directory of the cache on disk, in the cache location of the user
+	 * \return the path of the directory
+	 */
+	static QString getDefaultDirectory();
+
+	/*!
+	 * \brief Forgets every document extracted in memory and resets the counters (the cache on disk is kept)
+	 */
+	void clear();
+
+	/*!
+	 * \brief Gives the text units of a document if they are known, else reserves its extraction for the caller
+	 *
+	 * If another thread is extracting the document, the call waits for the end of its extraction.
+	 * \param[in] p_path  path of the document
+	 * \param[in] p_format  format of the units of the document (see RequirementFileAbstract::getTextUnitsFormat)
+	 * \param[out] p_units  the text units, if known
+	 * \return
+	 * - true if the units are known
+	 * - false else : the caller must extract the document then call release (unless the cache is disabled)
+	 */
+	bool acquire(const QString& p_path, const QString& p_format, QStringList& p_units);
+
+	/*!
+	 * \brief Ends an extraction reserved by acquire, waking up the threads waiting for it
+	 * \param[in] p_path  path of the document
+	 * \param[in] p_format  format of the document
+	 * \param[in] p_units  the extracted text units
+	 * \param[in] p_isValid  false if the extraction failed: the units are not kept
+	 */
+	void release(const QString& p_path, const QString& p_format, const QStringList& p_units, bool p_isValid);
+
+	/*!
+	 * \brief Key of a document: two paths of the same physical file give the same key
+	 * \param[in] p_path  path of the document
+	 * \param[in] p_format  format of the document
+	 * \return the key
+	 */
+	static QString getDocumentKey(const QString& p_path, const QString& p_format);
+
+	/*!
+	 * \brief Getter for the number of documents found in the cache since the last clear
+	 * \return the number of hits
+	 */
+	int getNbHits() const
+	{
+		return (__nbHits);
+	}
+
+	/*!
+	 * \brief Getter for the number of documents found on disk since the last clear (included in getNbHits)
+	 * \return the number of hits on disk
+	 */
+	int getNbPersistentHits() const
+	{
+		return (__nbPersistentHits);
+	}
+
+	/*!
+	 * \brief Getter for the number of documents extracted since the last clear (cache enabled)
+	 * \return the number of misses
+	 */
+	int getNbMisses() const
+	{
+		return (__nbMisses);
+	}
+
+private:
+	/*!
+	 * \brief Text units of a document, with the state of the file they have been extracted from
+	 */
+	typedef struct
+	{
+		qint64 size;  //!< Size of the file when its extraction began
+		QDateTime lastModified;  //!< Date of modification of the file when its extraction began
+		QStringList units;  //!< Text units, empty while the document is being extracted
+		QString entryPath;  //!< Entry of the document on disk, empty if the cache on disk is disabled
+	} document_t;
+
+	/*!
+	 * \brief Constructor, the cache is disabled
+	 */
+	AnalysisSngTextCache();
+
+	/*!
+	 * \brief Path of the entry of a document on disk
+	 * \param[in] p_path  path of the document
+	 * \param[in] p_format  format of the units of the document
+	 * \param[in] p_directory  directory of the entries
+	 * \return the path of the entry, empty if the document cannot be read
+	 */
+	static QString __getEntryPath(const QString& p_path, const QString& p_format, const QString& p_directory);
+
+	/*!
+	 * \brief Reads the units of a document on disk
+	 * \param[in] p_entryPath  path of the entry
+	 * \param[in] p_format  format of the units of the document
+	 * \param[out] p_units  the units
+	 * \return true if the entry exists and is valid
+	 */
+	static bool __readEntry(const QString& p_entryPath, const QString& p_format, QStringList& p_units);
+
+	/*!
+	 * \brief Writes the units of a document on disk
+	 * \param[in] p_entryPath  path of the entry
+	 * \param[in] p_format  format of the units of the document
+	 * \param[in] p_units  the units
+	 * \return the size of the entry, -1 if it cannot be written
+	 */
+	static qint64 __writeEntry(const QString& p_entryPath, const QString& p_format, const QStringList& p_units);
+
+	/*!
+	 * \brief Removes the oldest entries on disk until they fit in a part of the size of the cache, so that the next
+	 *        entries are written before the cache is pruned again
+	 * \param[in] p_directory  directory of the entries
+	 * \param[in] p_maxSizeBytes  size of the cache
+	 * \return the size of the remaining entries
+	 */
+	static qint64 __prune(const QString& p_directory, qint64 p_maxSizeBytes);
+
+	QMutex __mutex;  //!< Protects all the attributes
+	QWaitCondition __extractionFinished;  //!< Signaled each time an extraction ends
+	bool __isEnabled;  //!< Are the documents shared in memory ?
+	bool __isPersistent;  //!< Are the documents kept on disk ?
+	QString __directory;  //!< Directory of the entries on disk
+	qint64 __maxPersistentBytes;  //!< Size of the entries on disk over which the oldest ones are removed
+	qint64 __persistentBytes;  //!< Size of the entries on disk, since the last pruning
+	QHash<QString, document_t> __documents;  //!< Extracted documents, by key
+	QHash<QString, document_t> __pendingDocuments;  //!< Documents being extracted, by key
+	int __nbHits;  //!< Number of documents found in the cache
+	int __nbPersistentHits;  //!< Number of documents found on disk
+	int __nbMisses;  //!< Number of documents extracted
+};
+
+#endif /* ANALYSISSNGTEXTCACHE_H_ */
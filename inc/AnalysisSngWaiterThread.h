@@ -16,6 +16,9 @@
 /*!
  * \class AnalysisSngWaiterThread
  * \brief Class used to «listen» to the end of parsing file threads and update the GUI accordingly, outside the Qt main loop
+ *
+ * The thread can be stopped with QThread::requestInterruption (see Rekkix::slt_cancelAnalysis), allRegisteredTerminated
+ * is then not emitted.
  */
 class AnalysisSngWaiterThread : public QThread
 {
@@ -40,10 +43,12 @@ public:
 	/*!
 	 * \brief Setter for the __registeredFiles attribute
 	 * \param[in] p_files   Vector of files for which a thread ending is expected
+	 * \param[in] p_runId   identifier of the analysis run of the files (see ModelSngReqMatrix::getRunId)
 	 */
-	void setRegisteredFiles(const QVector<RequirementFileAbstractPtr>& p_files)
+	void setRegisteredFiles(const QVector<RequirementFileAbstractPtr>& p_files, int p_runId)
 	{
 		__registeredFiles = p_files ;
+		__runId = p_runId ;
 	}
 
 	/*!
@@ -52,22 +57,13 @@ public:
 	 */
 	void run() Q_DECL_OVERRIDE ;
 
-public slots:
-
-	/*!
-	 * \brief When a file starts its parsing, it must inform the waiter ... to wait for him ...
-	 */
-	void slt_parsingStarted()
-	{
-		static_cast<RequirementFileAbstractPtr>(QObject::sender())->setThreadActuallyLaunched() ;
-	}
-
 signals:
 
 	/*!
 	 * \brief this signal is emitted when all the registered files have been parsed
+	 * \param[in] p_runId  identifier of the analysis run, so a superseded run can be ignored
 	 */
-	void allRegisteredTerminated() ;
+	void allRegisteredTerminated(int p_runId) ;
 
 private:
 
@@ -80,6 +76,11 @@ private:
 	 * \brief list of the files for which an end of parsing is monitored
 	 */
 	QVector<RequirementFileAbstractPtr> __registeredFiles ;
+
+	/*!
+	 * \brief identifier of the analysis run of the registered files
+	 */
+	int __runId ;
 };
 
 #endif /* ANALYSISSNGWAITERTHREAD_H_ */
@@ -0,0 +1,100 @@
+/*!
+ * \file AnalysisSqliteExport.h
+ * \brief Definition of the class AnalysisSqliteExport
+ * \date 2016-11-14
+ * \author f.souliers
+ */
+
+#ifndef ANALYSISSQLITEEXPORT_H_
+#define ANALYSISSQLITEEXPORT_H_
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+
+#include "AnalysisSnapshot.h"
+
+/*!
+ * \class AnalysisSqliteExport
+ * \brief Export of an analysis into an SQLite database (writer <i>sqlite</i> of the <i>outputs</i> section)
+ *
+ * The csv report flattens the compositions and the coverages into delimited cells: the database holds the whole
+ * graph instead, so that other tools query it rather than parse a report. The tables are:
+ * - files (id, path, nb_requirements, nb_errors, must_have_downstream_documents, coverage)
+ * - document_links (upstream_file_id, downstream_file_id)
+ * - requirements (id, file_id, expected_by, is_consistent, must_be_covered, coverage)
+ * - compositions (composite_id, composing_id)
+ * - coverages (covered_id, covering_id)
+ * - errors (severity, category, code, location, description), every error, the ones not displayed included
+ * - analysis (run_id, creation_date), one row
+ *
+ * An invalid coverage (see Requirement::COVERAGE_INVALID_VALUE) and the file of a requirement defined nowhere are
+ * NULL. The code of an error is the value of AnalysisError::code_t, its description is translated.
+ *
+ * The database is written from scratch, with prepared statements in transactions of NB_ROWS_BY_TRANSACTION rows.
+ * The secondary indexes are created once every row is inserted, which is much faster than updating them row by
+ * row.
+ */
+class AnalysisSqliteExport
+{
+public:
+	static const int NB_ROWS_BY_TRANSACTION;  //!< Number of rows inserted before the transaction is committed
+
+	/*!
+	 * \brief Writes an analysis into a new database
+	 * \param[in] p_snapshot  the analysis
+	 * \param[in] p_path  path of the database, replaced if it exists
+	 * \param[out] p_errMsg  reason of the failure, if any
+	 * \return
+	 * - true if the database has been written
+	 * - false otherwise, the database is then removed
+	 */
+	static bool write(const AnalysisSnapshot& p_snapshot, const QString& p_path, QString& p_errMsg);
+
+private:
+	/*!
+	 * \brief Constructor of the class, only used by write
+	 * \param[in] p_db  the database, opened
+	 */
+	AnalysisSqliteExport(QSqlDatabase& p_db);
+
+	/*!
+	 * \brief Destructor of the class, does nothing special
+	 */
+	virtual ~AnalysisSqliteExport();
+
+	/*!
+	 * \brief Creates the tables, inserts the rows, then creates the indexes
+	 * \param[in] p_snapshot  the analysis
+	 * \return false if a statement fails (see __errMsg)
+	 */
+	bool __write(const AnalysisSnapshot& p_snapshot);
+
+	/*!
+	 * \brief Executes a statement without parameters
+	 * \param[in] p_statement  the statement
+	 * \return false if the statement fails (see __errMsg)
+	 */
+	bool __exec(const QString& p_statement);
+
+	/*!
+	 * \brief Prepares the insertion of a row
+	 * \param[out] p_query  the prepared query, its values are then bound in the order of the statement
+	 * \param[in] p_statement  the statement
+	 * \return false if the statement is invalid (see __errMsg)
+	 */
+	bool __prepare(QSqlQuery& p_query, const QString& p_statement);
+
+	/*!
+	 * \brief Inserts a row, and commits the transaction every NB_ROWS_BY_TRANSACTION rows
+	 * \param[inout] p_query  the prepared query, its values bound
+	 * \return false if the insertion fails (see __errMsg)
+	 */
+	bool __insert(QSqlQuery& p_query);
+
+	QSqlDatabase& __db;  //!< The database being written
+	int __nbRows;  //!< Number of rows inserted
+	QString __errMsg;  //!< Reason of the failure of the last statement
+};
+
+#endif /* ANALYSISSQLITEEXPORT_H_ */
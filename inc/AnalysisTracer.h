@@ -0,0 +1,190 @@
+/*!
+ * \file AnalysisTracer.h
+ * \brief Definition of the classes AnalysisTracer and AnalysisTraceScope
+ * \date 2016-10-20
+ * \author f.souliers
+ */
+
+#ifndef ANALYSISTRACER_H_
+#define ANALYSISTRACER_H_
+
+#include <QAtomicInt>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+/*!
+ * \class AnalysisTracer
+ * \brief Singleton collecting the timings of the analysis phases
+ *
+ * When enabled, each AnalysisTraceScope records one event (name, category, detail, thread, start, duration).
+ * The events can then be exported:
+ * - as a Chrome trace-event JSON file (see exportChromeTrace), viewable in chrome://tracing or Perfetto
+ * - as a per-file summary table (see getFileSummaryTable), used by the batch mode
+ *
+ * When disabled (default), a scope only costs the test of an atomic flag.
+ *
+ * Categories used by Rekkix:
+ * - CATEGORY_CONFIG : loading of the configuration file
+ * - CATEGORY_FILE : stages of the parsing of one file (the detail is the file id)
+ * - CATEGORY_COVERAGE : sub-passes of ModelSngReqMatrix::computeCoverage
+ * - CATEGORY_REPORT : rendering of a report (the detail is the writer)
+ */
+class AnalysisTracer
+{
+public:
+	static const char* CATEGORY_CONFIG;  //!< Category of the configuration events
+	static const char* CATEGORY_FILE;  //!< Category of the per-file events
+	static const char* CATEGORY_COVERAGE;  //!< Category of the coverage computation events
+	static const char* CATEGORY_REPORT;  //!< Category of the report rendering events
+
+	/*!
+	 * \brief Instance getter for the singleton object
+	 * \return The reference of the instance
+	 */
+	static AnalysisTracer& instance()
+	{
+		static AnalysisTracer r;
+		return (r);
+	}
+
+	/*!
+	 * \brief Destructor, does nothing special
+	 */
+	virtual ~AnalysisTracer();
+
+	/*!
+	 * \brief Enables or disables the recording of the events
+	 * \param[in] p_enabled  true to record the events
+	 */
+	void setEnabled(bool p_enabled)
+	{
+		__enabled.store(p_enabled ? 1 : 0);
+	}
+
+	/*!
+	 * \brief Getter for the recording state
+	 * \return true if the events are recorded
+	 */
+	bool isEnabled() const
+	{
+		return (__enabled.load() != 0);
+	}
+
+	/*!
+	 * \brief Removes every recorded event and resets the time origin of the trace
+	 */
+	void clear();
+
+	/*!
+	 * \brief Time elapsed since the origin of the trace
+	 * \return the time in nanoseconds
+	 */
+	qint64 now() const
+	{
+		return (__clock.nsecsElapsed() - __originNs.load());
+	}
+
+	/*!
+	 * \brief Records an event, thread-safe
+	 * \param[in] p_name  name of the event (a string literal, it is not copied)
+	 * \param[in] p_category  category of the event (a string literal, it is not copied)
+	 * \param[in] p_detail  detail of the event (file id, writer ...), may be empty
+	 * \param[in] p_startNs  start of the event (see now)
+	 * \param[in] p_durationNs  duration of the event
+	 */
+	void addEvent(const char* p_name, const char* p_category, const QString& p_detail, qint64 p_startNs, qint64 p_durationNs);
+
+	/*!
+	 * \brief Writes the recorded events as a Chrome trace-event JSON file
+	 * \param[in] p_path  path of the file to be written
+	 * \return true if the file has been written, false else
+	 */
+	bool exportChromeTrace(const QString& p_path) const;
+
+	/*!
+	 * \brief Builds a plain text table giving, for each file, the time spent in each parsing stage
+	 * \return the table, one line per file (empty if no file event has been recorded)
+	 */
+	QString getFileSummaryTable() const;
+
+private:
+	/*!
+	 * \brief One recorded event
+	 */
+	typedef struct
+	{
+		const char* name;  //!< Name of the event
+		const char* category;  //!< Category of the event
+		QString detail;  //!< File id, writer ...
+		Qt::HANDLE threadId;  //!< Thread in which the event occurred
+		qint64 startNs;  //!< Start of the event, relative to the origin of the trace
+		qint64 durationNs;  //!< Duration of the event
+	} event_t;
+
+	/*!
+	 * \brief Constructor, the recording is disabled by default
+	 */
+	AnalysisTracer();
+
+	QAtomicInt __enabled;  //!< 1 when the events are recorded
+	QElapsedTimer __clock;  //!< Started once by the constructor, never restarted: read by every thread without lock
+	QAtomicInteger<qint64> __originNs;  //!< Origin of the trace, relative to the start of __clock (see clear)
+	QVector<event_t> __events;  //!< Recorded events
+	mutable QMutex __eventsMutex;  //!< Protects __events
+};
+
+/*!
+ * \class AnalysisTraceScope
+ * \brief Scoped timer: records an event in AnalysisTracer from its construction to its destruction
+ *
+ * Typical use :
+ * \code
+ * {
+ *     AnalysisTraceScope ts("xml", AnalysisTracer::CATEGORY_FILE, getFileId());
+ *     mainDoc->setContent(...);
+ * }
+ * \endcode
+ */
+class AnalysisTraceScope
+{
+public:
+	/*!
+	 * \brief Starts the timer if the tracer is enabled
+	 * \param[in] p_name  name of the event (a string literal)
+	 * \param[in] p_category  category of the event (a string literal)
+	 * \param[in] p_detail  detail of the event (file id, writer ...)
+	 */
+	AnalysisTraceScope(const char* p_name, const char* p_category, const QString& p_detail = QString())
+		: __active(AnalysisTracer::instance().isEnabled()), __name(p_name), __category(p_category), __startNs(0)
+	{
+		if (__active)
+		{
+			__detail = p_detail;
+			__startNs = AnalysisTracer::instance().now();
+		}
+	}
+
+	/*!
+	 * \brief Records the event if the tracer was enabled at construction
+	 */
+	~AnalysisTraceScope()
+	{
+		if (__active)
+		{
+			AnalysisTracer& t = AnalysisTracer::instance();
+			t.addEvent(__name, __category, __detail, __startNs, t.now() - __startNs);
+		}
+	}
+
+private:
+	bool __active;  //!< Was the tracer enabled at construction
+	const char* __name;  //!< Name of the event
+	const char* __category;  //!< Category of the event
+	QString __detail;  //!< Detail of the event
+	qint64 __startNs;  //!< Start of the event
+};
+
+#endif /* ANALYSISTRACER_H_ */
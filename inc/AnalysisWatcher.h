@@ -0,0 +1,122 @@
+/*!
+ * \file AnalysisWatcher.h
+ * \brief Definition of the class AnalysisWatcher
+ * \date 2016-10-24
+ * \author f.souliers
+ */
+
+#ifndef ANALYSISWATCHER_H_
+#define ANALYSISWATCHER_H_
+
+#include <QFileSystemWatcher>
+#include <QMultiHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+#include "ModelConfiguration.h"
+
+/*!
+ * \class AnalysisWatcher
+ * \brief Watches the configuration file and the configured documents, used by the watch mode of Rekkix
+ *
+ * The changes are collected during a short delay (editors often write a file in several steps) and then
+ * notified at once:
+ * - configurationChanged if the configuration file has changed (the whole analysis must be done again)
+ * - documentsChanged with the ids of the changed documents else
+ *
+ * Many editors save a document by replacing it (write of a temporary file then rename): the watched file then
+ * disappears from QFileSystemWatcher. That is why the directories of the files are also watched, a file
+ * that is created again is watched again and notified as changed.
+ */
+class AnalysisWatcher : public QObject
+{
+	Q_OBJECT
+
+public:
+	/*!
+	 * \brief Constructor, nothing is watched until watch is called
+	 * \param[in] p_parent  parent of the object (Qt ownership)
+	 */
+	AnalysisWatcher(QObject* p_parent = Q_NULLPTR);
+
+	/*!
+	 * \brief Destructor, does nothing special
+	 */
+	virtual ~AnalysisWatcher();
+
+	/*!
+	 * \brief Starts watching a configuration file and its documents, the previously watched files are forgotten
+	 * \param[in] p_configPath  path of the configuration file
+	 * \param[in] p_files  configured documents (see ModelConfiguration::getConfiguredRequirementFiles)
+	 */
+	void watch(const QString& p_configPath, const ModelConfiguration::CnfFileAttributesMapsByFileId_t& p_files);
+
+	/*!
+	 * \brief Stops watching, pending changes are forgotten
+	 */
+	void stop();
+
+	/*!
+	 * \brief Getter for the watching state
+	 * \return true if files are being watched
+	 */
+	bool isWatching() const
+	{
+		return (!__configPath.isEmpty());
+	}
+
+signals:
+	/*!
+	 * \brief Emitted when the configuration file has changed
+	 */
+	void configurationChanged();
+
+	/*!
+	 * \brief Emitted when some documents have changed (and not the configuration file)
+	 * \param[in] p_fileIds  ids of the changed documents
+	 */
+	void documentsChanged(const QStringList& p_fileIds);
+
+private slots:
+	/*!
+	 * \brief Called by QFileSystemWatcher when a watched file has changed, been removed or renamed
+	 * \param[in] p_path  path of the file
+	 */
+	void slt_fileChanged(const QString& p_path);
+
+	/*!
+	 * \brief Called by QFileSystemWatcher when a file of a watched directory has been added or removed
+	 * \param[in] p_path  path of the directory
+	 */
+	void slt_directoryChanged(const QString& p_path);
+
+	/*!
+	 * \brief Called once the changes have stopped for a while : notifies them
+	 */
+	void slt_notifyChanges();
+
+private:
+	/*!
+	 * \brief Records a change and (re)starts the delay before notifying it
+	 * \param[in] p_path  path of the changed file
+	 */
+	void __addChange(const QString& p_path);
+
+	/*!
+	 * \brief Watches again a file that has been replaced
+	 * \param[in] p_path  path of the file
+	 * \return true if the file exists and is watched
+	 */
+	bool __rewatch(const QString& p_path);
+
+	QFileSystemWatcher __fsWatcher;  //!< Watcher of the files and their directories
+	QTimer __delayTimer;  //!< Delay between the last change and its notification
+	QString __configPath;  //!< Watched configuration file, empty if nothing is watched
+	QMultiHash<QString, QString> __fileIdsByPath;  //!< Ids of the documents, by path (several ids may share a path)
+	QSet<QString> __changedFileIds;  //!< Changed documents not notified yet
+	bool __isConfigChanged;  //!< Has the configuration file changed since the last notification
+};
+
+#endif /* ANALYSISWATCHER_H_ */
@@ -0,0 +1,136 @@
+/*!
+ * \file FactoryReport.h
+ * \brief Definition of the class FactoryReport
+ * \date 2016-10-18
+ * \author f.souliers
+ */
+
+#ifndef FACTORYREPORT_H_
+#define FACTORYREPORT_H_
+
+#include <QDateTime>
+#include <QString>
+
+#include "AnalysisSnapshotDiff.h"
+#include "ModelConfiguration.h"
+
+/*!
+ * \class FactoryReport
+ * \brief Simple and small factory used to build and write the reports configured in the <i>outputs</i> section
+ *
+ * The report content is built from the templates provided by FactoryReportBaseString and the data held by
+ * ModelSngReqMatrix and ModelSngAnalysisErrors. Those singletons must be up to date (ie
+ * ModelSngReqMatrix::computeCoverage must have been called) before generating any report.
+ *
+ * This class does not depend on the GUI so it can be used by the main window, the batch mode or any other
+ * tool (eg the benchmark harness) that needs to produce reports.
+ */
+class FactoryReport
+{
+public:
+	/*!
+	 * \brief Constructor of the class, does nothing special
+	 */
+	FactoryReport();
+
+	/*!
+	 * \brief Destructor of the class, does nothing special
+	 */
+	virtual ~FactoryReport();
+
+	/*!
+	 * \brief Build the content of a report for a given output description
+	 * \param[in] p_outFileDescription  Attributes of the output as read in the configuration file (see
+	 *                                  ModelConfiguration::OUTPUT_ATTRS)
+	 * \param[in] p_timestamp           Timestamp displayed in the report
+	 * \return
+	 * The whole content of the report, empty for a writer that is not a report (ie snapshot and sqlite)
+	 */
+	static QString buildReport(const ModelConfiguration::CnfFileAttributesMap_t& p_outFileDescription,
+	                           const QDateTime& p_timestamp);
+
+	/*!
+	 * \brief Build a report and store it on disk
+	 *
+	 * The tag ModelConfiguration::OUTPUT_STR_TIMESTAMP in the configured path is replaced by p_timestamp.
+	 * The writer snapshot saves the analysis itself (see AnalysisSnapshot::save) instead of a report, and the
+	 * writer sqlite exports it into a database (see AnalysisSqliteExport).
+	 * \param[in] p_outFileDescription  Attributes of the output as read in the configuration file
+	 * \param[in] p_timestamp           Timestamp displayed in the report and used in the file name
+	 * \param[out] p_errMsg             reason of the failure, to be displayed, if any
+	 * \return
+	 * - true if the report has been properly written
+	 * - false if the output file could not be written
+	 */
+	static bool writeReport(const ModelConfiguration::CnfFileAttributesMap_t& p_outFileDescription,
+	                        const QDateTime& p_timestamp, QString& p_errMsg);
+
+	/*!
+	 * \brief Build the content of a delta report, listing the changes between two analyses
+	 * \param[in] p_outFileDescription  Attributes of the output (only the html and csv writers are supported)
+	 * \param[in] p_diff                Changes between the analyses
+	 * \param[in] p_timestamp           Timestamp displayed in the report
+	 * \return
+	 * The whole content of the report
+	 */
+	static QString buildDeltaReport(const ModelConfiguration::CnfFileAttributesMap_t& p_outFileDescription,
+	                                const AnalysisSnapshotDiff& p_diff,
+	                                const QDateTime& p_timestamp);
+
+	/*!
+	 * \brief Build a delta report and store it on disk
+	 * \param[in] p_outFileDescription  Attributes of the output (only the html and csv writers are supported)
+	 * \param[in] p_diff                Changes between the analyses
+	 * \param[in] p_timestamp           Timestamp displayed in the report and used in the file name
+	 * \return
+	 * - true if the report has been properly written
+	 * - false if the output file could not be opened
+	 */
+	static bool writeDeltaReport(const ModelConfiguration::CnfFileAttributesMap_t& p_outFileDescription,
+	                             const AnalysisSnapshotDiff& p_diff,
+	                             const QDateTime& p_timestamp);
+
+private:
+	/*!
+	 * \brief Stores the content of a report on disk
+	 * \param[in] p_outFileDescription  Attributes of the output
+	 * \param[in] p_timestamp           Timestamp used in the file name
+	 * \param[in] p_content             Content of the report
+	 * \return
+	 * - true if the report has been properly written
+	 * - false if the output file could not be opened
+	 */
+	static bool __writeContent(const ModelConfiguration::CnfFileAttributesMap_t& p_outFileDescription,
+	                           const QDateTime& p_timestamp,
+	                           const QString& p_content);
+
+	/*!
+	 * \brief Builds the path of an output
+	 * \param[in] p_outFileDescription  Attributes of the output
+	 * \param[in] p_timestamp           Timestamp replacing ModelConfiguration::OUTPUT_STR_TIMESTAMP
+	 * \return
+	 * The path of the output file
+	 */
+	static QString __getOutputPath(const ModelConfiguration::CnfFileAttributesMap_t& p_outFileDescription,
+	                               const QDateTime& p_timestamp);
+
+	/*!
+	 * \brief When building a report, builds the string used for the summary of the report (list of files, errors, ...)
+	 * \param[in] p_writer  writer to be used for string generation (html, csv)
+	 * \param[in] p_delimiter  in case of csv, field delimiter
+	 * \return
+	 * The string representing the summary table according to the required format
+	 */
+	static const QString __getReportSummaryTable(const QString& p_writer, const QString& p_delimiter);
+
+	/*!
+	 * \brief When building a report, builds the string used for the table of errors (severity, category, location, description)
+	 * \param[in] p_writer  writer to be used for string generation (html, csv)
+	 * \param[in] p_delimiter  in case of csv, field delimiter
+	 * \return
+	 * The string representing the table of errors according to the required format
+	 */
+	static const QString __getReportErrorsTable(const QString& p_writer, const QString& p_delimiter);
+};
+
+#endif /* FACTORYREPORT_H_ */
@@ -22,6 +22,9 @@
  * - odt : parse the file as a LibreOffice text file
  * - txt : parse the file as a plain text file
  * - pdf : parse the file as a pdf file
+ *
+ * A path naming a directory or a glob pattern is a tree of plain text files (see RequirementFile_tree), whatever
+ * the parser.
  */
 class FactoryRequirementFile
 {
@@ -9,6 +9,7 @@
 #define MODELCONFIGURATION_H_
 
 #include <QAbstractItemModel>
+#include <QRegularExpression>
 
 #include "ModelConfigurationErrors.h"
 
@@ -69,7 +70,7 @@ public:
 
 
 	static const QString REQFILE_ATTR_ID;  //!< Attribute name for the file ID (part of the setting name in the *.ini file)
-	static const QString REQFILE_ATTR_PATH;  //!< Attribute name for the file path
+	static const QString REQFILE_ATTR_PATH;  //!< Attribute name for the file path (or the directory / glob pattern of a tree of files, see RequirementFile_tree)
 	static const QString REQFILE_ATTR_PARSER;  //!< Attribute name for the parser that must be used to read the file, see FactoryRequirementFile for available parsers
 
 	static const QString REQFILE_ATTR_REQREGEX;  //!< Attribute name for the regex used to identify a requirement
@@ -96,6 +97,14 @@ public:
 	static const QString REQFILE_ATTR_COVREGEX;
 	static const QString REQFILE_ATTR_COVSEPARATOR;  //!< Attribute name for the separator character in the upstream requirements list
 	static const QString REQFILE_ATTR_STOPAFTERREGEX;  //!< Attribute name for the regex used to stop the parsing of the file
+
+	/*!
+	 * \brief Attribute name for the pages of the file to parse, all of them if empty
+	 *
+	 * Only used by the pdf parser. Pages are numbered from 1, the first or the last page of a range may be omitted:
+	 * "12" is only the page 12, "5-120" the pages 5 to 120 and "5-" every page from the fifth one (see parsePageRange).
+	 */
+	static const QString REQFILE_ATTR_PAGES;
 	static const QString REQFILE_ATTR_HASDWN;  //!< Attribute name used to specify whether the file must have downstream documents
 	static const QString REQFILE_ATTR_HASUP;  //!< Attribute name used to specify whether the file must have upstream documents
 
@@ -119,6 +128,8 @@ public:
 
 	static const QString OUTPUT_ATTR_VALUE_HTML;  //!< Attribute value html for OUTPUT_ATTR_WRITER
 	static const QString OUTPUT_ATTR_VALUE_CSV;  //!< Attribute value csv for OUTPUT_ATTR_WRITER
+	static const QString OUTPUT_ATTR_VALUE_SNAPSHOT;  //!< Attribute value snapshot for OUTPUT_ATTR_WRITER (analysis saved for rekkix --diff, see AnalysisSnapshot::save)
+	static const QString OUTPUT_ATTR_VALUE_SQLITE;  //!< Attribute value sqlite for OUTPUT_ATTR_WRITER (whole traceability graph, see AnalysisSqliteExport)
 	static const QString OUTPUT_STR_TIMESTAMP;  //!< String in the path attribute value that shall be replaced by the timestamp
 
 
@@ -224,7 +235,43 @@ public:
 		return (__outputFiles);
 	}
 
+	/*!
+	 * \brief Gives the compiled regular expression of a pattern, compiled only once for the loaded configuration
+	 *
+	 * The patterns are compiled while the configuration is checked, then the parsers use the same compiled
+	 * regular expressions (see RequirementFileAbstract): the thousands of files of a big configuration usually
+	 * share a few patterns. The regular expressions are forgotten when the next configuration is loaded (see
+	 * setFile). Thread-safe, the patterns are compiled outside of the lock and the compiled regular expressions
+	 * can be used by several threads.
+	 * \param[in] p_pattern  the pattern
+	 * \return the regular expression, to be checked with isValid
+	 */
+	static QRegularExpression getCompiledRegex(const QString& p_pattern);
+
+	/*!
+	 * \brief Reads the value of the attribute REQFILE_ATTR_PAGES
+	 * \param[in] p_value  the value of the attribute
+	 * \param[out] p_first  first page to parse, from 1
+	 * \param[out] p_last  last page to parse, -1 for the last page of the document
+	 * \return false if the value is not a range of pages (an empty value is every page)
+	 */
+	static bool parsePageRange(const QString& p_value, int& p_first, int& p_last);
+
 private:
+	friend class ReqFilesCheckTask;
+
+	/*!
+	 * \typedef IniSection_t
+	 * \brief Values of a section of the configuration file: by group (file id), the values by attribute name
+	 */
+	typedef QMap<QString, CnfFileAttributesMap_t> IniSection_t;
+
+	/*!
+	 * \typedef IniFile_t
+	 * \brief Sections of the configuration file, by name
+	 */
+	typedef QMap<QString, IniSection_t> IniFile_t;
+
 	/*!
 	 * \brief Map of files containing requirements (see CnfFileAttributesMapsByFileId_t)
 	 */
@@ -240,18 +287,19 @@ private:
 	 *
 	 * The following rules are checked:
 	 * - the ID is mandatory
-	 * - the path is mandatory and must target an existing file
+	 * - the path is mandatory and must target an existing file, or the existing root directory of a tree
 	 * - the req_regex is mandatory
 	 * - if cmp_regex mentioned, then cmp_separator is mandatory
 	 * - if cov_regex mentioned, then cov_separator is mandatory
 	 *
+	 * Only reads its parameters: the files are checked by several threads at the same time (see __readSectionFiles).
 	 * \param[in] configured_file    attributes map of the file that must be verified
-	 * \param[inout] errModel        used to store every configuration error, so it can be displayed
+	 * \param[out] errors            every configuration error of the file is appended here
 	 * \return
-	 * If the errModel parameter has been modified, then returns true; else returns false.
+	 * If an error has been found, then returns true; else returns false.
 	 */
 	bool __hasAReqFileConsistecyError(const CnfFileAttributesMap_t& configured_file,
-	                                  ModelConfigurationErrorsRef errModel);
+	                                  QVector<ModelConfigurationErrors::error_t>& errors) const;
 
 	/*!
 	 * \brief Checks the consistency of the attributes of a given output file
@@ -269,23 +317,35 @@ private:
 	bool __hasAnOutputFileConsistecyError(const CnfFileAttributesMap_t& output_file,
 	                                      ModelConfigurationErrorsRef errModel);
 
+	/*!
+	 * \brief Reads the whole configuration file in one pass
+	 *
+	 * Only the usual syntax of the configuration files is understood (comments, sections, quoted or simple
+	 * values): anything else is left to QSettings, which gives the same values more slowly.
+	 * \param[in] configFilePath  Path to the ini configuration file
+	 * \param[out] iniFile        the sections of the file
+	 * \return false if the file must be read with QSettings
+	 */
+	static bool __readIniFileInOnePass(const QString& configFilePath, IniFile_t& iniFile);
+
 	/*!
 	 * \brief Reads the <i>files</i> section of the configuration file
-	 * \warning The existence and the possibility to open the configuration file must have been
-	 *          checked before calling this method
+	 *
+	 * The files are checked in parallel when they are many (see __hasAReqFileConsistecyError), the errors
+	 * being stored in the order of the file ids whatever the order of the checks.
+	 * \param[in] section         Values of the section
 	 * \param[in] configFilePath  Path to the ini configuration file
 	 * \param[inout] errModel     used to store every configuration error, so it can be displayed
 	 */
-	void __readSectionFiles(const QString& configFilePath, ModelConfigurationErrorsRef errModel);
+	void __readSectionFiles(const IniSection_t& section, const QString& configFilePath, ModelConfigurationErrorsRef errModel);
 
 	/*!
 	 * \brief Reads the <i>outputs</i> section of the configuration file
-	 * \warning The existence and the possibility to open the configuration file must have been
-	 *          checked before calling this method
+	 * \param[in] section         Values of the section
 	 * \param[in] configFilePath  Path to the ini configuration file
 	 * \param[inout] errModel     used to store every configuration error, so it can be displayed
 	 */
-	void __readSectionOutputs(const QString& configFilePath, ModelConfigurationErrorsRef errModel);
+	void __readSectionOutputs(const IniSection_t& section, const QString& configFilePath, ModelConfigurationErrorsRef errModel);
 
 
 	/*!
@@ -296,7 +356,7 @@ private:
 	 * \param[in] configured_file  Configuration map for the current file
 	 * \param[inout] errors        Vector of errors found
 	 */
-	void __regexCheckValidityAndGroups(const CnfFileAttributesMap_t& configured_file, QVector<ModelConfigurationErrors::error_t>& errors) ;
+	void __regexCheckValidityAndGroups(const CnfFileAttributesMap_t& configured_file, QVector<ModelConfigurationErrors::error_t>& errors) const ;
 };
 
 /*!
@@ -8,16 +8,30 @@
 #ifndef MODELSNGANALYSISERRORS_H_
 #define MODELSNGANALYSISERRORS_H_
 
-#include <QMutex>
 #include <QAbstractItemModel>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QThreadStorage>
 
 #include "AnalysisError.h"
+#include "AnalysisErrorStore.h"
 
 /*!
  * \class ModelSngAnalysisErrors
  * \brief Model (see Qt Framework and MVC) used to display the list of errors found during analysis
  *
  * This class is also a singleton as all the errors must be centralized and displayed at the same time
+ *
+ * The errors are grouped by kind and location (see AnalysisErrorStore): only the first errors of a group are
+ * displayed (and written in the reports), followed by one row telling how many errors of the group are not.
+ *
+ * The errors are raised by the threads merging the files, while the views read the model. Each thread adds its
+ * errors to its own buffer without any lock, and commits the buffer once the file is merged (see commitErrors):
+ * the batch is pushed on a lock-free list. The batches are only added to the store and to the rows by the main
+ * thread (see publishErrors), so that the views, and the reports once the analysis is over, read them safely.
+ *
+ * Once the analysis is over, all the errors are grouped again by a worker thread (see groupErrors) and handed over
+ * to the main thread, which only replaces the displayed errors by the prepared ones (see setErrors).
  */
 class ModelSngAnalysisErrors : public QAbstractItemModel
 {
@@ -25,6 +39,24 @@ Q_OBJECT
 
 public:
 
+	/*!
+	 * \brief Displayed row, an error kept by the store or the summary of a group
+	 */
+	typedef struct
+	{
+		int group;  //!< Index of the group of the row (see AnalysisErrorStore::getGroups)
+		int example;  //!< Index of the error in the examples of the group, -1 for the summary of the group
+	} row_t;
+
+	/*!
+	 * \brief Errors grouped and ready to be displayed, prepared by any thread (see groupErrors)
+	 */
+	typedef struct
+	{
+		AnalysisErrorStore store;  //!< The errors, grouped
+		QVector<row_t> rows;  //!< The displayed rows, in the order of the errors
+	} errors_t;
+
 	/*!
 	 * \brief Instance getter for the singleton object
 	 * \return The reference of the instance
@@ -95,28 +127,83 @@ public:
 	QModelIndex parent(const QModelIndex &index) const;
 
 	/*!
-	 * \brief Append one single error to the list of errors
+	 * \brief Append one single error to the buffer of the calling thread (see commitErrors)
 	 * \param[in] e  the error object to be added
 	 */
 	void addError(const AnalysisError& e);
 
 	/*!
-	 * \brief Append several errors to the list of errors
+	 * \brief Append several errors to the buffer of the calling thread (see commitErrors)
 	 * \param[in] ve  the vector of error objects to be added
 	 */
 	void addErrors(const QVector<AnalysisError>& ve);
 
+	/*!
+	 * \brief Hands the errors added by the calling thread over to the main thread, without any lock
+	 *
+	 * The errors are displayed by the next publishErrors. The ones added before the last clear are dropped.
+	 */
+	void commitErrors();
+
+	/*!
+	 * \brief Drops the errors added by the calling thread and not committed, eg the ones of a cancelled run
+	 */
+	void discardErrors();
+
+	/*!
+	 * \brief Displays the errors committed since the last call (see commitErrors)
+	 *
+	 * Must be called from the main thread, the rows are appended in the order of the commits.
+	 */
+	void publishErrors();
+
+	/*!
+	 * \brief Groups errors the way they are displayed, without modifying the model (can be called by any thread)
+	 * \param[in] p_errors  the errors, in the order they are displayed
+	 * \return the grouped errors, to be displayed by setErrors
+	 */
+	static errors_t groupErrors(const QVector<AnalysisError>& p_errors);
+
+	/*!
+	 * \brief Replaces all the displayed errors by errors already grouped (see groupErrors)
+	 *
+	 * Must be called from the main thread. The errors added or committed and not published yet are dropped as by
+	 * clear. Nothing is grouped here: the model only shares the data of p_errors (implicitly shared containers).
+	 * \param[in] p_errors  the grouped errors
+	 */
+	void setErrors(const errors_t& p_errors);
+
 	/*!
 	 * \brief Getter for the number of errors found in a given file
 	 * \param[in] p_fileId  File ID, as described in the configuration, for which the number of
 	 *                      errors have to be retrieved.
 	 * \return
-	 * The number of errors found in the given file
+	 * The number of errors published for the given file, the ones not displayed included
 	 */
 	int getNberrorsInAFile(const QString& p_fileId);
 
 	/*!
-	 * \brief Clear all the data contained in the model
+	 * \brief Getter for the number of errors
+	 * \return
+	 * The number of errors published since the last clear, the ones not displayed included
+	 */
+	int getNbErrors();
+
+	/*!
+	 * \brief Getter for the grouped errors, eg to filter them by location, severity or category
+	 * \return
+	 * The store of the published errors, to be used by the main thread or once the analysis is over
+	 */
+	const AnalysisErrorStore& getStore() const
+	{
+		return (__store);
+	}
+
+	/*!
+	 * \brief Clear all the data contained in the model, must be called from the main thread
+	 *
+	 * The errors committed and not published yet are dropped, as well as the ones the other threads are still
+	 * adding to their buffer.
 	 */
 	void clear();
 
@@ -151,19 +238,81 @@ private:
 	virtual ~ModelSngAnalysisErrors();
 
 	/*!
-	 * \brief Vector containing all the errors of analysis that have been detected
+	 * \brief Errors added by a thread and not committed yet
+	 */
+	typedef struct
+	{
+		int generation;  //!< Value of __generation when the first error has been added
+		QVector<AnalysisError> errors;  //!< The errors, in the order they have been added
+	} buffer_t;
+
+	/*!
+	 * \brief Errors committed by a thread, element of the list of the batches not published yet
+	 */
+	typedef struct batch
+	{
+		int generation;  //!< Value of __generation when the errors have been added
+		QVector<AnalysisError> errors;  //!< The errors
+		struct batch* next;  //!< Batch committed before this one, NULL for the first one
+	} batch_t;
+
+	/*!
+	 * \brief Getter for the buffer of the calling thread, emptied if it has been filled before the last clear
+	 * \return the buffer
+	 */
+	buffer_t& __getBuffer();
+
+	/*!
+	 * \brief Takes the batches committed and not published yet
+	 * \return the batches, the last committed first
+	 */
+	batch_t* __takeBatches();
+
+	/*!
+	 * \brief Deletes a list of batches
+	 * \param[in] p_batches  the first batch of the list, may be NULL
+	 */
+	static void __deleteBatches(batch_t* p_batches);
+
+	/*!
+	 * \brief Appends an error to a store, and its row if it is displayed
+	 * \param[inout] p_store  the store
+	 * \param[in] e  the error
+	 * \param[inout] p_rows  the row of the error is appended here if it is displayed
+	 */
+	static void __addError(AnalysisErrorStore& p_store, const AnalysisError& e, QVector<row_t>& p_rows);
+
+	/*!
+	 * \brief Getter for the error of a row, or the summary of its group
+	 * \param[in] p_row  the row
+	 * \return the error to be displayed
+	 */
+	AnalysisError __getRowError(const row_t& p_row) const;
+
+	/*!
+	 * \brief All the errors of analysis that have been published, grouped (main thread only)
+	 */
+	AnalysisErrorStore __store;
+
+	/*!
+	 * \brief Displayed rows, in the order the errors have been published (main thread only)
+	 */
+	QVector<row_t> __rows;
+
+	/*!
+	 * \brief Buffer of each thread adding errors
 	 */
-	QVector<AnalysisError> __errors;
+	QThreadStorage<buffer_t> __buffers;
 
 	/*!
-	 * \brief Map of the number of errors detected for each file id
+	 * \brief Last committed batch not published yet, the others follow it (pushed and taken atomically)
 	 */
-	QMap<QString, int> __nbErrorsByFileId;
+	QAtomicPointer<batch_t> __batches;
 
 	/*!
-	 * \brief Mutex used to lock access to __errors vector to avoid simultaneous writing
+	 * \brief Incremented by clear, tells the errors added before it from the ones added after
 	 */
-	QMutex __addErrorMutex ;
+	QAtomicInt __generation;
 };
 
 #endif /* MODELSNGANALYSISERRORS_H_ */
@@ -10,11 +10,21 @@
 
 
 #include <QAbstractItemModel>
+#include <QAtomicInt>
+#include <QHash>
 #include <QString>
 #include <QMap>
 #include <QMutex>
-
+#include <QPair>
+#include <QMetaType>
+#include <QSet>
+#include <QSharedPointer>
+#include <QThreadPool>
+
+#include "AnalysisSnapshot.h"
+#include "ModelSngAnalysisErrors.h"
 #include "Requirement.h"
+#include "RequirementArena.h"
 #include "RequirementFileAbstract.h"
 
 /*!
@@ -24,11 +34,28 @@
  * This class is also used as a model (see Qt Framework and MVC) to display the summary of requirement
  * traceability for the files configured (nb of requirements, errors, coverage for/in each file)
  *
- * Furthermore, this class contains the methods that should be called by file parser class when they detect
- * some requirements. Those methods are :
+ * Furthermore, this class contains the methods that are called when the contributions recorded by a file parser
+ * are merged (see mergeRequirementFile). Those methods are :
  * - addDefinedRequirement
  * - addExpectedCompositeRequirement
  * - addExpectedCoveredRequirement
+ *
+ * Each analysis is a «run» identified by an integer incremented by clear(). The parsers give the identifier of
+ * their run with each requirement, so the results of a cancelled run still being parsed are ignored instead
+ * of being mixed with the ones of the new run.
+ *
+ * Once the coverage has been computed, some files can be analysed again alone (watch mode): the contributions
+ * of their previous version are removed from the matrix (see prepareRequirementFilesUpdate), the new ones are
+ * merged, and computeCoverage only computes again the requirements that may have changed, ie the requirements
+ * touched by the files and their ancestors through composition and upstream coverage (their consistency and
+ * coverage depend on their composing and downstream requirements). The errors are kept with what they come
+ * from (parsing, merge, consistency of a requirement, links of a file) and published again altogether.
+ *
+ * The rows of the model are the files already merged: each merge queues the summary of its file (number of
+ * requirements and of errors), and the main thread inserts the queued rows periodically (see publishMergedFiles),
+ * so that the results of the first files can be read while the others are still being parsed. Their coverage is
+ * displayed once computed: the rows of every file and the errors are prepared by the worker computing the coverage
+ * (see createResults), the main thread only replaces the displayed ones (see publishCoverage).
  */
 class ModelSngReqMatrix : public QAbstractItemModel
 {
@@ -36,6 +63,27 @@ Q_OBJECT
 
 public:
 
+	/*!
+	 * \brief Summary of a file displayed by the model
+	 */
+	typedef struct
+	{
+		QString fileId;  //!< Id of the file
+		int nbRequirements;  //!< Number of requirements accepted for the file
+		int nbErrors;  //!< Number of errors of the file
+		bool isCoverageComputed;  //!< Is the coverage of the file up to date (else it is not displayed)
+		double coverage;  //!< Coverage of the file, copied so that the view does not read the next computation
+	} fileRow_t;
+
+	/*!
+	 * \brief Results of the coverage, prepared by a worker thread and displayed at once by the main thread
+	 */
+	typedef struct
+	{
+		ModelSngAnalysisErrors::errors_t errors;  //!< All the errors known by the matrix, grouped
+		QVector<fileRow_t> rows;  //!< Rows of every file, sorted by file id
+	} results_t;
+
 	/*!
 	 * \brief Instance getter for the singleton object
 	 * \return The reference of the instance
@@ -57,11 +105,12 @@ public:
 	 *  threads.
 	 * \param[in] file_id   file id being parsed in for witch the method has been called
 	 * \param[in] p_r       requirement object to be added into the matrix
+	 * \param[in] p_runId   identifier of the run of the calling parser (see getRunId)
 	 * \return
 	 * - true if the requirement has been properly added
-	 * - false if not
+	 * - false if not (including when p_runId is not the current run)
 	 */
-	bool addDefinedRequirement(const QString& file_id, RequirementRef p_r);
+	bool addDefinedRequirement(const QString& file_id, RequirementRef p_r, int p_runId);
 
 	/*!
 	 * \brief Add an expected requirement as it has been defined as a subelement of another one
@@ -70,8 +119,11 @@ public:
 	 * \param[in] location    File id / requirement being parsed in for witch the method has been called
 	 * \param[in] p_parentId  The Id of the requirement composed of at least p_r
 	 * \param[in] p_r         The requirement object which is a sublement of the requirement identified by p_parentId
+	 * \param[in] p_runId     identifier of the run of the calling parser, ignored if not the current run
+	 * \param[in] p_part      part of the document, given to the errors (see RequirementFileAbstract::contribution_t)
 	 */
-	void addExpectedCompositeRequirement(const QString& location, const QString& p_parentId, RequirementRef p_r);
+	void addExpectedCompositeRequirement(const QString& location, const QString& p_parentId, RequirementRef p_r, int p_runId,
+	                                     const QString& p_part = QString());
 
 	/*!
 	 * \brief Add an expected requirement as it has been defined as covered by the current one
@@ -83,12 +135,16 @@ public:
 	 * \param[in] file_id file id being parsed in for witch the method has been called
 	 * \param[in] p_reqId current requirement that covers p_coveredReq
 	 * \param[in] p_coveredReq Requirement covered by the current one
+	 * \param[in] p_runId identifier of the run of the calling parser, ignored if not the current run
+	 * \param[in] p_part part of the document, given to the errors (see RequirementFileAbstract::contribution_t)
 	 */
-	void addExpectedCoveredRequirement(const QString& location, const QString& p_reqId, RequirementRef p_coveredReq);
+	void addExpectedCoveredRequirement(const QString& location, const QString& p_reqId, RequirementRef p_coveredReq, int p_runId,
+	                                   const QString& p_part = QString());
 
 	/*!
 	 * \brief Add a file containing requirements to the list of such files
 	 *
+	 * The file is bound to the current run (see RequirementFileAbstract::setRunId).
 	 * \param[in] p  The file parser object that has to be taken into account. This must be a valid pointer.
 	 */
 	void addRequirementFile(RequirementFileAbstractPtr p);
@@ -103,13 +159,81 @@ public:
 	 */
 	void updateRequirementFileWithAcceptedRequirements(RequirementFileAbstractPtr p);
 
+	/*!
+	 * \brief Merges the contributions and the parsing errors recorded by a parsed file into the matrix
+	 *
+	 * The contributions are replayed in the order of the document: the composite and covered requirements
+	 * following a rejected definition (eg defined twice) are ignored, as the parsers used to do. The
+	 * requirements accepted for the file are then set (see updateRequirementFileWithAcceptedRequirements).
+	 * Nothing is done if the file does not belong to the current run.
+	 * \param[in] p  The parsed file. This must be a valid pointer.
+	 */
+	void mergeRequirementFile(RequirementFileAbstractPtr p);
+
+	/*!
+	 * \brief Displays the files merged since the last call (see mergeRequirementFile)
+	 *
+	 * Must be called from the main thread, the rows of the files are inserted at their place (the files are sorted
+	 * by id) or updated if the file is already displayed. Called at a fixed period during the parsing so that the
+	 * view is not refreshed for each file.
+	 */
+	void publishMergedFiles();
+
+	/*!
+	 * \brief Prepares the re-analysis of some files only (watch mode)
+	 *
+	 * A new run is started. The given files replace the ones with the same id (the replaced ones are released as
+	 * in clear) and the contributions of the replaced ones are removed from the matrix. The given files must then
+	 * be parsed and merged as usual, and computeCoverage only updates what they have touched.
+	 *
+	 * If the coverage has never been computed, or if a replaced file is involved in a redefinition or a multiple
+	 * coverage (the result then depends on the order of the merge), the matrix is built again instead: the
+	 * contributions recorded by the other files must be merged again (see mergeRequirementFile), without parsing
+	 * them. Nothing is merged here, so that the caller can merge them in a worker thread.
+	 * \param[in] p_files  new objects of the files to be parsed again (registered into the current run)
+	 * \return the other files, to be merged again before the coverage is computed, empty if the update is incremental
+	 */
+	QVector<RequirementFileAbstractPtr> prepareRequirementFilesUpdate(const QVector<RequirementFileAbstractPtr>& p_files);
+
 	/*!
 	 * \brief Compute the coverage values of files once they all have been parsed.
 	 *
-	 * At the end of the computation, the method emits dataChanged and layoutChanged signals to freshen
-	 * file coverage view
+	 * After a clear, everything is computed. After prepareRequirementFilesUpdate, only the requirements touched
+	 * since the last computation and their ancestors are computed again, and only their files are updated.
+	 *
+	 * Nothing is displayed here, so the computation can run in a worker thread as long as nothing else modifies
+	 * the matrix: the results are prepared by createResults and displayed by publishCoverage, from the main thread.
+	 * \param[in] p_isCancelled  the computation stops as soon as it is set, if not NULL
+	 * \return false if the computation has been cancelled: the matrix must then be cleared, or built again by
+	 *         prepareRequirementFilesUpdate
+	 */
+	bool computeCoverage(const QAtomicInt* p_isCancelled = NULL);
+
+	/*!
+	 * \brief Getter for the progress of the running computation of the coverage, can be called by any thread
+	 * \return the part of the computation already done, in [0 ; 1]
 	 */
-	void computeCoverage();
+	double getCoverageProgress() const;
+
+	/*!
+	 * \brief Prepares the display of the results of computeCoverage: groups all the errors and builds the row of
+	 *        every file with its coverage and its number of errors
+	 *
+	 * Must be called once the coverage has been computed, while nothing modifies the matrix (it can then be
+	 * called from a worker thread, see computeCoverage).
+	 * \return the results, which are not modified anymore
+	 */
+	QSharedPointer<const results_t> createResults() const;
+
+	/*!
+	 * \brief Displays the results prepared by createResults
+	 *
+	 * Must be called from the main thread: the errors of ModelSngAnalysisErrors and the rows of the model are
+	 * replaced by the prepared ones (the files merged and not displayed yet are then displayed too), nothing is
+	 * computed again.
+	 * \param[in] p_results  the results of the current run
+	 */
+	void publishCoverage(QSharedPointer<const results_t> p_results);
 
 	/*!
 	 * \brief Column counter for the model
@@ -179,7 +303,47 @@ public:
 	RequirementFileAbstractPtr getRequirementFile(const QString& p_fileID) const;
 
 	/*!
-	 * \brief Clear all the data contained in the model
+	 * \brief Getter for a requirement object (defined or expected one)
+	 * \param[in] p_id  Id of the required requirement
+	 * \return
+	 * A pointer to the required requirement object, NULL if it is unknown
+	 */
+	RequirementPtr getRequirement(const QString& p_id);
+
+	/*!
+	 * \brief Getter for the number of requirements known by the matrix (defined and expected ones)
+	 * \return
+	 * The number of requirement objects currently stored in the matrix
+	 */
+	int getNbRequirements() const
+	{
+		return (__reqsByName.count());
+	}
+
+	/*!
+	 * \brief Copies the results of the analysis into a snapshot that can be read by other threads
+	 *
+	 * Must be called once the coverage has been computed, while nothing modifies the matrix (it can then be
+	 * called from a worker thread, see computeCoverage).
+	 * \return the snapshot, which is not modified anymore
+	 */
+	AnalysisSnapshotPtr createSnapshot();
+
+	/*!
+	 * \brief Getter for the identifier of the current run
+	 * \return the identifier of the current run
+	 */
+	int getRunId() const
+	{
+		return (__runId.load());
+	}
+
+	/*!
+	 * \brief Clear all the data contained in the model and starts a new run
+	 *
+	 * The files still being parsed (cancelled run) are asked to stop and are deleted once their thread has
+	 * finished, the other ones are deleted immediately. Requirements sent later by the cancelled parsers
+	 * are ignored as they belong to the previous run.
 	 */
 	void clear();
 
@@ -210,16 +374,27 @@ private:
 	ModelSngReqMatrix(QObject *parent = Q_NULLPTR);
 
 	/*!
-	 * \brief Destructor of the model, does nothing
+	 * \brief Destructor of the model, waits for the requirements of the previous runs to be released
 	 */
 	virtual ~ModelSngReqMatrix();
 
 	/*!
 	 * \brief Map of the requirement objects, accessible by name (that means by the req_regex match)
 	 *
-	 * The requirements are only instantiated here, every other attributes use pointer to those objects
+	 * The requirements are only instantiated in __reqArena, every other attributes use pointer to those objects
 	 */
-	QMap<QString, Requirement> __reqsByName;
+	QMap<QString, Requirement*> __reqsByName;
+
+	/*!
+	 * \brief Storage of the requirements of the current run, replaced by a new one when the run is cleared
+	 */
+	RequirementArena* __reqArena;
+
+	/*!
+	 * \brief Single worker releasing the requirements of the previous runs, waited for by the destructor so that
+	 *        no release outlives the matrix
+	 */
+	QThreadPool __retiredRunsPool;
 
 	/*!
 	 * \brief Vector of pointers to all of the valid requirements of a given file id
@@ -231,6 +406,21 @@ private:
 	 */
 	QMap<QString, RequirementFileAbstractPtr> __filesByFileId;
 
+	/*!
+	 * \brief Rows of the model, sorted by file id (only used by the main thread)
+	 */
+	QVector<fileRow_t> __rows;
+
+	/*!
+	 * \brief Rows of the files merged but not displayed yet (see publishMergedFiles)
+	 */
+	QVector<fileRow_t> __mergedRows;
+
+	/*!
+	 * \brief Mutex used to control access to __mergedRows (filled by the thread merging the files)
+	 */
+	QMutex __mergedRowsMutex ;
+
 	/*!
 	 * \brief Mutex used to control access to __reqsByName (to avoid simultaneous writing)
 	 */
@@ -241,6 +431,161 @@ private:
 	 */
 	QMutex __reqsByFileIdMutex ;
 
+	/*!
+	 * \brief Identifier of the current run, incremented by clear (written under __reqsByNameMutex)
+	 */
+	QAtomicInt __runId ;
+
+	/*!
+	 * \brief Number of accepted compositions and coverages quoting a requirement, by requirement id
+	 *
+	 * An expected requirement that is not quoted anymore is removed from the matrix.
+	 */
+	QHash<QString, int> __nbReferencesByReqId ;
+
+	/*!
+	 * \brief Requirements defined several times or covered several times : the kept definition (or coverage)
+	 *        depends on the order of the merge, so the files involved cannot be removed incrementally
+	 */
+	QSet<QString> __conflictingReqIds ;
+
+	/*!
+	 * \brief Requirements changed by the merges and removals since the last computation of the coverage
+	 */
+	QSet<Requirement*> __touchedReqs ;
+
+	/*!
+	 * \brief Files replaced since the last computation of the coverage
+	 */
+	QSet<QString> __updatedFileIds ;
+
+	/*!
+	 * \brief Errors raised while merging the contributions of the files, by id of the contributing file
+	 */
+	QHash<QString, QVector<AnalysisError>> __mergeErrorsByFileId ;
+
+	/*!
+	 * \brief Configuration inconsistencies found while linking the documents, one warning by pair of linked
+	 *        documents (upstream file id, downstream file id)
+	 */
+	QMap<QPair<QString, QString>, AnalysisError> __linkErrorsByFilePair ;
+
+	/*!
+	 * \brief Links between the requirements of a document and the ones of a linked document
+	 */
+	typedef struct
+	{
+		RequirementFileAbstractPtr file;  //!< The linked document
+		int nbLinks;  //!< Number of links between the requirements of both documents
+		QString exampleReqId;  //!< Upstream requirement of one of the links, quoted by the warnings
+	} documentLink_t;
+
+	/*!
+	 * \brief true once the coverage of the whole matrix has been computed (the next computation can be partial)
+	 */
+	bool __isCoverageComputed ;
+
+	/*!
+	 * \brief Number of steps of the running computation of the coverage (requirements and files to compute)
+	 */
+	QAtomicInt __nbCoverageSteps ;
+
+	/*!
+	 * \brief Number of steps of the running computation of the coverage already done
+	 */
+	QAtomicInt __nbCoverageStepsDone ;
+
+	/*!
+	 * \brief Deletes a file object, or asks it to stop and deletes it once its thread has finished
+	 * \param[in] p  the file object, not referenced by the matrix anymore
+	 */
+	void __releaseRequirementFile(RequirementFileAbstractPtr p);
+
+	/*!
+	 * \brief Forgets all the requirements and what has been computed from them (both mutexes must be held)
+	 *
+	 * The requirements are released by another thread unless required, so that clearing a big matrix costs nothing
+	 * to the next run.
+	 * \param[in] p_isInBackground  false to release the requirements before returning
+	 */
+	void __clearRequirements(bool p_isInBackground = true);
+
+	/*!
+	 * \brief Removes a requirement from the matrix and releases it (__reqsByNameMutex must be held)
+	 * \param[in] p_reqId  id of the requirement, known by the matrix
+	 */
+	void __removeRequirement(const QString& p_reqId);
+
+	/*!
+	 * \brief Stores an error raised while merging a file and displays it immediately
+	 * \param[in] p_fileId  id of the file whose contributions raised the error
+	 * \param[in] e         the error
+	 */
+	void __addMergeError(const QString& p_fileId, const AnalysisError& e);
+
+	/*!
+	 * \brief Is a file involved in a redefinition or a multiple coverage (see __conflictingReqIds)
+	 * \param[in] p  the file
+	 * \return true if one of its contributions quotes a conflicting requirement
+	 */
+	bool __hasConflictingContributions(RequirementFileAbstractPtr p) const;
+
+	/*!
+	 * \brief Removes from the matrix everything the merge of a file has brought (both mutexes must be held)
+	 *
+	 * The requirements defined by the file become expected ones (or are removed if nothing quotes them anymore),
+	 * their compositions and coverages are removed and the linked documents forget the file.
+	 * \param[in] p  the file, still registered
+	 */
+	void __removeRequirementFileContributions(RequirementFileAbstractPtr p);
+
+	/*!
+	 * \brief Decrements the number of references of a requirement, and removes it if it is expected and not
+	 *        quoted anymore
+	 * \param[in] p_reqId  id of the requirement
+	 */
+	void __releaseReference(const QString& p_reqId);
+
+	/*!
+	 * \brief Gets the requirements whose consistency or coverage may have changed since the last computation
+	 *
+	 * These are the touched requirements and, transitively, the requirements composed of them and the
+	 * requirements covered by them.
+	 * \return the requirements to be computed again
+	 */
+	QVector<RequirementPtr> __getDirtyRequirements() const;
+
+	/*!
+	 * \brief Builds again the links of a file with its upstream and downstream documents
+	 *
+	 * Every link of a file involves one of its requirements, so they can all be found from them: the file is
+	 * removed from its linked documents, then the links of its requirements are counted by linked document and
+	 * each document is linked once. The configuration inconsistencies found are stored into __linkErrorsByFilePair.
+	 * \param[in] reqFile  the file
+	 */
+	void __computeDocumentLinks(RequirementFileAbstractPtr reqFile);
+
+	/*!
+	 * \brief Checks the configuration of two linked documents and stores the warning if they are not consistent
+	 * \param[in] p_upFile  the upstream document
+	 * \param[in] p_downFile  the downstream document
+	 * \param[in] p_link  links between the requirements of both documents
+	 */
+	void __checkDocumentLink(RequirementFileAbstractPtr p_upFile, RequirementFileAbstractPtr p_downFile,
+	                         const documentLink_t& p_link);
+
+	/*!
+	 * \brief Forgets the configuration inconsistencies of the links of a document
+	 * \param[in] p_fileId  id of the document
+	 */
+	void __removeLinkErrors(const QString& p_fileId);
+
+	/*!
+	 * \brief Gathers all the errors known by the matrix
+	 * \return the parsing errors, then the merge errors, the consistency errors and the links errors
+	 */
+	QVector<AnalysisError> __collectErrors() const;
+
 	/*!
 	 * \brief Builds the string representing the upstream and downstream files of the current one
 	 *
@@ -290,4 +635,13 @@ private:
 
 };
 
+/*!
+ * \typedef MatrixResultsPtr
+ * \brief Shared pointer to the results of the coverage, which cannot be modified anymore
+ */
+typedef QSharedPointer<const ModelSngReqMatrix::results_t> MatrixResultsPtr;
+
+// The results prepared by a worker thread are handed over to the main thread by a queued call
+Q_DECLARE_METATYPE(MatrixResultsPtr)
+
 #endif /* MODELSNGREQMATRIX_H_ */
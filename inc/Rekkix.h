@@ -10,19 +10,28 @@
 
 #include <QApplication>
 #include <QMainWindow>
+#include <QAtomicInt>
 #include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
 
 // Auto-generated ui headers
 #include "ui_Rekkix.h"
 
 // Application headers
+#include "AnalysisQueryServer.h"
+#include "AnalysisWatcher.h"
 #include "ModelConfiguration.h"
 #include "ModelStreamDocuments.h"
 #include "ModelReqsCoveringUpstream.h"
 #include "ModelReqsCoveredDownstream.h"
 #include "ModelCompositeReqs.h"
 #include "ModelReqs.h"
+#include "ModelSngReqMatrix.h"
 #include "ModelConfigurationErrors.h"
+#include "RequirementFileAbstract.h"
 #include "SngSettings.h"
 
 /*!
@@ -56,15 +65,44 @@ public slots :
 
 	/*!
 	 * \brief start the analysis with the loaded configuration file
+	 *
+	 * If an analysis is already running, it is cancelled first (see slt_cancelAnalysis).
 	 */
 	void slt_startAnalysis();
 
+	/*!
+	 * \brief cancel the running analysis, if any
+	 *
+	 * No file is started anymore, the running parsers stop at their next checkpoint and their results are
+	 * ignored (see ModelSngReqMatrix::clear). The method does not wait for the parsers.
+	 */
+	void slt_cancelAnalysis();
+
 	/*!
 	 * \brief this slot is called when a file is selected in the files coverage summary view
 	 * \param[in] p_index  Index selected in the view (needed to identify the selected row)
 	 */
 	void slt_fileCoverageSummary_selected(QModelIndex p_index);
 
+	/*!
+	 * \brief this slot is called when a requirement is double-clicked in the defined or impacted requirements
+	 *        views : the requirements it impacts are displayed (impact analysis)
+	 * \param[in] p_index  Index double-clicked in the view (needed to identify the requirement)
+	 */
+	void slt_requirement_followImpacts(QModelIndex p_index);
+
+	/*!
+	 * \brief displays the requirements impacted by the followed requirement, in the selected direction, from the
+	 *        last analysis (see AnalysisImpactIndex)
+	 */
+	void slt_refreshImpacts();
+
+	/*!
+	 * \brief searches the requirements whose id matches the searched text, as it is typed, in the last analysis
+	 *        (see AnalysisSearchIndex)
+	 */
+	void slt_searchRequirements();
+
 	/*!
 	 * \brief generate the report as specified in the loaded configuration file
 	 */
@@ -83,25 +121,170 @@ public slots :
 
 	/*!
 	 * \brief load a configuration file (from command line), compute analysis and generate reports
+	 *
+	 * If a trace file is given, the timings of the analysis are recorded (see AnalysisTracer), exported
+	 * as a Chrome trace-event JSON file and summarized per file on stdout.
 	 * \param[in] p_filename  file name & path of the file to be loaded
+	 * \param[in] p_traceFilename  file name & path of the trace file to be written, empty for no trace
 	 * \return
 	 * - EXIT_SUCCESS in case everything goes properly
 	 * - EXIT_FAILURE else and errors have been displayed on stderr
 	 */
-	int loadFileAndRunBatch(const char* p_filename);
+	int loadFileAndRunBatch(const char* p_filename, const QString& p_traceFilename = QString());
+
+	/*!
+	 * \brief load several configuration files (from command line), compute their analyses and generate their reports
+	 *
+	 * The configurations usually share most of their documents: every document of every configuration is
+	 * first extracted once, by a single pool of parsing threads (see __extractDocuments), then the
+	 * configurations are analysed one after the other (see loadFileAndRunBatch), their parsers only matching
+	 * their own regular expressions on the shared text (see AnalysisSngTextCache). Only the extraction is shared
+	 * and parallel across the configurations: ModelSngReqMatrix holds a single analysis, so two configurations are
+	 * never analysed at the same time.
+	 * \param[in] p_filenames  file names & paths of the files to be loaded
+	 * \return
+	 * - EXIT_SUCCESS if every configuration has been analysed
+	 * - EXIT_FAILURE else and errors have been displayed
+	 */
+	int loadFilesAndRunBatch(const QStringList& p_filenames);
+
+	/*!
+	 * \brief load a configuration file (from command line), compute analysis and generate reports, then watch the
+	 *        files and update the analysis and the reports each time they change (see slt_setWatchMode)
+	 * \param[in] p_filename  file name & path of the file to be loaded
+	 * \return
+	 * - EXIT_FAILURE if the first analysis cannot be done
+	 * - the exit code of the application once it is stopped else
+	 */
+	int loadFileAndWatch(const char* p_filename);
+
+	/*!
+	 * \brief load a configuration file (from command line), compute analysis, then answer the queries of local
+	 *        clients about it (see AnalysisQueryServer) until the application is stopped
+	 *
+	 * The files are watched (see slt_setWatchMode) and the queries are answered from the last analysis.
+	 * \param[in] p_filename  file name & path of the file to be loaded
+	 * \param[in] p_serverName  name of the local socket the server listens to
+	 * \return
+	 * - EXIT_FAILURE if the first analysis cannot be done or if the server cannot listen
+	 * - the exit code of the application once it is stopped else
+	 */
+	int loadFileAndServe(const char* p_filename, const QString& p_serverName);
+
+	/*!
+	 * \brief slot called at the end of each analysis in server mode : the query server answers from its results
+	 */
+	void slt_publishSnapshot();
+
+	/*!
+	 * \brief enables or disables the watch mode
+	 *
+	 * In watch mode, the configuration file and the configured documents are watched (see AnalysisWatcher):
+	 * - when documents change, only those are parsed again and the matrix is patched (see slt_watchedDocumentsChanged)
+	 * - when the configuration file changes, it is loaded again and a full analysis is done
+	 * \param[in] p_enabled  true to watch the files
+	 */
+	void slt_setWatchMode(bool p_enabled);
+
+	/*!
+	 * \brief slot called in watch mode when documents have changed : they are parsed again and the matrix is patched
+	 *
+	 * If a full analysis is running or has never been done, a full analysis is done instead.
+	 * \param[in] p_fileIds  ids of the changed documents
+	 */
+	void slt_watchedDocumentsChanged(const QStringList& p_fileIds);
+
+	/*!
+	 * \brief slot called in watch mode when the configuration file has changed : it is loaded again and analysed
+	 */
+	void slt_watchedConfigurationChanged();
 
 	/*!
 	 * \brief slot called when a requirement file finished its parsing.
+	 * \param[in] p_runId  analysis run of the file, nothing is done if it is not the current one
 	 */
-	void slt_reqFileParsingOneMoreFileFinished() ;
+	void slt_reqFileParsingOneMoreFileFinished(int p_runId) ;
 
 	/*!
 	 * \brief slot called when all of the requirement files have been parsed (the coverage computation can be performed)
+	 *
+	 * The coverage is computed by a background worker (see __backgroundPool), slt_coverageComputed is called once done.
+	 * \param[in] p_runId  analysis run of the files, nothing is done if it is not the current one
 	 */
-	void slt_reqFileParsingAllFilesFinished() ;
+	void slt_reqFileParsingAllFilesFinished(int p_runId) ;
+
+	/*!
+	 * \brief slot called by the background worker once the coverage has been computed, displays the results
+	 * \param[in] p_runId  analysis run of the files, nothing is done if it is not the current one
+	 * \param[in] p_results  errors and rows of the files prepared by the worker (see ModelSngReqMatrix::createResults)
+	 * \param[in] p_snapshot  results of the analysis built by the worker, null in batch mode
+	 */
+	void slt_coverageComputed(int p_runId, MatrixResultsPtr p_results, AnalysisSnapshotPtr p_snapshot) ;
+
+	/*!
+	 * \brief slot called by the background worker once the reports have been written
+	 * \param[in] p_isComplete  false if the generation has been cancelled before writing every report
+	 * \param[in] p_errors  reasons of the failures of the reports that could not be written
+	 */
+	void slt_reportsGenerated(bool p_isComplete, const QStringList& p_errors) ;
+
+	/*!
+	 * \brief slot called periodically during the parsing to display its progress (see AnalysisSngProgress)
+	 *
+	 * The progress bar (or the progress line in batch mode) is only refreshed here, so the number of updates
+	 * does not depend on the number of files nor on their size.
+	 */
+	void slt_refreshProgress() ;
+
+	/*!
+	 * \brief slot called at a fixed frame rate during the parsing to display the files merged meanwhile and their
+	 *        errors (see ModelSngReqMatrix::publishMergedFiles and ModelSngAnalysisErrors::publishErrors)
+	 */
+	void slt_publishMergedFiles() ;
+
+signals:
+
+	/*!
+	 * \brief signal emitted once the coverage has been computed at the end of an analysis
+	 */
+	void analysisFinished() ;
 
 private:
 
+	/*!
+	 * \brief stops the threads starting and waiting for the parsing threads and resets the number of parsing slots
+	 *
+	 * Both threads check for the interruption at least every few tens of milliseconds. The background work (coverage
+	 * computation, reports) is cancelled too (see __stopBackgroundWork).
+	 */
+	void __stopAnalysisThreads() ;
+
+	/*!
+	 * \brief cancels the coverage computation or the report generation running in __backgroundPool, and waits for it
+	 */
+	void __stopBackgroundWork() ;
+
+	/*!
+	 * \brief starts the parsing of files already registered into ModelSngReqMatrix (full analysis or patch)
+	 * \param[in] p_files  files to be parsed
+	 */
+	void __launchParsing(const QVector<RequirementFileAbstractPtr>& p_files) ;
+
+	/*!
+	 * \brief clears the views of the selected file (they point to requirements of the matrix)
+	 */
+	void __clearSelectedFileModels() ;
+
+	/*!
+	 * \brief extracts once the text of every document of several configurations into AnalysisSngTextCache
+	 *
+	 * The documents are extracted in parallel (as many threads as the parsing threads configured in the settings),
+	 * whatever the configuration they come from. A configuration with significant errors is ignored here: its
+	 * errors are displayed when it is analysed.
+	 * \param[in] p_filenames  file names & paths of the configuration files
+	 */
+	void __extractDocuments(const QStringList& p_filenames) ;
+
 	QApplication * __app;  //!< Application running the window
 	ModelConfiguration __cnfModel;  //!< loaded configuration
 	ModelConfigurationErrors __cnfErrorsModel;  //!< configuration errors detected when loading the configuration file
@@ -111,27 +294,30 @@ private:
 	ModelReqsCoveredDownstream __downstreamCoverageModel; //!< model for downstream requirements
 	ModelCompositeReqs __compositeRequirementsModel; //!< model for composite requirements
 	ModelReqs __requirementsModel; //!< model for requirements of the selected file
+	ModelReqs __impactedRequirementsModel; //!< model for requirements impacted by the followed one
+	ModelReqs __foundRequirementsModel; //!< model for requirements found by the search
+	QString __followedReqId ; //!< Requirement whose impacts are displayed, empty if none
+	AnalysisSnapshotPtr __snapshot ; //!< Results of the last analysis in GUI mode, for the impact analysis
 	bool __isBatchMode ; //!< is the application running in batch mode ? (ie without any GUI)
 	int __nbFiles ; //!< Number of files the analysis is going to take into account (calculated at the beginning of slt_analysis)
+	int __nbParsedFiles ; //!< Number of files already parsed by the current analysis (reset by slt_startAnalysis)
+	QTimer __progressTimer ; //!< Timer triggering slt_refreshProgress while files are being parsed
+	QTimer __resultsFrameTimer ; //!< Timer triggering slt_publishMergedFiles while files are being parsed (GUI mode only)
+	QThreadPool __backgroundPool ; //!< Single worker merging again the files kept by an update, computing the coverage and generating the reports, so that the GUI is not frozen
+	QAtomicInt __isBackgroundWorkCancelled ; //!< Set to stop the work of __backgroundPool (see __stopBackgroundWork)
+	bool __isComputingCoverage ; //!< Is the coverage of the running analysis being computed by __backgroundPool
+	bool __isGeneratingReports ; //!< Are the reports being generated by __backgroundPool
+	int __nbReports ; //!< Number of reports being generated
+	QAtomicInt __nbGeneratedReports ; //!< Number of reports already written by __backgroundPool
+	QString __lastProgressLine ; //!< Last progress line written in batch mode, to avoid writing twice the same one
+	QString __cnfFilePath ; //!< Path of the loaded configuration file
+	AnalysisWatcher __watcher ; //!< Watcher of the files in watch mode
+	bool __isAnalysisRunning ; //!< Is an analysis (full or patch) running
+	bool __hasAnalysisResults ; //!< Does the matrix contain the results of a complete analysis
+	QStringList __reparsedFileIds ; //!< Files being parsed again by the running patch (empty for a full analysis)
+	AnalysisQueryServer* __queryServer ; //!< Server answering the queries in server mode, NULL else
+	QThread __queryServerThread ; //!< Thread of the query server, so that it is not delayed by the analysis
 	QMutex __fileParsingFinishedGuiUpdate ;  //!< Mutex used to protect the GUI update when file parsing is terminated
-
-	/*!
-	 * \brief When building a report, builds the string used for the summary of the report (list of files, errors, ...)
-	 * \param[in] p_writer  writer to be used for string generation (html, csv)
-	 * \param[in] p_delimiter  in case of csv, field delimiter
-	 * \return
-	 * The string representing the summary table according to the required format
-	 */
-	const QString __getReportSummaryTable(const QString& p_writer, const QString& p_delimiter) const;
-
-	/*!
-	 * \brief When building a report, builds the string used for the table of errors (severity, category, location, description)
-	 * \param[in] p_writer  writer to be used for string generation (html, csv)
-	 * \param[in] p_delimiter  in case of csv, field delimiter
-	 * \return
-	 * The string representing the table of errors according to the required format
-	 */
-	const QString __getReportErrorsTable(const QString& p_writer, const QString& p_delimiter) const;
 };
 
 /*!
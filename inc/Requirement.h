@@ -11,6 +11,8 @@
 #include <QString>
 #include <QVector>
 
+#include "AnalysisError.h"
+
 class RequirementFileAbstract;
 
 /*!
@@ -170,6 +172,46 @@ public:
 		__composingReqs.append(p);
 	}
 
+	/*!
+	 * \brief Remove one requirement from the list of requirements composing the current one
+	 * \param[in] p  Pointer to the requirement that must not be stored as a composing requirement anymore
+	 */
+	void removeComposingRequirement(Requirement* p)
+	{
+		__composingReqs.removeOne(p);
+	}
+
+	/*!
+	 * \brief Add one requirement to the list of requirements the current one is composing
+	 *
+	 * This is the reverse link of addComposingRequirement: a requirement may be quoted as composing
+	 * requirement by several others, while its parent (see getParent) is only the last of them
+	 * \param[in] p  Pointer to the requirement composed of the current one
+	 */
+	void addCompositeRequirement(Requirement* p)
+	{
+		__compositeReqs.append(p);
+	}
+
+	/*!
+	 * \brief Remove one requirement from the list of requirements the current one is composing
+	 * \param[in] p  Pointer to the requirement not composed of the current one anymore
+	 */
+	void removeCompositeRequirement(Requirement* p)
+	{
+		__compositeReqs.removeOne(p);
+	}
+
+	/*!
+	 * \brief Getter for the requirements composed of the current one
+	 * \return
+	 * The vector of pointers to requirements the current one is composing
+	 */
+	const QVector<Requirement*>& getCompositeRequirements() const
+	{
+		return (__compositeReqs);
+	}
+
 	/*!
 	 * \brief Add one requirement to the list of upstream requirements for the current one
 	 * \param[in] p  Pointer to the requirement that must be stored as an upstream requirement
@@ -179,6 +221,15 @@ public:
 		__upstreamRequirements.append(p);
 	}
 
+	/*!
+	 * \brief Remove one requirement from the list of upstream requirements for the current one
+	 * \param[in] p  Pointer to the requirement that must not be stored as an upstream requirement anymore
+	 */
+	void removeUpstreamRequirement(Requirement* p)
+	{
+		__upstreamRequirements.removeOne(p);
+	}
+
 	/*!
 	 * \brief Getter for the upstream requirements of the current one
 	 * \return
@@ -232,6 +283,15 @@ public:
 		return (__expectedBy);
 	}
 
+	/*!
+	 * \brief Setter for the expected by location
+	 * \param[in] p  the file id (and requirement) in which this requirement is expected
+	 */
+	void setExpectedBy(const QString& p)
+	{
+		__expectedBy = p;
+	}
+
 	/*!
 	 * \brief Transform the requirement into a string
 	 * \return A QString givin the states of all attributes (for debug purpose)
@@ -251,11 +311,36 @@ public:
 	 * 3. Verify that there is no loop in the composing requirements (A composed of B and C, C composed of D and E, E composed of A and F)
 	 * \return
 	 * - true if there is no error and the requirement is consistent
-	 * - false if there is any inconsistency. In such a case, an AnalysisError has been added to
-	 *   ModelSngAnalysisErrors
+	 * - false if there is any inconsistency. In such a case, an AnalysisError has been stored (see getErrors)
 	 */
 	void computeConsistency() ;
 
+	/*!
+	 * \brief Getter for the errors found by computeConsistency
+	 *
+	 * They are published into ModelSngAnalysisErrors by ModelSngReqMatrix, which may compute the
+	 * consistency of some requirements only (see ModelSngReqMatrix::computeCoverage)
+	 * \return the errors of the requirement
+	 */
+	const QVector<AnalysisError>& getErrors() const
+	{
+		return (__errors);
+	}
+
+	/*!
+	 * \brief Forgets the consistency, the coverage and the errors computed so far
+	 *
+	 * Must be called when the requirement, or any requirement its consistency or its coverage depends on,
+	 * has changed. They are computed again by the next calls to computeConsistency and getCoverage.
+	 */
+	void invalidate()
+	{
+		__coverage = COVERAGE_INVALID_VALUE;
+		__isConsistent = false;
+		__isConsistencyAlreadyCalculated = false;
+		__errors.clear();
+	}
+
 	/*!
 	 * \brief Getter for the consistency (see computeConsistency)
 	 * \return
@@ -372,6 +457,17 @@ private:
 	 * contains the links to the covered requirements
 	 */
 	QVector<Requirement*> __upstreamRequirements;
+
+	/*!
+	 * If the requirement is composing one or more other requirements, this attribute contains the links to them
+	 * (reverse links of __composingReqs)
+	 */
+	QVector<Requirement*> __compositeReqs;
+
+	/*!
+	 * Errors found by the last consistency computation
+	 */
+	QVector<AnalysisError> __errors;
 };
 
 /*!
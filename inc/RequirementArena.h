@@ -0,0 +1,87 @@
+/*!
+ * \file RequirementArena.h
+ * \brief Definition of the class RequirementArena
+ * \date 2016-11-10
+ * \author f.souliers
+ */
+
+#ifndef REQUIREMENTARENA_H_
+#define REQUIREMENTARENA_H_
+
+#include <QVector>
+
+#include "Requirement.h"
+
+/*!
+ * \class RequirementArena
+ * \brief Storage of the requirements of one run of the analysis (see ModelSngReqMatrix)
+ *
+ * The requirements are built in large blocks instead of one heap allocation each, and never move: every link
+ * between requirements is a pointer into the arena. The slots of the requirements removed by the incremental
+ * analyses (watch mode) are reused by the next ones, so the arena does not grow while watching.
+ *
+ * The whole run is released at once by deleting the arena, which ModelSngReqMatrix::clear does in the background.
+ */
+class RequirementArena
+{
+public:
+	/*!
+	 * \brief Constructor of the class, nothing is allocated until the first requirement
+	 */
+	RequirementArena();
+
+	/*!
+	 * \brief Destructor of the class, destroys the requirements then frees the blocks
+	 */
+	virtual ~RequirementArena();
+
+	/*!
+	 * \brief Builds a requirement in the arena
+	 * \param[in] p_r  the requirement to copy
+	 * \return the requirement of the arena, valid until it is destroyed or the arena deleted
+	 */
+	Requirement* create(const Requirement& p_r);
+
+	/*!
+	 * \brief Destroys a requirement of the arena, its slot being reused by the next creation
+	 * \param[in] p_r  a requirement created by this arena
+	 */
+	void destroy(Requirement* p_r);
+
+	/*!
+	 * \brief Getter for the number of requirements living in the arena
+	 * \return the number of created requirements not destroyed yet
+	 */
+	int getNbRequirements() const
+	{
+		return (__nbUsedSlots - __freeSlots.count());
+	}
+
+	/*!
+	 * \brief Getter for the number of blocks allocated by the arena
+	 * \return the number of blocks, each one holding BLOCK_NB_REQUIREMENTS requirements
+	 */
+	int getNbBlocks() const
+	{
+		return (__blocks.count());
+	}
+
+	static const int BLOCK_NB_REQUIREMENTS;  //!< Number of requirements of a block
+
+private:
+	/*!
+	 * \brief Copy is forbidden: the requirements are pointed to by their links
+	 */
+	RequirementArena(const RequirementArena&);
+
+	/*!
+	 * \brief Copy is forbidden: the requirements are pointed to by their links
+	 */
+	RequirementArena& operator=(const RequirementArena&);
+
+	QVector<Requirement*> __blocks;  //!< Blocks of raw memory, the last one being filled
+	int __nbUsedSlots;  //!< Number of slots used so far in the blocks (filled up to that index, in order)
+	QVector<Requirement*> __freeSlots;  //!< Slots of the destroyed requirements, reused first
+};
+
+#endif /* REQUIREMENTARENA_H_ */
@@ -8,11 +8,15 @@
 #ifndef REQUIREMENTFILEABSTRACT_H_
 #define REQUIREMENTFILEABSTRACT_H_
 
+#include <QElapsedTimer>
+#include <QStringList>
 #include <QThread>
 #include <QVector>
 #include <QRegularExpression>
 #include <QRegularExpressionMatch>
 
+#include "AnalysisError.h"
+#include "AnalysisTracer.h"
 #include "ModelConfiguration.h"
 #include "Requirement.h"
 
@@ -37,12 +41,40 @@
  * <i>Blah blah blah</i>  is the real description of the requirement. By now, Rekkix does not interpret at all this
  * part of the file and will start interpreting a new requirement when the requirement regex
  * (see ModelConfiguration::REQFILE_ATTR_REQREGEX) matches again.
+ *
+ * The parsing does not write into the global matrix: each match is recorded as a «contribution» of the file
+ * (see getContributions), as well as the parsing errors. Both are merged into ModelSngReqMatrix once the file
+ * is parsed (see ModelSngReqMatrix::mergeRequirementFile), and can be merged again later without parsing the
+ * file again (watch mode, see Rekkix::slt_watchedDocumentsChanged).
  */
 class RequirementFileAbstract : public QThread
 {
 	Q_OBJECT
 
 public:
+	/*!
+	 * \brief Kinds of contributions of a file to the global matrix
+	 */
+	typedef enum e_contributionKind
+	{
+		Definition,  //!< reqId is defined in the file
+		Composition,  //!< reqId is composed of refId
+		Coverage  //!< reqId covers refId
+	} ContributionKind;
+
+	/*!
+	 * \brief One contribution of a file to the global matrix, in the order of the document
+	 */
+	typedef struct
+	{
+		ContributionKind kind;  //!< Kind of the contribution
+		QString location;  //!< Location used for the expected requirement and the errors ("file id / req id")
+		QString reqId;  //!< Current requirement of the document
+		QString refId;  //!< Referenced requirement (Composition and Coverage only)
+		QString part;  //!< Part of the document the contribution comes from, given to the errors (relative path of
+		               //!< a file of a tree, see RequirementFile_tree), empty for the other documents
+	} contribution_t;
+
 	/*!
 	 * \brief Constructor for the non pure abstract part of the class
 	 * \param[in]  p_cnfFile   Map of the configuration attributes for this particular file.
@@ -60,23 +92,64 @@ public:
 	/*!
 	 * \brief method called by Rekkix internals to parse a file containing requirements
 	 *
-	 * This methods must call several methods of ModelSngReqMatrix to load the requirements
-	 * that have been identified during parsing.
+	 * The parsing is made of two steps:
+	 * - the extraction of the text units of the document (lines, paragraphs), specific to each format (see
+	 *   _extractTextUnits), which does not depend on the configured regular expressions. It is shared with the
+	 *   other analyses through AnalysisSngTextCache (see loadTextUnits)
+	 * - the matching of the regular expressions on each unit, common to every format (see _matchTextUnits)
+	 */
+	virtual void parseFile();
+
+	/*!
+	 * \brief Format of the text units extracted by the parser, identifying them in AnalysisSngTextCache
 	 *
-	 * \see RequirementFile_docx for examples of implementation of this method
+	 * Its version number must be incremented each time _extractTextUnits changes the units it gives for a same
+	 * document, so that the units extracted by the previous versions are not used anymore.
+	 * \return the format, for example "docx-1" (only made of characters allowed in a file name), or an empty string
+	 * if the units must not be shared (see RequirementFile_tree)
 	 */
-	virtual void parseFile() = 0;
+	virtual QString getTextUnitsFormat() const = 0;
+
+	/*!
+	 * \brief Gives the text units of the file, extracting them only if they are not known by AnalysisSngTextCache
+	 * \param[out] p_units  the text units, in the order of the document
+	 * \return false if the text could not be extracted (errors have been recorded) or the parsing has been cancelled
+	 */
+	bool loadTextUnits(QStringList& p_units);
+
+	/*!
+	 * \brief Tells whether the parser may stop extracting the document before its end (see RequirementFile_pdf)
+	 *
+	 * Extracting the whole text of such a document beforehand (see Rekkix::__extractDocuments) would cost more
+	 * than its parsing.
+	 * \return true if the extraction stops with the parsing, false by default
+	 */
+	virtual bool isExtractedIncrementally() const
+	{
+		return (false);
+	}
 
 	/*!
 	 * \brief method called to run the parsing into a dedicated thread.
 	 *
-	 * It only calls parseFile that must be defined by each subclass and send a signal to inform that the
-	 * parsing of the file is terminated
+	 * It only calls parseFile and send a signal to inform that the
+	 * parsing of the file is terminated. Whatever the parser reported, the whole file is counted as processed
+	 * once parseFile returns (errors, stopafter_regex ...), unless the analysis has been cancelled.
 	 */
 	void run() Q_DECL_OVERRIDE
 	{
-		parseFile() ;
-		emit parsingFinished() ;
+		clearParsingResults() ;
+		_progressReportedBytes = 0 ;
+		_isTextExtracted = true ;
+		QElapsedTimer timer ;
+		timer.start() ;
+		{
+			AnalysisTraceScope ts("parse", AnalysisTracer::CATEGORY_FILE, getFileId());
+			parseFile() ;
+		}
+		_parsingDurationUs = timer.nsecsElapsed() / 1000 ;
+		_reportProgress(1, 1) ;
+		emit parsingFinished(_runId) ;
 	}
 
 	/*!
@@ -118,6 +191,33 @@ public:
 		return (_cnfFile[ModelConfiguration::REQFILE_ATTR_ID]);
 	}
 
+	/*!
+	 * \brief getter for the size of the file, which is its weight in the progress of the analysis
+	 * \return the size of the file in bytes (0 if the file does not exist)
+	 */
+	qint64 getFileSize() const
+	{
+		return (_fileSizeBytes);
+	}
+
+	/*!
+	 * \brief getter for the duration of the last parsing of the file in its thread, measured by run
+	 * \return the duration in microseconds, 0 if the file has never been parsed in its thread
+	 */
+	qint64 getParsingDuration() const
+	{
+		return (_parsingDurationUs);
+	}
+
+	/*!
+	 * \brief Tells whether the last parsing of the file has extracted its text (see AnalysisSngScheduler)
+	 * \return false if the text has been read from AnalysisSngTextCache
+	 */
+	bool isTextExtracted() const
+	{
+		return (_isTextExtracted);
+	}
+
 	/*!
 	 * \brief getter for the attribute ModelConfiguration::REQFILE_ATTR_PATH
 	 * \return the file absolute path of this file as configured in the configuration file
@@ -195,6 +295,25 @@ public:
 		return (_downstreamDocs);
 	}
 
+	/*!
+	 * \brief Forgets a document, whether it is an upstream or a downstream document of this file
+	 * \param[in] p_fileId  Unique ID of the file
+	 */
+	void removeLinkedDocument(const QString& p_fileId)
+	{
+		_upstreamDocs.remove(p_fileId) ;
+		_downstreamDocs.remove(p_fileId) ;
+	}
+
+	/*!
+	 * \brief Forgets all the upstream and downstream documents of this file
+	 */
+	void clearLinkedDocuments()
+	{
+		_upstreamDocs.clear() ;
+		_downstreamDocs.clear() ;
+	}
+
 	/*!
 	 * \brief Getter of the current value of the coverage for this file
 	 * \return The last known value for the average coverage calculated for this file
@@ -228,6 +347,64 @@ public:
 		return (_requirements);
 	}
 
+	/*!
+	 * \brief Getter for the contributions recorded by the last parsing of the file
+	 * \return the contributions, in the order of the document
+	 */
+	const QVector<contribution_t>& getContributions() const
+	{
+		return (_contributions);
+	}
+
+	/*!
+	 * \brief Getter for the errors raised by the last parsing of the file
+	 * \return the errors, in the order they have been raised
+	 */
+	const QVector<AnalysisError>& getParsingErrors() const
+	{
+		return (_parsingErrors);
+	}
+
+	/*!
+	 * \brief Forgets the contributions and errors of the previous parsing
+	 */
+	void clearParsingResults()
+	{
+		_contributions.clear() ;
+		_parsingErrors.clear() ;
+	}
+
+	/*!
+	 * \brief Forgets what has been computed from the global matrix (requirements, linked documents, coverage)
+	 *
+	 * Used before merging the contributions of the file again (see ModelSngReqMatrix::mergeRequirementFile).
+	 */
+	void clearAnalysisResults()
+	{
+		_requirements.clear() ;
+		_upstreamDocs.clear() ;
+		_downstreamDocs.clear() ;
+		_avgCoverage = 0.0 ;
+	}
+
+	/*!
+	 * \brief Setter for the identifier of the analysis run the file belongs to (see ModelSngReqMatrix::addRequirementFile)
+	 * \param[in] p_runId  identifier of the run
+	 */
+	void setRunId(int p_runId)
+	{
+		_runId = p_runId ;
+	}
+
+	/*!
+	 * \brief Getter for the identifier of the analysis run the file belongs to
+	 * \return the identifier of the run
+	 */
+	int getRunId() const
+	{
+		return (_runId) ;
+	}
+
 	/*!
 	 * \brief setter for the _threadLaunched flag
 	 */
@@ -250,8 +427,9 @@ public:
 signals:
 	/*!
 	 * \brief Signal emitted when the thread has finished to parse its associated file.
+	 * \param[in] p_runId  identifier of the analysis run the file belongs to, so a superseded run can be ignored
 	 */
-	void parsingFinished() ;
+	void parsingFinished(int p_runId) ;
 
 protected:
 	/*!
@@ -320,18 +498,127 @@ protected:
 	 */
 	bool _threadLaunched ;
 
+	/*!
+	 * \brief identifier of the analysis run the file belongs to, checked by ModelSngReqMatrix when merging the file
+	 */
+	int _runId ;
+
+	/*!
+	 * \brief contributions recorded by the last parsing of the file
+	 */
+	QVector<contribution_t> _contributions ;
+
+	/*!
+	 * \brief errors raised by the last parsing of the file
+	 */
+	QVector<AnalysisError> _parsingErrors ;
+
+	/*!
+	 * \brief size of the file in bytes, read when the object is built (see RequirementFile_tree for a tree)
+	 */
+	qint64 _fileSizeBytes ;
+
+	/*!
+	 * \brief part of _fileSizeBytes already reported to AnalysisSngProgress
+	 */
+	qint64 _progressReportedBytes ;
+
+	/*!
+	 * \brief duration of the last parsing of the file in its thread, in microseconds (see AnalysisSngScheduler)
+	 */
+	qint64 _parsingDurationUs ;
+
+	/*!
+	 * \brief has the text been extracted by the last parsing, rather than read from AnalysisSngTextCache ?
+	 */
+	bool _isTextExtracted ;
+
+	/*!
+	 * \brief number of lines / paragraphs parsed between two calls to _reportProgress
+	 */
+	static const int PROGRESS_STEP = 64 ;
+
+	/*!
+	 * \brief Reports the progress of the parsing of the file to AnalysisSngProgress
+	 *
+	 * The parsers use their own units (lines, paragraphs, pages, bytes ...): only the ratio
+	 * p_done / p_total matters, it is converted into a number of bytes of the file. Only the increase since
+	 * the previous call is published, with a lock-free operation, so this method can be called often.
+	 * \param[in] p_done   work done so far, in the unit of the parser
+	 * \param[in] p_total  whole work, in the same unit (must be strictly positive)
+	 */
+	void _reportProgress(qint64 p_done, qint64 p_total) ;
+
+	/*!
+	 * \brief Cancellation checkpoint, to be called by the parsers in their loops (lines, paragraphs, pages)
+	 *
+	 * The analysis is cancelled by QThread::requestInterruption (see Rekkix::slt_cancelAnalysis), the parser must
+	 * then stop as soon as possible: its results will not be used anyway.
+	 * \return true if the parsing must stop
+	 */
+	bool _isCancelled() const
+	{
+		return (isInterruptionRequested()) ;
+	}
+
+	/*!
+	 * \brief Extracts the text units of the file, the parts of the document on which the regular expressions are
+	 *        matched one by one (lines, paragraphs)
+	 *
+	 * This method must be defined by each format. The extraction counts for the first half of the progress of the
+	 * file (see _reportProgress), the matching for the second one. It must only depend on the content of the file,
+	 * never on the configured regular expressions: the units are shared between the analyses.
+	 * \param[out] p_units  the text units, in the order of the document
+	 * \return false if the text could not be extracted (errors must be recorded with _addParsingError)
+	 * \see RequirementFile_docx for examples of implementation of this method
+	 */
+	virtual bool _extractTextUnits(QStringList& p_units) = 0;
+
+	/*!
+	 * \brief Matches the regular expressions on the text units of the file and records the contributions
+	 * \param[in] p_units  the text units, in the order of the document
+	 */
+	void _matchTextUnits(const QStringList& p_units);
+
+	/*!
+	 * \brief Matches the regular expressions on one text unit
+	 *
+	 * This method only reads the compiled regular expressions: several threads can use it at the same time on
+	 * different documents, each one with its own state and contributions (see RequirementFile_tree).
+	 * \param[in] p_unit  the text unit
+	 * \param[in] p_location  location of the document in the contributions (usually the file id)
+	 * \param[inout] p_currentReq  current requirement of the document, updated if the unit defines a new one
+	 * \param[inout] p_isCurrentReqAcceptable  true once a requirement has been identified in the document
+	 * \param[inout] p_contributions  contributions of the document, the ones of the unit are appended
+	 * \return false if the stopafter_regex matched: the following units of the document must be ignored
+	 */
+	bool _matchTextUnit(const QString& p_unit, const QString& p_location, QString& p_currentReq,
+	                    bool& p_isCurrentReqAcceptable, QVector<contribution_t>& p_contributions) const;
+
+	/*!
+	 * \brief Records an error raised while parsing the file, published with the contributions of the file
+	 * \param[in] p_e  the error
+	 */
+	void _addParsingError(const AnalysisError& p_e)
+	{
+		_parsingErrors.append(p_e) ;
+	}
+
 	/*!
 	 * \brief Checks if the text matches the req_regex
 	 * \param[in] p_text  Text to be checked
 	 * \param[out] p_reqfound  If the regex matches, then it contains the requirement identified.
 	 *                         If the regex doesn't match, it contains an empty string
-	 * \param[out] p_reqAcceptable  true if the identified requirement has been accepted by the matrix,
-	 *                              false if the global matrix rejected the requirement
+	 * \param[out] p_reqAcceptable  true if a requirement has been identified (the global matrix may still
+	 *                              reject it when the file is merged, see ModelSngReqMatrix::mergeRequirementFile)
+	 * \param[inout] p_contributions  contributions the definition is appended to
+	 * \param[in] p_location  location of the document (usually the file id)
 	 * \return
 	 * - true if the regex matched
 	 * - false else
 	 */
-	bool _hasStoredAnyRequirementDefinition(const QString& p_text, QString& p_reqfound, bool& p_reqAcceptable);
+	bool _hasStoredAnyRequirementDefinition(const QString& p_text, QString& p_reqfound, bool& p_reqAcceptable,
+	                                        QVector<contribution_t>& p_contributions, const QString& p_location) const;
 
 	/*!
 	 * \brief Checks if the text matches the cmp_regex
@@ -342,11 +629,14 @@ protected:
 	 * \param[in] p_text  Text to be checked
 	 * \param[in] p_parentReqId  The requirement id of the parent of the composite requirements that are going
 	 *                       to be stored
+	 * \param[inout] p_contributions  contributions the composing requirements are appended to
+	 * \param[in] p_location  location of the document (usually the file id)
 	 * \return
 	 * - true if the regex matched
 	 * - false else
 	 */
-	bool _hasStoredAnyExpectedCompositeRequirements(const QString& p_text, const QString& p_parentReqId);
+	bool _hasStoredAnyExpectedCompositeRequirements(const QString& p_text, const QString& p_parentReqId,
+	                                                QVector<contribution_t>& p_contributions, const QString& p_location) const;
 
 	/*!
 	 * \brief Checks if the text matches the cov_regex
@@ -356,11 +646,14 @@ protected:
 	 * ModelSngReqMatrix handles it)
 	 * \param[in] p_text  Text to be checked
 	 * \param[in] p_currentReqId  The current requirement id (it means the one covering the upstream requirements)
+	 * \param[inout] p_contributions  contributions the covered requirements are appended to
+	 * \param[in] p_location  location of the document (usually the file id)
 	 * \return
 	 * - true if the regex matched
 	 * - false else
 	 */
-	bool _hasStoredAnyExpectedUpstreamRequirements(const QString& p_text, const QString& p_currentReqId) ;
+	bool _hasStoredAnyExpectedUpstreamRequirements(const QString& p_text, const QString& p_currentReqId,
+	                                               QVector<contribution_t>& p_contributions, const QString& p_location) const ;
 
 	/*!
 	 * \brief checks whether the "Stop After" regex has been reached
@@ -369,7 +662,7 @@ protected:
 	 * - true if the regex matched
 	 * - false else
 	 */
-	bool _mustStopParsing(const QString& p_text) ;
+	bool _mustStopParsing(const QString& p_text) const ;
 };
 
 /*!
@@ -34,9 +34,16 @@ public:
 	virtual ~RequirementFile_docx();
 
 	/*!
-	 * \brief Parse the docx file and call the methods of ModelSngReqMatrix to store the requirements found
+	 * \brief Format of the units extracted from docx files (see RequirementFileAbstract::getTextUnitsFormat)
 	 */
-	void parseFile();
+	QString getTextUnitsFormat() const;
+
+protected:
+
+	/*!
+	 * \brief Extracts the paragraphs of the docx file (see RequirementFileAbstract::_extractTextUnits)
+	 */
+	bool _extractTextUnits(QStringList& p_units);
 
 };
 
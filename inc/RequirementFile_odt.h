@@ -36,9 +36,16 @@ public:
 	virtual ~RequirementFile_odt();
 
 	/*!
-	 * \brief Parse the odt file and call the methods of ModelSngReqMatrix to store the requirements found
+	 * \brief Format of the units extracted from odt files (see RequirementFileAbstract::getTextUnitsFormat)
 	 */
-	void parseFile();
+	QString getTextUnitsFormat() const;
+
+protected:
+
+	/*!
+	 * \brief Extracts the paragraphs of the odt file (see RequirementFileAbstract::_extractTextUnits)
+	 */
+	bool _extractTextUnits(QStringList& p_units);
 
 private:
 
@@ -10,9 +10,18 @@
 
 #include "RequirementFileAbstract.h"
 
+namespace poppler
+{
+	class document;
+}
+
 /*!
  * \class RequirementFile_pdf
  * \brief Implements the RequirementFileAbstract interface for pdf files
+ *
+ * Only the pages of the attribute ModelConfiguration::REQFILE_ATTR_PAGES are extracted. Pdf documents are often
+ * long and only partly analysed (appendices ...): when a stopafter_regex is configured, each page is matched as soon
+ * as it is extracted, so that poppler stops at the page where the regex matches (see parseFile).
  */
 class RequirementFile_pdf : public RequirementFileAbstract
 {
@@ -21,7 +30,7 @@ class RequirementFile_pdf : public RequirementFileAbstract
 public:
 
 	/*!
-	 * \brief Constructor of the class, does nothing special
+	 * \brief Constructor of the class, reads the range of pages to parse
 	 * \param[in] p_cnfFile Map of the attributes configured for this file (ID, path of the file ...)
 	 */
 	RequirementFile_pdf(const ModelConfiguration::CnfFileAttributesMap_t& p_cnfFile);
@@ -32,11 +41,52 @@ public:
 	virtual ~RequirementFile_pdf();
 
 	/*!
-	 * \brief Parse the pdf file and call the methods of ModelSngReqMatrix to store the requirements found
+	 * \brief Format of the units extracted from pdf files (see RequirementFileAbstract::getTextUnitsFormat)
+	 *
+	 * The range of pages is part of the format: the units of two ranges of a same document are different.
+	 */
+	QString getTextUnitsFormat() const;
+
+	/*!
+	 * \brief Parses the pdf file (see RequirementFileAbstract::parseFile)
+	 *
+	 * Without stopafter_regex, the whole text is extracted then matched. Else, unless the text is already known by
+	 * AnalysisSngTextCache, the pages are matched one by one as they are extracted and the extraction stops at the
+	 * page where the regex matches; the text is then only shared if every page has been extracted.
 	 */
 	void parseFile();
 
+	/*!
+	 * \brief True if a stopafter_regex is configured (see RequirementFileAbstract::isExtractedIncrementally)
+	 */
+	bool isExtractedIncrementally() const;
+
+protected:
+
+	/*!
+	 * \brief Extracts the lines of the pdf file (see RequirementFileAbstract::_extractTextUnits)
+	 */
+	bool _extractTextUnits(QStringList& p_units);
+
+private:
+
+	/*!
+	 * \brief Opens the pdf file
+	 * \return the document, to be deleted by the caller, or NULL if the file cannot be opened (the error is recorded)
+	 */
+	poppler::document* __openDocument();
+
+	/*!
+	 * \brief Extracts the lines of the configured pages, optionally matching each page once it is extracted
+	 * \param[in] p_pdfDoc  the opened document
+	 * \param[out] p_units  the lines of the extracted pages
+	 * \param[in] p_isMatching  true to match the lines of each page before extracting the next one
+	 * \return true if every configured page has been extracted, false if the extraction stopped before
+	 */
+	bool __extractPages(poppler::document* p_pdfDoc, QStringList& p_units, bool p_isMatching);
 
+	int __firstPage;  //!< First page to parse, from 1 (see ModelConfiguration::REQFILE_ATTR_PAGES)
+	int __lastPage;  //!< Last page to parse, -1 for the last page of the document
 };
 
 #endif /* REQUIREMENTFILEPDF_H_ */
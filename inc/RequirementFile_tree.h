@@ -0,0 +1,183 @@
+/*!
+ * \file RequirementFile_tree.h
+ * \brief Definition of the class RequirementFile_tree
+ * \date 2016-11-08
+ * \author f.souliers
+ */
+
+#ifndef REQUIREMENTFILETREE_H_
+#define REQUIREMENTFILETREE_H_
+
+#include <QAtomicInteger>
+
+#include "RequirementFileAbstract.h"
+
+/*!
+ * \class RequirementFile_tree
+ * \brief Implements the RequirementFileAbstract interface for a whole tree of plain text files (source code ...)
+ *
+ * The path of the file is then either:
+ * - a directory: every file of the directory and of its subdirectories
+ * - a glob pattern on the relative path of the files: <i>*</i> and <i>?</i> match within a directory,
+ *   <i>**</i> across directories, <i>[abc]</i> one of the characters and <i>{cpp,h}</i> one of the alternatives,
+ *   for example ./src/**.{cpp,h}. The pattern begins with the first element of the path containing one of these
+ *   characters, the directories before it are the root of the tree
+ *
+ * The hidden files and directories are ignored, as well as the symbolic links to directories.
+ *
+ * The whole tree is one document of the analysis (one id, one coverage), its files being parsed as plain text
+ * files. The contributions and the errors are located on the tree (the file id), the path of the file they come
+ * from being an argument of the errors (see RequirementFileAbstract::contribution_t).
+ *
+ * Thousands of tiny files would cost much more in threads and compiled regular expressions than in parsing
+ * (see RequirementFile_txt): the directories are walked in parallel by the parsing thread of the tree (building
+ * the object costs nothing, its size is only known once parsed), then the files are split into batches of
+ * consecutive files. The batches are parsed by the thread of the tree, helped by the parsing slots the analysis
+ * leaves idle (see AnalysisSngStarterThread::borrowSlots), all of them sharing the regular expressions of the
+ * tree (see RequirementFileAbstract::_matchTextUnit).
+ */
+class RequirementFile_tree : public RequirementFileAbstract
+{
+	Q_OBJECT
+
+	friend class TreeBatchTask;
+
+public:
+
+	/*!
+	 * \brief Constructor of the class, does not list the files of the tree yet
+	 * \param[in] p_cnfFile Map of the attributes configured for this file (ID, path of the tree ...)
+	 */
+	RequirementFile_tree(const ModelConfiguration::CnfFileAttributesMap_t& p_cnfFile);
+
+	/*!
+	 * \brief Destructor of the class, does nothing
+	 */
+	virtual ~RequirementFile_tree();
+
+	/*!
+	 * \brief Empty format: a tree changes without its path changing, its text is not shared through
+	 *        AnalysisSngTextCache (see RequirementFileAbstract::getTextUnitsFormat)
+	 */
+	QString getTextUnitsFormat() const;
+
+	/*!
+	 * \brief Parses the files of the tree by batches (see RequirementFileAbstract::parseFile)
+	 */
+	void parseFile();
+
+	/*!
+	 * \brief Getter for the number of files of the tree
+	 * \return the number of files listed by the last parsing
+	 */
+	int getNbFiles() const
+	{
+		return (__files.count());
+	}
+
+	/*!
+	 * \brief Tells whether a configured path is a tree rather than a single file
+	 * \param[in] p_path  absolute path, as configured (see ModelConfiguration::REQFILE_ATTR_PATH)
+	 * \return true if the path is a directory, or a glob pattern not naming an existing file
+	 */
+	static bool isTreePath(const QString& p_path);
+
+	/*!
+	 * \brief Root directory of a tree, the part of its path before the first glob character
+	 * \param[in] p_path  absolute path of the tree
+	 * \return the path of the directory
+	 */
+	static QString getRootDirectory(const QString& p_path);
+
+	/*!
+	 * \brief Lists the files of a tree, walking its directories in parallel
+	 * \param[in] p_path  absolute path of the tree
+	 * \return the absolute paths of the files, sorted
+	 */
+	static QStringList listFiles(const QString& p_path);
+
+protected:
+
+	/*!
+	 * \brief Extracts the lines of all the files of the tree, one after the other
+	 *        (see RequirementFileAbstract::_extractTextUnits)
+	 *
+	 * Only used when the text of the whole tree is needed at once: parseFile matches the files by batches instead.
+	 */
+	bool _extractTextUnits(QStringList& p_units);
+
+private:
+
+	/*!
+	 * \brief One file of the tree
+	 */
+	typedef struct
+	{
+		QString path;  //!< Absolute path of the file
+		QString relativePath;  //!< Path of the file from the root of the tree
+		qint64 size;  //!< Size of the file in bytes
+	} file_t;
+
+	/*!
+	 * \brief What the parsing of a batch of files gives, merged into the file once every batch is done
+	 */
+	typedef struct
+	{
+		QVector<contribution_t> contributions;  //!< Contributions of the files of the batch, in their order
+		QVector<AnalysisError> errors;  //!< Errors raised by the files of the batch
+	} batchResult_t;
+
+	/*!
+	 * \brief Batches of a parsing, taken one after the other by the threads parsing the tree
+	 */
+	typedef struct
+	{
+		QVector<int> bounds;  //!< Index of the first file of each batch, followed by the number of files
+		QVector<batchResult_t> results;  //!< Result of each batch
+		QAtomicInt nextBatch;  //!< Index of the next batch to be parsed
+		QAtomicInteger<qint64> parsedBytes;  //!< Size of the parsed files, for the progress
+	} batches_t;
+
+	/*!
+	 * \brief Walks the directories of a tree in parallel
+	 * \param[in] p_path  absolute path of the tree
+	 * \return the files of the tree, sorted by path
+	 */
+	static QVector<file_t> __listFiles(const QString& p_path);
+
+	/*!
+	 * \brief Lists the files of the tree, at the beginning of each parsing, and corrects its size in the progress
+	 *        of the analysis
+	 */
+	void __walk();
+
+	/*!
+	 * \brief Reads the content of a file of the tree
+	 * \param[in] p_file  the file
+	 * \param[out] p_text  the content of the file
+	 * \param[out] p_errors  the error is appended here if the file cannot be read
+	 * \return false if the file cannot be read
+	 */
+	bool __readFile(const file_t& p_file, QString& p_text, QVector<AnalysisError>& p_errors) const;
+
+	/*!
+	 * \brief Parses a batch of consecutive files, called by the workers at the same time on different batches
+	 * \param[in] p_begin  index of the first file of the batch
+	 * \param[in] p_end  index following the last file of the batch
+	 * \param[out] p_result  contributions and errors of the batch
+	 * \param[inout] p_parsedBytes  size of the parsed files, shared by the workers for the progress
+	 */
+	void __parseBatch(int p_begin, int p_end, batchResult_t& p_result, QAtomicInteger<qint64>& p_parsedBytes) const;
+
+	/*!
+	 * \brief Parses the next batch not taken yet by another thread
+	 * \param[inout] p_batches  batches of the parsing
+	 * \return false if every batch has been taken
+	 */
+	bool __parseNextBatch(batches_t& p_batches) const;
+
+	QVector<file_t> __files;  //!< Files of the tree, sorted by path
+	int __nbWorkers;  //!< Maximum number of threads parsing the batches (see SngSettings::getNbParsingThreads)
+};
+
+#endif /* REQUIREMENTFILETREE_H_ */
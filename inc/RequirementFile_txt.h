@@ -32,9 +32,16 @@ public:
 	virtual ~RequirementFile_txt();
 
 	/*!
-	 * \brief Parse the txt file and call the methods of ModelSngReqMatrix to store the requirements found
+	 * \brief Format of the units extracted from txt files (see RequirementFileAbstract::getTextUnitsFormat)
 	 */
-	void parseFile();
+	QString getTextUnitsFormat() const;
+
+protected:
+
+	/*!
+	 * \brief Extracts the lines of the txt file (see RequirementFileAbstract::_extractTextUnits)
+	 */
+	bool _extractTextUnits(QStringList& p_units);
 
 
 };
@@ -44,6 +44,17 @@ public:
 	 */
 	static const QString key_parsingThreadsNum ;
 
+	/*!
+	 * \brief Name of the key for the cache on disk of the text extracted from the documents. Disabled by default, the
+	 *        documents are then not copied outside of their directory unless the user asks for it (see UiSettings)
+	 */
+	static const QString key_textCacheEnabled ;
+
+	/*!
+	 * \brief Name of the key for the size of the cache on disk of the extracted text, in MB. 512 by default
+	 */
+	static const QString key_textCacheMaxSizeMB ;
+
 	/*!
 	 * \brief Value of the current application version
 	 */
@@ -54,6 +65,16 @@ public:
 	 */
 	static const int value_nbParsingThreadsDefault ;
 
+	/*!
+	 * \brief Default use of the cache on disk of the extracted text
+	 */
+	static const bool value_textCacheEnabledDefault ;
+
+	/*!
+	 * \brief Default size of the cache on disk of the extracted text, in MB
+	 */
+	static const int value_textCacheMaxSizeMBDefault ;
+
 	/*!
 	 * \brief getter for the number of parsing threads to be used
 	 */
@@ -78,6 +99,41 @@ public:
 		__settings.endGroup() ;
 	}
 
+	/*!
+	 * \brief getter for the use of the cache on disk of the text extracted from the documents (see AnalysisSngTextCache)
+	 */
+	bool isTextCacheEnabled()
+	{
+		__settings.beginGroup(section_general) ;
+		bool val = __settings.value(key_textCacheEnabled, value_textCacheEnabledDefault).toBool() ;
+		__settings.endGroup() ;
+
+		return(val) ;
+	}
+
+	/*!
+	 * \brief setter for the use of the cache on disk of the text extracted from the documents
+	 */
+	void setTextCacheEnabled(bool p_enabled)
+	{
+		__settings.beginGroup(section_general) ;
+		__settings.setValue(key_textCacheEnabled, p_enabled) ;
+		__settings.endGroup() ;
+	}
+
+	/*!
+	 * \brief getter for the size over which the oldest entries of the cache on disk of the extracted text are removed
+	 * \return the size in bytes
+	 */
+	qint64 getTextCacheMaxSize()
+	{
+		__settings.beginGroup(section_general) ;
+		int val = __settings.value(key_textCacheMaxSizeMB, value_textCacheMaxSizeMBDefault).toInt() ;
+		__settings.endGroup() ;
+
+		return(qint64(val) * 1024 * 1024) ;
+	}
+
 private:
 	SngSettings();
 
@@ -27,11 +27,8 @@ win32 {
 # The widgets component has to be loaded
 QT += core widgets xml
 
-# Folders used for dependencies
-DEPENDPATH += ./src ./inc
-
-# Included folders at compile time
-INCLUDEPATH += ./inc ./ui_inc
+# Included folders at compile time (core folders are added by rekkix_core.pri)
+INCLUDEPATH += ./ui_inc
 
 # Preprocessor defines (-D directives)
 DEFINES += APP_VERSION=\\\"$$VERSION\\\"
@@ -39,13 +36,6 @@ DEFINES += APP_VERSION=\\\"$$VERSION\\\"
 CONFIG(debug, debug|release):DEFINES -= QT_NO_DEBUG_OUTPUT
 CONFIG(release, debug|release):DEFINES += QT_NO_DEBUG_OUTPUT 
 
-# Third party library : libzip & libpoppler
-win32:INCLUDEPATH += ./win32_libs/libzip-1.1.3/inc/ ./win32_libs/poppler-0.45/include/poppler/cpp/
-win32:LIBS += -L./win32_libs/libzip-1.1.3/lib/ -L./win32_libs/poppler-0.45/bin/ C:/Qt/Tools/mingw530_32/i686-w64-mingw32/lib/libiconv.a
-unix:INCLUDEPATH += /usr/include/poppler/cpp/
-LIBS += -lzip -lz -lpoppler-cpp 
-
-
 # all objects are generated at the same place
 OBJECTS_DIR = ./obj
 
@@ -65,65 +55,18 @@ macx:DESTDIR = ./bin/macx
 
 
 
-# Resources file
-RESOURCES = ./resources/rekkix.qrc
+# Analysis engine, report generation and third party libraries
+include(./rekkix_core.pri)
 
 # user interface files
 FORMS += ./ui/Rekkix.ui \
          ./ui/Settings.ui
 
-# headers
-HEADERS += ./inc/AnalysisError.h \
-           ./inc/AnalysisSngStarterThread.h \
-           ./inc/AnalysisSngWaiterThread.h \
-           ./inc/FactoryReportBaseString.h \
-           ./inc/FactoryRequirementFile.h \
-           ./inc/ModelCompositeReqs.h \
-           ./inc/ModelConfiguration.h \
-           ./inc/ModelConfigurationErrors.h \
-           ./inc/ModelReqs.h \
-           ./inc/ModelReqsCoveredDownstream.h \
-           ./inc/ModelReqsCoveringUpstream.h \
-           ./inc/ModelSngAnalysisErrors.h \
-           ./inc/ModelSngReqMatrix.h \
-           ./inc/ModelStreamDocuments.h \
-           ./inc/Rekkix.h \
-           ./inc/Requirement.h \
-           ./inc/RequirementFile_docx.h \ 
-           ./inc/RequirementFile_odt.h \ 
-           ./inc/RequirementFile_pdf.h \ 
-           ./inc/RequirementFile_txt.h \
-           ./inc/RequirementFileAbstract.h \
-           ./inc/RequirementFileAbstractZipped.h \
-           ./inc/SngSettings.h \
+# headers (core headers are listed in rekkix_core.pri)
+HEADERS += ./inc/Rekkix.h \
            ./inc/UiSettings.h
-           
-
-# sources
-SOURCES += ./srcxx/AnalysisError.cpp \
-           ./srcxx/AnalysisSngStarterThread.cpp \
-           ./srcxx/AnalysisSngWaiterThread.cpp \
-           ./srcxx/FactoryReportBaseString.cpp \
-           ./srcxx/FactoryRequirementFile.cpp \
-           ./srcxx/main.cpp \
-           ./srcxx/ModelCompositeReqs.cpp \
-           ./srcxx/ModelConfiguration.cpp \
-           ./srcxx/ModelConfigurationErrors.cpp \
-           ./srcxx/ModelReqs.cpp \
-           ./srcxx/ModelReqsCoveredDownstream.cpp \
-           ./srcxx/ModelReqsCoveringUpstream.cpp \
-           ./srcxx/ModelSngAnalysisErrors.cpp \
-           ./srcxx/ModelSngReqMatrix.cpp \
-           ./srcxx/ModelStreamDocuments.cpp \
+
+# sources (core sources are listed in rekkix_core.pri)
+SOURCES += ./srcxx/main.cpp \
            ./srcxx/Rekkix.cpp \
-           ./srcxx/Requirement.cpp \
-           ./srcxx/RequirementFile_docx.cpp \
-           ./srcxx/RequirementFile_odt.cpp \
-           ./srcxx/RequirementFile_pdf.cpp \
-           ./srcxx/RequirementFile_txt.cpp \
-           ./srcxx/RequirementFileAbstract.cpp \
-           ./srcxx/RequirementFileAbstractZipped.cpp \
-           ./srcxx/SngSettings.cpp \
            ./srcxx/UiSettings.cpp
-           
-
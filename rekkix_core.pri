@@ -0,0 +1,105 @@
+# rekkix
+# released under the terms of the GNU General Public License
+#
+# Core of the application: everything but the main window, the settings dialog and main().
+# This file is shared by rekkix.pro and by the benchmark harness (see bench/rekkix_bench.pro)
+# so both always build the very same analysis engine.
+
+# Folders used for dependencies
+DEPENDPATH += $$PWD/srcxx $$PWD/inc
+
+# Included folders at compile time
+INCLUDEPATH += $$PWD/inc
+
+# Third party library : libzip & libpoppler
+win32:INCLUDEPATH += $$PWD/win32_libs/libzip-1.1.3/inc/ $$PWD/win32_libs/poppler-0.45/include/poppler/cpp/
+win32:LIBS += -L$$PWD/win32_libs/libzip-1.1.3/lib/ -L$$PWD/win32_libs/poppler-0.45/bin/ C:/Qt/Tools/mingw530_32/i686-w64-mingw32/lib/libiconv.a
+unix:INCLUDEPATH += /usr/include/poppler/cpp/
+LIBS += -lzip -lz -lpoppler-cpp 
+
+# Local socket of the query server (rekkix --serve)
+QT += network
+
+# SQLite export of the analysis (writer sqlite)
+QT += sql
+
+# Resources file (report templates)
+RESOURCES += $$PWD/resources/rekkix.qrc
+
+# headers
+HEADERS += $$PWD/inc/AnalysisError.h \
+           $$PWD/inc/AnalysisErrorStore.h \
+           $$PWD/inc/AnalysisImpactIndex.h \
+           $$PWD/inc/AnalysisQueryServer.h \
+           $$PWD/inc/AnalysisSearchIndex.h \
+           $$PWD/inc/AnalysisSnapshot.h \
+           $$PWD/inc/AnalysisSnapshotDiff.h \
+           $$PWD/inc/AnalysisSqliteExport.h \
+           $$PWD/inc/AnalysisSngProgress.h \
+           $$PWD/inc/AnalysisSngScheduler.h \
+           $$PWD/inc/AnalysisSngStarterThread.h \
+           $$PWD/inc/AnalysisSngTextCache.h \
+           $$PWD/inc/AnalysisSngWaiterThread.h \
+           $$PWD/inc/AnalysisTracer.h \
+           $$PWD/inc/AnalysisWatcher.h \
+           $$PWD/inc/FactoryReport.h \
+           $$PWD/inc/FactoryReportBaseString.h \
+           $$PWD/inc/FactoryRequirementFile.h \
+           $$PWD/inc/ModelCompositeReqs.h \
+           $$PWD/inc/ModelConfiguration.h \
+           $$PWD/inc/ModelConfigurationErrors.h \
+           $$PWD/inc/ModelReqs.h \
+           $$PWD/inc/ModelReqsCoveredDownstream.h \
+           $$PWD/inc/ModelReqsCoveringUpstream.h \
+           $$PWD/inc/ModelSngAnalysisErrors.h \
+           $$PWD/inc/ModelSngReqMatrix.h \
+           $$PWD/inc/ModelStreamDocuments.h \
+           $$PWD/inc/Requirement.h \
+           $$PWD/inc/RequirementArena.h \
+           $$PWD/inc/RequirementFile_docx.h \
+           $$PWD/inc/RequirementFile_odt.h \
+           $$PWD/inc/RequirementFile_pdf.h \
+           $$PWD/inc/RequirementFile_tree.h \
+           $$PWD/inc/RequirementFile_txt.h \
+           $$PWD/inc/RequirementFileAbstract.h \
+           $$PWD/inc/RequirementFileAbstractZipped.h \
+           $$PWD/inc/SngSettings.h
+
+# sources
+SOURCES += $$PWD/srcxx/AnalysisError.cpp \
+           $$PWD/srcxx/AnalysisErrorStore.cpp \
+           $$PWD/srcxx/AnalysisImpactIndex.cpp \
+           $$PWD/srcxx/AnalysisQueryServer.cpp \
+           $$PWD/srcxx/AnalysisSearchIndex.cpp \
+           $$PWD/srcxx/AnalysisSnapshot.cpp \
+           $$PWD/srcxx/AnalysisSnapshotDiff.cpp \
+           $$PWD/srcxx/AnalysisSqliteExport.cpp \
+           $$PWD/srcxx/AnalysisSngProgress.cpp \
+           $$PWD/srcxx/AnalysisSngScheduler.cpp \
+           $$PWD/srcxx/AnalysisSngStarterThread.cpp \
+           $$PWD/srcxx/AnalysisSngTextCache.cpp \
+           $$PWD/srcxx/AnalysisSngWaiterThread.cpp \
+           $$PWD/srcxx/AnalysisTracer.cpp \
+           $$PWD/srcxx/AnalysisWatcher.cpp \
+           $$PWD/srcxx/FactoryReport.cpp \
+           $$PWD/srcxx/FactoryReportBaseString.cpp \
+           $$PWD/srcxx/FactoryRequirementFile.cpp \
+           $$PWD/srcxx/ModelCompositeReqs.cpp \
+           $$PWD/srcxx/ModelConfiguration.cpp \
+           $$PWD/srcxx/ModelConfigurationErrors.cpp \
+           $$PWD/srcxx/ModelReqs.cpp \
+           $$PWD/srcxx/ModelReqsCoveredDownstream.cpp \
+           $$PWD/srcxx/ModelReqsCoveringUpstream.cpp \
+           $$PWD/srcxx/ModelSngAnalysisErrors.cpp \
+           $$PWD/srcxx/ModelSngReqMatrix.cpp \
+           $$PWD/srcxx/ModelStreamDocuments.cpp \
+           $$PWD/srcxx/Requirement.cpp \
+           $$PWD/srcxx/RequirementArena.cpp \
+           $$PWD/srcxx/RequirementFile_docx.cpp \
+           $$PWD/srcxx/RequirementFile_odt.cpp \
+           $$PWD/srcxx/RequirementFile_pdf.cpp \
+           $$PWD/srcxx/RequirementFile_tree.cpp \
+           $$PWD/srcxx/RequirementFile_txt.cpp \
+           $$PWD/srcxx/RequirementFileAbstract.cpp \
+           $$PWD/srcxx/RequirementFileAbstractZipped.cpp \
+           $$PWD/srcxx/SngSettings.cpp
@@ -12,10 +12,17 @@
 AnalysisError::AnalysisError(const severity_t& severity,
                              const category_t& category,
                              const QString& location,
-                             const QString& description)
-		: __severity(severity), __category(category), __location(location), __description(description)
+                             const code_t& code,
+                             const QString& arg1,
+                             const QString& arg2,
+                             const QString& arg3,
+                             const QString& arg4)
+		: __severity(severity), __category(category), __location(location), __code(code)
 {
-
+	__args[0] = arg1;
+	__args[1] = arg2;
+	__args[2] = arg3;
+	__args[3] = arg4;
 }
 
 AnalysisError::~AnalysisError()
@@ -61,3 +68,122 @@ QString AnalysisError::getCategoryString() const
 
 	return (r);
 }
+
+QString AnalysisError::getDescription() const
+{
+	QString r;
+	QString inconsistency;
+
+	switch (__code)
+	{
+		case UNKNOWN:
+			break;
+
+		case FILE_OPEN_FAILED:
+			r = QObject::trUtf8("Impossible d'ouvrir le fichier %1").arg(__args[0]);
+			break;
+
+		case PDF_NOT_ENOUGH_PAGES:
+			r = QObject::trUtf8("Le fichier %1 n'a que %2 pages, aucune page n'est analysée").arg(__args[0]).arg(__args[1]);
+			break;
+
+		case TREE_NO_FILE:
+			r = QObject::trUtf8("Aucun fichier ne correspond à %1").arg(__args[0]);
+			break;
+
+		case DOCX_SET_CONTENT_FAILED:
+			r = QObject::trUtf8("Parser DOCX : erreur setContent ligne<%1> col<%2> msg<%3>").arg(__args[0]).arg(__args[1]).arg(__args[2]);
+			break;
+
+		case DOCX_NODE_NOT_FOUND:
+			r = QObject::trUtf8("Parser DOCX : Impossible de trouver le nœud %1").arg(__args[0]);
+			break;
+
+		case ODT_SET_CONTENT_FAILED:
+			r = QObject::trUtf8("Parser ODT : erreur setContent ligne<%1> col<%2> msg<%3>").arg(__args[0]).arg(__args[1]).arg(__args[2]);
+			break;
+
+		case ODT_NODE_NOT_FOUND:
+			r = QObject::trUtf8("Parser ODT : nœud %1 non trouvé").arg(__args[0]);
+			break;
+
+		case ZIP_OPEN_FAILED:
+			r = QObject::trUtf8("Erreur d'ouverture du fichier %1 (échec de zip_open, erreur %2)").arg(__args[0]).arg(__args[1]);
+			break;
+
+		case ZIP_LOCATE_FAILED:
+			r = QObject::trUtf8("Erreur de localisation de %1 (format de fichier invalide, échec de zip_name_locate)").arg(__args[0]);
+			break;
+
+		case ZIP_OPEN_INDEX_FAILED:
+			r = QObject::trUtf8("Erreur de localisation de l'index (format de fichier invalide, échec de zip_fopen_index)");
+			break;
+
+		case ZIP_READ_FAILED:
+			r = QObject::trUtf8("Erreur de lecture du fichier après %1 cycles (zip_fread retourne -1). zip_err %2 : %3").arg(__args[0]).arg(__args[1]).arg(__args[2]);
+			break;
+
+		case REQ_STATE_UNDEFINED:
+			r = QObject::trUtf8("État non défini d'une exigence qui devrait être définie --> erreur dans l'analyseur de fichier");
+			break;
+
+		case REQ_REDEFINED:
+			r = QObject::trUtf8("Redéfinition de %1, préalablement définie dans %2").arg(__args[0]).arg(__args[1]);
+			break;
+
+		case COMPOSITION_OF_UNDEFINED:
+			r = QObject::trUtf8("Tentative de définition de composition d'une exigence indéfinie (exigence composante %1)").arg(__args[0]);
+			if (!__args[1].isEmpty()) r += QObject::trUtf8(", fichier %1").arg(__args[1]);
+			break;
+
+		case COVERAGE_OF_UNDEFINED:
+			r = QObject::trUtf8("Tentative de définition de couverture d'une exigence indéfinie (exigence couverte : %1)").arg(__args[0]);
+			if (!__args[1].isEmpty()) r += QObject::trUtf8(", fichier %1").arg(__args[1]);
+			break;
+
+		case MULTIPLE_COVERAGE:
+			r = QObject::trUtf8("Couverture multiple : %1 déjà couverte par %2 et tentative de recouverture par %3").arg(__args[0]).arg(__args[1]).arg(__args[2]);
+			if (!__args[3].isEmpty()) r += QObject::trUtf8(", fichier %1").arg(__args[3]);
+			break;
+
+		case DOWNSTREAM_NOT_CONFIGURED:
+		case UPSTREAM_NOT_CONFIGURED:
+		case STREAMS_NOT_CONFIGURED:
+			if (__code != UPSTREAM_NOT_CONFIGURED)
+			{
+				inconsistency = QObject::trUtf8("%1 doit avoir des documents avals (downstream)").arg(__args[1]);
+			}
+
+			if (__code != DOWNSTREAM_NOT_CONFIGURED)
+			{
+				if (!inconsistency.isEmpty()) inconsistency += QObject::trUtf8(" et ");
+				inconsistency += QObject::trUtf8("%1 doit avoir des documents amonts (upstream)").arg(__args[2]);
+			}
+
+			r = QObject::trUtf8("Incohérence de paramétrage, %1 mais sa configuration ne le mentionne pas (%2 exigences de %3 couvertes par %4, par exemple %5)")
+			    .arg(inconsistency).arg(__args[0]).arg(__args[1]).arg(__args[2]).arg(__args[3]);
+			break;
+
+		case REQ_EXPECTED_UNDEFINED:
+			r = QObject::trUtf8("Exigence attendue mais définie dans aucun fichier : %1").arg(__args[0]);
+			break;
+
+		case COVERAGE_LOOP:
+			r = QObject::trUtf8("%1 : Rebouclage dans la *couverture* des exigences : %2").arg(__args[0]).arg(__args[1]);
+			break;
+
+		case COMPOSITION_LOOP:
+			r = QObject::trUtf8("%1 : Rebouclage dans la *composition* des exigences : %2").arg(__args[0]).arg(__args[1]);
+			break;
+
+		case COMPOSED_OF_INVALID:
+			r = QObject::trUtf8("%1 est composée d'exigences invalides : %2").arg(__args[0]).arg(__args[1]);
+			break;
+
+		case ERRORS_NOT_DETAILED:
+			r = QObject::trUtf8("... et %1 autres erreurs du même type à cet endroit, non détaillées").arg(__args[0]);
+			break;
+	}
+
+	return (r);
+}
@@ -0,0 +1,88 @@
+/*!
+ * \file AnalysisErrorStore.cpp
+ * \brief Implementation of the class AnalysisErrorStore
+ * \date 2016-11-11
+ * \author f.souliers
+ */
+
+#include "AnalysisErrorStore.h"
+
+const int AnalysisErrorStore::MAX_EXAMPLES_BY_GROUP = 100;
+
+AnalysisErrorStore::AnalysisErrorStore()
+{
+	clear();
+}
+
+AnalysisErrorStore::~AnalysisErrorStore()
+{
+}
+
+QString AnalysisErrorStore::__getGroupKey(const AnalysisError& p_error)
+{
+	return (QString("%1|%2|%3|%4").arg(p_error.getSeverity()).arg(p_error.getCategory()).arg(p_error.getCode())
+	        .arg(p_error.getLocation()));
+}
+
+bool AnalysisErrorStore::add(const AnalysisError& p_error, int* p_group)
+{
+	QString key = __getGroupKey(p_error);
+	QHash<QString, int>::const_iterator it = __groupByKey.constFind(key);
+
+	int g;
+	if (it == __groupByKey.constEnd())
+	{
+		group_t group;
+		group.severity = p_error.getSeverity();
+		group.category = p_error.getCategory();
+		group.code = p_error.getCode();
+		group.location = p_error.getLocation();
+		group.nbErrors = 0;
+
+		g = __groups.count();
+		__groups.append(group);
+		__groupByKey.insert(key, g);
+		__groupsByLocation[group.location].append(g);
+		__groupsBySeverity[group.severity].append(g);
+		__groupsByCategory[group.category].append(g);
+	}
+	else
+	{
+		g = it.value();
+	}
+
+	__nbErrors++;
+	__nbErrorsByLocation[p_error.getLocation()]++;
+	__nbErrorsBySeverity[p_error.getSeverity()]++;
+	__nbErrorsByCategory[p_error.getCategory()]++;
+
+	if (p_group) *p_group = g;
+
+	group_t& group = __groups[g];
+	group.nbErrors++;
+	if (group.examples.count() >= MAX_EXAMPLES_BY_GROUP) return (false);
+
+	group.examples.append(p_error);
+	return (true);
+}
+
+void AnalysisErrorStore::clear()
+{
+	__groups.clear();
+	__groupByKey.clear();
+	__groupsByLocation.clear();
+	__nbErrors = 0;
+	__nbErrorsByLocation.clear();
+
+	for (int s = 0 ; s < NB_SEVERITIES ; s++)
+	{
+		__groupsBySeverity[s].clear();
+		__nbErrorsBySeverity[s] = 0;
+	}
+
+	for (int c = 0 ; c < NB_CATEGORIES ; c++)
+	{
+		__groupsByCategory[c].clear();
+		__nbErrorsByCategory[c] = 0;
+	}
+}
@@ -0,0 +1,362 @@
+/*!
+ * \file AnalysisImpactIndex.cpp
+ * \brief Implementation of the class AnalysisImpactIndex
+ * \date 2016-10-28
+ * \author f.souliers
+ */
+
+#include <QDebug>
+#include <QPair>
+#include <QtAlgorithms>
+
+#include "AnalysisImpactIndex.h"
+#include "AnalysisSnapshot.h"
+#include "AnalysisTracer.h"
+
+/*!
+ * \brief Appends to an adjacency list (being built) the successors of a node that are known
+ */
+static void appendSuccessors(const QHash<QString, int>& p_nodeById, const QStringList& p_ids, QVector<int>& p_successors)
+{
+	foreach(QString id, p_ids)
+	{
+		QHash<QString, int>::const_iterator it = p_nodeById.constFind(id);
+		if (it != p_nodeById.constEnd()) p_successors.append(it.value());
+	}
+}
+
+AnalysisImpactIndex::AnalysisImpactIndex()
+{
+}
+
+AnalysisImpactIndex::~AnalysisImpactIndex()
+{
+}
+
+void AnalysisImpactIndex::build(const AnalysisSnapshot& p_snapshot)
+{
+	AnalysisTraceScope ts("impact_index", AnalysisTracer::CATEGORY_COVERAGE);
+
+	__ids = p_snapshot.getRequirementIds();
+	__nodeById.clear();
+	__nodeById.reserve(__ids.count());
+	for (int n = 0 ; n < __ids.count() ; n++)
+	{
+		__nodeById.insert(__ids[n], n);
+	}
+
+	// Adjacency lists of both directions
+	QVector<int> downOffsets(__ids.count() + 1, 0);
+	QVector<int> downSuccessors;
+	QVector<int> upOffsets(__ids.count() + 1, 0);
+	QVector<int> upSuccessors;
+	for (int n = 0 ; n < __ids.count() ; n++)
+	{
+		const AnalysisSnapshot::requirement_t* r = p_snapshot.getRequirement(__ids[n]);
+
+		if (!r->downstreamId.isEmpty()) appendSuccessors(__nodeById, QStringList(r->downstreamId), downSuccessors);
+		appendSuccessors(__nodeById, r->composingIds, downSuccessors);
+		downOffsets[n + 1] = downSuccessors.count();
+
+		appendSuccessors(__nodeById, r->upstreamIds, upSuccessors);
+		appendSuccessors(__nodeById, r->compositeIds, upSuccessors);
+		upOffsets[n + 1] = upSuccessors.count();
+	}
+
+	__buildReachability(downOffsets, downSuccessors, __downstream);
+	__buildReachability(upOffsets, upSuccessors, __upstream);
+
+	qDebug() << "AnalysisImpactIndex::build : " << __ids.count() << " exigences, "
+	         << __downstream.postByComponent.count() << " / " << __upstream.postByComponent.count() << " composantes, "
+	         << __downstream.intervals.count() / 2 << " / " << __upstream.intervals.count() / 2 << " intervalles";
+}
+
+void AnalysisImpactIndex::__buildReachability(const QVector<int>& p_offsets, const QVector<int>& p_successors, reachability_t& p_reach)
+{
+	int nbNodes = p_offsets.count() - 1;
+
+	// 1. Strongly connected components (Tarjan), the components are numbered successors first
+	QVector<int> order(nbNodes, -1);
+	QVector<int> lowLink(nbNodes, 0);
+	QVector<bool> isOnStack(nbNodes, false);
+	QVector<int> stack;
+	QVector< QPair<int, int> > calls;  // node, next successor to visit
+	int nbVisited = 0;
+	int nbComponents = 0;
+
+	p_reach.componentByNode.fill(-1, nbNodes);
+	for (int s = 0 ; s < nbNodes ; s++)
+	{
+		if (order[s] != -1) continue;
+
+		order[s] = lowLink[s] = nbVisited++;
+		stack.append(s);
+		isOnStack[s] = true;
+		calls.append(qMakePair(s, p_offsets[s]));
+
+		while (!calls.isEmpty())
+		{
+			int v = calls.last().first;
+			int pos = calls.last().second;
+
+			if (pos < p_offsets[v + 1])
+			{
+				calls.last().second++;
+				int w = p_successors[pos];
+				if (order[w] == -1)
+				{
+					order[w] = lowLink[w] = nbVisited++;
+					stack.append(w);
+					isOnStack[w] = true;
+					calls.append(qMakePair(w, p_offsets[w]));
+				}
+				else if (isOnStack[w])
+				{
+					lowLink[v] = qMin(lowLink[v], order[w]);
+				}
+			}
+			else
+			{
+				calls.removeLast();
+				if (!calls.isEmpty()) lowLink[calls.last().first] = qMin(lowLink[calls.last().first], lowLink[v]);
+
+				if (lowLink[v] == order[v])
+				{
+					int w;
+					do
+					{
+						w = stack.takeLast();
+						isOnStack[w] = false;
+						p_reach.componentByNode[w] = nbComponents;
+					} while (w != v);
+					nbComponents++;
+				}
+			}
+		}
+	}
+
+	// Requirements grouped by component
+	p_reach.nodeOffsetsByComponent.fill(0, nbComponents + 1);
+	for (int n = 0 ; n < nbNodes ; n++)
+	{
+		p_reach.nodeOffsetsByComponent[p_reach.componentByNode[n] + 1]++;
+	}
+	for (int c = 0 ; c < nbComponents ; c++)
+	{
+		p_reach.nodeOffsetsByComponent[c + 1] += p_reach.nodeOffsetsByComponent[c];
+	}
+	QVector<int> nextNodePos = p_reach.nodeOffsetsByComponent;
+	p_reach.nodes.resize(nbNodes);
+	for (int n = 0 ; n < nbNodes ; n++)
+	{
+		p_reach.nodes[nextNodePos[p_reach.componentByNode[n]]++] = n;
+	}
+
+	// Condensed DAG, without duplicated edges
+	QVector<int> dagOffsets(nbComponents + 1, 0);
+	QVector<int> dagSuccessors;
+	QVector<int> lastSource(nbComponents, -1);
+	for (int c = 0 ; c < nbComponents ; c++)
+	{
+		for (int i = p_reach.nodeOffsetsByComponent[c] ; i < p_reach.nodeOffsetsByComponent[c + 1] ; i++)
+		{
+			int n = p_reach.nodes[i];
+			for (int pos = p_offsets[n] ; pos < p_offsets[n + 1] ; pos++)
+			{
+				int d = p_reach.componentByNode[p_successors[pos]];
+				if (d == c || lastSource[d] == c) continue;
+
+				lastSource[d] = c;
+				dagSuccessors.append(d);
+			}
+		}
+		dagOffsets[c + 1] = dagSuccessors.count();
+	}
+
+	// 2. Post-order numbers, the roots are taken predecessors first so that the spanning forest covers much
+	QVector<int> firstPost(nbComponents, -1);
+	QVector< QPair<int, int> > dagCalls;  // component, next successor to visit
+	int nbPosts = 0;
+
+	p_reach.postByComponent.fill(-1, nbComponents);
+	p_reach.componentByPost.fill(-1, nbComponents);
+	for (int r = nbComponents - 1 ; r >= 0 ; r--)
+	{
+		if (firstPost[r] != -1) continue;
+
+		firstPost[r] = nbPosts;
+		dagCalls.append(qMakePair(r, dagOffsets[r]));
+		while (!dagCalls.isEmpty())
+		{
+			int c = dagCalls.last().first;
+			int pos = dagCalls.last().second;
+
+			if (pos < dagOffsets[c + 1])
+			{
+				dagCalls.last().second++;
+				int d = dagSuccessors[pos];
+				if (firstPost[d] == -1)
+				{
+					firstPost[d] = nbPosts;
+					dagCalls.append(qMakePair(d, dagOffsets[d]));
+				}
+			}
+			else
+			{
+				dagCalls.removeLast();
+				p_reach.postByComponent[c] = nbPosts;
+				p_reach.componentByPost[nbPosts] = c;
+				nbPosts++;
+			}
+		}
+	}
+
+	// 3. Labels, the successors of a component having lower numbers their labels are already known
+	p_reach.labelOffsetsByComponent.fill(0, nbComponents + 1);
+	p_reach.intervals.clear();
+	QVector< QPair<int, int> > label;
+	for (int c = 0 ; c < nbComponents ; c++)
+	{
+		label.clear();
+		label.append(qMakePair(firstPost[c], p_reach.postByComponent[c]));
+		for (int pos = dagOffsets[c] ; pos < dagOffsets[c + 1] ; pos++)
+		{
+			int d = dagSuccessors[pos];
+			for (int k = p_reach.labelOffsetsByComponent[d] ; k < p_reach.labelOffsetsByComponent[d + 1] ; k++)
+			{
+				label.append(qMakePair(p_reach.intervals[2 * k], p_reach.intervals[2 * k + 1]));
+			}
+		}
+		qSort(label);
+
+		// Merge of the overlapping or contiguous intervals
+		int first = label[0].first;
+		int last = label[0].second;
+		for (int k = 1 ; k < label.count() ; k++)
+		{
+			if (label[k].first <= last + 1)
+			{
+				last = qMax(last, label[k].second);
+			}
+			else
+			{
+				p_reach.intervals << first << last;
+				first = label[k].first;
+				last = label[k].second;
+			}
+		}
+		p_reach.intervals << first << last;
+		p_reach.labelOffsetsByComponent[c + 1] = p_reach.intervals.count() / 2;
+	}
+}
+
+void AnalysisImpactIndex::__appendReachableNodes(const reachability_t& p_reach, int p_node, QVector<int>& p_nodes)
+{
+	int c = p_reach.componentByNode[p_node];
+	for (int k = p_reach.labelOffsetsByComponent[c] ; k < p_reach.labelOffsetsByComponent[c + 1] ; k++)
+	{
+		for (int post = p_reach.intervals[2 * k] ; post <= p_reach.intervals[2 * k + 1] ; post++)
+		{
+			int d = p_reach.componentByPost[post];
+			for (int i = p_reach.nodeOffsetsByComponent[d] ; i < p_reach.nodeOffsetsByComponent[d + 1] ; i++)
+			{
+				p_nodes.append(p_reach.nodes[i]);
+			}
+		}
+	}
+}
+
+bool AnalysisImpactIndex::__isReachable(const reachability_t& p_reach, int p_from, int p_to)
+{
+	int post = p_reach.postByComponent[p_reach.componentByNode[p_to]];
+
+	// Last interval starting before post (the intervals are sorted and disjoint)
+	int lo = p_reach.labelOffsetsByComponent[p_reach.componentByNode[p_from]];
+	int hi = p_reach.labelOffsetsByComponent[p_reach.componentByNode[p_from] + 1];
+	while (hi - lo > 1)
+	{
+		int mid = (lo + hi) / 2;
+		if (p_reach.intervals[2 * mid] <= post)
+		{
+			lo = mid;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	return (p_reach.intervals[2 * lo] <= post && post <= p_reach.intervals[2 * lo + 1]);
+}
+
+QStringList AnalysisImpactIndex::getImpactedRequirements(const QString& p_id, Direction p_direction) const
+{
+	QStringList retVal;
+
+	QHash<QString, int>::const_iterator it = __nodeById.constFind(p_id);
+	if (it == __nodeById.constEnd()) return (retVal);
+
+	QVector<int> nodes;
+	if (p_direction & DOWNSTREAM) __appendReachableNodes(__downstream, it.value(), nodes);
+	if (p_direction & UPSTREAM) __appendReachableNodes(__upstream, it.value(), nodes);
+
+	// The node numbers follow the order of the ids
+	qSort(nodes);
+	int previous = it.value();
+	foreach(int n, nodes)
+	{
+		if (n == previous || n == it.value()) continue;
+
+		retVal.append(__ids[n]);
+		previous = n;
+	}
+
+	return (retVal);
+}
+
+bool AnalysisImpactIndex::isImpacted(const QString& p_modifiedId, const QString& p_id, Direction p_direction) const
+{
+	if (p_modifiedId == p_id) return (false);
+
+	QHash<QString, int>::const_iterator from = __nodeById.constFind(p_modifiedId);
+	QHash<QString, int>::const_iterator to = __nodeById.constFind(p_id);
+	if (from == __nodeById.constEnd() || to == __nodeById.constEnd()) return (false);
+
+	return (((p_direction & DOWNSTREAM) && __isReachable(__downstream, from.value(), to.value()))
+	        || ((p_direction & UPSTREAM) && __isReachable(__upstream, from.value(), to.value())));
+}
+
+QString AnalysisImpactIndex::directionToString(Direction p_direction)
+{
+	switch (p_direction)
+	{
+		case DOWNSTREAM:
+			return (QString("down"));
+		case UPSTREAM:
+			return (QString("up"));
+		default:
+			return (QString("all"));
+	}
+}
+
+AnalysisImpactIndex::Direction AnalysisImpactIndex::stringToDirection(const QString& p_name, bool* p_ok)
+{
+	Direction retVal = BOTH;
+	bool isKnown = true;
+
+	if (p_name == "down")
+	{
+		retVal = DOWNSTREAM;
+	}
+	else if (p_name == "up")
+	{
+		retVal = UPSTREAM;
+	}
+	else if (p_name != "all")
+	{
+		isKnown = false;
+	}
+
+	if (p_ok) *p_ok = isKnown;
+	return (retVal);
+}
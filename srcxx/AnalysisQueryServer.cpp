@@ -0,0 +1,368 @@
+/*!
+ * \file AnalysisQueryServer.cpp
+ * \brief Implementation of the class AnalysisQueryServer
+ * \date 2016-10-26
+ * \author f.souliers
+ */
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QMutexLocker>
+#include <QRunnable>
+
+#include "AnalysisQueryServer.h"
+#include "Requirement.h"
+
+const QString AnalysisQueryServer::DEFAULT_SERVER_NAME = "rekkix";
+
+static const qint64 MAX_REQUEST_LENGTH = 4096;  //!< Longer lines are answered by an error, without being read whole
+static const char* DISCARDING_PROPERTY = "rekkix_discarding";  //!< Set on a socket while the end of a line too long is dropped
+static const int MAX_SEARCH_RESULTS = 1000;  //!< Maximum number of ids answered to a search
+static const int MAX_SEARCH_PATTERN_LENGTH = 256;  //!< Longer regular expressions are not searched
+static const int MAX_QUERY_THREADS = 2;  //!< Threads answering the requests, the analysis keeps the others
+static const int MAX_PENDING_REQUESTS = 64;  //!< The socket of a client is not read while more requests are waiting
+
+/*!
+ * \class QueryAnsweringTask
+ * \brief Answers one request of a client, then hands the answer over to the thread of the server
+ */
+class QueryAnsweringTask : public QRunnable
+{
+public:
+	QueryAnsweringTask(AnalysisQueryServer* p_server, int p_clientId, const QByteArray& p_request)
+		: QRunnable(), __server(p_server), __clientId(p_clientId), __request(p_request)
+	{
+		setAutoDelete(true);
+	}
+
+	void run()
+	{
+		QByteArray answer = __server->answer(__request);
+		QMetaObject::invokeMethod(__server, "slt_answered", Qt::QueuedConnection,
+		                          Q_ARG(int, __clientId), Q_ARG(QByteArray, answer));
+	}
+
+private:
+	AnalysisQueryServer* __server;  //!< Server of the client, waits for the task before being destroyed
+	int __clientId;  //!< Client of the request
+	QByteArray __request;  //!< The request, without its end of line
+};
+
+/*!
+ * \brief JSON value of a coverage, null if it is invalid
+ */
+static QJsonValue coverageToJson(double p_coverage)
+{
+	if (p_coverage == Requirement::COVERAGE_INVALID_VALUE) return (QJsonValue());
+	return (QJsonValue(p_coverage));
+}
+
+/*!
+ * \brief JSON form of a requirement of the snapshot
+ */
+static QJsonObject requirementToJson(const AnalysisSnapshot::requirement_t& p_req)
+{
+	QJsonObject o;
+	o.insert("id", p_req.id);
+	o.insert("file", p_req.fileId.isEmpty() ? QJsonValue() : QJsonValue(p_req.fileId));
+	o.insert("expectedBy", p_req.expectedBy);
+	o.insert("consistent", p_req.isConsistent);
+	o.insert("mustBeCovered", p_req.mustBeCovered);
+	o.insert("coverage", coverageToJson(p_req.coverage));
+	o.insert("coveredBy", p_req.downstreamId.isEmpty() ? QJsonValue() : QJsonValue(p_req.downstreamId));
+	o.insert("covers", QJsonArray::fromStringList(p_req.upstreamIds));
+	o.insert("composedOf", QJsonArray::fromStringList(p_req.composingIds));
+	o.insert("composing", QJsonArray::fromStringList(p_req.compositeIds));
+	return (o);
+}
+
+/*!
+ * \brief JSON form of a file of the snapshot
+ */
+static QJsonObject fileToJson(const AnalysisSnapshot::file_t& p_file)
+{
+	QJsonObject o;
+	o.insert("id", p_file.id);
+	o.insert("path", p_file.path);
+	o.insert("requirements", p_file.nbRequirements);
+	o.insert("errors", p_file.nbErrors);
+	o.insert("mustBeCovered", p_file.mustHaveDownstreamDocuments);
+	o.insert("coverage", p_file.mustHaveDownstreamDocuments ? coverageToJson(p_file.coverage) : QJsonValue());
+	o.insert("upstream", QJsonArray::fromStringList(p_file.upstreamDocuments));
+	o.insert("downstream", QJsonArray::fromStringList(p_file.downstreamDocuments));
+	return (o);
+}
+
+AnalysisQueryServer::AnalysisQueryServer(QObject* p_parent)
+	: QObject(p_parent), __server(new QLocalServer(this)), __nextClientId(0)
+{
+	__queryPool.setMaxThreadCount(MAX_QUERY_THREADS);
+	QObject::connect(__server, SIGNAL(newConnection()), this, SLOT(slt_newConnection()));
+}
+
+AnalysisQueryServer::~AnalysisQueryServer()
+{
+	__queryPool.waitForDone();
+}
+
+void AnalysisQueryServer::setSnapshot(AnalysisSnapshotPtr p)
+{
+	QMutexLocker l(&__snapshotMutex);
+	__snapshot = p;
+}
+
+AnalysisSnapshotPtr AnalysisQueryServer::getSnapshot() const
+{
+	QMutexLocker l(&__snapshotMutex);
+	return (__snapshot);
+}
+
+bool AnalysisQueryServer::listen(const QString& p_serverName)
+{
+	QLocalServer::removeServer(p_serverName);
+	if (!__server->listen(p_serverName))
+	{
+		qDebug() << "AnalysisQueryServer::listen : " << p_serverName << " : " << __server->errorString();
+		return (false);
+	}
+
+	qDebug() << "AnalysisQueryServer::listen : " << __server->fullServerName();
+	return (true);
+}
+
+void AnalysisQueryServer::close()
+{
+	__server->close();
+
+	// The answers still being computed are dropped with their client
+	__queryPool.waitForDone();
+	__clients.clear();
+
+	foreach(QLocalSocket* s, __server->findChildren<QLocalSocket*>())
+	{
+		s->abort();
+		s->deleteLater();
+	}
+}
+
+void AnalysisQueryServer::slt_newConnection()
+{
+	while (__server->hasPendingConnections())
+	{
+		QLocalSocket* s = __server->nextPendingConnection();  // child of __server
+		int id = __nextClientId++;
+
+		client_t c;
+		c.socket = s;
+		c.isAnswering = false;
+		__clients.insert(id, c);
+
+		QObject::connect(s, &QLocalSocket::readyRead, this, [this, id]() { __readRequests(id); });
+		QObject::connect(s, &QLocalSocket::disconnected, this, [this, id]() { __clients.remove(id); });
+		QObject::connect(s, SIGNAL(disconnected()), s, SLOT(deleteLater()));
+	}
+}
+
+void AnalysisQueryServer::__readRequests(int p_clientId)
+{
+	if (!__clients.contains(p_clientId)) return;
+
+	client_t& c = __clients[p_clientId];
+	QLocalSocket* socket = c.socket;
+
+	// A line too long is read by pieces of MAX_REQUEST_LENGTH bytes, its end is not awaited. The lines of a client
+	// sending too many requests are left in its socket, they are read once its requests are answered
+	do
+	{
+		while (c.requests.count() < MAX_PENDING_REQUESTS
+		       && (socket->canReadLine() || socket->bytesAvailable() > MAX_REQUEST_LENGTH))
+		{
+			QByteArray line = socket->readLine(MAX_REQUEST_LENGTH + 2);  // the request and its end of line
+			bool isLineEnded = line.endsWith('\n');
+
+			if (socket->property(DISCARDING_PROPERTY).toBool())
+			{
+				// The rest of a line too long, already answered
+				socket->setProperty(DISCARDING_PROPERTY, !isLineEnded);
+				continue;
+			}
+
+			if (!isLineEnded)
+			{
+				// Answered once, in its turn, the next requests are read after its end of line
+				socket->setProperty(DISCARDING_PROPERTY, true);
+				c.requests.enqueue(QByteArray());
+				continue;
+			}
+
+			QByteArray request = line.trimmed();
+			if (request.isEmpty()) continue;
+
+			c.requests.enqueue(request);
+		}
+
+		__answerNext(p_clientId);
+	}
+	// Only lines too long may have been queued: they are answered at once, the next lines are read now
+	while (!c.isAnswering && (socket->canReadLine() || socket->bytesAvailable() > MAX_REQUEST_LENGTH));
+}
+
+void AnalysisQueryServer::__answerNext(int p_clientId)
+{
+	client_t& c = __clients[p_clientId];
+	while (!c.isAnswering && !c.requests.isEmpty())
+	{
+		QByteArray request = c.requests.dequeue();
+		if (request.isEmpty())
+		{
+			c.socket->write(QJsonDocument(__error(QObject::trUtf8("Requête trop longue"))).toJson(QJsonDocument::Compact) + '\n');
+			continue;
+		}
+
+		c.isAnswering = true;
+		__queryPool.start(new QueryAnsweringTask(this, p_clientId, request));
+	}
+}
+
+void AnalysisQueryServer::slt_answered(int p_clientId, const QByteArray& p_answer)
+{
+	// The client may have disconnected while its request was answered
+	if (!__clients.contains(p_clientId)) return;
+
+	client_t& c = __clients[p_clientId];
+	c.socket->write(p_answer + '\n');
+	c.isAnswering = false;
+
+	// The lines left in the socket are read now that a request has been answered
+	__readRequests(p_clientId);
+}
+
+QJsonObject AnalysisQueryServer::__error(const QString& p_message)
+{
+	QJsonObject o;
+	o.insert("status", QString("error"));
+	o.insert("message", p_message);
+	return (o);
+}
+
+QByteArray AnalysisQueryServer::answer(const QByteArray& p_request) const
+{
+	QString request = QString::fromUtf8(p_request).trimmed();
+	QString command = request.section(' ', 0, 0, QString::SectionSkipEmpty).toLower();
+	QString arg = request.section(' ', 1, -1, QString::SectionSkipEmpty).trimmed();
+
+	// The snapshot is kept alive by this pointer even if a new one is published meanwhile
+	AnalysisSnapshotPtr snapshot = getSnapshot();
+
+	QJsonObject o;
+	if (!snapshot)
+	{
+		o = __error(QObject::trUtf8("Aucune analyse disponible"));
+	}
+	else if (command == "status")
+	{
+		o.insert("run", snapshot->getRunId());
+		o.insert("date", snapshot->getCreationDate().toString(Qt::ISODate));
+		o.insert("files", snapshot->getFileIds().count());
+		o.insert("requirements", snapshot->getNbRequirements());
+	}
+	else if (command == "files")
+	{
+		o.insert("files", QJsonArray::fromStringList(snapshot->getFileIds()));
+	}
+	else if (command == "file")
+	{
+		const AnalysisSnapshot::file_t* f = snapshot->getFile(arg);
+		if (f)
+		{
+			o.insert("file", fileToJson(*f));
+		}
+		else
+		{
+			o = __error(QObject::trUtf8("Fichier inconnu : %1").arg(arg));
+		}
+	}
+	else if (command == "impact")
+	{
+		QString id = arg.section(' ', 0, 0, QString::SectionSkipEmpty);
+		QString directionName = arg.section(' ', 1, 1, QString::SectionSkipEmpty).toLower();
+		if (directionName.isEmpty()) directionName = AnalysisImpactIndex::directionToString(AnalysisImpactIndex::BOTH);
+
+		bool isKnownDirection = false;
+		AnalysisImpactIndex::Direction direction = AnalysisImpactIndex::stringToDirection(directionName, &isKnownDirection);
+		if (!isKnownDirection)
+		{
+			o = __error(QObject::trUtf8("Direction inconnue : %1 (directions possibles : down, up, all)").arg(directionName));
+		}
+		else if (!snapshot->getRequirement(id))
+		{
+			o = __error(QObject::trUtf8("Exigence inconnue : %1").arg(id));
+		}
+		else
+		{
+			o.insert("requirement", id);
+			o.insert("direction", directionName);
+			o.insert("impacted", QJsonArray::fromStringList(snapshot->getImpactIndex().getImpactedRequirements(id, direction)));
+		}
+	}
+	else if (command == "search")
+	{
+		QString modeName = arg.section(' ', 0, 0, QString::SectionSkipEmpty).toLower();
+		QString text = arg.section(' ', 1, -1, QString::SectionSkipEmpty);
+
+		bool isKnownMode = false;
+		AnalysisSearchIndex::Mode mode = AnalysisSearchIndex::stringToMode(modeName, &isKnownMode);
+		if (!isKnownMode)
+		{
+			o = __error(QObject::trUtf8("Type de recherche inconnu : %1 (types possibles : prefix, contains, regex)").arg(modeName));
+		}
+		else if (mode == AnalysisSearchIndex::REGEX && text.length() > MAX_SEARCH_PATTERN_LENGTH)
+		{
+			o = __error(QObject::trUtf8("Expression régulière trop longue (%1 caractères au plus)").arg(MAX_SEARCH_PATTERN_LENGTH));
+		}
+		else
+		{
+			bool isTruncated = false;
+			o.insert("found", QJsonArray::fromStringList(snapshot->getSearchIndex().search(text, mode, MAX_SEARCH_RESULTS, &isTruncated)));
+			o.insert("truncated", isTruncated);
+		}
+	}
+	else if (command == "req" || command == "coveredby" || command == "covers")
+	{
+		const AnalysisSnapshot::requirement_t* r = snapshot->getRequirement(arg);
+		if (!r)
+		{
+			o = __error(QObject::trUtf8("Exigence inconnue : %1").arg(arg));
+		}
+		else if (command == "req")
+		{
+			o.insert("requirement", requirementToJson(*r));
+		}
+		else if (command == "coveredby")
+		{
+			const AnalysisSnapshot::requirement_t* dw = snapshot->getRequirement(r->downstreamId);
+			o.insert("requirement", r->id);
+			o.insert("coveredBy", dw ? QJsonValue(requirementToJson(*dw)) : QJsonValue());
+		}
+		else
+		{
+			QJsonArray covered;
+			foreach(QString id, r->upstreamIds)
+			{
+				const AnalysisSnapshot::requirement_t* up = snapshot->getRequirement(id);
+				if (up) covered.append(requirementToJson(*up));
+			}
+			o.insert("requirement", r->id);
+			o.insert("covers", covered);
+		}
+	}
+	else
+	{
+		o = __error(QObject::trUtf8("Requête inconnue : %1 (requêtes possibles : req, coveredby, covers, impact, search, file, files, status)").arg(command));
+	}
+
+	if (!o.contains("status")) o.insert("status", QString("ok"));
+	return (QJsonDocument(o).toJson(QJsonDocument::Compact));
+}
@@ -0,0 +1,334 @@
+/*!
+ * \file AnalysisSearchIndex.cpp
+ * \brief Implementation of the class AnalysisSearchIndex
+ * \date 2016-10-31
+ * \author f.souliers
+ */
+
+#include <algorithm>
+#include <iterator>
+
+#include <QDebug>
+#include <QPair>
+#include <QRegularExpression>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QtAlgorithms>
+
+#include "AnalysisSearchIndex.h"
+#include "AnalysisTracer.h"
+
+static const int MIN_IDS_BY_SLICE = 20000;  //!< Below this number of ids by thread, the slices are not worth it
+
+/*!
+ * \class SearchIndexSliceTask
+ * \brief Builds the trigram lists of a slice of the sorted ids
+ */
+class SearchIndexSliceTask : public QRunnable
+{
+public:
+	SearchIndexSliceTask(const QStringList* p_foldedIds, int p_first, int p_end, QHash<quint64, QVector<int> >* p_positionsByTrigram)
+		: QRunnable(), __foldedIds(p_foldedIds), __first(p_first), __end(p_end), __positionsByTrigram(p_positionsByTrigram)
+	{
+		setAutoDelete(true);
+	}
+
+	void run()
+	{
+		for (int pos = __first ; pos < __end ; pos++)
+		{
+			const QString& id = __foldedIds->at(pos);
+			for (int i = 0 ; i + 3 <= id.length() ; i++)
+			{
+				quint64 key = (quint64(id[i].unicode()) << 32) | (quint64(id[i + 1].unicode()) << 16) | quint64(id[i + 2].unicode());
+				QVector<int>& positions = (*__positionsByTrigram)[key];
+
+				// A trigram found several times in an id is only listed once
+				if (positions.isEmpty() || positions.last() != pos) positions.append(pos);
+			}
+		}
+	}
+
+private:
+	const QStringList* __foldedIds;  //!< All the folded ids
+	int __first;  //!< First position of the slice
+	int __end;  //!< Position following the slice
+	QHash<quint64, QVector<int> >* __positionsByTrigram;  //!< Lists of the slice, owned by the caller
+};
+
+AnalysisSearchIndex::AnalysisSearchIndex()
+{
+}
+
+AnalysisSearchIndex::~AnalysisSearchIndex()
+{
+}
+
+void AnalysisSearchIndex::build(const QStringList& p_ids)
+{
+	AnalysisTraceScope ts("search_index", AnalysisTracer::CATEGORY_COVERAGE);
+
+	// Ids sorted by their folded form (the same QString data is shared with the caller)
+	QVector< QPair<QString, QString> > sorted;
+	sorted.reserve(p_ids.count());
+	foreach(QString id, p_ids)
+	{
+		sorted.append(qMakePair(id.toCaseFolded(), id));
+	}
+	qSort(sorted);
+
+	__ids.clear();
+	__foldedIds.clear();
+	__ids.reserve(sorted.count());
+	__foldedIds.reserve(sorted.count());
+	for (int i = 0 ; i < sorted.count() ; i++)
+	{
+		__foldedIds.append(sorted[i].first);
+		__ids.append(sorted[i].second);
+	}
+
+	// Trigram lists, one slice of the ids by thread
+	int nbSlices = qBound(1, __ids.count() / MIN_IDS_BY_SLICE, qMax(1, QThread::idealThreadCount()));
+	QVector< QHash<quint64, QVector<int> > > slices(nbSlices);
+
+	QThreadPool pool;
+	pool.setMaxThreadCount(nbSlices);
+	for (int s = 0 ; s < nbSlices ; s++)
+	{
+		int first = int(qint64(__ids.count()) * s / nbSlices);
+		int end = int(qint64(__ids.count()) * (s + 1) / nbSlices);
+		pool.start(new SearchIndexSliceTask(&__foldedIds, first, end, &slices[s]));
+	}
+	pool.waitForDone();
+
+	// The slices follow the order of the ids : the concatenated lists stay sorted
+	__positionsByTrigram = slices[0];
+	for (int s = 1 ; s < nbSlices ; s++)
+	{
+		QHash<quint64, QVector<int> >::const_iterator it;
+		for (it = slices[s].constBegin() ; it != slices[s].constEnd() ; ++it)
+		{
+			__positionsByTrigram[it.key()] += it.value();
+		}
+	}
+
+	qDebug() << "AnalysisSearchIndex::build : " << __ids.count() << " exigences, " << __positionsByTrigram.count()
+	         << " trigrammes, " << nbSlices << " threads";
+}
+
+QVector<int> AnalysisSearchIndex::__candidates(const QString& p_foldedText) const
+{
+	// The intersection starts with the shortest list
+	QVector<const QVector<int>*> lists;
+	for (int i = 0 ; i + 3 <= p_foldedText.length() ; i++)
+	{
+		QHash<quint64, QVector<int> >::const_iterator it = __positionsByTrigram.constFind(__trigramKey(p_foldedText, i));
+		if (it == __positionsByTrigram.constEnd()) return (QVector<int>());
+
+		lists.append(&it.value());
+	}
+	std::sort(lists.begin(), lists.end(), [](const QVector<int>* a, const QVector<int>* b) { return (a->count() < b->count()); });
+
+	QVector<int> retVal = *lists[0];
+	for (int l = 1 ; l < lists.count() && !retVal.isEmpty() ; l++)
+	{
+		QVector<int> kept;
+		std::set_intersection(retVal.constBegin(), retVal.constEnd(), lists[l]->constBegin(), lists[l]->constEnd(), std::back_inserter(kept));
+		retVal = kept;
+	}
+
+	return (retVal);
+}
+
+int AnalysisSearchIndex::__skipEscape(const QString& p_pattern, int p_index)
+{
+	QChar e = p_pattern[p_index];
+	int last = p_index;
+
+	if (p_index + 1 < p_pattern.length() && p_pattern[p_index + 1] == '{' && QString("xopPNgk").contains(e))
+	{
+		// \x{263a}, \p{Lu}, \g{1} ...
+		int closing = p_pattern.indexOf('}', p_index + 1);
+		return (closing < 0 ? p_pattern.length() - 1 : closing);
+	}
+
+	if (e == 'x' || e == 'u')
+	{
+		int nbDigits = (e == 'x' ? 2 : 4);
+		static const QString HEX_DIGITS = "0123456789abcdefABCDEF";
+		while (last + 1 < p_pattern.length() && nbDigits-- > 0 && HEX_DIGITS.contains(p_pattern[last + 1])) last++;
+	}
+	else if (e == 'c')
+	{
+		if (last + 1 < p_pattern.length()) last++;
+	}
+	else if (e.isDigit())
+	{
+		while (last + 1 < p_pattern.length() && p_pattern[last + 1].isDigit()) last++;
+	}
+
+	return (last);
+}
+
+QString AnalysisSearchIndex::__longestLiteral(const QString& p_pattern)
+{
+	static const QString METACHARACTERS = "\\^$.|?*+()[]{}";
+
+	// Alternatives would need one literal each
+	if (p_pattern.contains('|')) return (QString());
+
+	QString longest;
+	QString current;
+	for (int i = 0 ; i < p_pattern.length() ; i++)
+	{
+		QChar c = p_pattern[i];
+		bool isLiteral = !METACHARACTERS.contains(c);
+
+		// An escaped punctuation is a literal, other escapes are classes (\d, \w ...), assertions (\b ...),
+		// back references or character codes (\x41 ...): they end the literal, with their operand
+		if (c == '\\' && i + 1 < p_pattern.length())
+		{
+			if (!p_pattern[i + 1].isLetterOrNumber())
+			{
+				c = p_pattern[++i];
+				isLiteral = true;
+			}
+			else
+			{
+				if (current.length() > longest.length()) longest = current;
+				current.clear();
+				i = __skipEscape(p_pattern, i + 1);
+				continue;
+			}
+		}
+
+		// A character followed by a quantifier allowing zero or several of it is not required as is
+		bool isQuantified = (i + 1 < p_pattern.length() && QString("?*+{").contains(p_pattern[i + 1]));
+
+		if (isLiteral && !isQuantified)
+		{
+			current.append(c);
+		}
+		else
+		{
+			if (current.length() > longest.length()) longest = current;
+			current.clear();
+		}
+
+		// A group, a class or a repetition count is skipped entirely (it may be optional)
+		if (!isLiteral && (c == '[' || c == '(' || c == '{'))
+		{
+			QChar closing = (c == '[' ? ']' : (c == '(' ? ')' : '}'));
+			int depth = 1;
+			while (i + 1 < p_pattern.length() && depth > 0)
+			{
+				i++;
+				if (p_pattern[i] == '\\')
+				{
+					i++;
+				}
+				else if (p_pattern[i] == c && c == '(')
+				{
+					depth++;
+				}
+				else if (p_pattern[i] == closing)
+				{
+					depth--;
+				}
+			}
+		}
+	}
+	if (current.length() > longest.length()) longest = current;
+
+	return (longest.toCaseFolded());
+}
+
+QStringList AnalysisSearchIndex::search(const QString& p_text, Mode p_mode, int p_maxResults, bool* p_isTruncated) const
+{
+	QStringList retVal;
+	bool isTruncated = false;
+
+	if (p_text.isEmpty() || p_maxResults <= 0)
+	{
+		if (p_isTruncated) *p_isTruncated = false;
+		return (retVal);
+	}
+
+	QString folded = p_text.toCaseFolded();
+	if (p_mode == PREFIX)
+	{
+		QStringList::const_iterator it = std::lower_bound(__foldedIds.constBegin(), __foldedIds.constEnd(), folded);
+		for (int pos = int(it - __foldedIds.constBegin()) ; pos < __foldedIds.count() && __foldedIds[pos].startsWith(folded) ; pos++)
+		{
+			if (retVal.count() == p_maxResults)
+			{
+				isTruncated = true;
+				break;
+			}
+			retVal.append(__ids[pos]);
+		}
+	}
+	else
+	{
+		QRegularExpression re;
+		QString literal = folded;
+		if (p_mode == REGEX)
+		{
+			re.setPattern(p_text);
+			re.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+			if (!re.isValid())
+			{
+				qDebug() << "AnalysisSearchIndex::search : expression invalide " << p_text << " : " << re.errorString();
+				if (p_isTruncated) *p_isTruncated = false;
+				return (retVal);
+			}
+			literal = __longestLiteral(p_text);
+		}
+
+		// Without any trigram every id is a candidate
+		bool isScan = (literal.length() < 3);
+		QVector<int> candidates;
+		if (!isScan) candidates = __candidates(literal);
+		int nbCandidates = (isScan ? __ids.count() : candidates.count());
+
+		for (int c = 0 ; c < nbCandidates ; c++)
+		{
+			int pos = (isScan ? c : candidates[c]);
+			bool isMatching = (p_mode == REGEX ? re.match(__ids[pos]).hasMatch() : __foldedIds[pos].contains(folded));
+			if (!isMatching) continue;
+
+			if (retVal.count() == p_maxResults)
+			{
+				isTruncated = true;
+				break;
+			}
+			retVal.append(__ids[pos]);
+		}
+	}
+
+	if (p_isTruncated) *p_isTruncated = isTruncated;
+	return (retVal);
+}
+
+AnalysisSearchIndex::Mode AnalysisSearchIndex::stringToMode(const QString& p_name, bool* p_ok)
+{
+	Mode retVal = SUBSTRING;
+	bool isKnown = true;
+
+	if (p_name == "prefix")
+	{
+		retVal = PREFIX;
+	}
+	else if (p_name == "regex")
+	{
+		retVal = REGEX;
+	}
+	else if (p_name != "contains")
+	{
+		isKnown = false;
+	}
+
+	if (p_ok) *p_ok = isKnown;
+	return (retVal);
+}
@@ -0,0 +1,229 @@
+/*!
+ * \file AnalysisSnapshot.cpp
+ * \brief Implementation of the class AnalysisSnapshot
+ * \date 2016-10-26
+ * \author f.souliers
+ */
+
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QObject>
+
+#include "AnalysisSnapshot.h"
+
+static const quint32 SNAPSHOT_FILE_MAGIC = 0x524b5853;  //!< "RKXS", first bytes of a snapshot file
+static const quint32 SNAPSHOT_FILE_VERSION = 2;  //!< Version of the content, incremented when it changes
+static const int SNAPSHOT_FILE_COMPRESSION = 6;  //!< zlib level, the ids are very repetitive
+
+/*!
+ * \brief Serialization of the requirements of a snapshot
+ */
+static QDataStream& operator<<(QDataStream& p_stream, const AnalysisSnapshot::requirement_t& p_req)
+{
+	p_stream << p_req.id << p_req.fileId << p_req.expectedBy << p_req.isConsistent << p_req.mustBeCovered << p_req.coverage
+	         << p_req.downstreamId << p_req.upstreamIds << p_req.composingIds << p_req.compositeIds;
+	return (p_stream);
+}
+
+/*!
+ * \brief Deserialization of the requirements of a snapshot
+ */
+static QDataStream& operator>>(QDataStream& p_stream, AnalysisSnapshot::requirement_t& p_req)
+{
+	p_stream >> p_req.id >> p_req.fileId >> p_req.expectedBy >> p_req.isConsistent >> p_req.mustBeCovered >> p_req.coverage
+	         >> p_req.downstreamId >> p_req.upstreamIds >> p_req.composingIds >> p_req.compositeIds;
+	return (p_stream);
+}
+
+/*!
+ * \brief Serialization of the files of a snapshot
+ */
+static QDataStream& operator<<(QDataStream& p_stream, const AnalysisSnapshot::file_t& p_file)
+{
+	p_stream << p_file.id << p_file.path << qint32(p_file.nbRequirements) << qint32(p_file.nbErrors)
+	         << p_file.mustHaveDownstreamDocuments << p_file.coverage << p_file.upstreamDocuments << p_file.downstreamDocuments;
+	return (p_stream);
+}
+
+/*!
+ * \brief Deserialization of the files of a snapshot
+ */
+static QDataStream& operator>>(QDataStream& p_stream, AnalysisSnapshot::file_t& p_file)
+{
+	qint32 nbRequirements;
+	qint32 nbErrors;
+	p_stream >> p_file.id >> p_file.path >> nbRequirements >> nbErrors
+	         >> p_file.mustHaveDownstreamDocuments >> p_file.coverage >> p_file.upstreamDocuments >> p_file.downstreamDocuments;
+	p_file.nbRequirements = nbRequirements;
+	p_file.nbErrors = nbErrors;
+	return (p_stream);
+}
+
+AnalysisSnapshot::AnalysisSnapshot(int p_runId)
+	: __runId(p_runId), __creationDate(QDateTime::currentDateTime())
+{
+}
+
+AnalysisSnapshot::~AnalysisSnapshot()
+{
+}
+
+void AnalysisSnapshot::addRequirement(const requirement_t& p_req)
+{
+	__reqsById.insert(p_req.id, p_req);
+}
+
+void AnalysisSnapshot::addFile(const file_t& p_file)
+{
+	__filesById.insert(p_file.id, p_file);
+}
+
+const AnalysisSnapshot::requirement_t* AnalysisSnapshot::getRequirement(const QString& p_id) const
+{
+	QHash<QString, requirement_t>::const_iterator it = __reqsById.constFind(p_id);
+	if (it == __reqsById.constEnd()) return (NULL);
+
+	return (&it.value());
+}
+
+bool AnalysisSnapshot::save(const QString& p_path) const
+{
+	// The requirements are written sorted, so that two saves of the same analysis are identical
+	QByteArray content;
+	QDataStream out(&content, QIODevice::WriteOnly);
+	out.setVersion(QDataStream::Qt_5_0);
+
+	out << qint32(__runId) << __creationDate;
+	QStringList ids = getRequirementIds();
+	out << qint32(ids.count());
+	foreach(QString id, ids)
+	{
+		out << __reqsById[id];
+	}
+
+	out << qint32(__filesById.count());
+	foreach(file_t f, __filesById)
+	{
+		out << f;
+	}
+
+	out << qint32(__errors.count());
+	foreach(AnalysisError e, __errors)
+	{
+		// The code and its arguments rather than the description, which is translated when displayed
+		out << qint32(e.getSeverity()) << qint32(e.getCategory()) << e.getLocation() << qint32(e.getCode());
+		for (int a = 0 ; a < AnalysisError::MAX_ARGUMENTS ; a++)
+		{
+			out << e.getArgument(a);
+		}
+	}
+
+	QFile fout(p_path);
+	if (!fout.open(QIODevice::WriteOnly))
+	{
+		qDebug() << "AnalysisSnapshot::save : unable to open " << p_path;
+		return (false);
+	}
+
+	QDataStream header(&fout);
+	header.setVersion(QDataStream::Qt_5_0);
+	header << SNAPSHOT_FILE_MAGIC << SNAPSHOT_FILE_VERSION << qCompress(content, SNAPSHOT_FILE_COMPRESSION);
+	fout.close();
+
+	return (header.status() == QDataStream::Ok);
+}
+
+AnalysisSnapshotPtr AnalysisSnapshot::load(const QString& p_path, QString& p_errMsg)
+{
+	QFile fin(p_path);
+	if (!fin.open(QIODevice::ReadOnly))
+	{
+		p_errMsg = QObject::trUtf8("Impossible d'ouvrir l'analyse enregistrée %1").arg(p_path);
+		return (AnalysisSnapshotPtr());
+	}
+
+	QDataStream header(&fin);
+	header.setVersion(QDataStream::Qt_5_0);
+	quint32 magic = 0;
+	quint32 version = 0;
+	QByteArray compressed;
+	header >> magic >> version;
+	if (magic != SNAPSHOT_FILE_MAGIC || version != SNAPSHOT_FILE_VERSION)
+	{
+		p_errMsg = QObject::trUtf8("%1 n'est pas une analyse enregistrée par cette version de Rekkix").arg(p_path);
+		return (AnalysisSnapshotPtr());
+	}
+	header >> compressed;
+
+	QByteArray content = qUncompress(compressed);
+	QDataStream in(content);
+	in.setVersion(QDataStream::Qt_5_0);
+
+	qint32 runId = 0;
+	QDateTime creationDate;
+	in >> runId >> creationDate;
+
+	AnalysisSnapshot* snapshot = new AnalysisSnapshot(runId);
+	snapshot->__creationDate = creationDate;
+
+	qint32 nbItems = 0;
+	in >> nbItems;
+	snapshot->__reqsById.reserve(nbItems);
+	for (qint32 i = 0 ; i < nbItems && in.status() == QDataStream::Ok ; i++)
+	{
+		requirement_t r;
+		in >> r;
+		snapshot->addRequirement(r);
+	}
+
+	in >> nbItems;
+	for (qint32 i = 0 ; i < nbItems && in.status() == QDataStream::Ok ; i++)
+	{
+		file_t f;
+		in >> f;
+		snapshot->addFile(f);
+	}
+
+	in >> nbItems;
+	for (qint32 i = 0 ; i < nbItems && in.status() == QDataStream::Ok ; i++)
+	{
+		qint32 severity;
+		qint32 category;
+		QString location;
+		qint32 code;
+		QString args[AnalysisError::MAX_ARGUMENTS];
+		in >> severity >> category >> location >> code;
+		for (int a = 0 ; a < AnalysisError::MAX_ARGUMENTS ; a++)
+		{
+			in >> args[a];
+		}
+
+		snapshot->__errors.append(AnalysisError(AnalysisError::severity_t(severity), AnalysisError::category_t(category), location,
+		                                        AnalysisError::code_t(code), args[0], args[1], args[2], args[3]));
+	}
+
+	if (content.isEmpty() || in.status() != QDataStream::Ok)
+	{
+		delete (snapshot);
+		p_errMsg = QObject::trUtf8("L'analyse enregistrée %1 est corrompue").arg(p_path);
+		return (AnalysisSnapshotPtr());
+	}
+
+	return (AnalysisSnapshotPtr(snapshot));
+}
+
+QStringList AnalysisSnapshot::getRequirementIds() const
+{
+	QStringList retVal = __reqsById.keys();
+	retVal.sort();
+	return (retVal);
+}
+
+const AnalysisSnapshot::file_t* AnalysisSnapshot::getFile(const QString& p_id) const
+{
+	QMap<QString, file_t>::const_iterator it = __filesById.constFind(p_id);
+	if (it == __filesById.constEnd()) return (NULL);
+
+	return (&it.value());
+}
@@ -0,0 +1,284 @@
+/*!
+ * \file AnalysisSnapshotDiff.cpp
+ * \brief Implementation of the class AnalysisSnapshotDiff
+ * \date 2016-11-02
+ * \author f.souliers
+ */
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QObject>
+#include <QPair>
+#include <QStringList>
+#include <QtAlgorithms>
+
+#include "AnalysisSnapshotDiff.h"
+#include "AnalysisTracer.h"
+#include "Requirement.h"
+
+static const double COVERAGE_EPSILON = 1e-9;  //!< Coverages closer than this are equal
+
+/*!
+ * \brief Text of a coverage, as displayed in the reports
+ */
+static QString coverageToString(double p_coverage)
+{
+	if (p_coverage == Requirement::COVERAGE_INVALID_VALUE) return (QObject::trUtf8("invalide"));
+	return (QString("%1 %").arg(p_coverage * 100));
+}
+
+/*!
+ * \brief Text of the links of a requirement, in an order that does not depend on the parsing
+ */
+static QString linksToString(const AnalysisSnapshot::requirement_t& p_req)
+{
+	QStringList parts;
+	QStringList ids;
+
+	if (!p_req.downstreamId.isEmpty()) parts << QObject::trUtf8("couverte par %1").arg(p_req.downstreamId);
+
+	ids = p_req.upstreamIds;
+	ids.sort();
+	if (!ids.isEmpty()) parts << QObject::trUtf8("couvre %1").arg(ids.join(", "));
+
+	ids = p_req.composingIds;
+	ids.sort();
+	if (!ids.isEmpty()) parts << QObject::trUtf8("composée de %1").arg(ids.join(", "));
+
+	ids = p_req.compositeIds;
+	ids.sort();
+	if (!ids.isEmpty()) parts << QObject::trUtf8("compose %1").arg(ids.join(", "));
+
+	return (parts.join(" ; "));
+}
+
+/*!
+ * \brief Key of an error, errors with the same key are considered as the same error
+ */
+static QString errorKey(const AnalysisError& p_error)
+{
+	// The code and the arguments are enough, the descriptions are only built for the changes
+	QString key = p_error.getLocation() + QChar(0) + QString::number(p_error.getSeverity()) + QChar(0)
+	              + QString::number(p_error.getCategory()) + QChar(0) + QString::number(p_error.getCode());
+	for (int a = 0 ; a < AnalysisError::MAX_ARGUMENTS ; a++)
+	{
+		key += QChar(0) + p_error.getArgument(a);
+	}
+
+	return (key);
+}
+
+AnalysisSnapshotDiff::AnalysisSnapshotDiff()
+	: __nbChangesByKind(NB_CHANGE_KINDS, 0)
+{
+}
+
+AnalysisSnapshotDiff::~AnalysisSnapshotDiff()
+{
+}
+
+void AnalysisSnapshotDiff::compute(const AnalysisSnapshot& p_baseline, const AnalysisSnapshot& p_current)
+{
+	AnalysisTraceScope ts("snapshot_diff", AnalysisTracer::CATEGORY_REPORT);
+
+	__changes.clear();
+	__nbChangesByKind.fill(0, NB_CHANGE_KINDS);
+	__baselineDate = p_baseline.getCreationDate();
+	__currentDate = p_current.getCreationDate();
+
+	__compareRequirements(p_baseline, p_current);
+	__compareFiles(p_baseline, p_current);
+	__compareErrors(p_baseline, p_current);
+
+	// Grouped by kind, the merges having produced the items of each kind in order (the sort is stable)
+	std::stable_sort(__changes.begin(), __changes.end(),
+	                 [](const change_t& a, const change_t& b) { return (a.kind < b.kind); });
+
+	qDebug() << "AnalysisSnapshotDiff::compute : " << __changes.count() << " changements";
+}
+
+void AnalysisSnapshotDiff::__addChange(ChangeKind p_kind, const QString& p_item, const QString& p_location,
+                                       const QString& p_before, const QString& p_after)
+{
+	change_t c;
+	c.kind = p_kind;
+	c.item = p_item;
+	c.location = p_location;
+	c.before = p_before;
+	c.after = p_after;
+
+	__changes.append(c);
+	__nbChangesByKind[p_kind]++;
+}
+
+void AnalysisSnapshotDiff::__compareRequirements(const AnalysisSnapshot& p_baseline, const AnalysisSnapshot& p_current)
+{
+	QStringList baselineIds = p_baseline.getRequirementIds();
+	QStringList currentIds = p_current.getRequirementIds();
+
+	int i = 0;
+	int j = 0;
+	while (i < baselineIds.count() || j < currentIds.count())
+	{
+		if (j == currentIds.count() || (i < baselineIds.count() && baselineIds[i] < currentIds[j]))
+		{
+			const AnalysisSnapshot::requirement_t* r = p_baseline.getRequirement(baselineIds[i++]);
+			__addChange(REQ_REMOVED, r->id, r->fileId, coverageToString(r->coverage), QString());
+		}
+		else if (i == baselineIds.count() || currentIds[j] < baselineIds[i])
+		{
+			const AnalysisSnapshot::requirement_t* r = p_current.getRequirement(currentIds[j++]);
+			__addChange(REQ_ADDED, r->id, r->fileId, QString(), coverageToString(r->coverage));
+		}
+		else
+		{
+			const AnalysisSnapshot::requirement_t* before = p_baseline.getRequirement(baselineIds[i++]);
+			const AnalysisSnapshot::requirement_t* after = p_current.getRequirement(currentIds[j++]);
+
+			if (before->fileId != after->fileId)
+			{
+				__addChange(REQ_FILE_CHANGED, after->id, after->fileId, before->fileId, after->fileId);
+			}
+
+			// The invalid coverage is the lowest value, so it is a drop
+			if (after->coverage < before->coverage - COVERAGE_EPSILON)
+			{
+				__addChange(REQ_COVERAGE_DROPPED, after->id, after->fileId, coverageToString(before->coverage), coverageToString(after->coverage));
+			}
+			else if (after->coverage > before->coverage + COVERAGE_EPSILON)
+			{
+				__addChange(REQ_COVERAGE_RAISED, after->id, after->fileId, coverageToString(before->coverage), coverageToString(after->coverage));
+			}
+
+			QString linksBefore = linksToString(*before);
+			QString linksAfter = linksToString(*after);
+			if (linksBefore != linksAfter)
+			{
+				__addChange(REQ_LINKS_CHANGED, after->id, after->fileId, linksBefore, linksAfter);
+			}
+		}
+	}
+}
+
+void AnalysisSnapshotDiff::__compareFiles(const AnalysisSnapshot& p_baseline, const AnalysisSnapshot& p_current)
+{
+	QStringList baselineIds = p_baseline.getFileIds();
+	QStringList currentIds = p_current.getFileIds();
+
+	int i = 0;
+	int j = 0;
+	while (i < baselineIds.count() || j < currentIds.count())
+	{
+		if (j == currentIds.count() || (i < baselineIds.count() && baselineIds[i] < currentIds[j]))
+		{
+			const AnalysisSnapshot::file_t* f = p_baseline.getFile(baselineIds[i++]);
+			__addChange(FILE_REMOVED, f->id, f->path, coverageToString(f->coverage), QString());
+		}
+		else if (i == baselineIds.count() || currentIds[j] < baselineIds[i])
+		{
+			const AnalysisSnapshot::file_t* f = p_current.getFile(currentIds[j++]);
+			__addChange(FILE_ADDED, f->id, f->path, QString(), coverageToString(f->coverage));
+		}
+		else
+		{
+			const AnalysisSnapshot::file_t* before = p_baseline.getFile(baselineIds[i++]);
+			const AnalysisSnapshot::file_t* after = p_current.getFile(currentIds[j++]);
+
+			if (after->coverage < before->coverage - COVERAGE_EPSILON)
+			{
+				__addChange(FILE_COVERAGE_DROPPED, after->id, after->path, coverageToString(before->coverage), coverageToString(after->coverage));
+			}
+			else if (after->coverage > before->coverage + COVERAGE_EPSILON)
+			{
+				__addChange(FILE_COVERAGE_RAISED, after->id, after->path, coverageToString(before->coverage), coverageToString(after->coverage));
+			}
+		}
+	}
+}
+
+void AnalysisSnapshotDiff::__compareErrors(const AnalysisSnapshot& p_baseline, const AnalysisSnapshot& p_current)
+{
+	// Errors have no id : they are sorted by their content, an error found twice must be found twice again
+	QVector< QPair<QString, int> > baselineKeys;
+	baselineKeys.reserve(p_baseline.getErrors().count());
+	for (int e = 0 ; e < p_baseline.getErrors().count() ; e++)
+	{
+		baselineKeys.append(qMakePair(errorKey(p_baseline.getErrors()[e]), e));
+	}
+	qSort(baselineKeys);
+
+	QVector< QPair<QString, int> > currentKeys;
+	currentKeys.reserve(p_current.getErrors().count());
+	for (int e = 0 ; e < p_current.getErrors().count() ; e++)
+	{
+		currentKeys.append(qMakePair(errorKey(p_current.getErrors()[e]), e));
+	}
+	qSort(currentKeys);
+
+	int i = 0;
+	int j = 0;
+	while (i < baselineKeys.count() || j < currentKeys.count())
+	{
+		if (j == currentKeys.count() || (i < baselineKeys.count() && baselineKeys[i].first < currentKeys[j].first))
+		{
+			const AnalysisError& e = p_baseline.getErrors()[baselineKeys[i++].second];
+			__addChange(ERROR_REMOVED, e.getSeverityString() + " / " + e.getCategoryString(), e.getLocation(), e.getDescription(), QString());
+		}
+		else if (i == baselineKeys.count() || currentKeys[j].first < baselineKeys[i].first)
+		{
+			const AnalysisError& e = p_current.getErrors()[currentKeys[j++].second];
+			__addChange(ERROR_ADDED, e.getSeverityString() + " / " + e.getCategoryString(), e.getLocation(), QString(), e.getDescription());
+		}
+		else
+		{
+			i++;
+			j++;
+		}
+	}
+}
+
+QString AnalysisSnapshotDiff::kindToString(ChangeKind p_kind)
+{
+	switch (p_kind)
+	{
+		case REQ_ADDED:
+			return (QObject::trUtf8("Exigence ajoutée"));
+		case REQ_REMOVED:
+			return (QObject::trUtf8("Exigence supprimée"));
+		case REQ_FILE_CHANGED:
+			return (QObject::trUtf8("Exigence déplacée"));
+		case REQ_COVERAGE_DROPPED:
+			return (QObject::trUtf8("Couverture d'exigence en baisse"));
+		case REQ_COVERAGE_RAISED:
+			return (QObject::trUtf8("Couverture d'exigence en hausse"));
+		case REQ_LINKS_CHANGED:
+			return (QObject::trUtf8("Liens d'exigence modifiés"));
+		case FILE_ADDED:
+			return (QObject::trUtf8("Fichier ajouté"));
+		case FILE_REMOVED:
+			return (QObject::trUtf8("Fichier supprimé"));
+		case FILE_COVERAGE_DROPPED:
+			return (QObject::trUtf8("Couverture de fichier en baisse"));
+		case FILE_COVERAGE_RAISED:
+			return (QObject::trUtf8("Couverture de fichier en hausse"));
+		case ERROR_ADDED:
+			return (QObject::trUtf8("Nouvelle erreur"));
+		case ERROR_REMOVED:
+			return (QObject::trUtf8("Erreur disparue"));
+		default:
+			return (QString());
+	}
+}
+
+QStringList AnalysisSnapshotDiff::getSummary() const
+{
+	QStringList retVal;
+	for (int k = 0 ; k < NB_CHANGE_KINDS ; k++)
+	{
+		if (__nbChangesByKind[k] > 0) retVal << QString("%1 : %2").arg(kindToString(ChangeKind(k))).arg(__nbChangesByKind[k]);
+	}
+
+	if (retVal.isEmpty()) retVal << QObject::trUtf8("Aucun changement");
+	return (retVal);
+}
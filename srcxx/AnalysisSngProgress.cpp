@@ -0,0 +1,71 @@
+/*!
+ * \file AnalysisSngProgress.cpp
+ * \brief Implementation of the class AnalysisSngProgress
+ * \date 2016-10-21
+ * \author f.souliers
+ */
+
+#include <QObject>
+#include <QString>
+
+#include "AnalysisSngProgress.h"
+
+static const double BYTES_PER_MB = 1024.0 * 1024.0;  //!< Used to display the throughput
+
+AnalysisSngProgress::AnalysisSngProgress()
+	: __processedBytes(0), __totalBytes(0)
+{
+	__elapsed.start();
+}
+
+AnalysisSngProgress::~AnalysisSngProgress()
+{
+}
+
+void AnalysisSngProgress::start(qint64 p_totalBytes)
+{
+	__processedBytes.store(0);
+	__totalBytes.store(p_totalBytes);
+	__elapsed.restart();
+}
+
+AnalysisSngProgress::progress_t AnalysisSngProgress::getProgress() const
+{
+	progress_t p;
+	p.processedBytes = __processedBytes.load();
+	p.totalBytes = __totalBytes.load();
+
+	if (p.totalBytes > 0)
+	{
+		p.ratio = qBound(0.0, static_cast<double>(p.processedBytes) / p.totalBytes, 1.0);
+	}
+	else
+	{
+		p.ratio = 0.0;
+	}
+
+	double seconds = __elapsed.elapsed() / 1000.0;
+	p.bytesPerSecond = (seconds > 0.0) ? p.processedBytes / seconds : 0.0;
+
+	// No estimation until something has been processed
+	if (p.bytesPerSecond > 0.0)
+	{
+		p.remainingSeconds = qMax(0LL, p.totalBytes - p.processedBytes) / p.bytesPerSecond;
+	}
+	else
+	{
+		p.remainingSeconds = -1.0;
+	}
+
+	return (p);
+}
+
+QString AnalysisSngProgress::toString(const progress_t& p)
+{
+	QString s = QObject::trUtf8("%1 Mo/s").arg(p.bytesPerSecond / BYTES_PER_MB, 0, 'f', 1);
+	if (p.remainingSeconds >= 0.0)
+	{
+		s += QObject::trUtf8(", reste %1 s").arg(qRound(p.remainingSeconds));
+	}
+	return (s);
+}
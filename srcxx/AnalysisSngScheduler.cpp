@@ -0,0 +1,335 @@
+/*!
+ * \file AnalysisSngScheduler.cpp
+ * \brief Implementation of the class AnalysisSngScheduler
+ * \date 2016-11-07
+ * \author f.souliers
+ */
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QObject>
+#include <QPair>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QStringList>
+
+#include "AnalysisSngScheduler.h"
+#include "AnalysisSngTextCache.h"
+
+static const quint32 COSTS_FILE_MAGIC = 0x524b5843;  //!< "RKXC", first bytes of the history file
+static const quint32 COSTS_FILE_VERSION = 1;  //!< Version of the content, incremented when it changes
+static const qint64 FILE_OVERHEAD_US = 2000;  //!< Cost of a file whatever its size (thread, opening ...)
+static const double LEARNING_RATE = 0.3;  //!< Weight of the last run in the learnt cost by byte of a format
+
+/*!
+ * \brief Path of the history file
+ */
+static QString historyPath()
+{
+	return (QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/Rekkix/parsing_costs.dat");
+}
+
+/*!
+ * \brief Cost by byte of a format before anything has been learnt, only the orders of magnitude matter
+ */
+static double defaultNsPerByte(const QString& p_format)
+{
+	if (p_format.startsWith("pdf")) return (2000.0);
+	if (p_format.startsWith("docx") || p_format.startsWith("odt")) return (150.0);
+	if (p_format.startsWith("txt")) return (30.0);
+	return (200.0);
+}
+
+/*!
+ * \brief Duration in milliseconds, as displayed
+ */
+static QString usToMs(qint64 p_us)
+{
+	return (QString::number(p_us / 1000.0, 'f', 1));
+}
+
+AnalysisSngScheduler::AnalysisSngScheduler()
+	: __isHistoryLoaded(false), __nbWorkers(1), __predictedMakespanUs(0), __actualMakespanUs(-1)
+{
+}
+
+AnalysisSngScheduler::~AnalysisSngScheduler()
+{
+}
+
+double AnalysisSngScheduler::__getNsPerByte(const QString& p_format) const
+{
+	return (__nsPerByteByFormat.value(p_format, defaultNsPerByte(p_format)));
+}
+
+qint64 AnalysisSngScheduler::__predictCost(RequirementFileAbstractPtr p_file, bool* p_isFromHistory)
+{
+	__loadHistory();
+
+	QString format = p_file->getTextUnitsFormat();
+	qint64 size = p_file->getFileSize();
+	qint64 retVal;
+
+	QHash<QString, history_t>::const_iterator it = __historyByDocument.constFind(AnalysisSngTextCache::getDocumentKey(p_file->getFilePath(), format));
+	bool isFromHistory = (it != __historyByDocument.constEnd());
+	if (isFromHistory)
+	{
+		// A document usually grows or shrinks a little between two analyses
+		retVal = it->durationUs;
+		if (it->sizeBytes > 0) retVal = qint64(double(it->durationUs) * size / it->sizeBytes);
+	}
+	else
+	{
+		retVal = FILE_OVERHEAD_US + qint64(__getNsPerByte(format) * size / 1000.0);
+	}
+
+	if (p_isFromHistory) *p_isFromHistory = isFromHistory;
+	return (retVal);
+}
+
+qint64 AnalysisSngScheduler::predictCost(RequirementFileAbstractPtr p_file)
+{
+	QMutexLocker l(&__mutex);
+	return (__predictCost(p_file));
+}
+
+QVector<RequirementFileAbstractPtr> AnalysisSngScheduler::orderLongestFirst(const QVector<RequirementFileAbstractPtr>& p_files)
+{
+	QMutexLocker l(&__mutex);
+
+	QVector< QPair<qint64, int> > costs;
+	costs.reserve(p_files.count());
+	for (int i = 0 ; i < p_files.count() ; i++)
+	{
+		costs.append(qMakePair(__predictCost(p_files[i]), i));
+	}
+
+	// Decreasing cost, the files of the same cost staying in their order
+	std::stable_sort(costs.begin(), costs.end(),
+	                 [](const QPair<qint64, int>& a, const QPair<qint64, int>& b) { return (a.first > b.first); });
+
+	QVector<RequirementFileAbstractPtr> retVal;
+	retVal.reserve(p_files.count());
+	for (int i = 0 ; i < costs.count() ; i++)
+	{
+		retVal.append(p_files[costs[i].second]);
+	}
+
+	return (retVal);
+}
+
+QVector<RequirementFileAbstractPtr> AnalysisSngScheduler::startRun(const QVector<RequirementFileAbstractPtr>& p_files, int p_nbWorkers)
+{
+	QVector<RequirementFileAbstractPtr> retVal = orderLongestFirst(p_files);
+
+	QMutexLocker l(&__mutex);
+	__jobs.clear();
+	__jobIndexByFile.clear();
+	__nbWorkers = qMax(1, p_nbWorkers);
+	__actualMakespanUs = -1;
+
+	// The starter gives each file to the first free thread : the run is simulated the same way
+	std::priority_queue<qint64, std::vector<qint64>, std::greater<qint64> > workersEnd;
+	for (int w = 0 ; w < __nbWorkers ; w++)
+	{
+		workersEnd.push(0);
+	}
+
+	__predictedMakespanUs = 0;
+	foreach(RequirementFileAbstractPtr f, retVal)
+	{
+		job_t j;
+		j.fileId = f->getFileId();
+		j.format = f->getTextUnitsFormat();
+		j.documentKey = AnalysisSngTextCache::getDocumentKey(f->getFilePath(), j.format);
+		j.sizeBytes = f->getFileSize();
+		j.predictedUs = __predictCost(f, &j.isFromHistory);
+		j.actualUs = -1;
+		j.isTextExtracted = false;
+
+		__jobIndexByFile.insert(f, __jobs.count());
+		__jobs.append(j);
+
+		qint64 end = workersEnd.top() + j.predictedUs;
+		workersEnd.pop();
+		workersEnd.push(end);
+		__predictedMakespanUs = qMax(__predictedMakespanUs, end);
+	}
+
+	__runTimer.start();
+	return (retVal);
+}
+
+void AnalysisSngScheduler::recordActualCost(RequirementFileAbstractPtr p_file)
+{
+	QMutexLocker l(&__mutex);
+
+	QHash<RequirementFileAbstractPtr, int>::const_iterator it = __jobIndexByFile.constFind(p_file);
+	if (it == __jobIndexByFile.constEnd()) return;
+
+	__jobs[it.value()].actualUs = p_file->getParsingDuration();
+	__jobs[it.value()].sizeBytes = p_file->getFileSize();  // The size of a tree is only known once its files are listed
+	__jobs[it.value()].isTextExtracted = p_file->isTextExtracted();
+}
+
+void AnalysisSngScheduler::endRun()
+{
+	QMutexLocker l(&__mutex);
+	if (__jobIndexByFile.isEmpty()) return;
+
+	__actualMakespanUs = __runTimer.nsecsElapsed() / 1000;
+
+	// The next runs predict from the last durations (a document parsed again costs about the same). A text read
+	// from the cache says nothing about the cost of the document once it changes: only extractions are learnt
+	QHash<QString, double> sumUsByFormat;
+	QHash<QString, qint64> sumBytesByFormat;
+	foreach(job_t j, __jobs)
+	{
+		if (j.actualUs < 0 || !j.isTextExtracted) continue;
+
+		history_t h;
+		h.sizeBytes = j.sizeBytes;
+		h.durationUs = j.actualUs;
+		__historyByDocument.insert(j.documentKey, h);
+
+		sumUsByFormat[j.format] += qMax(qint64(0), j.actualUs - FILE_OVERHEAD_US);
+		sumBytesByFormat[j.format] += j.sizeBytes;
+	}
+
+	QHash<QString, qint64>::const_iterator it;
+	for (it = sumBytesByFormat.constBegin() ; it != sumBytesByFormat.constEnd() ; ++it)
+	{
+		if (it.value() <= 0) continue;
+
+		double observed = sumUsByFormat[it.key()] * 1000.0 / it.value();
+		__nsPerByteByFormat[it.key()] = (1.0 - LEARNING_RATE) * __getNsPerByte(it.key()) + LEARNING_RATE * observed;
+	}
+
+	__jobIndexByFile.clear();
+	__saveHistory();
+
+	qDebug() << "AnalysisSngScheduler::endRun : " << __jobs.count() << " fichiers, durée prévue " << __predictedMakespanUs
+	         << " µs, réelle " << __actualMakespanUs << " µs";
+}
+
+QString AnalysisSngScheduler::getSummary() const
+{
+	QMutexLocker l(&__mutex);
+	if (__jobs.isEmpty() || __actualMakespanUs < 0) return (QString());
+
+	// Mean of the relative errors of the files, the predictions being compared to what actually happened
+	double sumErrors = 0.0;
+	int nbMeasured = 0;
+	foreach(job_t j, __jobs)
+	{
+		if (j.actualUs <= 0) continue;
+
+		sumErrors += qAbs(double(j.predictedUs - j.actualUs)) / j.actualUs;
+		nbMeasured++;
+	}
+
+	return (QObject::trUtf8("Ordonnancement (plus longs d'abord, %1 threads) : durée prévue %2 ms, réelle %3 ms, écart moyen par fichier %4 %")
+	        .arg(__nbWorkers).arg(usToMs(__predictedMakespanUs)).arg(usToMs(__actualMakespanUs))
+	        .arg(nbMeasured > 0 ? qRound(100.0 * sumErrors / nbMeasured) : 0));
+}
+
+QString AnalysisSngScheduler::getJobsTable() const
+{
+	QVector<job_t> jobs = getJobs();
+	if (jobs.isEmpty()) return (QString());
+
+	int idWidth = QString("ID").length();
+	foreach(job_t j, jobs)
+	{
+		idWidth = qMax(idWidth, j.fileId.length());
+	}
+
+	const int colWidth = 14;
+	QString table = QString("ID").leftJustified(idWidth);
+	table += QString(" %1 %2 %3 %4").arg("size (kB)", colWidth).arg("predicted (ms)", colWidth).arg("actual (ms)", colWidth).arg("source", colWidth);
+
+	foreach(job_t j, jobs)
+	{
+		table += "\n" + j.fileId.leftJustified(idWidth);
+		table += QString(" %1 %2 %3 %4").arg(QString::number(j.sizeBytes / 1024.0, 'f', 1), colWidth).arg(usToMs(j.predictedUs), colWidth)
+		         .arg(j.actualUs < 0 ? QString("-") : usToMs(j.actualUs), colWidth).arg(j.isFromHistory ? "history" : "size", colWidth);
+	}
+
+	return (table);
+}
+
+QVector<AnalysisSngScheduler::job_t> AnalysisSngScheduler::getJobs() const
+{
+	QMutexLocker l(&__mutex);
+	return (__jobs);
+}
+
+void AnalysisSngScheduler::__loadHistory()
+{
+	if (__isHistoryLoaded) return;
+	__isHistoryLoaded = true;
+
+	QFile fin(historyPath());
+	if (!fin.open(QIODevice::ReadOnly)) return;
+
+	QDataStream in(&fin);
+	in.setVersion(QDataStream::Qt_5_0);
+	quint32 magic = 0;
+	quint32 version = 0;
+	in >> magic >> version;
+	if (magic != COSTS_FILE_MAGIC || version != COSTS_FILE_VERSION) return;
+
+	qint32 nbDocuments = 0;
+	in >> nbDocuments;
+	for (qint32 i = 0 ; i < nbDocuments && in.status() == QDataStream::Ok ; i++)
+	{
+		QString key;
+		history_t h;
+		in >> key >> h.sizeBytes >> h.durationUs;
+		__historyByDocument.insert(key, h);
+	}
+	in >> __nsPerByteByFormat;
+
+	// A corrupted history is only a worse prediction
+	if (in.status() != QDataStream::Ok)
+	{
+		__historyByDocument.clear();
+		__nsPerByteByFormat.clear();
+	}
+}
+
+void AnalysisSngScheduler::__saveHistory() const
+{
+	QString path = historyPath();
+	if (!QDir().mkpath(QFileInfo(path).absolutePath())) return;
+
+	QSaveFile fout(path);
+	if (!fout.open(QIODevice::WriteOnly))
+	{
+		qDebug() << "AnalysisSngScheduler::__saveHistory : impossible d'ouvrir " << path;
+		return;
+	}
+
+	QDataStream out(&fout);
+	out.setVersion(QDataStream::Qt_5_0);
+	out << COSTS_FILE_MAGIC << COSTS_FILE_VERSION << qint32(__historyByDocument.count());
+	QHash<QString, history_t>::const_iterator it;
+	for (it = __historyByDocument.constBegin() ; it != __historyByDocument.constEnd() ; ++it)
+	{
+		out << it.key() << it->sizeBytes << it->durationUs;
+	}
+	out << __nsPerByteByFormat;
+
+	if (out.status() != QDataStream::Ok || !fout.commit())
+	{
+		qDebug() << "AnalysisSngScheduler::__saveHistory : impossible d'écrire " << path;
+	}
+}
@@ -9,8 +9,10 @@
 #include "AnalysisSngStarterThread.h"
 #include "ModelSngReqMatrix.h"
 
+static const int STARTER_POLLING_PERIOD_MS = 20;  //!< Max time waiting for a free slot before checking for a cancellation
+
 AnalysisSngStarterThread::AnalysisSngStarterThread()
-	: QThread(), QSemaphore()
+	: QThread(), QSemaphore(), __runId(-1)
 {
 
 }
@@ -27,10 +29,37 @@ void AnalysisSngStarterThread::run()
 	{
 		qDebug() << "AnalysisSngStarterThread::run --> remaining available : " << available() ;
 
-		acquire(1) ; // Semaphore control : keep stuck on this call until enough threads have terminated their job
-		             // (ressource is released in Rekkix::slt_reqFileParsingOneMoreFileFinished)
+		// Semaphore control : keep stuck on this call until enough threads have terminated their job
+		// (ressource is released in Rekkix::slt_reqFileParsingOneMoreFileFinished) or the analysis is cancelled
+		while (!tryAcquire(1, STARTER_POLLING_PERIOD_MS))
+		{
+			if (isInterruptionRequested()) return ;
+		}
+		if (isInterruptionRequested())
+		{
+			release(1) ;
+			return ;
+		}
 
+		// The waiter only waits for launched threads : the flag is set once the thread is running
 		(*it_rf)->start() ;
+		(*it_rf)->setThreadActuallyLaunched() ;
 	}
 }
 
+int AnalysisSngStarterThread::borrowSlots(int p_max, int p_runId)
+{
+	QMutexLocker l(&__slotsMutex) ;
+	if (p_runId != __runId) return (0) ;
+
+	int retVal = 0 ;
+	while (retVal < p_max && tryAcquire(1)) retVal++ ;
+
+	return (retVal) ;
+}
+
+void AnalysisSngStarterThread::giveBackSlots(int p_nb, int p_runId)
+{
+	QMutexLocker l(&__slotsMutex) ;
+	if (p_nb > 0 && p_runId == __runId) release(p_nb) ;
+}
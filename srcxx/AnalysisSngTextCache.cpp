@@ -0,0 +1,311 @@
+/*!
+ * \file AnalysisSngTextCache.cpp
+ * \brief Implementation of the class AnalysisSngTextCache
+ * \date 2016-11-04
+ * \author f.souliers
+ */
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include "AnalysisSngTextCache.h"
+
+static const quint32 TEXT_CACHE_FILE_MAGIC = 0x524b5854;  //!< "RKXT", first bytes of an entry
+static const quint32 TEXT_CACHE_FILE_VERSION = 1;  //!< Version of the layout of an entry (the units have their own format)
+static const int TEXT_CACHE_FILE_COMPRESSION = 6;  //!< zlib level, the text of the documents compresses well
+static const QString TEXT_CACHE_FILE_SUFFIX = ".rxt";  //!< Suffix of the entries
+static const double TEXT_CACHE_PRUNED_RATIO = 0.75;  //!< Part of the size of the cache kept by a pruning
+
+AnalysisSngTextCache::AnalysisSngTextCache()
+	: __isEnabled(false), __isPersistent(false), __maxPersistentBytes(0), __persistentBytes(0), __nbHits(0), __nbPersistentHits(0),
+	  __nbMisses(0)
+{
+}
+
+AnalysisSngTextCache::~AnalysisSngTextCache()
+{
+}
+
+void AnalysisSngTextCache::setEnabled(bool p_enabled)
+{
+	QMutexLocker l(&__mutex);
+	__isEnabled = p_enabled;
+	if (!__isEnabled) __documents.clear();
+}
+
+void AnalysisSngTextCache::setPersistent(bool p_persistent, qint64 p_maxSizeBytes, const QString& p_directory)
+{
+	QString directory = (p_directory.isEmpty() ? getDefaultDirectory() : p_directory);
+	if (p_persistent && !QDir().mkpath(directory))
+	{
+		qDebug() << "AnalysisSngTextCache::setPersistent : impossible de créer " << directory;
+		p_persistent = false;
+	}
+
+	// The entries written by the previous runs count in the size of the cache
+	qint64 persistentBytes = (p_persistent ? __prune(directory, p_maxSizeBytes) : 0);
+
+	QMutexLocker l(&__mutex);
+	__isPersistent = p_persistent;
+	__directory = directory;
+	__maxPersistentBytes = p_maxSizeBytes;
+	__persistentBytes = persistentBytes;
+}
+
+QString AnalysisSngTextCache::getDefaultDirectory()
+{
+	return (QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/Rekkix/extracted_text");
+}
+
+void AnalysisSngTextCache::clear()
+{
+	QMutexLocker l(&__mutex);
+	__documents.clear();
+	__nbHits = 0;
+	__nbPersistentHits = 0;
+	__nbMisses = 0;
+}
+
+QString AnalysisSngTextCache::getDocumentKey(const QString& p_path, const QString& p_format)
+{
+	// The canonical path is empty if the file does not exist
+	QFileInfo fi(p_path);
+	QString path = fi.canonicalFilePath();
+	if (path.isEmpty()) path = fi.absoluteFilePath();
+
+	return (p_format + QChar(0) + path);
+}
+
+QString AnalysisSngTextCache::__getEntryPath(const QString& p_path, const QString& p_format, const QString& p_directory)
+{
+	// Reading the whole file is much cheaper than decoding it
+	QFile f(p_path);
+	if (!f.open(QIODevice::ReadOnly)) return (QString());
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	if (!hash.addData(&f)) return (QString());
+
+	return (p_directory + "/" + QString::fromLatin1(hash.result().toHex()) + "." + p_format + TEXT_CACHE_FILE_SUFFIX);
+}
+
+bool AnalysisSngTextCache::__readEntry(const QString& p_entryPath, const QString& p_format, QStringList& p_units)
+{
+	QFile fin(p_entryPath);
+	if (!fin.open(QIODevice::ReadOnly)) return (false);
+
+	QDataStream header(&fin);
+	header.setVersion(QDataStream::Qt_5_0);
+	quint32 magic = 0;
+	quint32 version = 0;
+	QString format;
+	QByteArray compressed;
+	header >> magic >> version >> format;
+	if (magic != TEXT_CACHE_FILE_MAGIC || version != TEXT_CACHE_FILE_VERSION || format != p_format) return (false);
+	header >> compressed;
+
+	QByteArray content = qUncompress(compressed);
+	QDataStream in(content);
+	in.setVersion(QDataStream::Qt_5_0);
+	in >> p_units;
+
+	// A truncated or corrupted entry is extracted again (and written again)
+	if (header.status() != QDataStream::Ok || content.isEmpty() || in.status() != QDataStream::Ok)
+	{
+		p_units.clear();
+		return (false);
+	}
+
+	return (true);
+}
+
+qint64 AnalysisSngTextCache::__writeEntry(const QString& p_entryPath, const QString& p_format, const QStringList& p_units)
+{
+	QByteArray content;
+	QDataStream out(&content, QIODevice::WriteOnly);
+	out.setVersion(QDataStream::Qt_5_0);
+	out << p_units;
+
+	// Another process may read the entry at the same time : it only appears once complete
+	QSaveFile fout(p_entryPath);
+	if (!fout.open(QIODevice::WriteOnly))
+	{
+		qDebug() << "AnalysisSngTextCache::__writeEntry : impossible d'ouvrir " << p_entryPath;
+		return (-1);
+	}
+
+	QDataStream header(&fout);
+	header.setVersion(QDataStream::Qt_5_0);
+	header << TEXT_CACHE_FILE_MAGIC << TEXT_CACHE_FILE_VERSION << p_format << qCompress(content, TEXT_CACHE_FILE_COMPRESSION);
+	qint64 size = fout.size();
+	if (header.status() != QDataStream::Ok || !fout.commit())
+	{
+		qDebug() << "AnalysisSngTextCache::__writeEntry : impossible d'écrire " << p_entryPath;
+		return (-1);
+	}
+
+	return (size);
+}
+
+qint64 AnalysisSngTextCache::__prune(const QString& p_directory, qint64 p_maxSizeBytes)
+{
+	// The most recent entries first : the documents of the current analyses are kept
+	QFileInfoList entries = QDir(p_directory).entryInfoList(QStringList("*" + TEXT_CACHE_FILE_SUFFIX), QDir::Files, QDir::Time);
+
+	qint64 retVal = 0;
+	foreach(QFileInfo fi, entries)
+	{
+		retVal += fi.size();
+	}
+	if (retVal <= p_maxSizeBytes) return (retVal);
+
+	qint64 keptBytes = 0;
+	int nbRemoved = 0;
+	foreach(QFileInfo fi, entries)
+	{
+		if (keptBytes + fi.size() <= p_maxSizeBytes * TEXT_CACHE_PRUNED_RATIO)
+		{
+			keptBytes += fi.size();
+		}
+		else if (QFile::remove(fi.absoluteFilePath()))
+		{
+			nbRemoved++;
+		}
+		else
+		{
+			// Being read by another process, it is removed by a next pruning
+			keptBytes += fi.size();
+		}
+	}
+
+	qDebug() << "AnalysisSngTextCache::__prune : " << nbRemoved << " entrées supprimées, " << keptBytes << " octets conservés";
+	return (keptBytes);
+}
+
+bool AnalysisSngTextCache::acquire(const QString& p_path, const QString& p_format, QStringList& p_units)
+{
+	QString key = getDocumentKey(p_path, p_format);
+	QFileInfo fi(p_path);
+	QString directory;
+
+	{
+		QMutexLocker l(&__mutex);
+		if (!__isEnabled && !__isPersistent) return (false);
+
+		// Another thread is extracting the document : its result is awaited (and may be a failure)
+		while (__pendingDocuments.contains(key))
+		{
+			__extractionFinished.wait(&__mutex);
+		}
+
+		QHash<QString, document_t>::const_iterator it = __documents.constFind(key);
+		if (it != __documents.constEnd() && it->size == fi.size() && it->lastModified == fi.lastModified())
+		{
+			p_units = it->units;
+			__nbHits++;
+			return (true);
+		}
+
+		// Unknown or modified since its extraction : the document is reserved while it is looked for on disk
+		__documents.remove(key);
+		document_t d;
+		d.size = fi.size();
+		d.lastModified = fi.lastModified();
+		__pendingDocuments.insert(key, d);
+
+		if (__isPersistent) directory = __directory;
+	}
+
+	// The disk is read without holding the lock, the other documents go on meanwhile
+	QString entryPath;
+	bool isFound = false;
+	if (!directory.isEmpty())
+	{
+		entryPath = __getEntryPath(p_path, p_format, directory);
+		if (!entryPath.isEmpty()) isFound = __readEntry(entryPath, p_format, p_units);
+	}
+
+	QMutexLocker l(&__mutex);
+	QHash<QString, document_t>::iterator it = __pendingDocuments.find(key);
+	if (isFound)
+	{
+		if (__isEnabled)
+		{
+			document_t d = it.value();
+			d.units = p_units;
+			__documents.insert(key, d);
+		}
+		__pendingDocuments.erase(it);
+		__nbHits++;
+		__nbPersistentHits++;
+		__extractionFinished.wakeAll();
+
+		return (true);
+	}
+
+	// The caller extracts the document, then releases it
+	it->entryPath = entryPath;
+	__nbMisses++;
+
+	return (false);
+}
+
+void AnalysisSngTextCache::release(const QString& p_path, const QString& p_format, const QStringList& p_units, bool p_isValid)
+{
+	QString key = getDocumentKey(p_path, p_format);
+	QString entryPath;
+	QString directory;
+	qint64 maxPersistentBytes = 0;
+
+	{
+		QMutexLocker l(&__mutex);
+
+		// Nothing has been reserved when the cache is disabled
+		QHash<QString, document_t>::const_iterator it = __pendingDocuments.constFind(key);
+		if (it == __pendingDocuments.constEnd()) return;
+
+		if (p_isValid && __isPersistent) entryPath = it->entryPath;
+	}
+
+	// Written before waking up the waiting threads, so that they find it when only the disk is used
+	qint64 entryBytes = (entryPath.isEmpty() ? -1 : __writeEntry(entryPath, p_format, p_units));
+
+	QMutexLocker l(&__mutex);
+	if (entryBytes > 0)
+	{
+		__persistentBytes += entryBytes;
+		if (__persistentBytes > __maxPersistentBytes)
+		{
+			directory = __directory;
+			maxPersistentBytes = __maxPersistentBytes;
+		}
+	}
+
+	QHash<QString, document_t>::iterator it = __pendingDocuments.find(key);
+	if (p_isValid && __isEnabled)
+	{
+		document_t d = it.value();
+		d.units = p_units;
+		__documents.insert(key, d);
+	}
+	else if (!p_isValid)
+	{
+		qDebug() << "AnalysisSngTextCache::release : extraction de " << p_path << " non conservée";
+	}
+	__pendingDocuments.erase(it);
+
+	__extractionFinished.wakeAll();
+	if (directory.isEmpty()) return;
+
+	// The disk is pruned without holding the lock
+	l.unlock();
+	qint64 persistentBytes = __prune(directory, maxPersistentBytes);
+	l.relock();
+	__persistentBytes = persistentBytes;
+}
@@ -7,11 +7,13 @@
 
 #include <QDebug>
 
+#include "AnalysisSngScheduler.h"
 #include "AnalysisSngWaiterThread.h"
+#include "AnalysisTracer.h"
 #include "ModelSngReqMatrix.h"
 
 AnalysisSngWaiterThread::AnalysisSngWaiterThread()
-	: QThread()
+	: QThread(), __runId(0)
 {
 
 }
@@ -24,7 +26,7 @@ AnalysisSngWaiterThread::~AnalysisSngWaiterThread()
 void AnalysisSngWaiterThread::run()
 {
 	// 2nd Step of analysis : wait until all threads have terminated their work
-	bool allFinished ;
+	bool allFinished = false ;
 	QVector<RequirementFileAbstractPtr>::Iterator it_rf ;
 	QVector<RequirementFileAbstractPtr> terminatedFiles ;
 
@@ -35,6 +37,9 @@ void AnalysisSngWaiterThread::run()
 		// For each file, test if the parsing is terminated
 		for (it_rf = __registeredFiles.begin() ; it_rf != __registeredFiles.end() ; ++it_rf)
 		{
+			// The analysis has been cancelled : the files are not ours anymore (see ModelSngReqMatrix::clear)
+			if (isInterruptionRequested()) return ;
+
 			// if the file has been parsed, no need to waste time
 			if (terminatedFiles.contains((*it_rf))) continue ;
 
@@ -43,7 +48,9 @@ void AnalysisSngWaiterThread::run()
 			if ((*it_rf)->isThreadActuallyLaunched() && (*it_rf)->wait(5))
 			{
 				qDebug() << "AnalysisSngWaiterThread::run : fin d'analyse de " << (*it_rf)->getFileId() ;
-				ModelSngReqMatrix::instance().updateRequirementFileWithAcceptedRequirements(*it_rf) ;
+				AnalysisTraceScope ts("merge", AnalysisTracer::CATEGORY_FILE, (*it_rf)->getFileId());
+				ModelSngReqMatrix::instance().mergeRequirementFile(*it_rf) ;
+				AnalysisSngScheduler::instance().recordActualCost(*it_rf) ;
 				terminatedFiles.append((*it_rf)) ;
 			}
 			else
@@ -57,11 +64,11 @@ void AnalysisSngWaiterThread::run()
 		if (!allFinished)
 		{
 			qDebug() << "AnalysisSngWaiterThread::run : attente ..." ;
-			QThread::msleep(50) ;
+			QThread::msleep(20) ;
 		}
 	}
 
 	// now all the files have been parsed, let's emit the information
-	emit allRegisteredTerminated() ;
+	emit allRegisteredTerminated(__runId) ;
 }
 
@@ -0,0 +1,255 @@
+/*!
+ * \file AnalysisSqliteExport.cpp
+ * \brief Implementation of the class AnalysisSqliteExport
+ * \date 2016-11-14
+ * \author f.souliers
+ */
+
+#include <QDebug>
+#include <QFile>
+#include <QSqlError>
+#include <QThread>
+#include <QVariant>
+
+#include "AnalysisSqliteExport.h"
+#include "AnalysisTracer.h"
+#include "Requirement.h"
+
+const int AnalysisSqliteExport::NB_ROWS_BY_TRANSACTION = 50000;
+
+/*!
+ * \brief Statements creating the tables, executed before any row is inserted
+ */
+static const QVector<QString> SQLITE_TABLES { "CREATE TABLE analysis (run_id INTEGER, creation_date TEXT)",
+                                              "CREATE TABLE files (id TEXT PRIMARY KEY, path TEXT, nb_requirements INTEGER, "
+                                              "nb_errors INTEGER, must_have_downstream_documents INTEGER, coverage REAL)",
+                                              "CREATE TABLE document_links (upstream_file_id TEXT, downstream_file_id TEXT)",
+                                              "CREATE TABLE requirements (id TEXT PRIMARY KEY, file_id TEXT, expected_by TEXT, "
+                                              "is_consistent INTEGER, must_be_covered INTEGER, coverage REAL)",
+                                              "CREATE TABLE compositions (composite_id TEXT, composing_id TEXT)",
+                                              "CREATE TABLE coverages (covered_id TEXT, covering_id TEXT)",
+                                              "CREATE TABLE errors (severity TEXT, category TEXT, code INTEGER, location TEXT, "
+                                              "description TEXT)" };
+
+/*!
+ * \brief Statements creating the indexes, executed once every row is inserted
+ */
+static const QVector<QString> SQLITE_INDEXES { "CREATE INDEX document_links_upstream ON document_links (upstream_file_id)",
+                                               "CREATE INDEX document_links_downstream ON document_links (downstream_file_id)",
+                                               "CREATE INDEX requirements_file ON requirements (file_id)",
+                                               "CREATE INDEX compositions_composite ON compositions (composite_id)",
+                                               "CREATE INDEX compositions_composing ON compositions (composing_id)",
+                                               "CREATE INDEX coverages_covered ON coverages (covered_id)",
+                                               "CREATE INDEX coverages_covering ON coverages (covering_id)",
+                                               "CREATE INDEX errors_location ON errors (location)",
+                                               "CREATE INDEX errors_code ON errors (code)" };
+
+/*!
+ * \brief Value of a coverage, NULL if invalid
+ */
+static QVariant coverageValue(double p_coverage)
+{
+	if (p_coverage == Requirement::COVERAGE_INVALID_VALUE) return (QVariant(QVariant::Double));
+	return (QVariant(p_coverage));
+}
+
+AnalysisSqliteExport::AnalysisSqliteExport(QSqlDatabase& p_db)
+		: __db(p_db), __nbRows(0)
+{
+}
+
+AnalysisSqliteExport::~AnalysisSqliteExport()
+{
+}
+
+bool AnalysisSqliteExport::write(const AnalysisSnapshot& p_snapshot, const QString& p_path, QString& p_errMsg)
+{
+	AnalysisTraceScope ts("write_sqlite", AnalysisTracer::CATEGORY_REPORT);
+
+	// The database is written from scratch, not updated
+	if (QFile::exists(p_path) && !QFile::remove(p_path))
+	{
+		p_errMsg = QObject::trUtf8("Impossible de remplacer %1").arg(p_path);
+		return (false);
+	}
+
+	// The reports may be generated by a worker thread: one connection by thread
+	QString connectionName = QString("rekkix_sqlite_export_%1").arg(quintptr(QThread::currentThreadId()));
+	bool isWritten = false;
+	{
+		QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+		db.setDatabaseName(p_path);
+		if (!db.open())
+		{
+			p_errMsg = QObject::trUtf8("Impossible de créer la base %1 : %2").arg(p_path).arg(db.lastError().text());
+		}
+		else
+		{
+			AnalysisSqliteExport e(db);
+			isWritten = e.__write(p_snapshot);
+			if (!isWritten)
+			{
+				p_errMsg = QObject::trUtf8("Erreur d'écriture de la base %1 : %2").arg(p_path).arg(e.__errMsg);
+				db.rollback();
+			}
+			db.close();
+		}
+	}
+	QSqlDatabase::removeDatabase(connectionName);
+
+	if (!isWritten)
+	{
+		qDebug() << "AnalysisSqliteExport::write : " << p_errMsg;
+		QFile::remove(p_path);
+	}
+
+	return (isWritten);
+}
+
+bool AnalysisSqliteExport::__write(const AnalysisSnapshot& p_snapshot)
+{
+	// The file is new and removed if anything fails: no need for a journal
+	if (!__exec("PRAGMA journal_mode = OFF") || !__exec("PRAGMA synchronous = OFF")) return (false);
+
+	foreach(const QString& statement, SQLITE_TABLES)
+	{
+		if (!__exec(statement)) return (false);
+	}
+
+	if (!__db.transaction())
+	{
+		__errMsg = __db.lastError().text();
+		return (false);
+	}
+
+	QSqlQuery q(__db);
+	if (!__prepare(q, "INSERT INTO analysis VALUES (?, ?)")) return (false);
+	q.addBindValue(p_snapshot.getRunId());
+	q.addBindValue(p_snapshot.getCreationDate().toString(Qt::ISODate));
+	if (!__insert(q)) return (false);
+
+	// Files, and the links between them
+	QSqlQuery qLink(__db);
+	if (!__prepare(q, "INSERT INTO files VALUES (?, ?, ?, ?, ?, ?)")) return (false);
+	if (!__prepare(qLink, "INSERT INTO document_links VALUES (?, ?)")) return (false);
+	foreach(const QString& fileId, p_snapshot.getFileIds())
+	{
+		const AnalysisSnapshot::file_t* f = p_snapshot.getFile(fileId);
+		q.addBindValue(f->id);
+		q.addBindValue(f->path);
+		q.addBindValue(f->nbRequirements);
+		q.addBindValue(f->nbErrors);
+		q.addBindValue(f->mustHaveDownstreamDocuments);
+		q.addBindValue(coverageValue(f->coverage));
+		if (!__insert(q)) return (false);
+
+		foreach(const QString& downId, f->downstreamDocuments)
+		{
+			qLink.addBindValue(f->id);
+			qLink.addBindValue(downId);
+			if (!__insert(qLink)) return (false);
+		}
+	}
+
+	// Requirements, then the edges of the graph: each one is given by one end only
+	QSqlQuery qComposition(__db);
+	QSqlQuery qCoverage(__db);
+	if (!__prepare(q, "INSERT INTO requirements VALUES (?, ?, ?, ?, ?, ?)")) return (false);
+	if (!__prepare(qComposition, "INSERT INTO compositions VALUES (?, ?)")) return (false);
+	if (!__prepare(qCoverage, "INSERT INTO coverages VALUES (?, ?)")) return (false);
+	foreach(const QString& reqId, p_snapshot.getRequirementIds())
+	{
+		const AnalysisSnapshot::requirement_t* r = p_snapshot.getRequirement(reqId);
+		q.addBindValue(r->id);
+		q.addBindValue(r->fileId.isEmpty() ? QVariant(QVariant::String) : QVariant(r->fileId));
+		q.addBindValue(r->expectedBy);
+		q.addBindValue(r->isConsistent);
+		q.addBindValue(r->mustBeCovered);
+		q.addBindValue(coverageValue(r->coverage));
+		if (!__insert(q)) return (false);
+
+		foreach(const QString& composingId, r->composingIds)
+		{
+			qComposition.addBindValue(r->id);
+			qComposition.addBindValue(composingId);
+			if (!__insert(qComposition)) return (false);
+		}
+
+		if (!r->downstreamId.isEmpty())
+		{
+			qCoverage.addBindValue(r->id);
+			qCoverage.addBindValue(r->downstreamId);
+			if (!__insert(qCoverage)) return (false);
+		}
+	}
+
+	// Errors, all of them
+	if (!__prepare(q, "INSERT INTO errors VALUES (?, ?, ?, ?, ?)")) return (false);
+	foreach(const AnalysisError& e, p_snapshot.getErrors())
+	{
+		q.addBindValue(e.getSeverityString());
+		q.addBindValue(e.getCategoryString());
+		q.addBindValue(int(e.getCode()));
+		q.addBindValue(e.getLocation());
+		q.addBindValue(e.getDescription());
+		if (!__insert(q)) return (false);
+	}
+
+	foreach(const QString& statement, SQLITE_INDEXES)
+	{
+		if (!__exec(statement)) return (false);
+	}
+
+	if (!__db.commit())
+	{
+		__errMsg = __db.lastError().text();
+		return (false);
+	}
+
+	qDebug() << "AnalysisSqliteExport::__write : " << __nbRows << " rows written";
+	return (true);
+}
+
+bool AnalysisSqliteExport::__exec(const QString& p_statement)
+{
+	QSqlQuery q(__db);
+	if (!q.exec(p_statement))
+	{
+		__errMsg = q.lastError().text();
+		return (false);
+	}
+
+	return (true);
+}
+
+bool AnalysisSqliteExport::__prepare(QSqlQuery& p_query, const QString& p_statement)
+{
+	if (!p_query.prepare(p_statement))
+	{
+		__errMsg = p_query.lastError().text();
+		return (false);
+	}
+
+	return (true);
+}
+
+bool AnalysisSqliteExport::__insert(QSqlQuery& p_query)
+{
+	if (!p_query.exec())
+	{
+		__errMsg = p_query.lastError().text();
+		return (false);
+	}
+
+	__nbRows++;
+	if (__nbRows % NB_ROWS_BY_TRANSACTION != 0) return (true);
+
+	// The prepared queries stay valid across the transactions
+	if (!__db.commit() || !__db.transaction())
+	{
+		__errMsg = __db.lastError().text();
+		return (false);
+	}
+
+	return (true);
+}
@@ -0,0 +1,152 @@
+/*!
+ * \file AnalysisTracer.cpp
+ * \brief Implementation of the class AnalysisTracer
+ * \date 2016-10-20
+ * \author f.souliers
+ */
+
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+
+#include "AnalysisTracer.h"
+
+const char* AnalysisTracer::CATEGORY_CONFIG = "config";
+const char* AnalysisTracer::CATEGORY_FILE = "file";
+const char* AnalysisTracer::CATEGORY_COVERAGE = "coverage";
+const char* AnalysisTracer::CATEGORY_REPORT = "report";
+
+AnalysisTracer::AnalysisTracer()
+	: __enabled(0), __originNs(0)
+{
+	__clock.start();
+}
+
+AnalysisTracer::~AnalysisTracer()
+{
+}
+
+void AnalysisTracer::clear()
+{
+	QMutexLocker l(&__eventsMutex);
+	__events.clear();
+	__originNs.store(__clock.nsecsElapsed());
+}
+
+void AnalysisTracer::addEvent(const char* p_name,
+                              const char* p_category,
+                              const QString& p_detail,
+                              qint64 p_startNs,
+                              qint64 p_durationNs)
+{
+	event_t e;
+	e.name = p_name;
+	e.category = p_category;
+	e.detail = p_detail;
+	e.threadId = QThread::currentThreadId();
+	e.startNs = p_startNs;
+	e.durationNs = p_durationNs;
+
+	QMutexLocker l(&__eventsMutex);
+	__events.append(e);
+}
+
+bool AnalysisTracer::exportChromeTrace(const QString& p_path) const
+{
+	QJsonArray traceEvents;
+	{
+		QMutexLocker l(&__eventsMutex);
+
+		// Thread handles are replaced by small numbers, in order of appearance
+		QHash<Qt::HANDLE, int> tids;
+		foreach(const event_t& e, __events)
+		{
+			if (!tids.contains(e.threadId)) tids.insert(e.threadId, tids.count() + 1);
+
+			QJsonObject o;
+			o.insert("name", QString(e.name));
+			o.insert("cat", QString(e.category));
+			o.insert("ph", QString("X"));  // complete event : start and duration
+			o.insert("ts", e.startNs / 1000.0);  // microseconds
+			o.insert("dur", e.durationNs / 1000.0);
+			o.insert("pid", 1);
+			o.insert("tid", tids[e.threadId]);
+			if (!e.detail.isEmpty())
+			{
+				QJsonObject args;
+				args.insert("detail", e.detail);
+				o.insert("args", args);
+			}
+			traceEvents.append(o);
+		}
+	}
+
+	QJsonObject root;
+	root.insert("traceEvents", traceEvents);
+	root.insert("displayTimeUnit", QString("ms"));
+
+	QFile f(p_path);
+	if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		qDebug() << "AnalysisTracer::exportChromeTrace : unable to open " << p_path;
+		return (false);
+	}
+	f.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+	f.close();
+
+	return (true);
+}
+
+QString AnalysisTracer::getFileSummaryTable() const
+{
+	// Cumulated duration by file and by stage, stages are kept in order of first appearance
+	QStringList stages;
+	QMap<QString, QMap<QString, qint64>> durations;
+	{
+		QMutexLocker l(&__eventsMutex);
+		foreach(const event_t& e, __events)
+		{
+			if (qstrcmp(e.category, CATEGORY_FILE) != 0) continue;
+
+			QString stage(e.name);
+			if (!stages.contains(stage)) stages.append(stage);
+			durations[e.detail][stage] += e.durationNs;
+		}
+	}
+
+	if (durations.isEmpty()) return (QString());
+
+	int idWidth = QString("ID").length();
+	foreach(QString fileId, durations.keys())
+	{
+		idWidth = qMax(idWidth, fileId.length());
+	}
+
+	const int colWidth = 12;
+	QString table = QString("ID").leftJustified(idWidth);
+	foreach(QString stage, stages)
+	{
+		table += QString(" %1").arg(stage + " (ms)", colWidth);
+	}
+	table += "\n";
+
+	QMap<QString, QMap<QString, qint64>>::const_iterator it;
+	for (it = durations.constBegin() ; it != durations.constEnd() ; ++it)
+	{
+		table += it.key().leftJustified(idWidth);
+		foreach(QString stage, stages)
+		{
+			table += QString(" %1").arg(it.value().value(stage) / 1000000.0, colWidth, 'f', 1);
+		}
+		table += "\n";
+	}
+
+	return (table);
+}
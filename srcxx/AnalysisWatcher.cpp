@@ -0,0 +1,152 @@
+/*!
+ * \file AnalysisWatcher.cpp
+ * \brief Implementation of the class AnalysisWatcher
+ * \date 2016-10-24
+ * \author f.souliers
+ */
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+
+#include "AnalysisWatcher.h"
+#include "RequirementFile_tree.h"
+
+static const int CHANGES_NOTIFICATION_DELAY_MS = 500;  //!< Time without any change before notifying the changes
+
+AnalysisWatcher::AnalysisWatcher(QObject* p_parent)
+	: QObject(p_parent), __isConfigChanged(false)
+{
+	__delayTimer.setSingleShot(true);
+	__delayTimer.setInterval(CHANGES_NOTIFICATION_DELAY_MS);
+
+	QObject::connect(&__fsWatcher, SIGNAL(fileChanged(QString)), this, SLOT(slt_fileChanged(QString)));
+	QObject::connect(&__fsWatcher, SIGNAL(directoryChanged(QString)), this, SLOT(slt_directoryChanged(QString)));
+	QObject::connect(&__delayTimer, SIGNAL(timeout()), this, SLOT(slt_notifyChanges()));
+}
+
+AnalysisWatcher::~AnalysisWatcher()
+{
+}
+
+void AnalysisWatcher::watch(const QString& p_configPath, const ModelConfiguration::CnfFileAttributesMapsByFileId_t& p_files)
+{
+	stop();
+
+	__configPath = QFileInfo(p_configPath).absoluteFilePath();
+
+	QStringList paths;
+	paths << __configPath;
+	foreach(ModelConfiguration::CnfFileAttributesMap_t f, p_files)
+	{
+		QString path = QFileInfo(f[ModelConfiguration::REQFILE_ATTR_PATH]).absoluteFilePath();
+
+		// The files of a tree are watched one by one, the ones created later are found by the next full analysis
+		QStringList filePaths = (RequirementFile_tree::isTreePath(path) ? RequirementFile_tree::listFiles(path) : QStringList(path));
+		foreach(QString filePath, filePaths)
+		{
+			__fileIdsByPath.insert(filePath, f[ModelConfiguration::REQFILE_ATTR_ID]);
+			paths << filePath;
+		}
+	}
+	paths.removeDuplicates();
+
+	QStringList dirs;
+	foreach(QString path, paths)
+	{
+		dirs << QFileInfo(path).absolutePath();
+	}
+	dirs.removeDuplicates();
+
+	// Missing files are only watched through their directory
+	QStringList existingPaths;
+	foreach(QString path, paths)
+	{
+		if (QFileInfo(path).exists()) existingPaths << path;
+	}
+	if (!existingPaths.isEmpty()) __fsWatcher.addPaths(existingPaths);
+	__fsWatcher.addPaths(dirs);
+
+	qDebug() << "AnalysisWatcher::watch : " << __fsWatcher.files().count() << " fichiers, " << __fsWatcher.directories().count() << " répertoires";
+}
+
+void AnalysisWatcher::stop()
+{
+	__delayTimer.stop();
+
+	if (!__fsWatcher.files().isEmpty()) __fsWatcher.removePaths(__fsWatcher.files());
+	if (!__fsWatcher.directories().isEmpty()) __fsWatcher.removePaths(__fsWatcher.directories());
+
+	__configPath.clear();
+	__fileIdsByPath.clear();
+	__changedFileIds.clear();
+	__isConfigChanged = false;
+}
+
+bool AnalysisWatcher::__rewatch(const QString& p_path)
+{
+	if (!QFileInfo(p_path).exists()) return (false);
+
+	if (!__fsWatcher.files().contains(p_path)) __fsWatcher.addPath(p_path);
+	return (true);
+}
+
+void AnalysisWatcher::__addChange(const QString& p_path)
+{
+	if (p_path == __configPath)
+	{
+		__isConfigChanged = true;
+	}
+	else
+	{
+		foreach(QString fileId, __fileIdsByPath.values(p_path))
+		{
+			__changedFileIds.insert(fileId);
+		}
+	}
+
+	__delayTimer.start();
+}
+
+void AnalysisWatcher::slt_fileChanged(const QString& p_path)
+{
+	// A removed or renamed file is not watched anymore : it is watched again if it has been replaced,
+	// otherwise its directory will tell when it is created again
+	__rewatch(p_path);
+	__addChange(p_path);
+}
+
+void AnalysisWatcher::slt_directoryChanged(const QString& p_path)
+{
+	// Only the watched files that have been (re)created in the directory are interesting
+	QStringList paths = __fileIdsByPath.uniqueKeys();
+	paths << __configPath;
+	foreach(QString path, paths)
+	{
+		if (QFileInfo(path).absolutePath() != QDir(p_path).absolutePath()) continue;
+		if (__fsWatcher.files().contains(path)) continue;
+
+		if (__rewatch(path)) __addChange(path);
+	}
+}
+
+void AnalysisWatcher::slt_notifyChanges()
+{
+	if (__isConfigChanged)
+	{
+		__isConfigChanged = false;
+		__changedFileIds.clear();
+
+		qDebug() << "AnalysisWatcher::slt_notifyChanges : configuration modifiée";
+		emit configurationChanged();
+	}
+	else if (!__changedFileIds.isEmpty())
+	{
+		QStringList fileIds = __changedFileIds.toList();
+		fileIds.sort();
+		__changedFileIds.clear();
+
+		qDebug() << "AnalysisWatcher::slt_notifyChanges : documents modifiés " << fileIds;
+		emit documentsChanged(fileIds);
+	}
+}
@@ -0,0 +1,221 @@
+/*!
+ * \file FactoryReport.cpp
+ * \brief Implementation of the class FactoryReport
+ * \date 2016-10-18
+ * \author f.souliers
+ */
+
+#include <QDebug>
+#include <QFile>
+#include <QTextStream>
+
+#include "AnalysisSqliteExport.h"
+#include "AnalysisTracer.h"
+#include "FactoryReport.h"
+#include "FactoryReportBaseString.h"
+#include "ModelSngReqMatrix.h"
+#include "ModelSngAnalysisErrors.h"
+
+FactoryReport::FactoryReport()
+{
+}
+
+FactoryReport::~FactoryReport()
+{
+}
+
+QString FactoryReport::buildReport(const ModelConfiguration::CnfFileAttributesMap_t& p_outFileDescription,
+                                   const QDateTime& p_timestamp)
+{
+	// Step 0 : prepare base file templates
+	QString writer = p_outFileDescription[ModelConfiguration::OUTPUT_ATTR_WRITER];
+	if (writer == ModelConfiguration::OUTPUT_ATTR_VALUE_SNAPSHOT || writer == ModelConfiguration::OUTPUT_ATTR_VALUE_SQLITE)
+	{
+		return (QString());
+	}
+
+	AnalysisTraceScope ts("build_report", AnalysisTracer::CATEGORY_REPORT, writer);
+	QString delimiter = p_outFileDescription[ModelConfiguration::OUTPUT_ATTR_DELIMITER];
+	FactoryReportBaseString fact;
+	QString s_base(fact.getBaseString("base", writer, delimiter));
+
+	// In case of html, Step 1 : include CSS and replace the template values
+	if (writer == ModelConfiguration::OUTPUT_ATTR_VALUE_HTML)
+	{
+		s_base.replace("REKKIX_CSS_SECTION", fact.getCSString());
+	}
+
+	// Step 2 : build the report header and summary table
+	s_base.replace("REKKIX_REPORT_TITLE", QObject::trUtf8("Rapport de traçabilité"));
+	s_base.replace("REKKIX_REPORT_SUBTITLE", QObject::trUtf8("Généré le %1").arg(p_timestamp.toString(QObject::trUtf8("dd/MM/yyyy hh:mm:ss"))));
+	s_base.replace("REKKIX_SUMMARY_TITLE", QObject::trUtf8("1/ Matrice de traçabilité"));
+	s_base.replace("REKKIX_SUMMARY_TABLE", __getReportSummaryTable(writer, delimiter));
+
+	// Step 3 : build the error section
+	s_base.replace("REKKIX_ERRORS_TITLE", QObject::trUtf8("2/ Erreurs trouvées dans l'analyse des fichiers"));
+	s_base.replace("REKKIX_ERRORS_CONTENT", __getReportErrorsTable(writer, delimiter));
+
+	// Step 4 : build the report with data and replace the tag
+	s_base.replace("REKKIX_DETAILS_TITLE", QObject::trUtf8("3/ Détails de traçabilité des fichiers"));
+	s_base.replace("REKKIX_DETAILS_CONTENT", ModelSngReqMatrix::instance().getReportFileDetails(writer, delimiter));
+
+	return (s_base);
+}
+
+bool FactoryReport::writeReport(const ModelConfiguration::CnfFileAttributesMap_t& p_outFileDescription,
+                                const QDateTime& p_timestamp, QString& p_errMsg)
+{
+	QString outFilePath = __getOutputPath(p_outFileDescription, p_timestamp);
+
+	// The analysis itself is saved, eg to be used as a baseline by rekkix --diff
+	if (p_outFileDescription[ModelConfiguration::OUTPUT_ATTR_WRITER] == ModelConfiguration::OUTPUT_ATTR_VALUE_SNAPSHOT)
+	{
+		AnalysisTraceScope ts("write_snapshot", AnalysisTracer::CATEGORY_REPORT);
+		qDebug() << "FactoryReport::writeReport : saving the analysis in " << outFilePath;
+		if (ModelSngReqMatrix::instance().createSnapshot()->save(outFilePath)) return (true);
+
+		p_errMsg = QObject::trUtf8("Impossible d'enregistrer l'analyse dans %1").arg(outFilePath);
+		return (false);
+	}
+
+	// The whole graph is exported, to be queried by other tools
+	if (p_outFileDescription[ModelConfiguration::OUTPUT_ATTR_WRITER] == ModelConfiguration::OUTPUT_ATTR_VALUE_SQLITE)
+	{
+		qDebug() << "FactoryReport::writeReport : exporting the analysis in " << outFilePath;
+		return (AnalysisSqliteExport::write(*ModelSngReqMatrix::instance().createSnapshot(), outFilePath, p_errMsg));
+	}
+
+	if (__writeContent(p_outFileDescription, p_timestamp, buildReport(p_outFileDescription, p_timestamp))) return (true);
+
+	p_errMsg = QObject::trUtf8("Impossible d'écrire le rapport %1").arg(outFilePath);
+	return (false);
+}
+
+QString FactoryReport::buildDeltaReport(const ModelConfiguration::CnfFileAttributesMap_t& p_outFileDescription,
+                                        const AnalysisSnapshotDiff& p_diff,
+                                        const QDateTime& p_timestamp)
+{
+	QString writer = p_outFileDescription[ModelConfiguration::OUTPUT_ATTR_WRITER];
+	AnalysisTraceScope ts("build_delta_report", AnalysisTracer::CATEGORY_REPORT, writer);
+	QString delimiter = p_outFileDescription[ModelConfiguration::OUTPUT_ATTR_DELIMITER];
+	FactoryReportBaseString fact;
+	QString s_base(fact.getBaseString("delta", writer, delimiter));
+
+	if (writer == ModelConfiguration::OUTPUT_ATTR_VALUE_HTML)
+	{
+		s_base.replace("REKKIX_CSS_SECTION", fact.getCSString());
+	}
+
+	// Step 1 : header, with the dates of both analyses
+	QString dateFormat(QObject::trUtf8("dd/MM/yyyy hh:mm:ss"));
+	s_base.replace("REKKIX_REPORT_TITLE", QObject::trUtf8("Rapport d'évolution de la traçabilité"));
+	s_base.replace("REKKIX_REPORT_SUBTITLE", QObject::trUtf8("Généré le %1, analyse du %2 comparée à la référence du %3")
+	               .arg(p_timestamp.toString(dateFormat))
+	               .arg(p_diff.getCurrentDate().toString(dateFormat))
+	               .arg(p_diff.getBaselineDate().toString(dateFormat)));
+
+	// Step 2 : number of changes by kind
+	QString separator = (writer == ModelConfiguration::OUTPUT_ATTR_VALUE_HTML ? QString("<br/>\n") : delimiter + "\n");
+	s_base.replace("REKKIX_DELTA_SUMMARY_TITLE", QObject::trUtf8("1/ Résumé des changements"));
+	s_base.replace("REKKIX_DELTA_SUMMARY_CONTENT", p_diff.getSummary().join(separator));
+
+	// Step 3 : the changes themselves
+	QString s_table(fact.getBaseString("delta_base", writer, delimiter));
+	s_table.replace("REKKIX_DELTA_KIND_TITLE", QObject::trUtf8("Changement"));
+	s_table.replace("REKKIX_DELTA_ITEM_TITLE", QObject::trUtf8("Élément"));
+	s_table.replace("REKKIX_DELTA_LOCATION_TITLE", QObject::trUtf8("Localisation"));
+	s_table.replace("REKKIX_DELTA_BEFORE_TITLE", QObject::trUtf8("Référence"));
+	s_table.replace("REKKIX_DELTA_AFTER_TITLE", QObject::trUtf8("Analyse"));
+
+	QString s_line(fact.getBaseString("delta_line", writer, delimiter));
+	QString lines;
+	foreach(AnalysisSnapshotDiff::change_t c, p_diff.getChanges())
+	{
+		bool isRegression = (c.kind == AnalysisSnapshotDiff::REQ_REMOVED || c.kind == AnalysisSnapshotDiff::REQ_COVERAGE_DROPPED
+		                     || c.kind == AnalysisSnapshotDiff::FILE_REMOVED || c.kind == AnalysisSnapshotDiff::FILE_COVERAGE_DROPPED
+		                     || c.kind == AnalysisSnapshotDiff::ERROR_ADDED);
+
+		QString newline = s_line;
+		newline.replace("REKKIX_DELTA_ROW_COLOR", isRegression ? " class=\"invalid\" " : "");
+		newline.replace("REKKIX_DELTA_KIND", AnalysisSnapshotDiff::kindToString(c.kind));
+		newline.replace("REKKIX_DELTA_ITEM", c.item);
+		newline.replace("REKKIX_DELTA_LOCATION", c.location);
+		newline.replace("REKKIX_DELTA_BEFORE", c.before);
+		newline.replace("REKKIX_DELTA_AFTER", c.after);
+		lines += newline + "\n";
+	}
+	s_table.replace("REKKIX_DELTA_LINES_CONTENT", lines);
+
+	s_base.replace("REKKIX_DELTA_CHANGES_TITLE", QObject::trUtf8("2/ Détail des changements"));
+	s_base.replace("REKKIX_DELTA_CHANGES_CONTENT", s_table);
+
+	return (s_base);
+}
+
+bool FactoryReport::writeDeltaReport(const ModelConfiguration::CnfFileAttributesMap_t& p_outFileDescription,
+                                     const AnalysisSnapshotDiff& p_diff,
+                                     const QDateTime& p_timestamp)
+{
+	return (__writeContent(p_outFileDescription, p_timestamp, buildDeltaReport(p_outFileDescription, p_diff, p_timestamp)));
+}
+
+QString FactoryReport::__getOutputPath(const ModelConfiguration::CnfFileAttributesMap_t& p_outFileDescription,
+                                       const QDateTime& p_timestamp)
+{
+	QString outFilePath(p_outFileDescription[ModelConfiguration::OUTPUT_ATTR_PATH]);
+	outFilePath.replace(ModelConfiguration::OUTPUT_STR_TIMESTAMP, p_timestamp.toString("yyyyMMddhhmmss"));
+	return (outFilePath);
+}
+
+bool FactoryReport::__writeContent(const ModelConfiguration::CnfFileAttributesMap_t& p_outFileDescription,
+                                   const QDateTime& p_timestamp,
+                                   const QString& p_content)
+{
+	AnalysisTraceScope ts("write_report", AnalysisTracer::CATEGORY_REPORT, p_outFileDescription[ModelConfiguration::OUTPUT_ATTR_WRITER]);
+
+	QString outFilePath = __getOutputPath(p_outFileDescription, p_timestamp);
+
+	qDebug() << "FactoryReport::writeReport : generating " << outFilePath;
+	QFile fout(outFilePath);
+	if (!fout.open(QIODevice::WriteOnly | QIODevice::Text))
+	{
+		qDebug() << "FactoryReport::writeReport : unable to open " << outFilePath;
+		return (false);
+	}
+
+	QTextStream out_stream(&fout);
+	out_stream.setCodec("UTF-8");
+	out_stream << p_content;
+	fout.close();
+
+	return (true);
+}
+
+const QString FactoryReport::__getReportSummaryTable(const QString& p_writer, const QString& p_delimiter)
+{
+	FactoryReportBaseString fact;
+	QString s_base(fact.getBaseString("summaryTable_base", p_writer, p_delimiter));
+
+	s_base.replace("REKKIX_SUMMARY_TABLE_FILE_ID_TITLE", QObject::trUtf8("ID Fichier"));
+	s_base.replace("REKKIX_SUMMARY_TABLE_FILE_NB_REQS_TITLE", QObject::trUtf8("Nb Exigences"));
+	s_base.replace("REKKIX_SUMMARY_TABLE_FILE_COVERAGE_TITLE", QObject::trUtf8("Couverture"));
+	s_base.replace("REKKIX_SUMMARY_TABLE_FILE_NB_ERRORS_TITLE", QObject::trUtf8("Nb Erreurs"));
+	s_base.replace("REKKIX_SUMMARY_TABLE_FILE_PATH_TITLE", QObject::trUtf8("Path Fichier"));
+	s_base.replace("REKKIX_SUMMARY_TABLE_LINES_CONTENT", ModelSngReqMatrix::instance().getReportFileSummaryTable(p_writer, p_delimiter));
+
+	return (s_base);
+}
+
+const QString FactoryReport::__getReportErrorsTable(const QString& p_writer, const QString& p_delimiter)
+{
+	FactoryReportBaseString fact;
+	QString s_base(fact.getBaseString("errors_base", p_writer, p_delimiter));
+
+	s_base.replace("REKKIX_ERRORS_SEVERITY_TITLE", QObject::trUtf8("Sévérité"));
+	s_base.replace("REKKIX_ERRORS_CATEGORY_TITLE", QObject::trUtf8("Catégorie"));
+	s_base.replace("REKKIX_ERRORS_LOCATION_ID_TITLE", QObject::trUtf8("Localisation"));
+	s_base.replace("REKKIX_ERRORS_DESCRIPTION_TITLE", QObject::trUtf8("Description"));
+	s_base.replace("REKKIX_ERRORS_LINES_CONTENT", ModelSngAnalysisErrors::instance().getReportErrorSummaryTable(p_writer, p_delimiter));
+
+	return (s_base);
+}
@@ -9,6 +9,7 @@
 #include "RequirementFile_docx.h"
 #include "RequirementFile_odt.h"
 #include "RequirementFile_pdf.h"
+#include "RequirementFile_tree.h"
 #include "RequirementFile_txt.h"
 
 /*!
@@ -55,7 +56,12 @@ RequirementFileAbstractPtr FactoryRequirementFile::getRequirementFile(const Mode
 	QString filename = p_cnfFile[ModelConfiguration::REQFILE_ATTR_PATH];
 	QString parser = p_cnfFile[ModelConfiguration::REQFILE_ATTR_PARSER];
 
-	if (AVAILABLE_PARSERS.contains(parser))
+	if (RequirementFile_tree::isTreePath(filename))
+	{
+		// A directory or a glob pattern : its files are parsed as plain text files, whatever the parser
+		retPtr = new RequirementFile_tree(p_cnfFile) ;
+	}
+	else if (AVAILABLE_PARSERS.contains(parser))
 	{
 		// The required parser is known --> just use it
 		if (parser == EXT_DOCX) retPtr = new RequirementFile_docx(p_cnfFile) ;
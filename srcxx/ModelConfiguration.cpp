@@ -11,10 +11,18 @@
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QRegularExpression>
+#include <QRunnable>
 #include <QSettings>
+#include <QThread>
+#include <QThreadPool>
 
+#include "AnalysisTracer.h"
 #include "ModelConfiguration.h"
+#include "RequirementFile_tree.h"
 
 /*!
  * \brief Section of the configuration file starting the definition of requirement files
@@ -26,6 +34,12 @@ static const QString SECTION_REQFILES("files");
  */
 static const QString SECTION_OUTPUT_FILES("outputs");
 
+static const int MIN_FILES_BY_CHECK_TASK = 64;  //!< Below, the files are checked by the calling thread
+static const int CHECK_TASKS_BY_THREAD = 4;  //!< Several tasks by thread, some files being much longer to check
+
+static QMutex compiledRegexesMutex;  //!< Protects compiledRegexes
+static QHash<QString, QRegularExpression> compiledRegexes;  //!< Regular expressions of the loaded configuration, by pattern
+
 const QString ModelConfiguration::REQFILE_ATTR_ID("id");
 const QString ModelConfiguration::REQFILE_ATTR_PATH("path");
 const QString ModelConfiguration::REQFILE_ATTR_PARSER("parser");
@@ -35,6 +49,7 @@ const QString ModelConfiguration::REQFILE_ATTR_CMPSEPARATOR("cmp_separator");
 const QString ModelConfiguration::REQFILE_ATTR_COVREGEX("cov_regex");
 const QString ModelConfiguration::REQFILE_ATTR_COVSEPARATOR("cov_separator");
 const QString ModelConfiguration::REQFILE_ATTR_STOPAFTERREGEX("stopafter_regex");
+const QString ModelConfiguration::REQFILE_ATTR_PAGES("pages");
 const QString ModelConfiguration::REQFILE_ATTR_HASDWN("has_downstream");
 const QString ModelConfiguration::REQFILE_ATTR_HASUP("has_upstream");
 const QString ModelConfiguration::REQFILE_ATTR_VALUE_YES("y");
@@ -47,6 +62,8 @@ const QString ModelConfiguration::OUTPUT_ATTR_WRITER("writer");
 const QString ModelConfiguration::OUTPUT_ATTR_DELIMITER("delimiter");
 const QString ModelConfiguration::OUTPUT_ATTR_VALUE_HTML("html");
 const QString ModelConfiguration::OUTPUT_ATTR_VALUE_CSV("csv");
+const QString ModelConfiguration::OUTPUT_ATTR_VALUE_SNAPSHOT("snapshot");
+const QString ModelConfiguration::OUTPUT_ATTR_VALUE_SQLITE("sqlite");
 const QString ModelConfiguration::OUTPUT_STR_TIMESTAMP("REKKIXTIMESTAMP");
 
 /*!
@@ -64,7 +81,8 @@ const QVector<QString> ModelConfiguration::REQFILE_ATTRS { REQFILE_ATTR_ID,
                                                            REQFILE_ATTR_CMPSEPARATOR,
                                                            REQFILE_ATTR_COVREGEX,
                                                            REQFILE_ATTR_COVSEPARATOR,
-                                                           REQFILE_ATTR_STOPAFTERREGEX };
+                                                           REQFILE_ATTR_STOPAFTERREGEX,
+                                                           REQFILE_ATTR_PAGES };
 
 /*!
  * \brief Vector of headers for attributes that has to be visible in the gui
@@ -81,7 +99,8 @@ const QVector<QString> ModelConfiguration::REQFILE_HEADER_ATTRS { QObject::trUtf
                                                                   QObject::trUtf8("Séparateur Composition"),
                                                                   QObject::trUtf8("Regex Couverture"),
                                                                   QObject::trUtf8("Séparateur Couverture"),
-                                                                  QObject::trUtf8("Regex de fin d'analyse") };
+                                                                  QObject::trUtf8("Regex de fin d'analyse"),
+                                                                  QObject::trUtf8("Pages") };
 
 /*!
  * \brief Vector of attributes for the output documents, currently not displayed in the gui
@@ -94,7 +113,9 @@ const QVector<QString> ModelConfiguration::OUTPUT_ATTRS { OUTPUT_ATTR_PATH,
  * \brief Vector of the supported output file formats
  */
 const QVector<QString> ModelConfiguration::OUTPUT_SUPPORTED_EXT { OUTPUT_ATTR_VALUE_HTML,
-                                                                  OUTPUT_ATTR_VALUE_CSV };
+                                                                  OUTPUT_ATTR_VALUE_CSV,
+                                                                  OUTPUT_ATTR_VALUE_SNAPSHOT,
+                                                                  OUTPUT_ATTR_VALUE_SQLITE };
 
 ModelConfiguration::~ModelConfiguration()
 {
@@ -158,15 +179,161 @@ QModelIndex ModelConfiguration::parent(const QModelIndex & /*index*/) const
 	return (QModelIndex());
 }
 
-void ModelConfiguration::__readSectionFiles(const QString& configFilePath,
+/*!
+ * \class ReqFilesCheckTask
+ * \brief Checks the consistency of consecutive requirement files of the configuration (see ModelConfiguration::__readSectionFiles)
+ */
+class ReqFilesCheckTask : public QRunnable
+{
+public:
+	ReqFilesCheckTask(const ModelConfiguration* p_config, const ModelConfiguration::CnfFileAttributesMap_t* p_items,
+	                  QVector<ModelConfigurationErrors::error_t>* p_errors, int p_begin, int p_end)
+		: QRunnable(), __config(p_config), __items(p_items), __errors(p_errors), __begin(p_begin), __end(p_end)
+	{
+		setAutoDelete(true);
+	}
+
+	void run()
+	{
+		for (int i = __begin ; i < __end ; i++)
+		{
+			__config->__hasAReqFileConsistecyError(__items[i], __errors[i]);
+		}
+	}
+
+private:
+	const ModelConfiguration* __config;  //!< The configuration, only read
+	const ModelConfiguration::CnfFileAttributesMap_t* __items;  //!< Files to check, owned by the configuration
+	QVector<ModelConfigurationErrors::error_t>* __errors;  //!< Errors of each file, owned by the configuration
+	int __begin;  //!< Index of the first file checked by the task
+	int __end;  //!< Index following the last file checked by the task
+};
+
+/*!
+ * \brief Unescapes a quoted value of the configuration file, the way QSettings does
+ * \param[in] p_text    the text following the equal sign, starting with the quote
+ * \param[out] p_value  the unescaped value
+ * \return false if the value uses a syntax left to QSettings
+ */
+static bool unquoteIniValue(const QString& p_text, QString& p_value)
+{
+	p_value.clear();
+	p_value.reserve(p_text.length());
+
+	int i = 1;
+	for ( ; i < p_text.length() && p_text[i] != '"' ; i++)
+	{
+		QChar c = p_text[i];
+		if (c != '\\')
+		{
+			p_value += c;
+			continue;
+		}
+
+		if (++i >= p_text.length()) return (false);
+		switch (p_text[i].unicode())
+		{
+			case '\\': case '"': case '\'': case '?': p_value += p_text[i]; break;
+			case 'a': p_value += QChar('\a'); break;
+			case 'b': p_value += QChar('\b'); break;
+			case 'f': p_value += QChar('\f'); break;
+			case 'n': p_value += QChar('\n'); break;
+			case 'r': p_value += QChar('\r'); break;
+			case 't': p_value += QChar('\t'); break;
+			case 'v': p_value += QChar('\v'); break;
+			default: return (false);  // hexadecimal and octal codes
+		}
+	}
+
+	// Only a comment may follow the value (a comma would make it a list)
+	if (i >= p_text.length()) return (false);
+	QString rest = p_text.mid(i + 1).trimmed();
+	return (rest.isEmpty() || rest.startsWith(';'));
+}
+
+bool ModelConfiguration::__readIniFileInOnePass(const QString& configFilePath, IniFile_t& iniFile)
+{
+	QFile fin(configFilePath);
+	if (!fin.open(QIODevice::ReadOnly)) return (false);
+
+	QString text = QString::fromUtf8(fin.readAll());
+	if (text.startsWith(QChar(0xfeff))) text.remove(0, 1);
+
+	static const QRegularExpression unquotedSpecials("[\\s\"\\\\,;]");
+	QString sectionName;
+	IniSection_t* section = 0;
+#ifdef Q_OS_WIN
+	// Keys are case insensitive there: QSettings keeps the first spelling of a group
+	QHash<QString, QString> groupsByLowerName;
+#endif
+
+	foreach(QString line, text.split('\n'))
+	{
+		line = line.trimmed();
+		if (line.isEmpty() || line.startsWith(';')) continue;
+
+		if (line.startsWith('['))
+		{
+			if (!line.endsWith(']')) return (false);
+			sectionName = line.mid(1, line.length() - 2).trimmed();
+			if (sectionName.contains(QRegularExpression("[%/\\\\]"))) return (false);
+#ifdef Q_OS_WIN
+			sectionName = sectionName.toLower();
+#endif
+			section = &iniFile[sectionName];
+			continue;
+		}
+
+		int eq = line.indexOf('=');
+		if (eq <= 0 || line.startsWith('#')) return (false);
+
+		QString key = line.left(eq).trimmed().replace('\\', '/');
+		QString rawValue = line.mid(eq + 1).trimmed();
+		if (key.contains('%') || rawValue.startsWith('@')) return (false);
+
+		QString value;
+		if (rawValue.startsWith('"'))
+		{
+			if (!unquoteIniValue(rawValue, value)) return (false);
+		}
+		else if (rawValue.contains(unquotedSpecials))
+		{
+			return (false);
+		}
+		else
+		{
+			value = rawValue;
+		}
+
+		// Only the keys of a group of a section are read (group/attribute)
+		int slash = key.indexOf('/');
+		if (slash < 0) continue;
+		if (section == 0) return (false);
+
+		QString group = key.left(slash);
+		QString attribute = key.mid(slash + 1);
+#ifdef Q_OS_WIN
+		attribute = attribute.toLower();
+		QString& spelling = groupsByLowerName[sectionName.toLower() + "/" + group.toLower()];
+		if (spelling.isEmpty()) spelling = group;
+		if (spelling != group) return (false);
+#endif
+		(*section)[group][attribute] = value;
+	}
+
+	return (true);
+}
+
+void ModelConfiguration::__readSectionFiles(const IniSection_t& section, const QString& configFilePath,
                                             ModelConfigurationErrorsRef errModel)
 {
-	QSettings configSettings(configFilePath, QSettings::IniFormat);
-	configSettings.setIniCodec("UTF-8") ;
+	QVector<CnfFileAttributesMap_t> items;
+	items.reserve(section.count());
+	QString configDirPath = QFileInfo(configFilePath).absoluteDir().absolutePath();
 
 	// First read the defined files : store each configuration value for each expected attribute
-	configSettings.beginGroup(SECTION_REQFILES);
-	foreach(QString file_id, configSettings.childGroups())
+	IniSection_t::const_iterator it;
+	for (it = section.constBegin() ; it != section.constEnd() ; ++it)
 	{
 		// Temporarily store the value in a map ; it will be really added only if it is consistent
 		CnfFileAttributesMap_t newItem;
@@ -176,13 +343,13 @@ void ModelConfiguration::__readSectionFiles(const QString& configFilePath,
 			// The id isn't read as an attribute : it is the group name
 			if (attr_key == REQFILE_ATTR_ID)
 			{
-				newItem[attr_key] = file_id;
+				newItem[attr_key] = it.key();
 				continue;
 			}
 			else
 			{
 				// all others attributes are read with an empty string as a default value
-				newItem[attr_key] = configSettings.value(QString("%1/%2").arg(file_id).arg(attr_key), QString("")).toString();
+				newItem[attr_key] = it.value().value(attr_key, QString(""));
 			}
 		}
 
@@ -194,32 +361,61 @@ void ModelConfiguration::__readSectionFiles(const QString& configFilePath,
 		QFileInfo fi(newItem[REQFILE_ATTR_PATH]);
 		if (fi.isRelative())
 		{
-			QFileInfo ficnf(configFilePath);
-			newItem[REQFILE_ATTR_PATH] = ficnf.absoluteDir().absolutePath() + "/" + newItem[REQFILE_ATTR_PATH];
+			newItem[REQFILE_ATTR_PATH] = configDirPath + "/" + newItem[REQFILE_ATTR_PATH];
 		}
 
-		/*
-		 * And now, the consistency of this item can be checked. The item is added to the list of configured files
-		 * only if it is consistent
-		 */
-		if (!__hasAReqFileConsistecyError(newItem, errModel))
+		items.append(newItem);
+	}
+
+	/*
+	 * And now, the consistency of the items can be checked, in parallel as most of the time is spent in the file
+	 * system and in the compilation of the regular expressions
+	 */
+	QVector< QVector<ModelConfigurationErrors::error_t> > errorsByItem(items.count());
+	int nbTasks = qMin(items.count() / MIN_FILES_BY_CHECK_TASK, QThread::idealThreadCount() * CHECK_TASKS_BY_THREAD);
+	if (nbTasks <= 1)
+	{
+		for (int i = 0 ; i < items.count() ; i++)
 		{
-			qDebug() << "ModelConfiguration::__readSectionFiles : File description is consistent --> adding the file to the list of configured files";
-			__reqFiles.insert(newItem[REQFILE_ATTR_ID], newItem);
+			__hasAReqFileConsistecyError(items[i], errorsByItem[i]);
 		}
 	}
-	configSettings.endGroup();
+	else
+	{
+		QThreadPool pool;
+		for (int t = 0 ; t < nbTasks ; t++)
+		{
+			pool.start(new ReqFilesCheckTask(this, items.constData(), errorsByItem.data(),
+			                                 items.count() * t / nbTasks, items.count() * (t + 1) / nbTasks));
+		}
+		pool.waitForDone();
+	}
+
+	// The item is added to the list of configured files only if it is consistent
+	int nbConsistent = 0;
+	for (int i = 0 ; i < items.count() ; i++)
+	{
+		if (errorsByItem[i].isEmpty())
+		{
+			__reqFiles.insert(items[i][REQFILE_ATTR_ID], items[i]);
+			nbConsistent++;
+		}
+		else
+		{
+			errModel.addErrors(errorsByItem[i]);
+		}
+	}
+
+	qDebug() << "ModelConfiguration::__readSectionFiles : " << nbConsistent << " fichiers cohérents sur " << items.count()
+	         << " (" << nbTasks << " tâches de vérification)";
 }
 
-void ModelConfiguration::__readSectionOutputs(const QString& configFilePath,
-                                            ModelConfigurationErrorsRef errModel)
+void ModelConfiguration::__readSectionOutputs(const IniSection_t& section, const QString& configFilePath,
+                                              ModelConfigurationErrorsRef errModel)
 {
-	QSettings configSettings(configFilePath, QSettings::IniFormat);
-	configSettings.setIniCodec("UTF-8") ;
-
 	// First read the defined files : store each configuration value for each expected attribute
-	configSettings.beginGroup(SECTION_OUTPUT_FILES);
-	foreach(QString file_id, configSettings.childGroups())
+	IniSection_t::const_iterator it;
+	for (it = section.constBegin() ; it != section.constEnd() ; ++it)
 	{
 		// Temporarily store the value in a map ; it will be really added only if it is consistent
 		CnfFileAttributesMap_t newItem;
@@ -227,7 +423,7 @@ void ModelConfiguration::__readSectionOutputs(const QString& configFilePath,
 		foreach(QString attr_key, OUTPUT_ATTRS)
 		{
 			// all attributes are read with an empty string as a default value
-			newItem[attr_key] = configSettings.value(QString("%1/%2").arg(file_id).arg(attr_key), QString("")).toString();
+			newItem[attr_key] = it.value().value(attr_key, QString(""));
 		}
 
 		/*
@@ -252,16 +448,24 @@ void ModelConfiguration::__readSectionOutputs(const QString& configFilePath,
 			__outputFiles.append(newItem);
 		}
 	}
-	configSettings.endGroup();
 }
 
 void ModelConfiguration::setFile(const char* p_filepath, ModelConfigurationErrorsRef errModel)
 {
+	AnalysisTraceScope ts("config_load", AnalysisTracer::CATEGORY_CONFIG, QString(p_filepath));
+
 	// Clear possible previous data & errors
 	__reqFiles.clear();
 	__outputFiles.clear();
 	errModel.clear();
 
+	// The patterns of the previous configuration are not kept for the whole process (watch mode, edited
+	// configurations ...), the parsers already built keep their own copies
+	{
+		QMutexLocker l(&compiledRegexesMutex);
+		compiledRegexes.clear();
+	}
+
 	/*
 	 * First check the existence and the possibility to open the file and only then, open it as a QSetting.
 	 * It is mandatory because in case p_filepath is coming from the command line, it is
@@ -285,22 +489,51 @@ void ModelConfiguration::setFile(const char* p_filepath, ModelConfigurationError
 		// Close the file to let the QSettings access it
 		tstf.close() ;
 
-		// Check the format of the file ; parse it only if it is correct
-		QSettings configSettings(configFilePath, QSettings::IniFormat);
-		if (configSettings.status() == QSettings::FormatError)
+		// The usual syntax is read in one pass, QSettings reads the rest of the files
+		IniFile_t iniFile;
+		bool isRead = __readIniFileInOnePass(configFilePath, iniFile);
+		if (!isRead)
 		{
-			ModelConfigurationErrors::error_t e;
-			e.severity = ModelConfigurationErrors::WARNING;
-			e.category = ModelConfigurationErrors::PARSING;
-			e.description = QObject::trUtf8("Erreurs de format de fichier ini (la configuration peut être fausse)");
+			qDebug() << "ModelConfiguration::setFile : syntaxe non reconnue, lecture par QSettings de " << configFilePath;
+			iniFile.clear();
+
+			// Check the format of the file ; parse it only if it is correct
+			QSettings configSettings(configFilePath, QSettings::IniFormat);
+			configSettings.setIniCodec("UTF-8") ;
+			if (configSettings.status() == QSettings::FormatError)
+			{
+				ModelConfigurationErrors::error_t e;
+				e.severity = ModelConfigurationErrors::WARNING;
+				e.category = ModelConfigurationErrors::PARSING;
+				e.description = QObject::trUtf8("Erreurs de format de fichier ini (la configuration peut être fausse)");
 
-			errModel.addError(e);
+				errModel.addError(e);
+			}
+			else
+			{
+				foreach(QString section_name, QStringList() << SECTION_REQFILES << SECTION_OUTPUT_FILES)
+				{
+					configSettings.beginGroup(section_name);
+					foreach(QString group, configSettings.childGroups())
+					{
+						configSettings.beginGroup(group);
+						foreach(QString attr_key, configSettings.childKeys())
+						{
+							iniFile[section_name][group][attr_key] = configSettings.value(attr_key).toString();
+						}
+						configSettings.endGroup();
+					}
+					configSettings.endGroup();
+				}
+				isRead = true;
+			}
 		}
-		else
+
+		// From now it is possible to read the configuration safely
+		if (isRead)
 		{
-			// From now it is possible to read the configuration safely
-			__readSectionFiles(configFilePath, errModel);
-			__readSectionOutputs(configFilePath, errModel);
+			__readSectionFiles(iniFile.value(SECTION_REQFILES), configFilePath, errModel);
+			__readSectionOutputs(iniFile.value(SECTION_OUTPUT_FILES), configFilePath, errModel);
 		}
 	}
 
@@ -314,8 +547,54 @@ void ModelConfiguration::setFile(const char* p_filepath, ModelConfigurationError
 	errModel.refresh();
 }
 
+QRegularExpression ModelConfiguration::getCompiledRegex(const QString& p_pattern)
+{
+	{
+		QMutexLocker l(&compiledRegexesMutex);
+		QHash<QString, QRegularExpression>::const_iterator it = compiledRegexes.constFind(p_pattern);
+		if (it != compiledRegexes.constEnd()) return (it.value());
+	}
+
+	// Compiled without holding the lock, so that the checks of the files go on in parallel
+	QRegularExpression regex(p_pattern);
+	regex.optimize();
+
+	// Another thread may have compiled the same pattern meanwhile : its regular expression is shared, the copies
+	// sharing the compiled pattern
+	QMutexLocker l(&compiledRegexesMutex);
+	QHash<QString, QRegularExpression>::const_iterator it = compiledRegexes.constFind(p_pattern);
+	if (it != compiledRegexes.constEnd()) return (it.value());
+
+	compiledRegexes.insert(p_pattern, regex);
+	return (regex);
+}
+
+bool ModelConfiguration::parsePageRange(const QString& p_value, int& p_first, int& p_last)
+{
+	static const QRegularExpression rangeRegex("^\\s*(?<first>[0-9]*)\\s*(?<dash>-?)\\s*(?<last>[0-9]*)\\s*$");
+
+	p_first = 1;
+	p_last = -1;
+	if (p_value.trimmed().isEmpty()) return (true);
+
+	QRegularExpressionMatch m = rangeRegex.match(p_value);
+	if (!m.hasMatch()) return (false);
+
+	QString first = m.captured("first");
+	QString last = m.captured("last");
+	bool isRange = !m.captured("dash").isEmpty();
+	if (first.isEmpty() && last.isEmpty()) return (false);
+	if (!isRange && !last.isEmpty()) return (false);  // two numbers without a dash
+
+	if (!first.isEmpty()) p_first = first.toInt();
+	if (!last.isEmpty()) p_last = last.toInt();
+	else if (!isRange) p_last = p_first;
+
+	return (p_first >= 1 && (p_last == -1 || p_last >= p_first));
+}
+
 void ModelConfiguration::__regexCheckValidityAndGroups(const CnfFileAttributesMap_t& configured_file,
-                                                       QVector<ModelConfigurationErrors::error_t>& errors)
+                                                       QVector<ModelConfigurationErrors::error_t>& errors) const
 {
 	ModelConfigurationErrors::error_t e ;
 	QRegularExpression regex;
@@ -335,7 +614,7 @@ void ModelConfiguration::__regexCheckValidityAndGroups(const CnfFileAttributesMa
 
 	auto isValidPattern = [&e, &regex, &msg, &errors, &file_id, &attrVal, &attrName]()
 	{
-		regex.setPattern(attrVal);
+		regex = getCompiledRegex(attrVal);
 		bool b = regex.isValid() ;
 		if (!b)
 		{
@@ -399,8 +678,8 @@ void ModelConfiguration::__regexCheckValidityAndGroups(const CnfFileAttributesMa
 		addContentError() ;
 	}
 
-	attrName = REQFILE_ATTR_REQREGEX ;
-	attrVal = configured_file[REQFILE_ATTR_REQREGEX] ;
+	attrName = REQFILE_ATTR_STOPAFTERREGEX ;
+	attrVal = configured_file[REQFILE_ATTR_STOPAFTERREGEX] ;
 	if (!attrVal.isEmpty())
 	{
 		// no special requirement for REQFILE_ATTR_STOPAFTERREGEX but being valid if it is not empty
@@ -409,10 +688,10 @@ void ModelConfiguration::__regexCheckValidityAndGroups(const CnfFileAttributesMa
 }
 
 bool ModelConfiguration::__hasAReqFileConsistecyError(const CnfFileAttributesMap_t& configured_file,
-                                                      ModelConfigurationErrorsRef errModel)
+                                                      QVector<ModelConfigurationErrors::error_t>& errors) const
 {
 	bool retVal = true;  // errors by default
-	QVector<ModelConfigurationErrors::error_t> errors;
+	int nbPreviousErrors = errors.count();
 	ModelConfigurationErrors::error_t e;
 	QString msg ;
 	QString file_id = configured_file[REQFILE_ATTR_ID];
@@ -440,11 +719,13 @@ bool ModelConfiguration::__hasAReqFileConsistecyError(const CnfFileAttributesMap
 	 *
 	 * - REQFILE_ATTR_HASUP must not be empty
 	 *
-	 * - REQFILE_ATTR_PATH must be an existing file and must be readable
+	 * - REQFILE_ATTR_PATH must be an existing file and must be readable (or the root directory of a tree)
 	 *
 	 * - REQFILE_ATTR_REQREGEX cannot be empty, must be a valid regex and contain a group named REQFILE_GRPNAME_REQID
 	 *
 	 * - if not empty, REQFILE_ATTR_STOPAFTERREGEX must be a valid regex
+	 *
+	 * - if not empty, REQFILE_ATTR_PAGES must be a range of pages
 	 */
 	__regexCheckValidityAndGroups(configured_file, errors) ;
 
@@ -460,9 +741,28 @@ bool ModelConfiguration::__hasAReqFileConsistecyError(const CnfFileAttributesMap
 		addContentError() ;
 	}
 
+	int first_page ;
+	int last_page ;
+	if (!parsePageRange(configured_file[REQFILE_ATTR_PAGES], first_page, last_page))
+	{
+		msg = QObject::trUtf8("Fichier %1, l'attribut %2 n'est pas un intervalle de pages (par exemple 5-120) : %3").arg(file_id).arg(REQFILE_ATTR_PAGES).arg(configured_file[REQFILE_ATTR_PAGES]);
+		addContentError() ;
+	}
+
 	QString file_path = configured_file[REQFILE_ATTR_PATH] ;
 	QFileInfo fi(file_path);
-	if (!fi.exists() || !fi.isFile())
+	if (RequirementFile_tree::isTreePath(file_path))
+	{
+		// The files of a tree are only listed when it is parsed, many of them are expected
+		QString root_path = RequirementFile_tree::getRootDirectory(file_path) ;
+		QFileInfo root(root_path) ;
+		if (!root.isDir() || !root.isReadable())
+		{
+			msg = QObject::trUtf8("Fichier %1, le répertoire %2 n'existe pas ou n'est pas accessible en lecture").arg(file_id).arg(root_path);
+			addContentError() ;
+		}
+	}
+	else if (!fi.exists() || !fi.isFile())
 	{
 		msg = QObject::trUtf8("Fichier %1, le fichier %2 n'existe pas ou n'est pas de type fichier").arg(file_id).arg(file_path);
 		addContentError() ;
@@ -483,15 +783,7 @@ bool ModelConfiguration::__hasAReqFileConsistecyError(const CnfFileAttributesMap
 
 
 	// compute result
-	if (errors.count() > 0)
-	{
-		errModel.addErrors(errors);
-		retVal = true;
-	}
-	else
-	{
-		retVal = false;
-	}
+	retVal = (errors.count() > nbPreviousErrors);
 
 	return (retVal);
 }
@@ -7,7 +7,6 @@
 
 #include <QDebug>
 #include <QFile>
-#include <QMutexLocker>
 
 #include "ModelSngAnalysisErrors.h"
 #include "FactoryReportBaseString.h"
@@ -27,12 +26,13 @@ static const QVector<QString> COL_HEADERS { QObject::trUtf8("Sévérité"),
                                             QObject::trUtf8("Description") };
 
 ModelSngAnalysisErrors::ModelSngAnalysisErrors(QObject *parent)
-		: QAbstractItemModel(parent)
+		: QAbstractItemModel(parent), __batches(NULL), __generation(0)
 {
 }
 
 ModelSngAnalysisErrors::~ModelSngAnalysisErrors()
 {
+	__deleteBatches(__takeBatches());
 }
 
 int ModelSngAnalysisErrors::columnCount(const QModelIndex & /*parent*/) const
@@ -42,7 +42,7 @@ int ModelSngAnalysisErrors::columnCount(const QModelIndex & /*parent*/) const
 
 int ModelSngAnalysisErrors::rowCount(const QModelIndex & /*parent*/) const
 {
-	return (__errors.count());
+	return (__rows.count());
 }
 
 QVariant ModelSngAnalysisErrors::data(const QModelIndex &index, int role) const
@@ -51,7 +51,7 @@ QVariant ModelSngAnalysisErrors::data(const QModelIndex &index, int role) const
 
 	if (role == Qt::DisplayRole)
 	{
-		AnalysisError e = __errors.at(index.row());
+		AnalysisError e = __getRowError(__rows.at(index.row()));
 
 		switch (index.column())
 		{
@@ -107,59 +107,178 @@ QModelIndex ModelSngAnalysisErrors::parent(const QModelIndex & /*index*/) const
 	return (QModelIndex());
 }
 
-void ModelSngAnalysisErrors::addError(const AnalysisError& e)
+void ModelSngAnalysisErrors::__addError(AnalysisErrorStore& p_store, const AnalysisError& e, QVector<row_t>& p_rows)
 {
-	QMutexLocker l(&__addErrorMutex) ; // avoid simultaneous writing
+	int g;
+	row_t row;
+	if (p_store.add(e, &g))
+	{
+		row.group = g;
+		row.example = p_store.getGroups()[g].examples.count() - 1;
+		p_rows.append(row);
+	}
+	else if (p_store.getGroups()[g].nbErrors == AnalysisErrorStore::MAX_EXAMPLES_BY_GROUP + 1)
+	{
+		// The first error not displayed: the group is summarized after its examples
+		row.group = g;
+		row.example = -1;
+		p_rows.append(row);
+	}
+}
 
-	__errors.append(e);
+ModelSngAnalysisErrors::buffer_t& ModelSngAnalysisErrors::__getBuffer()
+{
+	int generation = __generation.loadAcquire();
+	if (!__buffers.hasLocalData())
+	{
+		buffer_t b;
+		b.generation = generation;
+		__buffers.setLocalData(b);
+	}
 
-	QString loc = e.getLocation();
-	if (__nbErrorsByFileId.contains(loc))
+	buffer_t& b = __buffers.localData();
+	if (b.generation != generation)
 	{
-		__nbErrorsByFileId[loc] += 1;
+		// Added before the last clear, and never committed (eg the merge of a cancelled run)
+		b.generation = generation;
+		b.errors.clear();
 	}
-	else
+
+	return (b);
+}
+
+ModelSngAnalysisErrors::batch_t* ModelSngAnalysisErrors::__takeBatches()
+{
+	return (__batches.fetchAndStoreAcquire(NULL));
+}
+
+void ModelSngAnalysisErrors::__deleteBatches(batch_t* p_batches)
+{
+	while (p_batches)
 	{
-		__nbErrorsByFileId[loc] = 1;
+		batch_t* next = p_batches->next;
+		delete (p_batches);
+		p_batches = next;
 	}
 }
 
+void ModelSngAnalysisErrors::addError(const AnalysisError& e)
+{
+	__getBuffer().errors.append(e);
+}
+
 void ModelSngAnalysisErrors::addErrors(const QVector<AnalysisError>& ve)
 {
-	QMutexLocker l(&__addErrorMutex) ; // avoid simultaneous writing
+	__getBuffer().errors += ve;
+}
+
+void ModelSngAnalysisErrors::commitErrors()
+{
+	buffer_t& b = __getBuffer();
+	if (b.errors.isEmpty()) return;
 
-	__errors.append(ve);
+	batch_t* batch = new batch_t;
+	batch->generation = b.generation;
+	batch->errors.swap(b.errors);
 
-	foreach(AnalysisError e, ve)
+	// Only pushes are concurrent, the batches are taken all at once: the head is simply swapped
+	batch_t* head;
+	do
 	{
-		QString loc = e.getLocation();
-		if ( __nbErrorsByFileId.contains(loc) )
-		{
-			__nbErrorsByFileId[loc] += 1;
-		}
-		else
-		{
-			__nbErrorsByFileId[loc] = 1;
-		}
+		head = __batches.loadAcquire();
+		batch->next = head;
 	}
+	while (!__batches.testAndSetRelease(head, batch));
 }
 
-void ModelSngAnalysisErrors::clear()
+void ModelSngAnalysisErrors::discardErrors()
 {
-	__errors.clear();
-	__nbErrorsByFileId.clear();
+	__getBuffer().errors.clear();
 }
 
-int ModelSngAnalysisErrors::getNberrorsInAFile(const QString& p_fileId)
+void ModelSngAnalysisErrors::publishErrors()
 {
-	if (!__nbErrorsByFileId.contains(p_fileId))
+	// The batches are taken the last committed first, they are published in the order of the commits
+	QVector<batch_t*> batches;
+	for (batch_t* b = __takeBatches() ; b ; b = b->next)
 	{
-		return (0);
+		batches.prepend(b);
 	}
-	else
+
+	int generation = __generation.loadAcquire();
+	QVector<row_t> rows;
+	foreach(batch_t* b, batches)
 	{
-		return (__nbErrorsByFileId[p_fileId]);
+		if (b->generation == generation)
+		{
+			foreach(const AnalysisError& e, b->errors)
+			{
+				__addError(__store, e, rows);
+			}
+		}
+
+		delete (b);
 	}
+
+	if (rows.isEmpty()) return;
+
+	beginInsertRows(QModelIndex(), __rows.count(), __rows.count() + rows.count() - 1);
+	__rows += rows;
+	endInsertRows();
+}
+
+ModelSngAnalysisErrors::errors_t ModelSngAnalysisErrors::groupErrors(const QVector<AnalysisError>& p_errors)
+{
+	errors_t grouped;
+	foreach(const AnalysisError& e, p_errors)
+	{
+		__addError(grouped.store, e, grouped.rows);
+	}
+
+	return (grouped);
+}
+
+void ModelSngAnalysisErrors::setErrors(const errors_t& p_errors)
+{
+	// The errors added or committed from now on are the ones of the next analysis
+	__generation.fetchAndAddOrdered(1);
+	__deleteBatches(__takeBatches());
+
+	beginResetModel();
+	__store = p_errors.store;
+	__rows = p_errors.rows;
+	endResetModel();
+}
+
+void ModelSngAnalysisErrors::clear()
+{
+	// The errors added or committed from now on are the ones of the next analysis
+	__generation.fetchAndAddOrdered(1);
+	__deleteBatches(__takeBatches());
+
+	beginResetModel();
+	__store.clear();
+	__rows.clear();
+	endResetModel();
+}
+
+int ModelSngAnalysisErrors::getNberrorsInAFile(const QString& p_fileId)
+{
+	return (__store.getNbErrorsOfLocation(p_fileId));
+}
+
+int ModelSngAnalysisErrors::getNbErrors()
+{
+	return (__store.getNbErrors());
+}
+
+AnalysisError ModelSngAnalysisErrors::__getRowError(const row_t& p_row) const
+{
+	const AnalysisErrorStore::group_t& group = __store.getGroups().at(p_row.group);
+	if (p_row.example >= 0) return (group.examples.at(p_row.example));
+
+	return (AnalysisError(group.severity, group.category, group.location, AnalysisError::ERRORS_NOT_DETAILED,
+	                      QString::number(group.nbErrors - group.examples.count())));
 }
 
 void ModelSngAnalysisErrors::refresh()
@@ -180,8 +299,9 @@ const QString ModelSngAnalysisErrors::getReportErrorSummaryTable(const QString&
 
 	QString result = "";
 
-	foreach(AnalysisError a, __errors)
+	foreach(const row_t& row, __rows)
 	{
+		AnalysisError a = __getRowError(row);
 		QString newline = s_base;
 		newline.replace("REKKIX_ERRORS_SEVERITY", a.getSeverityString());
 
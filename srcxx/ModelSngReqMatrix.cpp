@@ -5,9 +5,15 @@
  *      Author: f.souliers
  */
 
+#include <algorithm>
+
 #include <QDebug>
 #include <QMutexLocker>
+#include <QRunnable>
+#include <QStringList>
+#include <QThreadPool>
 
+#include "AnalysisTracer.h"
 #include "ModelSngReqMatrix.h"
 #include "ModelSngAnalysisErrors.h"
 #include "FactoryReportBaseString.h"
@@ -28,35 +34,377 @@ static const QVector<QString> FILECOVERAGE_HEADERS { QObject::trUtf8("ID"),
 
 static const QString STR_CSS_INVALID_ROW_CLASS_ATTR = " class=\"invalid\" ";
 
+/*!
+ * \class RetiredRunDeletion
+ * \brief Deletes the requirements of a previous run in the background (see ModelSngReqMatrix::clear)
+ *
+ * Nothing points to them anymore: the files of the run have been released with it.
+ */
+class RetiredRunDeletion : public QRunnable
+{
+public:
+	RetiredRunDeletion(RequirementArena* p_arena, QMap<QString, RequirementPtr>& p_reqsByName,
+	                   QMap<QString, QVector<RequirementPtr>>& p_reqsByFileId)
+		: QRunnable(), __arena(p_arena)
+	{
+		setAutoDelete(true);
+		__reqsByName.swap(p_reqsByName);
+		__reqsByFileId.swap(p_reqsByFileId);
+	}
+
+	void run()
+	{
+		AnalysisTraceScope ts("release_requirements", AnalysisTracer::CATEGORY_COVERAGE);
+		__reqsByName.clear();
+		__reqsByFileId.clear();
+		delete (__arena);
+	}
+
+private:
+	RequirementArena* __arena;  //!< Requirements of the run, owned by the task
+	QMap<QString, RequirementPtr> __reqsByName;  //!< Index of the run, its nodes are released here too
+	QMap<QString, QVector<RequirementPtr>> __reqsByFileId;  //!< Requirements of the run by file
+};
+
 
 ModelSngReqMatrix::ModelSngReqMatrix(QObject *parent)
-		: QAbstractItemModel(parent)
+		: QAbstractItemModel(parent), __reqArena(new RequirementArena()), __runId(0), __isCoverageComputed(false)
 {
+	__retiredRunsPool.setMaxThreadCount(1);
 }
 
 ModelSngReqMatrix::~ModelSngReqMatrix()
 {
+	__retiredRunsPool.waitForDone();
+
+	// The application is ending : the requirements are released at once, not by __retiredRunsPool
+	__clearRequirements(false);
 	clear();
+	delete (__reqArena);
 }
 
 void ModelSngReqMatrix::clear()
 {
+	QMutexLocker l_rbn(&__reqsByNameMutex) ; // a parser of the previous run may still be writing
+	QMutexLocker l_rbf(&__reqsByFileIdMutex) ;
+	beginResetModel();
+
+	// From now on, everything sent by the parsers of the previous run is ignored
+	__runId.ref();
+
 	QMap<QString, RequirementFileAbstractPtr>::iterator it;
 	for (it = __filesByFileId.begin(); it != __filesByFileId.end() ; ++it)
 	{
-		RequirementFileAbstractPtr p = it.value();
-		if (p) delete (p);
+		if (it.value()) __releaseRequirementFile(it.value());
+	}
 
-		__filesByFileId[it.key()] = NULL;
+	__filesByFileId.clear();
+	__updatedFileIds.clear();
+	__clearRequirements();
+	__isCoverageComputed = false;
+
+	__rows.clear();
+	{
+		QMutexLocker l_mr(&__mergedRowsMutex) ;
+		__mergedRows.clear();
+	}
+
+	endResetModel();
+}
+
+void ModelSngReqMatrix::__clearRequirements(bool p_isInBackground)
+{
+	if (p_isInBackground && !__reqsByName.isEmpty())
+	{
+		// The next run starts with a new arena, the requirements of this one are released by another thread
+		__retiredRunsPool.start(new RetiredRunDeletion(__reqArena, __reqsByName, __reqsByFileId));
+		__reqArena = new RequirementArena();
 	}
 
 	__reqsByName.clear();
 	__reqsByFileId.clear();
+	__nbReferencesByReqId.clear();
+	__conflictingReqIds.clear();
+	__touchedReqs.clear();
+	__mergeErrorsByFileId.clear();
+	__linkErrorsByFilePair.clear();
+}
+
+void ModelSngReqMatrix::__addMergeError(const QString& p_fileId, const AnalysisError& e)
+{
+	__mergeErrorsByFileId[p_fileId].append(e);
+	ModelSngAnalysisErrors::instance().addError(e);
+}
+
+void ModelSngReqMatrix::__releaseRequirementFile(RequirementFileAbstractPtr p)
+{
+	// A thread cannot be deleted while running : it is deleted once finished. If it finishes between the
+	// connection and the test, the pending deleteLater is discarded by the deletion
+	QObject::disconnect(p, 0, 0, 0);
+	QObject::connect(p, SIGNAL(finished()), p, SLOT(deleteLater()));
+	p->requestInterruption();
+	if (!p->isRunning()) delete (p);
+}
+
+QVector<RequirementFileAbstractPtr> ModelSngReqMatrix::prepareRequirementFilesUpdate(const QVector<RequirementFileAbstractPtr>& p_files)
+{
+	QVector<RequirementFileAbstractPtr> keptFiles;
+	{
+		QMutexLocker l_rbn(&__reqsByNameMutex) ; // same protection as clear
+		QMutexLocker l_rbf(&__reqsByFileIdMutex) ;
+		beginResetModel();
+
+		__runId.ref();
+
+		// The previous versions of the files can only be removed if the matrix does not depend on the order
+		// of the merge
+		bool isIncremental = __isCoverageComputed;
+		foreach(RequirementFileAbstractPtr p, p_files)
+		{
+			RequirementFileAbstractPtr old = __filesByFileId.value(p->getFileId(), NULL);
+			if (old && __hasConflictingContributions(old)) isIncremental = false;
+		}
+
+		if (isIncremental)
+		{
+			foreach(RequirementFileAbstractPtr p, p_files)
+			{
+				RequirementFileAbstractPtr old = __filesByFileId.value(p->getFileId(), NULL);
+				if (old && old != p) __removeRequirementFileContributions(old);
+			}
+		}
+
+		foreach(RequirementFileAbstractPtr p, p_files)
+		{
+			RequirementFileAbstractPtr old = __filesByFileId.value(p->getFileId(), NULL);
+			if (old && old != p) __releaseRequirementFile(old);
+
+			p->setRunId(getRunId());
+			__filesByFileId.insert(p->getFileId(), p);
+			__updatedFileIds.insert(p->getFileId());
+		}
+
+		foreach(RequirementFileAbstractPtr p, __filesByFileId.values())
+		{
+			if (p_files.contains(p)) continue;
+
+			p->setRunId(getRunId());
+			if (!isIncremental)
+			{
+				p->clearAnalysisResults();
+				keptFiles.append(p);
+			}
+		}
+
+		if (!isIncremental)
+		{
+			qDebug() << "ModelSngReqMatrix::prepareRequirementFilesUpdate : the whole matrix is built again";
+			__clearRequirements();
+			__isCoverageComputed = false;
+		}
+
+		// The files stay displayed, their coverage is not up to date anymore
+		for (int i = 0 ; i < __rows.count() ; i++)
+		{
+			if (!isIncremental || __updatedFileIds.contains(__rows[i].fileId)) __rows[i].isCoverageComputed = false;
+		}
+		{
+			QMutexLocker l_mr(&__mergedRowsMutex) ;
+			__mergedRows.clear();
+		}
+
+		endResetModel();
+	}
+
+	// The errors of the replaced files are not displayed anymore, all the errors are displayed again with the
+	// coverage (see createResults)
+	ModelSngAnalysisErrors::instance().clear();
+
+	// The unchanged files are merged again by the caller from what they recorded, without being parsed
+	return (keptFiles);
+}
+
+bool ModelSngReqMatrix::__hasConflictingContributions(RequirementFileAbstractPtr p) const
+{
+	if (__conflictingReqIds.isEmpty()) return (false);
+
+	foreach(const RequirementFileAbstract::contribution_t& c, p->getContributions())
+	{
+		if (__conflictingReqIds.contains(c.reqId) || __conflictingReqIds.contains(c.refId)) return (true);
+	}
+
+	return (false);
+}
+
+void ModelSngReqMatrix::__removeRequirementFileContributions(RequirementFileAbstractPtr p)
+{
+	QString fileId = p->getFileId();
+
+	// The linked documents must not keep a pointer to the replaced object
+	foreach(QString linkedId, p->getUpstreamDocuments().keys() + p->getDownstreamDocuments().keys())
+	{
+		RequirementFileAbstractPtr linked = __filesByFileId.value(linkedId, NULL);
+		if (linked) linked->removeLinkedDocument(fileId);
+	}
+
+	// Only the requirements defined by the file can be composed of or cover other requirements
+	QVector<RequirementPtr> defined = __reqsByFileId.take(fileId);
+	QStringList definedIds;
+	QStringList releasedIds;
+	foreach(RequirementPtr r, defined)
+	{
+		foreach(RequirementPtr c, r->getComposingRequirements())
+		{
+			r->removeComposingRequirement(c);
+			c->removeCompositeRequirement(r);
+			if (c->getParent() == r)
+			{
+				c->setParent(c->getCompositeRequirements().isEmpty() ? NULL : c->getCompositeRequirements().last());
+			}
+
+			__touchedReqs.insert(c);
+			releasedIds.append(c->getId());
+		}
+
+		foreach(RequirementPtr u, r->getUpstreamRequirements())
+		{
+			r->removeUpstreamRequirement(u);
+			u->setDownstreamRequirement(NULL);
+
+			__touchedReqs.insert(u);
+			releasedIds.append(u->getId());
+		}
+
+		r->setState(Requirement::Expected);
+		r->setLocation(NULL);
+		r->setMustBeCovered(false);
+		__touchedReqs.insert(r);
+		definedIds.append(r->getId());
+	}
+
+	// A requirement still quoted by another file is kept as expected by it
+	foreach(RequirementPtr r, defined)
+	{
+		if (r->getParent())
+		{
+			r->setExpectedBy(r->getParent()->getLocationId() + " / " + r->getParent()->getId());
+		}
+		else if (r->getDownstreamRequirement())
+		{
+			r->setExpectedBy(r->getDownstreamRequirement()->getLocationId() + " / " + r->getDownstreamRequirement()->getId());
+		}
+	}
+
+	// The references are released once the links are removed, so no removed requirement is still pointed to
+	// (the pointers above may be dangling from now)
+	foreach(QString reqId, releasedIds)
+	{
+		__releaseReference(reqId);
+	}
+	foreach(QString reqId, definedIds)
+	{
+		if (__reqsByName.contains(reqId) && !__nbReferencesByReqId.contains(reqId))
+		{
+			__removeRequirement(reqId);
+		}
+	}
+
+	__mergeErrorsByFileId.remove(fileId);
+	__removeLinkErrors(fileId);
+}
+
+void ModelSngReqMatrix::__releaseReference(const QString& p_reqId)
+{
+	QHash<QString, int>::iterator it = __nbReferencesByReqId.find(p_reqId);
+	if (it == __nbReferencesByReqId.end()) return;
+
+	if (--it.value() > 0) return;
+
+	__nbReferencesByReqId.erase(it);
+	if (__reqsByName.contains(p_reqId) && __reqsByName[p_reqId]->getState() == Requirement::Expected)
+	{
+		__removeRequirement(p_reqId);
+	}
+}
+
+void ModelSngReqMatrix::__removeRequirement(const QString& p_reqId)
+{
+	Requirement* r = __reqsByName.take(p_reqId);
+	__touchedReqs.remove(r);
+	__reqArena->destroy(r);
+}
+
+void ModelSngReqMatrix::mergeRequirementFile(RequirementFileAbstractPtr p)
+{
+	int runId = p->getRunId();
+	if (runId != getRunId()) return;  // result of a cancelled run
+
+	ModelSngAnalysisErrors::instance().addErrors(p->getParsingErrors());
+
+	QString fileId = p->getFileId();
+	bool isCurrentReqAccepted = false;
+	foreach(const RequirementFileAbstract::contribution_t& c, p->getContributions())
+	{
+		switch (c.kind)
+		{
+			case RequirementFileAbstract::Definition:
+			{
+				Requirement r(c.reqId, Requirement::Defined, fileId);
+				r.setLocation(p);
+				r.setMustBeCovered(p->mustHaveDownstreamDocuments());
+				isCurrentReqAccepted = addDefinedRequirement(fileId, r, runId);
+				break;
+			}
+
+			case RequirementFileAbstract::Composition:
+				if (isCurrentReqAccepted)
+				{
+					Requirement r(c.refId, Requirement::Expected, c.location);
+					addExpectedCompositeRequirement(c.location, c.reqId, r, runId, c.part);
+				}
+				break;
+
+			case RequirementFileAbstract::Coverage:
+				if (isCurrentReqAccepted)
+				{
+					Requirement r(c.refId, Requirement::Expected, c.location);
+					addExpectedCoveredRequirement(c.location, c.reqId, r, runId, c.part);
+				}
+				break;
+		}
+	}
+
+	updateRequirementFileWithAcceptedRequirements(p);
+
+	// The errors of the file are displayed at once by the main thread. The run is checked under the same mutex as
+	// clear, which changes the run before the errors are cleared: the errors of a cancelled run are never committed
+	{
+		QMutexLocker l_rbn(&__reqsByNameMutex) ;
+		if (runId == getRunId()) ModelSngAnalysisErrors::instance().commitErrors();
+		else ModelSngAnalysisErrors::instance().discardErrors();
+	}
+
+	// The file is displayed by the next publishMergedFiles, its coverage is not known yet
+	fileRow_t row;
+	row.fileId = fileId;
+	row.nbRequirements = p->getRequirements().count();
+	row.nbErrors = p->getParsingErrors().count();
+	row.isCoverageComputed = false;
+	row.coverage = 0.0;
+	{
+		QMutexLocker l_rbn(&__reqsByNameMutex) ;
+		row.nbErrors += __mergeErrorsByFileId.value(fileId).count();
+	}
+
+	// Checked again under the mutex: clear empties __mergedRows after changing the run
+	QMutexLocker l_mr(&__mergedRowsMutex) ;
+	if (runId == getRunId()) __mergedRows.append(row);
 }
 
 void ModelSngReqMatrix::addRequirementFile(RequirementFileAbstractPtr p)
 {
 	QString f_id = p->getFileId();
+	p->setRunId(getRunId());
 
 	// If the file id is defined several times, then a configuration error is reported (see ModelConfiguration)
 	// ... so direct inserting is safe here
@@ -74,40 +422,43 @@ void ModelSngReqMatrix::updateRequirementFileWithAcceptedRequirements(Requiremen
 	p->setRequirements(__reqsByFileId[f_id]);
 }
 
-bool ModelSngReqMatrix::addDefinedRequirement(const QString& file_id, RequirementRef p_r)
+bool ModelSngReqMatrix::addDefinedRequirement(const QString& file_id, RequirementRef p_r, int p_runId)
 {
 	bool retval = false;  // by default, the method fails
 
+	// Result of a cancelled run (the run id cannot change while l_rbn is held, see clear)
+	QMutexLocker l_rbn(&__reqsByNameMutex) ; // avoid simultaneous access
+	if (p_runId != getRunId()) return (retval);
+
 	if (p_r.getState() != Requirement::Defined)
 	{
 		AnalysisError e(AnalysisError::ERROR,
 		                AnalysisError::CONSISTENCY,
 		                file_id,
-		                QObject::trUtf8("État non défini d'une exigence qui devrait être définie --> erreur dans l'analyseur de fichier"));
+		                AnalysisError::REQ_STATE_UNDEFINED);
 
-		ModelSngAnalysisErrors::instance().addError(e);
+		__addMergeError(file_id, e);
 		return (retval);
 	}
 
-	QMutexLocker l_rbn(&__reqsByNameMutex) ; // avoid simultaneous access
 	QString req_id = p_r.getId();
 	if (!__reqsByName.contains(req_id))
 	{
 		// The requirement does not exist at all in the global matrix, this is the easy case : it is
 		// just necessary to add it
-		__reqsByName.insert(req_id, p_r);
+		__reqsByName.insert(req_id, __reqArena->create(p_r));
 
 		retval = true;
 	}
 	else
 	{
-		if (__reqsByName[req_id].getState() == Requirement::Expected)
+		if (__reqsByName[req_id]->getState() == Requirement::Expected)
 		{
 			// The requirement exists in the matrix, only because it has been referenced by another
 			// requirement --> we just have to update it and set it as defined
-			__reqsByName[req_id].setState(Requirement::Defined);
-			__reqsByName[req_id].setLocation(p_r.getLocation());
-			__reqsByName[req_id].setMustBeCovered(p_r.mustBeCovered());
+			__reqsByName[req_id]->setState(Requirement::Defined);
+			__reqsByName[req_id]->setLocation(p_r.getLocation());
+			__reqsByName[req_id]->setMustBeCovered(p_r.mustBeCovered());
 
 			retval = true;
 		}
@@ -119,9 +470,12 @@ bool ModelSngReqMatrix::addDefinedRequirement(const QString& file_id, Requiremen
 			AnalysisError e(AnalysisError::ERROR,
 			                AnalysisError::CONSISTENCY,
 			                p_r.getLocationId(),
-			                QObject::trUtf8("Redéfinition de %1, préalablement définie dans %2").arg(req_id).arg(__reqsByName[req_id].getLocationId()));
+			                AnalysisError::REQ_REDEFINED,
+			                req_id,
+			                __reqsByName[req_id]->getLocationId());
 
-			ModelSngAnalysisErrors::instance().addError(e);
+			__addMergeError(file_id, e);
+			__conflictingReqIds.insert(req_id);
 			retval = false;
 		}
 	}
@@ -129,16 +483,23 @@ bool ModelSngReqMatrix::addDefinedRequirement(const QString& file_id, Requiremen
 	// If the retval is true, it means the requirement is actually defined in the
 	// current location --> store it in the __reqsByFileId map
 	QMutexLocker l_rbf(&__reqsByFileIdMutex) ; // avoid simultaneous writing
-	if (retval) __reqsByFileId[p_r.getLocationId()].append(&__reqsByName[req_id]);
+	if (retval)
+	{
+		__reqsByFileId[p_r.getLocationId()].append(__reqsByName[req_id]);
+		__touchedReqs.insert(__reqsByName[req_id]);
+	}
 
 	return (retval);
 }
 
 void ModelSngReqMatrix::addExpectedCompositeRequirement(const QString& location,
                                                         const QString& p_parentId,
-                                                        RequirementRef p_r)
+                                                        RequirementRef p_r,
+                                                        int p_runId,
+                                                        const QString& p_part)
 {
 	QMutexLocker l_rbn(&__reqsByNameMutex) ; // avoid simultaneous access
+	if (p_runId != getRunId()) return;  // result of a cancelled run
 
 	// The method has been called while there is no consistent «current requirement» parsing
 	// the requirement file
@@ -147,27 +508,37 @@ void ModelSngReqMatrix::addExpectedCompositeRequirement(const QString& location,
 		AnalysisError e(AnalysisError::ERROR,
 		                AnalysisError::PARSING,
 		                location,
-		                QObject::trUtf8("Tentative de définition de composition d'une exigence indéfinie (exigence composante %1)").arg(p_r.getId()));
+		                AnalysisError::COMPOSITION_OF_UNDEFINED,
+		                p_r.getId(),
+		                p_part);
 
-		ModelSngAnalysisErrors::instance().addError(e);
+		__addMergeError(location, e);
 		return;
 	}
 
 	// First, if the requirement isn't in the global matrix, just add it. In case it is already
 	// present, we don't have more information to add
 	QString req_id = p_r.getId();
-	if (!__reqsByName.contains(req_id)) __reqsByName.insert(req_id, p_r);
+	if (!__reqsByName.contains(req_id)) __reqsByName.insert(req_id, __reqArena->create(p_r));
 
 	// Second, create the link between the parent and this new requirement
-	__reqsByName[p_parentId].addComposingRequirement(&(__reqsByName[req_id]));
-	__reqsByName[req_id].setParent(&(__reqsByName[p_parentId]));
+	__reqsByName[p_parentId]->addComposingRequirement(__reqsByName[req_id]);
+	__reqsByName[req_id]->setParent(__reqsByName[p_parentId]);
+	__reqsByName[req_id]->addCompositeRequirement(__reqsByName[p_parentId]);
+
+	__nbReferencesByReqId[req_id]++;
+	__touchedReqs.insert(__reqsByName[p_parentId]);
+	__touchedReqs.insert(__reqsByName[req_id]);
 }
 
 void ModelSngReqMatrix::addExpectedCoveredRequirement(const QString& location,
                                                       const QString& p_reqId,
-                                                      RequirementRef p_coveredReq)
+                                                      RequirementRef p_coveredReq,
+                                                      int p_runId,
+                                                      const QString& p_part)
 {
 	QMutexLocker l_rbn(&__reqsByNameMutex) ; // avoid simultaneous access
+	if (p_runId != getRunId()) return;  // result of a cancelled run
 
 	// The method has been called while there is no consistent «current requirement» parsing
 	// the requirement file
@@ -176,155 +547,371 @@ void ModelSngReqMatrix::addExpectedCoveredRequirement(const QString& location,
 		AnalysisError e(AnalysisError::ERROR,
 		                AnalysisError::PARSING,
 		                location,
-		                QObject::trUtf8("Tentative de définition de couverture d'une exigence indéfinie (exigence couverte : %1)").arg(p_coveredReq.getId()));
+		                AnalysisError::COVERAGE_OF_UNDEFINED,
+		                p_coveredReq.getId(),
+		                p_part);
 
-		ModelSngAnalysisErrors::instance().addError(e);
+		__addMergeError(location, e);
 		return;
 	}
 
 	// First, if the covered requirement ins't in the global matrix, just add it. In case it is already
 	// present, we don't have more information to add
 	QString covered_req_id = p_coveredReq.getId();
-	if (!__reqsByName.contains(covered_req_id)) __reqsByName.insert(covered_req_id, p_coveredReq);
+	if (!__reqsByName.contains(covered_req_id)) __reqsByName.insert(covered_req_id, __reqArena->create(p_coveredReq));
 
 	// If the currently covered requirement is already covered ... there is an error ...
-	if (__reqsByName[covered_req_id].isCovered())
+	if (__reqsByName[covered_req_id]->isCovered())
 	{
 		AnalysisError e(AnalysisError::ERROR,
 		                AnalysisError::CONSISTENCY,
 		                location,
-		                QObject::trUtf8("Couverture multiple : %1 déjà couverte par %2 et tentative de recouverture par %3").arg(covered_req_id).arg(__reqsByName[covered_req_id].getDownstreamRequirement()->getId()).arg(p_reqId));
-
-		ModelSngAnalysisErrors::instance().addError(e);
+		                AnalysisError::MULTIPLE_COVERAGE,
+		                covered_req_id,
+		                __reqsByName[covered_req_id]->getDownstreamRequirement()->getId(),
+		                p_reqId,
+		                p_part);
+
+		__addMergeError(__reqsByName[p_reqId]->getLocationId(), e);
+		__conflictingReqIds.insert(covered_req_id);
 	}
 	else
 	{
 		// else, we just have to set this requirement as covered by the current one
-		__reqsByName[covered_req_id].setDownstreamRequirement(&(__reqsByName[p_reqId]));
+		__reqsByName[covered_req_id]->setDownstreamRequirement(__reqsByName[p_reqId]);
 
 		// And the current requirement covers the covered requirement \o/ (so obvious ...)
-		__reqsByName[p_reqId].addUpstreamRequirement(&(__reqsByName[covered_req_id]));
+		__reqsByName[p_reqId]->addUpstreamRequirement(__reqsByName[covered_req_id]);
+
+		__nbReferencesByReqId[covered_req_id]++;
+		__touchedReqs.insert(__reqsByName[p_reqId]);
+		__touchedReqs.insert(__reqsByName[covered_req_id]);
 	}
 
 }
 
-void ModelSngReqMatrix::computeCoverage()
+bool ModelSngReqMatrix::computeCoverage(const QAtomicInt* p_isCancelled)
 {
-	qDebug() << "ModelSngReqMatrix::computeCoverage : consistency check" ;
-	QMap<QString, Requirement>::iterator it;
+	AnalysisTraceScope ts("compute_coverage", AnalysisTracer::CATEGORY_COVERAGE);
+	__nbCoverageStepsDone.store(0);
+	__nbCoverageSteps.store(0);
+
+	// Requirements whose consistency and coverage must be computed, files whose links and coverage must be updated
+	QVector<RequirementPtr> reqs;
+	QList<RequirementFileAbstractPtr> files;
+	if (__isCoverageComputed)
+	{
+		AnalysisTraceScope tsDirty("dirty_propagation", AnalysisTracer::CATEGORY_COVERAGE);
+		reqs = __getDirtyRequirements();
 
-	// First of all, compute consistency for all requirements
-	for (it = __reqsByName.begin(); it != __reqsByName.end() ; ++it)
+		// The links of a requirement involve the files of its downstream and upstream requirements
+		QSet<QString> fileIds = __updatedFileIds;
+		foreach(RequirementPtr r, reqs)
+		{
+			fileIds.insert(r->getLocationId());
+			if (r->getDownstreamRequirement()) fileIds.insert(r->getDownstreamRequirement()->getLocationId());
+			foreach(RequirementPtr up_req, r->getUpstreamRequirements())
+			{
+				fileIds.insert(up_req->getLocationId());
+			}
+		}
+
+		foreach(QString fileId, fileIds)
+		{
+			RequirementFileAbstractPtr f = __filesByFileId.value(fileId, NULL);
+			if (f) files.append(f);
+		}
+	}
+	else
 	{
-		Requirement& req = it.value();
-		req.computeConsistency() ;
+		reqs.reserve(__reqsByName.count());
+		QMap<QString, Requirement*>::iterator it;
+		for (it = __reqsByName.begin(); it != __reqsByName.end() ; ++it)
+		{
+			reqs.append(it.value());
+		}
+		files = __filesByFileId.values();
 	}
+	qDebug() << "ModelSngReqMatrix::computeCoverage : " << reqs.count() << " exigences et " << files.count() << " fichiers à calculer" ;
+	__nbCoverageSteps.store(reqs.count() + 2 * files.count());
 
-	// Then the upstream and downstream actually read can be updated
-	for (it = __reqsByName.begin(); it != __reqsByName.end() ; ++it)
+	// A cancelled computation leaves the requirements half computed: the matrix must be built again
+	__isCoverageComputed = false;
+
+	// First of all, compute consistency for the requirements (the composing requirements are computed first
+	// by recursive calls)
 	{
-		Requirement& req = it.value();
+		AnalysisTraceScope tsPass("consistency", AnalysisTracer::CATEGORY_COVERAGE);
+		foreach(RequirementPtr r, reqs)
+		{
+			r->invalidate() ;
+		}
+		foreach(RequirementPtr r, reqs)
+		{
+			if (p_isCancelled && p_isCancelled->load()) return (false) ;
 
-		// If the requirement is inconsistent, it must be ignored
-		if (!req.isConsistent()) continue ;
+			r->computeConsistency() ;
+			__nbCoverageStepsDone.fetchAndAddRelaxed(1) ;
+		}
+	}
+
+	// Then the upstream and downstream actually read can be updated
+	{
+		AnalysisTraceScope tsPass("document_links", AnalysisTracer::CATEGORY_COVERAGE);
+		foreach(RequirementFileAbstractPtr f, files)
+		{
+			if (p_isCancelled && p_isCancelled->load()) return (false) ;
 
-		// Otherwize, the requirement can be taken into account
-		QString req_id = req.getId();
-		RequirementFileAbstractPtr reqFile = req.getLocation();
+			__computeDocumentLinks(f) ;
+			__nbCoverageStepsDone.fetchAndAddRelaxed(1) ;
+		}
+	}
 
-		// If any, downstream document can also be added
-		RequirementPtr dw_req = req.getDownstreamRequirement();
-		if (dw_req)
+	// Finally, the coverage for each file can be calculated
+	{
+		AnalysisTraceScope tsPass("file_coverage", AnalysisTracer::CATEGORY_COVERAGE);
+		foreach(RequirementFileAbstractPtr f, files)
 		{
-			RequirementFileAbstractPtr dw_reqFile = dw_req->getLocation();
-			if (dw_reqFile)
-			{
-				reqFile->addDownstreamDocument(dw_reqFile->getFileId(), dw_reqFile);
-				dw_reqFile->addUpstreamDocument(reqFile->getFileId(), reqFile);
+			qDebug() << "ModelSngReqMatrix::computeCoverage : Computing coverage for " << f->getFileId() ;
+			f->computeCoverage() ;
+			__nbCoverageStepsDone.fetchAndAddRelaxed(1) ;
+		}
+	}
 
-				// It is moreover possible to check consistency of the configuration
-				// (important for reporting phase)
-				if (!reqFile->mustHaveDownstreamDocuments())
-				{
-					// The file actually has downstream doc but its configuration says it shouldn't
-					AnalysisError e(AnalysisError::WARNING,
-					                AnalysisError::CONSISTENCY,
-					                req.getExpectedBy(),
-					                QObject::trUtf8("Incohérence de paramétrage, %1 doit avoir des documents avals (downstream) mais sa configuration ne le mentionne pas").arg(reqFile->getFileId()));
+	__touchedReqs.clear();
+	__updatedFileIds.clear();
+	__isCoverageComputed = true;
 
-					ModelSngAnalysisErrors::instance().addError(e);
-				}
+	return (true);
+}
 
-				if (!dw_reqFile->mustHaveUpstreamDocuments())
-				{
-					// The file actually has upstream doc but its configuration says it shouldn't
-					AnalysisError e(AnalysisError::WARNING,
-					                AnalysisError::CONSISTENCY,
-					                req.getExpectedBy(),
-					                QObject::trUtf8("Incohérence de paramétrage, %1 doit avoir des documents amonts (upstream) mais sa configuration ne le mentionne pas").arg(dw_reqFile->getFileId()));
+double ModelSngReqMatrix::getCoverageProgress() const
+{
+	int nbSteps = __nbCoverageSteps.load();
+	if (nbSteps <= 0) return (0.0);
 
-					ModelSngAnalysisErrors::instance().addError(e);
-				}
-			}
+	return (qMin(1.0, double(__nbCoverageStepsDone.load()) / nbSteps));
+}
+
+QSharedPointer<const ModelSngReqMatrix::results_t> ModelSngReqMatrix::createResults() const
+{
+	AnalysisTraceScope ts("results", AnalysisTracer::CATEGORY_COVERAGE);
+	results_t* results = new results_t;
+
+	// The errors are gathered from the matrix and grouped here, the number of errors of each file comes with them
+	results->errors = ModelSngAnalysisErrors::groupErrors(__collectErrors());
+
+	results->rows.reserve(__filesByFileId.count());
+	QMap<QString, RequirementFileAbstractPtr>::const_iterator file_it;
+	for (file_it = __filesByFileId.constBegin(); file_it != __filesByFileId.constEnd() ; ++file_it)
+	{
+		fileRow_t row;
+		row.fileId = file_it.key();
+		row.nbRequirements = __reqsByFileId.value(file_it.key()).count();
+		row.nbErrors = results->errors.store.getNbErrorsOfLocation(file_it.key());
+		row.isCoverageComputed = __isCoverageComputed;
+		row.coverage = file_it.value()->getCoverage();
+		results->rows.append(row);
+	}
+
+	return (QSharedPointer<const results_t>(results));
+}
+
+void ModelSngReqMatrix::publishCoverage(QSharedPointer<const results_t> p_results)
+{
+	ModelSngAnalysisErrors::instance().setErrors(p_results->errors);
+
+	// The rows of every file replace the ones merged, displayed or not
+	{
+		QMutexLocker l_mr(&__mergedRowsMutex) ;
+		__mergedRows.clear();
+	}
+
+	beginResetModel();
+	__rows = p_results->rows;
+	endResetModel();
+}
+
+QVector<RequirementPtr> ModelSngReqMatrix::__getDirtyRequirements() const
+{
+	QSet<RequirementPtr> dirty;
+	QVector<RequirementPtr> toVisit = __touchedReqs.toList().toVector();
+	while (!toVisit.isEmpty())
+	{
+		RequirementPtr r = toVisit.takeLast();
+		if (dirty.contains(r)) continue;
+
+		dirty.insert(r);
+		toVisit += r->getCompositeRequirements();
+		toVisit += r->getUpstreamRequirements();
+	}
+
+	return (dirty.toList().toVector());
+}
+
+void ModelSngReqMatrix::__computeDocumentLinks(RequirementFileAbstractPtr reqFile)
+{
+	QString fileId = reqFile->getFileId();
+
+	foreach(RequirementFileAbstractPtr linked, reqFile->getUpstreamDocuments().values() + reqFile->getDownstreamDocuments().values())
+	{
+		linked->removeLinkedDocument(fileId);
+	}
+	reqFile->clearLinkedDocuments();
+	__removeLinkErrors(fileId);
+
+	// The links between requirements are first counted by linked document: a link needs one of its requirements
+	// to be consistent. The upstream requirement of a link is kept as an example for the warnings
+	QMap<QString, documentLink_t> downstreamLinks;
+	QMap<QString, documentLink_t> upstreamLinks;
+	foreach(RequirementPtr req, __reqsByFileId.value(fileId))
+	{
+		RequirementPtr dw_req = req->getDownstreamRequirement();
+		if (dw_req && dw_req->getLocation() && (req->isConsistent() || dw_req->isConsistent()))
+		{
+			documentLink_t& l = downstreamLinks[dw_req->getLocation()->getFileId()];
+			if (l.nbLinks == 0 || req->getId() < l.exampleReqId) l.exampleReqId = req->getId();
+			l.file = dw_req->getLocation();
+			l.nbLinks++;
 		}
 
 		// With the same logic, if the current requirement is covering other requirements (ie upstream
 		// requirements), it means that the documents containing those requirements are upstream documents
 		// for the current one
-		foreach (RequirementPtr up_req, req.getUpstreamRequirements())
+		foreach (RequirementPtr up_req, req->getUpstreamRequirements())
 		{
-			RequirementFileAbstractPtr up_reqFile = up_req->getLocation();
-			if (up_reqFile)
+			if (up_req->getLocation() && (req->isConsistent() || up_req->isConsistent()))
 			{
-				reqFile->addUpstreamDocument(up_reqFile->getFileId(), up_reqFile);
-				up_reqFile->addDownstreamDocument(reqFile->getFileId(), reqFile);
+				documentLink_t& l = upstreamLinks[up_req->getLocation()->getFileId()];
+				if (l.nbLinks == 0 || up_req->getId() < l.exampleReqId) l.exampleReqId = up_req->getId();
+				l.file = up_req->getLocation();
+				l.nbLinks++;
+			}
+		}
 
-				// It is moreover possible to check consistency of the configuration
-				// (important for reporting phase)
-				if (!up_reqFile->mustHaveDownstreamDocuments())
-				{
-					// The file actually has downstream doc but its configuration says it shouldn't
-					AnalysisError e(AnalysisError::WARNING,
-					                AnalysisError::CONSISTENCY,
-					                req.getExpectedBy(),
-					                QObject::trUtf8("Incohérence de paramétrage, %1 doit avoir des documents avals (downstream) mais sa configuration ne le mentionne pas").arg(up_reqFile->getFileId()));
+		// TODO WTF with the composite requirements ? maybe create another section called «Related Documents»
+	}
 
-					ModelSngAnalysisErrors::instance().addError(e);
-				}
+	// Then the documents are linked once, and their configuration checked once by pair of documents
+	QMap<QString, documentLink_t>::const_iterator it;
+	for (it = downstreamLinks.constBegin(); it != downstreamLinks.constEnd() ; ++it)
+	{
+		reqFile->addDownstreamDocument(it.key(), it->file);
+		it->file->addUpstreamDocument(fileId, reqFile);
+		__checkDocumentLink(reqFile, it->file, it.value());
+	}
 
-				if (!reqFile->mustHaveUpstreamDocuments())
-				{
-					// The file actually has upstream doc but its configuration says it shouldn't
-					AnalysisError e(AnalysisError::WARNING,
-					                AnalysisError::CONSISTENCY,
-					                req.getExpectedBy(),
-					                QObject::trUtf8("Incohérence de paramétrage, %1 doit avoir des documents amonts (upstream) mais sa configuration ne le mentionne pas").arg(reqFile->getFileId()));
+	for (it = upstreamLinks.constBegin(); it != upstreamLinks.constEnd() ; ++it)
+	{
+		reqFile->addUpstreamDocument(it.key(), it->file);
+		it->file->addDownstreamDocument(fileId, reqFile);
+		__checkDocumentLink(it->file, reqFile, it.value());
+	}
+}
 
-					ModelSngAnalysisErrors::instance().addError(e);
-				}
-			}
+void ModelSngReqMatrix::__checkDocumentLink(RequirementFileAbstractPtr p_upFile, RequirementFileAbstractPtr p_downFile,
+                                            const documentLink_t& p_link)
+{
+	QString upId = p_upFile->getFileId();
+	QString downId = p_downFile->getFileId();
+
+	// It is important for the reporting phase that the configuration is consistent with the actual links
+	bool isDownstreamConfigured = p_upFile->mustHaveDownstreamDocuments();
+	bool isUpstreamConfigured = p_downFile->mustHaveUpstreamDocuments();
+	if (isDownstreamConfigured && isUpstreamConfigured) return;
+
+	AnalysisError::code_t code = AnalysisError::STREAMS_NOT_CONFIGURED;
+	if (isDownstreamConfigured) code = AnalysisError::UPSTREAM_NOT_CONFIGURED;
+	if (isUpstreamConfigured) code = AnalysisError::DOWNSTREAM_NOT_CONFIGURED;
+
+	// The same pair is found from both documents, with the same links : it is simply replaced
+	AnalysisError e(AnalysisError::WARNING,
+	                AnalysisError::CONSISTENCY,
+	                isDownstreamConfigured ? downId : upId,
+	                code,
+	                QString::number(p_link.nbLinks),
+	                upId,
+	                downId,
+	                p_link.exampleReqId);
+
+	__linkErrorsByFilePair.insert(qMakePair(upId, downId), e);
+}
+
+void ModelSngReqMatrix::__removeLinkErrors(const QString& p_fileId)
+{
+	QMap<QPair<QString, QString>, AnalysisError>::iterator it = __linkErrorsByFilePair.begin();
+	while (it != __linkErrorsByFilePair.end())
+	{
+		if (it.key().first == p_fileId || it.key().second == p_fileId)
+		{
+			it = __linkErrorsByFilePair.erase(it);
 		}
+		else
+		{
+			++it;
+		}
+	}
+}
 
-		// TODO WTF with the composite requirements ? maybe create another section called «Related Documents»
+QVector<AnalysisError> ModelSngReqMatrix::__collectErrors() const
+{
+	QVector<AnalysisError> errors;
+
+	QMap<QString, RequirementFileAbstractPtr>::const_iterator file_it;
+	for (file_it = __filesByFileId.constBegin(); file_it != __filesByFileId.constEnd() ; ++file_it)
+	{
+		errors += file_it.value()->getParsingErrors();
 	}
 
-	// Finally, the coverage for each file can be calculated
-	QMap<QString, RequirementFileAbstractPtr>::iterator file_it ;
-	for (file_it = __filesByFileId.begin(); file_it != __filesByFileId.end() ; ++file_it)
+	QHash<QString, QVector<AnalysisError>>::const_iterator err_it;
+	for (err_it = __mergeErrorsByFileId.constBegin(); err_it != __mergeErrorsByFileId.constEnd() ; ++err_it)
 	{
-		qDebug() << "ModelSngReqMatrix::computeCoverage : Computing coverage for " << file_it.key() ;
-		file_it.value()->computeCoverage() ;
+		errors += err_it.value();
 	}
 
-	// Data has been updated, the view can be freshened
-	QModelIndex topLeft = index(0, 0);
-	QModelIndex bottomRight = index(rowCount() - 1, columnCount() - 1);
+	QMap<QString, Requirement*>::const_iterator req_it;
+	for (req_it = __reqsByName.constBegin(); req_it != __reqsByName.constEnd() ; ++req_it)
+	{
+		if (!req_it.value()->getErrors().isEmpty()) errors += req_it.value()->getErrors();
+	}
 
-	emit dataChanged(topLeft, bottomRight);
-	emit layoutChanged();
+	QMap<QPair<QString, QString>, AnalysisError>::const_iterator link_it;
+	for (link_it = __linkErrorsByFilePair.constBegin(); link_it != __linkErrorsByFilePair.constEnd() ; ++link_it)
+	{
+		errors.append(link_it.value());
+	}
 
-	// same for error matrix
-	ModelSngAnalysisErrors::instance().refresh();
+	return (errors);
+}
+
+void ModelSngReqMatrix::publishMergedFiles()
+{
+	QVector<fileRow_t> mergedRows;
+	{
+		QMutexLocker l_mr(&__mergedRowsMutex) ;
+		mergedRows.swap(__mergedRows);
+	}
+
+	foreach(const fileRow_t& row, mergedRows)
+	{
+		// The file may have been removed by a configuration change since its merge
+		if (!__filesByFileId.contains(row.fileId)) continue;
+
+		QVector<fileRow_t>::iterator it = std::lower_bound(__rows.begin(), __rows.end(), row.fileId,
+		                                                   [](const fileRow_t& r, const QString& id) { return (r.fileId < id); });
+		int pos = it - __rows.begin();
+		if (it != __rows.end() && it->fileId == row.fileId)
+		{
+			*it = row;
+			emit dataChanged(index(pos, 0), index(pos, columnCount() - 1));
+		}
+		else
+		{
+			beginInsertRows(QModelIndex(), pos, pos);
+			__rows.insert(pos, row);
+			endInsertRows();
+		}
+	}
 }
 
 int ModelSngReqMatrix::columnCount(const QModelIndex & /*parent*/) const
@@ -334,7 +921,7 @@ int ModelSngReqMatrix::columnCount(const QModelIndex & /*parent*/) const
 
 int ModelSngReqMatrix::rowCount(const QModelIndex & /*parent*/) const
 {
-	return (__filesByFileId.count());
+	return (__rows.count());
 }
 
 QVariant ModelSngReqMatrix::data(const QModelIndex &index, int role) const
@@ -345,22 +932,22 @@ QVariant ModelSngReqMatrix::data(const QModelIndex &index, int role) const
 	if (role == Qt::DisplayRole)
 	{
 		retVal = QObject::trUtf8("ERREUR DATA");
-		RequirementFileAbstractPtr f = __filesByFileId.values().at(index.row());
+		const fileRow_t& row = __rows.at(index.row());
+		RequirementFileAbstractPtr f = __filesByFileId.value(row.fileId, NULL);
 		if (!f) return (retVal);
 
-		QString file_id = f->getFileId();
 		switch (index.column())
 		{
 			case FILECOVERAGE_COL_ID:
-				retVal = file_id;
+				retVal = row.fileId;
 				break;
 
 			case FILECOVERAGE_COL_NBREQ:
-				retVal = __reqsByFileId[file_id].count();
+				retVal = row.nbRequirements;
 				break;
 
 			case FILECOVERAGE_COL_HASDWN:
-				if (__filesByFileId[file_id]->mustHaveDownstreamDocuments())
+				if (f->mustHaveDownstreamDocuments())
 				{
 					retVal = QObject::trUtf8("Oui");
 				}
@@ -371,9 +958,13 @@ QVariant ModelSngReqMatrix::data(const QModelIndex &index, int role) const
 				break;
 
 			case FILECOVERAGE_COL_COVERAGE:
-				if (__filesByFileId[file_id]->mustHaveDownstreamDocuments())
+				if (!row.isCoverageComputed)
 				{
-					retVal = QString("%1 %").arg(__filesByFileId[file_id]->getCoverage() * 100);
+					retVal = QObject::trUtf8("En cours");
+				}
+				else if (f->mustHaveDownstreamDocuments())
+				{
+					retVal = QString("%1 %").arg(row.coverage * 100);
 				}
 				else
 				{
@@ -382,11 +973,11 @@ QVariant ModelSngReqMatrix::data(const QModelIndex &index, int role) const
 				break;
 
 			case FILECOVERAGE_COL_NBERR:
-				retVal = ModelSngAnalysisErrors::instance().getNberrorsInAFile(file_id);
+				retVal = row.nbErrors;
 				break;
 
 			case FILECOVERAGE_COL_FILEPATH:
-				retVal = __filesByFileId[file_id]->getFilePath();
+				retVal = f->getFilePath();
 				break;
 
 			default:
@@ -424,6 +1015,72 @@ QModelIndex ModelSngReqMatrix::parent(const QModelIndex & /*index*/) const
 	return (QModelIndex());
 }
 
+AnalysisSnapshotPtr ModelSngReqMatrix::createSnapshot()
+{
+	AnalysisTraceScope ts("snapshot", AnalysisTracer::CATEGORY_COVERAGE);
+	AnalysisSnapshot* snapshot = new AnalysisSnapshot(getRunId());
+
+	QMap<QString, Requirement*>::iterator it;
+	for (it = __reqsByName.begin(); it != __reqsByName.end() ; ++it)
+	{
+		Requirement& req = *it.value();
+
+		AnalysisSnapshot::requirement_t r;
+		r.id = req.getId();
+		r.fileId = req.getLocationId();
+		r.expectedBy = req.getExpectedBy();
+		r.isConsistent = req.isConsistent();
+		r.mustBeCovered = req.mustBeCovered();
+		r.coverage = req.getCoverage();
+		if (req.getDownstreamRequirement()) r.downstreamId = req.getDownstreamRequirement()->getId();
+		foreach(RequirementPtr p, req.getUpstreamRequirements())
+		{
+			r.upstreamIds.append(p->getId());
+		}
+		foreach(RequirementPtr p, req.getComposingRequirements())
+		{
+			r.composingIds.append(p->getId());
+		}
+		foreach(RequirementPtr p, req.getCompositeRequirements())
+		{
+			r.compositeIds.append(p->getId());
+		}
+
+		snapshot->addRequirement(r);
+	}
+
+	// The errors are gathered from the matrix, ModelSngAnalysisErrors being only filled by the main thread
+	QVector<AnalysisError> errors = __collectErrors();
+	QHash<QString, int> nbErrorsByLocation;
+	foreach(const AnalysisError& e, errors)
+	{
+		nbErrorsByLocation[e.getLocation()]++;
+	}
+
+	QMap<QString, RequirementFileAbstractPtr>::const_iterator file_it;
+	for (file_it = __filesByFileId.constBegin(); file_it != __filesByFileId.constEnd() ; ++file_it)
+	{
+		RequirementFileAbstractPtr p = file_it.value();
+
+		AnalysisSnapshot::file_t f;
+		f.id = p->getFileId();
+		f.path = p->getFilePath();
+		f.nbRequirements = __reqsByFileId.value(f.id).count();
+		f.nbErrors = nbErrorsByLocation.value(f.id);
+		f.mustHaveDownstreamDocuments = p->mustHaveDownstreamDocuments();
+		f.coverage = p->getCoverage();
+		f.upstreamDocuments = p->getUpstreamDocuments().keys();
+		f.downstreamDocuments = p->getDownstreamDocuments().keys();
+
+		snapshot->addFile(f);
+	}
+
+	snapshot->addErrors(errors);
+	snapshot->buildImpactIndex();
+	snapshot->buildSearchIndex();
+	return (AnalysisSnapshotPtr(snapshot));
+}
+
 RequirementFileAbstractPtr ModelSngReqMatrix::getRequirementFile(const QString& p_fileID) const
 {
 	if (__filesByFileId.contains(p_fileID))
@@ -436,6 +1093,14 @@ RequirementFileAbstractPtr ModelSngReqMatrix::getRequirementFile(const QString&
 	}
 }
 
+RequirementPtr ModelSngReqMatrix::getRequirement(const QString& p_id)
+{
+	QMap<QString, Requirement*>::iterator it = __reqsByName.find(p_id);
+	if (it == __reqsByName.end()) return (NULL);
+
+	return (it.value());
+}
+
 const QString ModelSngReqMatrix::getReportFileSummaryTable(const QString& p_writer,
                                                            const QString& p_delimiter) const
 {
@@ -5,25 +5,203 @@
  * \author f.souliers
  */
 
+#include <QAtomicInt>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QFileDialog>
 #include <QItemSelectionModel>
-#include <QTextStream>
 #include <QDateTime>
+#include <QEventLoop>
 #include <QMessageBox>
 #include <QMutexLocker>
+#include <QRunnable>
 #include <QThread>
+#include <QThreadPool>
 
 #include "Rekkix.h"
 #include "ModelSngReqMatrix.h"
 #include "ModelSngAnalysisErrors.h"
 #include "ModelConfiguration.h"
 #include "FactoryRequirementFile.h"
-#include "FactoryReportBaseString.h"
+#include "RequirementFile_tree.h"
+#include "FactoryReport.h"
 #include "AnalysisSngWaiterThread.h"
 #include "AnalysisSngStarterThread.h"
+#include "AnalysisSngProgress.h"
+#include "AnalysisSngScheduler.h"
+#include "AnalysisSngTextCache.h"
+#include "AnalysisTracer.h"
 #include "UiSettings.h"
 
+static const int PROGRESS_REFRESH_PERIOD_MS = 100;  //!< Period of the refresh of the progress during the parsing
+static const int RESULTS_FRAME_PERIOD_MS = 40;  //!< Period of the display of the merged files during the parsing (25 frames per second)
+static const int PROGRESS_PARSING_MIN = 1;  //!< Value of the progress bar at the beginning of the parsing
+static const int PROGRESS_PARSING_MAX = 85;  //!< Value of the progress bar once every file has been parsed (the coverage computation remains)
+static const int MAX_DISPLAYED_SEARCH_RESULTS = 1000;  //!< The search results are limited so that typing stays fluid
+
+/*!
+ * \class DocumentExtractionTask
+ * \brief Extracts the text of a document into AnalysisSngTextCache (see Rekkix::__extractDocuments)
+ */
+class DocumentExtractionTask : public QRunnable
+{
+public:
+	DocumentExtractionTask(RequirementFileAbstractPtr p_file, QAtomicInt* p_nbExtracted)
+		: QRunnable(), __file(p_file), __nbExtracted(p_nbExtracted)
+	{
+		setAutoDelete(true);
+	}
+
+	~DocumentExtractionTask()
+	{
+		delete (__file);
+	}
+
+	void run()
+	{
+		// The errors are recorded again by the analysis of the configuration, which extracts the document again
+		QStringList units;
+		__file->loadTextUnits(units);
+		__nbExtracted->fetchAndAddRelaxed(1);
+	}
+
+private:
+	RequirementFileAbstractPtr __file;  //!< Parser of the document, only used for the extraction
+	QAtomicInt* __nbExtracted;  //!< Number of documents extracted, owned by the caller
+};
+
+/*!
+ * \class RequirementFilesMergeTask
+ * \brief Merges again the files kept by a watch-mode update when the matrix is built again (see
+ *        Rekkix::slt_watchedDocumentsChanged)
+ *
+ * The files changed are parsed and merged meanwhile, which is safe (see ModelSngReqMatrix::mergeRequirementFile). The
+ * coverage is computed by the same worker, so only once every kept file has been merged.
+ */
+class RequirementFilesMergeTask : public QRunnable
+{
+public:
+	RequirementFilesMergeTask(const QVector<RequirementFileAbstractPtr>& p_files, const QAtomicInt* p_isCancelled)
+		: QRunnable(), __files(p_files), __isCancelled(p_isCancelled)
+	{
+		setAutoDelete(true);
+	}
+
+	void run()
+	{
+		AnalysisTraceScope ts("merge_kept_files", AnalysisTracer::CATEGORY_COVERAGE);
+		foreach(RequirementFileAbstractPtr p, __files)
+		{
+			// A cancelled update is followed by a new one, which builds the matrix again
+			if (__isCancelled->load()) return;
+
+			ModelSngReqMatrix::instance().mergeRequirementFile(p);
+		}
+	}
+
+private:
+	QVector<RequirementFileAbstractPtr> __files;  //!< Files to be merged again, owned by the matrix
+	const QAtomicInt* __isCancelled;  //!< Set by the main thread to stop the merge, owned by the caller
+};
+
+/*!
+ * \class CoverageComputationTask
+ * \brief Computes the coverage once every file has been merged, then hands the results over to the main thread
+ *        (see Rekkix::slt_reqFileParsingAllFilesFinished)
+ *
+ * Nothing modifies the matrix meanwhile: the analyses are started from the main thread, which cancels the task first.
+ */
+class CoverageComputationTask : public QRunnable
+{
+public:
+	CoverageComputationTask(QObject* p_receiver, int p_runId, bool p_isSnapshotNeeded, const QAtomicInt* p_isCancelled)
+		: QRunnable(), __receiver(p_receiver), __runId(p_runId), __isSnapshotNeeded(p_isSnapshotNeeded), __isCancelled(p_isCancelled)
+	{
+		setAutoDelete(true);
+	}
+
+	void run()
+	{
+		if (!ModelSngReqMatrix::instance().computeCoverage(__isCancelled)) return;
+		if (__isCancelled->load()) return;
+
+		// The errors and the rows of the files are grouped here, the main thread only displays them
+		MatrixResultsPtr results = ModelSngReqMatrix::instance().createResults();
+
+		// The snapshot is the only result read by the GUI outside of the models, it is built here too
+		AnalysisSnapshotPtr snapshot;
+		if (__isSnapshotNeeded) snapshot = ModelSngReqMatrix::instance().createSnapshot();
+
+		QMetaObject::invokeMethod(__receiver, "slt_coverageComputed", Qt::QueuedConnection,
+		                          Q_ARG(int, __runId), Q_ARG(MatrixResultsPtr, results),
+		                          Q_ARG(AnalysisSnapshotPtr, snapshot));
+	}
+
+private:
+	QObject* __receiver;  //!< Object whose slot slt_coverageComputed is called once done
+	int __runId;  //!< Analysis run whose coverage is computed
+	bool __isSnapshotNeeded;  //!< Must the snapshot of the results be built
+	const QAtomicInt* __isCancelled;  //!< Set by the main thread to stop the computation, owned by the caller
+};
+
+/*!
+ * \class ReportGenerationTask
+ * \brief Writes the configured reports, one after the other (see Rekkix::slt_generateReports)
+ *
+ * The reports are written from the matrix and ModelSngAnalysisErrors, which are not modified until the task is
+ * cancelled and finished (see Rekkix::__stopBackgroundWork).
+ */
+class ReportGenerationTask : public QRunnable
+{
+public:
+	ReportGenerationTask(QObject* p_receiver, const ModelConfiguration::OutputFiles_t& p_outputs, const QDateTime& p_timestamp,
+	                     QAtomicInt* p_nbGenerated, const QAtomicInt* p_isCancelled)
+		: QRunnable(), __receiver(p_receiver), __outputs(p_outputs), __timestamp(p_timestamp), __nbGenerated(p_nbGenerated),
+		  __isCancelled(p_isCancelled)
+	{
+		setAutoDelete(true);
+	}
+
+	void run()
+	{
+		bool isComplete = true;
+		foreach(ModelConfiguration::CnfFileAttributesMap_t outFileDescription, __outputs)
+		{
+			if (__isCancelled->load())
+			{
+				isComplete = false;
+				break;
+			}
+
+			QString errMsg;
+			if (!FactoryReport::writeReport(outFileDescription, __timestamp, errMsg)) __errors.append(errMsg);
+			__nbGenerated->fetchAndAddRelaxed(1);
+		}
+
+		if (__receiver)
+		{
+			QMetaObject::invokeMethod(__receiver, "slt_reportsGenerated", Qt::QueuedConnection, Q_ARG(bool, isComplete),
+			                          Q_ARG(QStringList, __errors));
+		}
+	}
+
+	/*!
+	 * \brief Reasons of the failures of the reports not written, once the task has run
+	 */
+	const QStringList& getErrors() const
+	{
+		return (__errors);
+	}
+
+private:
+	QObject* __receiver;  //!< Object whose slot slt_reportsGenerated is called once done, NULL if none
+	ModelConfiguration::OutputFiles_t __outputs;  //!< Reports to be written
+	QDateTime __timestamp;  //!< Date of the reports
+	QAtomicInt* __nbGenerated;  //!< Number of reports written, owned by the caller
+	const QAtomicInt* __isCancelled;  //!< Set by the main thread to stop the generation, owned by the caller
+	QStringList __errors;  //!< Reasons of the failures of the reports not written
+};
+
 // Constructor #1
 Rekkix::Rekkix(QApplication * parent, bool setupUI)
 		: QMainWindow(NULL, Qt::Window)
@@ -34,6 +212,7 @@ Rekkix::Rekkix(QApplication * parent, bool setupUI)
 
 	// Load the application settings
 	SngSettings::instance() ;
+	AnalysisSngTextCache::instance().setPersistent(SngSettings::instance().isTextCacheEnabled(), SngSettings::instance().getTextCacheMaxSize()) ;
 
 	// If needed prepare GUI
 	if (setupUI)
@@ -53,21 +232,59 @@ Rekkix::Rekkix(QApplication * parent, bool setupUI)
 		this->tv_downstreamCoverage->setModel(&__downstreamCoverageModel);
 		this->tv_compositeReqs->setModel(&__compositeRequirementsModel);
 		this->tv_definedReqs->setModel(&__requirementsModel);
+		this->tv_impactedReqs->setModel(&__impactedRequirementsModel);
+		this->tv_foundReqs->setModel(&__foundRequirementsModel);
 		this->tv_errors->setModel(&ModelSngAnalysisErrors::instance());
 	}
 
 	// Common initialization
 	__isBatchMode = false ;
 	__nbFiles = -1 ;
+	__nbParsedFiles = 0 ;
+	__isAnalysisRunning = false ;
+	__hasAnalysisResults = false ;
+	__queryServer = NULL ;
+	__isComputingCoverage = false ;
+	__isGeneratingReports = false ;
+	__nbReports = 0 ;
+
+	// The coverage and the reports are handled one after the other
+	qRegisterMetaType<AnalysisSnapshotPtr>("AnalysisSnapshotPtr") ;
+	qRegisterMetaType<MatrixResultsPtr>("MatrixResultsPtr") ;
+	__backgroundPool.setMaxThreadCount(1) ;
+
+	QObject::connect(&__watcher, SIGNAL(documentsChanged(QStringList)), this, SLOT(slt_watchedDocumentsChanged(QStringList))) ;
+	QObject::connect(&__watcher, SIGNAL(configurationChanged()), this, SLOT(slt_watchedConfigurationChanged())) ;
+
+	__progressTimer.setInterval(PROGRESS_REFRESH_PERIOD_MS) ;
+	QObject::connect(&__progressTimer, SIGNAL(timeout()), this, SLOT(slt_refreshProgress())) ;
+
+	__resultsFrameTimer.setInterval(RESULTS_FRAME_PERIOD_MS) ;
+	QObject::connect(&__resultsFrameTimer, SIGNAL(timeout()), this, SLOT(slt_publishMergedFiles())) ;
+
+	// Connected once for all the analyses (the waiter is a singleton)
+	QObject::connect(&AnalysisSngWaiterThread::instance(), SIGNAL(allRegisteredTerminated(int)), this, SLOT(slt_reqFileParsingAllFilesFinished(int))) ;
 }
 
 Rekkix::~Rekkix()
 {
+	if (__queryServer)
+	{
+		QMetaObject::invokeMethod(__queryServer, "close", Qt::BlockingQueuedConnection) ;
+		__queryServerThread.quit() ;
+		__queryServerThread.wait() ;
+		delete (__queryServer) ;
+	}
+
+	__stopAnalysisThreads() ;
 }
 
 void Rekkix::loadFileAndInitGui(const char* p_filename)
 {
+	__cnfFilePath = p_filename ;
+	__hasAnalysisResults = false ;
 	__cnfModel.setFile(p_filename, __cnfErrorsModel);
+	if (__watcher.isWatching()) __watcher.watch(__cnfFilePath, __cnfModel.getConfiguredRequirementFiles()) ;
 	this->progbar_analysis->setValue(0);
 	this->tv_configuredFiles->resizeColumnsToContents();
 	this->tv_configurationErrors->resizeColumnsToContents();
@@ -82,12 +299,19 @@ void Rekkix::loadFileAndInitGui(const char* p_filename)
 	}
 }
 
-int Rekkix::loadFileAndRunBatch(const char* p_filename)
+int Rekkix::loadFileAndRunBatch(const char* p_filename, const QString& p_traceFilename)
 {
 	// the program is running without GUI
 	__isBatchMode = true ;
 
+	if (!p_traceFilename.isEmpty())
+	{
+		AnalysisTracer::instance().clear();
+		AnalysisTracer::instance().setEnabled(true);
+	}
+
 	fprintf(stdout, "\n%s\n", QObject::trUtf8("Chargement du fichier de configuration : %1").arg(p_filename).toStdString().c_str()) ;
+	__cnfFilePath = p_filename ;
 	__cnfModel.setFile(p_filename, __cnfErrorsModel);
 
 	// Check if the configuration is OK
@@ -115,17 +339,281 @@ int Rekkix::loadFileAndRunBatch(const char* p_filename)
 		fprintf(stdout, "%s\n", QObject::trUtf8("Configuration OK").toStdString().c_str()) ;
 	}
 
-	// Run analysis and generate report
+	// Run analysis and generate report. There is no main event loop in batch mode, so a local one is needed
+	// to receive the signals of the parsing threads until the coverage has been computed
 	fprintf(stdout, "%s\n", QObject::trUtf8("Analyse des documents mentionnés en configuration :").toStdString().c_str()) ;
+	QEventLoop analysisLoop ;
+	QObject::connect(this, SIGNAL(analysisFinished()), &analysisLoop, SLOT(quit())) ;
 	slt_startAnalysis() ;
+	analysisLoop.exec() ;
 
 	fprintf(stdout, "%s\n", QObject::trUtf8("Génération des rapports mentionnés en configuration :").toStdString().c_str()) ;
 	slt_generateReports() ;
 
+	if (!p_traceFilename.isEmpty())
+	{
+		AnalysisTracer::instance().setEnabled(false);
+
+		fprintf(stdout, "%s\n", QObject::trUtf8("Durées d'analyse par fichier :").toStdString().c_str()) ;
+		fprintf(stdout, "%s\n", AnalysisTracer::instance().getFileSummaryTable().toStdString().c_str()) ;
+
+		fprintf(stdout, "%s\n", QObject::trUtf8("Durées prévues et réelles par fichier, dans l'ordre de lancement :").toStdString().c_str()) ;
+		fprintf(stdout, "%s\n", AnalysisSngScheduler::instance().getJobsTable().toStdString().c_str()) ;
+
+		if (AnalysisTracer::instance().exportChromeTrace(p_traceFilename))
+		{
+			fprintf(stdout, "%s\n", QObject::trUtf8("Trace d'exécution écrite dans %1").arg(p_traceFilename).toStdString().c_str()) ;
+		}
+		else
+		{
+			fprintf(stderr, "%s\n", QObject::trUtf8("Impossible d'écrire la trace d'exécution dans %1").arg(p_traceFilename).toStdString().c_str()) ;
+		}
+	}
+
 	// Happy end
 	return(EXIT_SUCCESS) ;
 }
 
+int Rekkix::loadFilesAndRunBatch(const QStringList& p_filenames)
+{
+	__isBatchMode = true ;
+	AnalysisSngTextCache::instance().clear() ;
+	AnalysisSngTextCache::instance().setEnabled(true) ;
+
+	// 1st step : the documents shared by the configurations are extracted once, all together
+	__extractDocuments(p_filenames) ;
+
+	// 2nd step : each configuration is analysed on the extracted text, then its reports are generated. The analyses
+	// are serial, not concurrent: the matrix and the errors are singletons holding one analysis at a time (each
+	// analysis still parses its files with every parsing thread)
+	QStringList failedFilenames ;
+	foreach(QString filename, p_filenames)
+	{
+		if (loadFileAndRunBatch(filename.toStdString().c_str()) != EXIT_SUCCESS) failedFilenames.append(filename) ;
+	}
+
+	fprintf(stdout, "%s\n", QObject::trUtf8("%1 configurations analysées, %2 documents extraits, %3 extractions évitées (dont %4 grâce au cache sur disque)")
+	                        .arg(p_filenames.count()).arg(AnalysisSngTextCache::instance().getNbMisses())
+	                        .arg(AnalysisSngTextCache::instance().getNbHits())
+	                        .arg(AnalysisSngTextCache::instance().getNbPersistentHits()).toStdString().c_str()) ;
+	AnalysisSngTextCache::instance().setEnabled(false) ;
+
+	if (!failedFilenames.isEmpty())
+	{
+		fprintf(stderr, "%s\n", QObject::trUtf8("Configurations non analysées : %1").arg(failedFilenames.join(", ")).toStdString().c_str()) ;
+		return (EXIT_FAILURE) ;
+	}
+
+	return (EXIT_SUCCESS) ;
+}
+
+void Rekkix::__extractDocuments(const QStringList& p_filenames)
+{
+	AnalysisTraceScope ts("extract_documents", AnalysisTracer::CATEGORY_CONFIG);
+
+	// One parser by physical document and format, whatever the configurations referencing it
+	QMap<QString, RequirementFileAbstractPtr> filesByDocument ;
+	foreach(QString filename, p_filenames)
+	{
+		ModelConfiguration cnf ;
+		ModelConfigurationErrors cnfErrors ;
+		cnf.setFile(filename.toStdString().c_str(), cnfErrors) ;
+		if (cnfErrors.hasSignificantError()) continue ;
+
+		ModelConfiguration::CnfFileAttributesMapsByFileId_t files = cnf.getConfiguredRequirementFiles() ;
+		foreach(ModelConfiguration::CnfFileAttributesMap_t attributes, files)
+		{
+			// The text of a tree is not shared (see RequirementFile_tree::getTextUnitsFormat)
+			if (RequirementFile_tree::isTreePath(attributes[ModelConfiguration::REQFILE_ATTR_PATH])) continue ;
+
+			RequirementFileAbstractPtr f = FactoryRequirementFile::getRequirementFile(attributes) ;
+			if (!f) continue ;
+
+			// The documents whose text is not shared, or only partly extracted, are only parsed by the analysis of their configuration
+			if (f->getTextUnitsFormat().isEmpty() || f->isExtractedIncrementally())
+			{
+				delete (f) ;
+				continue ;
+			}
+
+			QString key = AnalysisSngTextCache::getDocumentKey(f->getFilePath(), f->getTextUnitsFormat()) ;
+			if (filesByDocument.contains(key))
+			{
+				delete (f) ;
+			}
+			else
+			{
+				filesByDocument.insert(key, f) ;
+			}
+		}
+	}
+
+	QThreadPool pool ;
+	pool.setMaxThreadCount(SngSettings::instance().getNbParsingThreads()) ;
+	fprintf(stdout, "\n%s\n", QObject::trUtf8("Extraction de %1 documents (%2 configurations, %3 threads) :")
+	                          .arg(filesByDocument.count()).arg(p_filenames.count()).arg(pool.maxThreadCount()).toStdString().c_str()) ;
+
+	QAtomicInt nbExtracted(0) ;
+	QElapsedTimer timer ;
+	timer.start() ;
+	foreach(RequirementFileAbstractPtr f, AnalysisSngScheduler::instance().orderLongestFirst(filesByDocument.values().toVector()))
+	{
+		pool.start(new DocumentExtractionTask(f, &nbExtracted)) ;
+	}
+
+	// The tasks are not QObjects : their progress is polled
+	bool isDone = false ;
+	while (!isDone)
+	{
+		isDone = pool.waitForDone(PROGRESS_REFRESH_PERIOD_MS) ;
+		fprintf(stdout, "%s", QObject::trUtf8("\rExtraction : %1/%2 documents").arg(nbExtracted.load()).arg(filesByDocument.count()).toStdString().c_str()) ;
+		fflush(stdout) ;
+	}
+	fprintf(stdout, "%s\n", QObject::trUtf8(" en %1 s").arg(timer.elapsed() / 1000.0).toStdString().c_str()) ;
+}
+
+int Rekkix::loadFileAndWatch(const char* p_filename)
+{
+	int i = loadFileAndRunBatch(p_filename) ;
+	if (i != EXIT_SUCCESS) return (i) ;
+
+	// From now, each analysis (patch or full) is followed by the generation of the reports
+	QObject::connect(this, SIGNAL(analysisFinished()), this, SLOT(slt_generateReports())) ;
+	slt_setWatchMode(true) ;
+
+	fprintf(stdout, "%s\n", QObject::trUtf8("Surveillance des fichiers (Ctrl+C pour arrêter) ...").toStdString().c_str()) ;
+	return (__app->exec()) ;
+}
+
+int Rekkix::loadFileAndServe(const char* p_filename, const QString& p_serverName)
+{
+	int i = loadFileAndRunBatch(p_filename) ;
+	if (i != EXIT_SUCCESS) return (i) ;
+
+	// The server lives in its own thread, the queries are answered from the snapshot of the last analysis
+	__queryServer = new AnalysisQueryServer() ;
+	__queryServer->moveToThread(&__queryServerThread) ;
+	__queryServerThread.start() ;
+	slt_publishSnapshot() ;
+
+	bool isListening = false ;
+	QMetaObject::invokeMethod(__queryServer, "listen", Qt::BlockingQueuedConnection,
+	                          Q_RETURN_ARG(bool, isListening), Q_ARG(QString, p_serverName)) ;
+	if (!isListening)
+	{
+		fprintf(stderr, "%s\n", QObject::trUtf8("Impossible d'écouter sur %1").arg(p_serverName).toStdString().c_str()) ;
+		return (EXIT_FAILURE) ;
+	}
+
+	// The answers follow the modifications of the files
+	QObject::connect(this, SIGNAL(analysisFinished()), this, SLOT(slt_publishSnapshot())) ;
+	slt_setWatchMode(true) ;
+
+	fprintf(stdout, "%s\n", QObject::trUtf8("Serveur de requêtes à l'écoute sur %1 (Ctrl+C pour arrêter) ...").arg(p_serverName).toStdString().c_str()) ;
+	return (__app->exec()) ;
+}
+
+void Rekkix::slt_publishSnapshot()
+{
+	if (__queryServer) __queryServer->setSnapshot(ModelSngReqMatrix::instance().createSnapshot()) ;
+}
+
+void Rekkix::slt_setWatchMode(bool p_enabled)
+{
+	if (p_enabled && !__cnfFilePath.isEmpty())
+	{
+		__watcher.watch(__cnfFilePath, __cnfModel.getConfiguredRequirementFiles()) ;
+	}
+	else
+	{
+		__watcher.stop() ;
+	}
+}
+
+void Rekkix::slt_watchedConfigurationChanged()
+{
+	if (__isBatchMode)
+	{
+		fprintf(stdout, "%s\n", QObject::trUtf8("Fichier de configuration modifié : %1").arg(__cnfFilePath).toStdString().c_str()) ;
+		__cnfModel.setFile(__cnfFilePath.toStdString().c_str(), __cnfErrorsModel);
+	}
+	else
+	{
+		loadFileAndInitGui(__cnfFilePath.toStdString().c_str()) ;
+	}
+	__hasAnalysisResults = false ;
+
+	// The configured documents may have changed
+	__watcher.watch(__cnfFilePath, __cnfModel.getConfiguredRequirementFiles()) ;
+
+	if (__cnfErrorsModel.hasSignificantError())
+	{
+		// Nothing more until the next modification of the configuration file
+		if (__isBatchMode)
+		{
+			QString err = "" ;
+			__cnfErrorsModel.appendErrorString(err) ;
+			fprintf(stdout, "%s\n%s\n", QObject::trUtf8("Erreurs graves de configuration identifées, impossible de continuer :").toStdString().c_str(), err.toStdString().c_str()) ;
+		}
+		return ;
+	}
+
+	slt_startAnalysis() ;
+}
+
+void Rekkix::slt_watchedDocumentsChanged(const QStringList& p_fileIds)
+{
+	// A patch needs the results of a complete analysis, otherwise (or if a full analysis is running)
+	// everything is analysed again
+	if ((!__hasAnalysisResults && !__isAnalysisRunning) || (__isAnalysisRunning && __reparsedFileIds.isEmpty()))
+	{
+		slt_startAnalysis() ;
+		return ;
+	}
+
+	// The files of a running patch have not been merged yet : they are parsed again with the new ones
+	QStringList fileIds = p_fileIds ;
+	if (__isAnalysisRunning)
+	{
+		foreach(QString id, __reparsedFileIds)
+		{
+			if (!fileIds.contains(id)) fileIds.append(id) ;
+		}
+	}
+
+	if (__isBatchMode)
+	{
+		fprintf(stdout, "%s\n", QObject::trUtf8("Documents modifiés : %1").arg(fileIds.join(", ")).toStdString().c_str()) ;
+	}
+
+	__stopAnalysisThreads() ;
+	__clearSelectedFileModels() ;
+	__lastProgressLine.clear() ;
+
+	ModelConfiguration::CnfFileAttributesMapsByFileId_t files = __cnfModel.getConfiguredRequirementFiles();
+	QVector<RequirementFileAbstractPtr> changedFiles ;
+	foreach(QString id, fileIds)
+	{
+		if (!files.contains(id)) continue ;
+
+		RequirementFileAbstractPtr f = FactoryRequirementFile::getRequirementFile(files[id]);
+		if (f)
+		{
+			changedFiles.append(f) ;
+			QObject::connect(f, SIGNAL(parsingFinished(int)), this, SLOT(slt_reqFileParsingOneMoreFileFinished(int))) ;
+		}
+	}
+
+	// The previous versions of the files are removed from the matrix, only what they touch is computed again. If the
+	// matrix is built again, the other files are merged again by the background worker instead of the GUI thread,
+	// and are displayed as they are merged, as the parsed ones
+	QVector<RequirementFileAbstractPtr> keptFiles = ModelSngReqMatrix::instance().prepareRequirementFilesUpdate(changedFiles) ;
+	if (!keptFiles.isEmpty()) __backgroundPool.start(new RequirementFilesMergeTask(keptFiles, &__isBackgroundWorkCancelled)) ;
+
+	__reparsedFileIds = fileIds ;
+	__launchParsing(changedFiles) ;
+}
+
 
 
 void Rekkix::slt_loadConfigurationFile()
@@ -148,10 +636,121 @@ void Rekkix::slt_showSettingsDlg()
 	setDlg.exec() ;
 }
 
+void Rekkix::__stopAnalysisThreads()
+{
+	AnalysisSngStarterThread::instance().requestInterruption() ;
+	AnalysisSngWaiterThread::instance().requestInterruption() ;
+	AnalysisSngStarterThread::instance().wait() ;
+	AnalysisSngWaiterThread::instance().wait() ;
+
+	AnalysisSngStarterThread::instance().reset() ;
+
+	__stopBackgroundWork() ;
+}
+
+void Rekkix::__stopBackgroundWork()
+{
+	__isBackgroundWorkCancelled.store(1) ;
+	__backgroundPool.waitForDone() ;
+	__isBackgroundWorkCancelled.store(0) ;
+
+	__isComputingCoverage = false ;
+	if (__isGeneratingReports)
+	{
+		__isGeneratingReports = false ;
+		if (!__isBatchMode) this->pb_generateReports->setEnabled(true) ;
+	}
+}
+
+void Rekkix::__launchParsing(const QVector<RequirementFileAbstractPtr>& p_files)
+{
+	__nbFiles = p_files.count() ;
+	__nbParsedFiles = 0 ;
+	__isAnalysisRunning = true ;
+	__hasAnalysisResults = false ;
+
+	// The progress is weighted by the size of the files and displayed periodically
+	qint64 totalBytes = 0 ;
+	foreach(RequirementFileAbstractPtr f, p_files)
+	{
+		totalBytes += f->getFileSize() ;
+	}
+	AnalysisSngProgress::instance().start(totalBytes) ;
+	__progressTimer.start() ;
+
+	// The files are displayed as soon as they are merged, the coverage once every one has been
+	if (!__isBatchMode) __resultsFrameTimer.start() ;
+
+	// 2nd step start the thread waiting for parsing threads ending
+	AnalysisSngWaiterThread::instance().setRegisteredFiles(p_files, ModelSngReqMatrix::instance().getRunId()) ;
+	AnalysisSngWaiterThread::instance().start() ;
+
+	// 3rd step start the the thread starting the other ones (main goal is not to interfere with Qt main loop),
+	// the longest files first so that none of them is started when the others are done
+	int nbThreads = SngSettings::instance().getNbParsingThreads() ;
+	AnalysisSngStarterThread::instance().setRegisteredFiles(AnalysisSngScheduler::instance().startRun(p_files, nbThreads),
+	                                                        ModelSngReqMatrix::instance().getRunId()) ;
+	AnalysisSngStarterThread::instance().release(nbThreads) ;
+	AnalysisSngStarterThread::instance().start() ;
+
+	if (!__isBatchMode) this->pb_cancelAnalysis->setEnabled(true);
+}
+
+void Rekkix::__clearSelectedFileModels()
+{
+	__currentlyDisplayedUpstreamDocsModel.clear();
+	__currentlyDisplayedDownstreamDocsModel.clear();
+	__requirementsModel.clear();
+	__upstreamCoverageModel.clear();
+	__downstreamCoverageModel.clear();
+	__compositeRequirementsModel.clear();
+	__impactedRequirementsModel.clear();
+	__foundRequirementsModel.clear();
+}
+
+void Rekkix::slt_cancelAnalysis()
+{
+	// Only the reports are being generated : the results of the analysis are kept
+	if (__isGeneratingReports && !__isAnalysisRunning)
+	{
+		__stopBackgroundWork() ;
+		if (!__isBatchMode)
+		{
+			this->pb_cancelAnalysis->setEnabled(false);
+			this->progbar_analysis->setFormat(QObject::trUtf8("Génération des rapports annulée"));
+		}
+		return ;
+	}
+
+	__stopAnalysisThreads() ;
+	__progressTimer.stop() ;
+	__resultsFrameTimer.stop() ;
+	__isAnalysisRunning = false ;
+	__hasAnalysisResults = false ;
+	__reparsedFileIds.clear() ;
+	__clearSelectedFileModels() ;
+
+	// The parsers still running are left to finish on their own, their results are ignored
+	ModelSngReqMatrix::instance().clear();
+	ModelSngAnalysisErrors::instance().clear();
+
+	if (!__isBatchMode)
+	{
+		this->pb_cancelAnalysis->setEnabled(false);
+		this->progbar_analysis->setValue(0);
+		this->progbar_analysis->setFormat(QObject::trUtf8("Analyse annulée"));
+	}
+}
+
 void Rekkix::slt_startAnalysis()
 {
+	// A running analysis is superseded by the new one
+	__stopAnalysisThreads() ;
+
 	ModelConfiguration::CnfFileAttributesMapsByFileId_t files = __cnfModel.getConfiguredRequirementFiles();
-	__nbFiles = files.count() ;
+	__lastProgressLine.clear() ;
+	__reparsedFileIds.clear() ;
+	__clearSelectedFileModels() ;
 	ModelSngReqMatrix::instance().clear();
 	ModelSngAnalysisErrors::instance().clear();
 
@@ -169,78 +768,143 @@ void Rekkix::slt_startAnalysis()
 			registeredFiles.append(f) ;
 			ModelSngReqMatrix::instance().addRequirementFile(f);
 
-			QObject::connect(f, SIGNAL(parsingFinished()), this, SLOT(slt_reqFileParsingOneMoreFileFinished())) ;
-			QObject::connect(f, SIGNAL(started()), &AnalysisSngWaiterThread::instance(), SLOT(slt_parsingStarted())) ;
+			QObject::connect(f, SIGNAL(parsingFinished(int)), this, SLOT(slt_reqFileParsingOneMoreFileFinished(int))) ;
 		}
 	}
 
-	// 2nd step start the thread waiting for parsing threads ending
-	AnalysisSngWaiterThread::instance().setRegisteredFiles(registeredFiles) ;
-	QObject::connect(&AnalysisSngWaiterThread::instance(), SIGNAL(allRegisteredTerminated()), this, SLOT(slt_reqFileParsingAllFilesFinished())) ;
-	AnalysisSngWaiterThread::instance().start() ;
-
-	// 3rd step start the the thread starting the other ones (main goal is not to interfere with Qt main loop)
-	AnalysisSngStarterThread::instance().setRegisteredFiles(registeredFiles) ;
-	AnalysisSngStarterThread::instance().release(SngSettings::instance().getNbParsingThreads()) ;
-	AnalysisSngStarterThread::instance().start() ;
+	__launchParsing(registeredFiles) ;
 }
 
-void Rekkix::slt_reqFileParsingAllFilesFinished()
+void Rekkix::slt_reqFileParsingAllFilesFinished(int p_runId)
 {
+	// The signal may have been queued before the run was cancelled
+	if (p_runId != ModelSngReqMatrix::instance().getRunId()) return ;
+
 	// 3rd Step of analysis : computing coverage (only once all requirements are known)
 	QMutexLocker l(&__fileParsingFinishedGuiUpdate) ;
-	ModelSngReqMatrix::instance().computeCoverage();
+	__resultsFrameTimer.stop() ;
+	AnalysisSngScheduler::instance().endRun() ;
+
+	// The progress is still displayed, for the computation this time
+	__isComputingCoverage = true ;
+	__backgroundPool.start(new CoverageComputationTask(this, p_runId, !__isBatchMode, &__isBackgroundWorkCancelled)) ;
+}
+
+void Rekkix::slt_coverageComputed(int p_runId, MatrixResultsPtr p_results, AnalysisSnapshotPtr p_snapshot)
+{
+	// The analysis may have been superseded since the end of the computation
+	if (p_runId != ModelSngReqMatrix::instance().getRunId()) return ;
+
+	QMutexLocker l(&__fileParsingFinishedGuiUpdate) ;
+	__progressTimer.stop() ;
+	__isComputingCoverage = false ;
+	ModelSngReqMatrix::instance().publishCoverage(p_results) ;
+	__isAnalysisRunning = false ;
+	__hasAnalysisResults = true ;
+	__reparsedFileIds.clear() ;
 
 	int progbar_value = 100 ; // 100% reached ... arbitrarily ...
 	if (__isBatchMode)
 	{
-		fprintf(stdout, "%s\n", QObject::trUtf8("\rAnalyse : %01 %\n").arg(progbar_value).toStdString().c_str()) ;
+		QString line = QObject::trUtf8("\rAnalyse : %01 %").arg(progbar_value) ;
+		fprintf(stdout, "%s\n", line.leftJustified(__lastProgressLine.length()).toStdString().c_str()) ;
+
+		QString schedulingSummary = AnalysisSngScheduler::instance().getSummary() ;
+		if (!schedulingSummary.isEmpty()) fprintf(stdout, "%s\n", schedulingSummary.toStdString().c_str()) ;
+		fprintf(stdout, "\n") ;
 	}
 	else
 	{
 		this->progbar_analysis->setValue(progbar_value);
+		this->progbar_analysis->resetFormat();
+		this->pb_cancelAnalysis->setEnabled(false);
 
 		// Last Step : change current tab to display results
 		this->mw_tabs->setCurrentWidget(this->tab_results);
 		this->tv_filesCoverageSummary->resizeColumnsToContents();
 		this->tv_errors->resizeColumnsToContents();
+
+		// The followed requirement may be impacted differently by the new results
+		__snapshot = p_snapshot ;
+		slt_refreshImpacts() ;
+		slt_searchRequirements() ;
 	}
+
+	emit analysisFinished() ;
 }
 
 
-void Rekkix::slt_reqFileParsingOneMoreFileFinished()
+void Rekkix::slt_reqFileParsingOneMoreFileFinished(int p_runId)
 {
+	// A file of a cancelled run must not free a slot of the current one
+	if (p_runId != ModelSngReqMatrix::instance().getRunId()) return ;
+
 	QMutexLocker l(&__fileParsingFinishedGuiUpdate) ;
+
+	// The display is refreshed by slt_refreshProgress, only the counter is updated here
+	__nbParsedFiles++ ;
+
+	// One new thread can be launched
+	AnalysisSngStarterThread::instance().release(1) ;
+}
+
+void Rekkix::slt_refreshProgress()
+{
 	int progbar_value ;
-	static int nbParsedFiles = 0 ;
+	QString details ;
+	QString title = QObject::trUtf8("Analyse") ;
+	if (__isGeneratingReports)
+	{
+		title = QObject::trUtf8("Rapports") ;
+		progbar_value = (__nbReports > 0 ? 100 * __nbGeneratedReports.load() / __nbReports : 100) ;
+		details = QObject::trUtf8("%1/%2 rapports").arg(__nbGeneratedReports.load()).arg(__nbReports) ;
+	}
+	else if (__isComputingCoverage)
+	{
+		// The end of the bar is for the coverage computation
+		progbar_value = PROGRESS_PARSING_MAX + qRound((100 - PROGRESS_PARSING_MAX) * ModelSngReqMatrix::instance().getCoverageProgress()) ;
+		details = QObject::trUtf8("calcul de la couverture") ;
+	}
+	else
+	{
+		AnalysisSngProgress::progress_t p = AnalysisSngProgress::instance().getProgress() ;
 
-	nbParsedFiles++ ;
+		// Parsing progress is displayed in [PROGRESS_PARSING_MIN;PROGRESS_PARSING_MAX]
+		progbar_value = PROGRESS_PARSING_MIN + qRound((PROGRESS_PARSING_MAX - PROGRESS_PARSING_MIN) * p.ratio) ;
+		details = QObject::trUtf8("%1/%2 fichiers, %3").arg(__nbParsedFiles).arg(__nbFiles).arg(AnalysisSngProgress::toString(p)) ;
+	}
 
-	// Calculate GUI update so the user can see the software is alive
-	progbar_value = 84 * nbParsedFiles / __nbFiles + 1;  // dumb calculation just to ensure the value will alway be in [1;85] ... why 85 ? because 42 is not big enough
 	if (__isBatchMode)
 	{
-		fprintf(stdout, "%s", QObject::trUtf8("\rAnalyse : %01 %").arg(progbar_value).toStdString().c_str()) ;
+		QString line = QObject::trUtf8("\r%1 : %2 % (%3)").arg(title).arg(progbar_value).arg(details) ;
+		if (line != __lastProgressLine)
+		{
+			// Padding erases the end of a previous longer line
+			fprintf(stdout, "%s", line.leftJustified(__lastProgressLine.length()).toStdString().c_str()) ;
+			fflush(stdout) ;
+			__lastProgressLine = line ;
+		}
 	}
 	else
 	{
 		this->progbar_analysis->setValue(progbar_value);
+		this->progbar_analysis->setFormat(QString("%p % - ") + details);
 	}
-
-	// One new thread can be launched
-	AnalysisSngStarterThread::instance().release(1) ;
 }
 
+void Rekkix::slt_publishMergedFiles()
+{
+	ModelSngReqMatrix::instance().publishMergedFiles() ;
+	ModelSngAnalysisErrors::instance().publishErrors() ;
+}
 
 void Rekkix::slt_fileCoverageSummary_selected(QModelIndex /*p_index*/)
 {
 	// clear all the models of the other views
-	__currentlyDisplayedUpstreamDocsModel.clear();
-	__currentlyDisplayedDownstreamDocsModel.clear();
-	__requirementsModel.clear();
-	__upstreamCoverageModel.clear();
-	__downstreamCoverageModel.clear();
-	__compositeRequirementsModel.clear();
+	__clearSelectedFileModels();
+
+	// The requirements are still being linked by the merges of the other files
+	if (__isAnalysisRunning) return;
 
 	// then compute their new value
 	QItemSelectionModel* ism = tv_filesCoverageSummary->selectionModel();
@@ -282,91 +946,146 @@ void Rekkix::slt_fileCoverageSummary_selected(QModelIndex /*p_index*/)
 	}
 }
 
-void Rekkix::slt_generateReports()
+void Rekkix::slt_requirement_followImpacts(QModelIndex p_index)
 {
-	QDateTime reportTimestamp = QDateTime::currentDateTime();
+	if (!p_index.isValid()) return ;
 
-	foreach(ModelConfiguration::CnfFileAttributesMap_t outFileDescription, __cnfModel.getOutputFiles())
-	{
-		// Step 0 : prepare base file templates
-		QString writer = outFileDescription[ModelConfiguration::OUTPUT_ATTR_WRITER];
-		QString delimiter = outFileDescription[ModelConfiguration::OUTPUT_ATTR_DELIMITER];
-		FactoryReportBaseString fact;
-		QString s_base(fact.getBaseString("base", writer, delimiter));
+	__followedReqId = p_index.sibling(p_index.row(), 0).data().toString() ;
+	qDebug() << "Rekkix::slt_requirement_followImpacts " << __followedReqId ;
 
-		// In case of html, Step 1 : include CSS and replace the template values
-		if (writer == ModelConfiguration::OUTPUT_ATTR_VALUE_HTML)
+	slt_refreshImpacts() ;
+	this->result_tabs->setCurrentWidget(this->tab_impacts) ;
+}
+
+void Rekkix::slt_refreshImpacts()
+{
+	__impactedRequirementsModel.clear() ;
+
+	if (__snapshot && !__followedReqId.isEmpty() && !__isAnalysisRunning)
+	{
+		static const AnalysisImpactIndex::Direction DIRECTIONS[] = { AnalysisImpactIndex::DOWNSTREAM,
+		                                                             AnalysisImpactIndex::UPSTREAM,
+		                                                             AnalysisImpactIndex::BOTH } ;
+		AnalysisImpactIndex::Direction direction = DIRECTIONS[qBound(0, this->cb_impactDirection->currentIndex(), 2)] ;
+
+		QStringList ids = __snapshot->getImpactIndex().getImpactedRequirements(__followedReqId, direction) ;
+		QVector<Requirement*> v_r ;
+		foreach(QString id, ids)
 		{
-			s_base.replace("REKKIX_CSS_SECTION", fact.getCSString());
+			RequirementPtr r = ModelSngReqMatrix::instance().getRequirement(id) ;
+			if (r) v_r.append(r) ;
 		}
+		__impactedRequirementsModel.addRequirementsOfAFile(v_r) ;
 
-		// Step 2 : build the report header and summary table
-		s_base.replace("REKKIX_REPORT_TITLE", QObject::trUtf8("Rapport de traçabilité"));
-		s_base.replace("REKKIX_REPORT_SUBTITLE", QObject::trUtf8("Généré le %1").arg(reportTimestamp.toString(QObject::trUtf8("dd/MM/yyyy hh:mm:ss"))));
-		s_base.replace("REKKIX_SUMMARY_TITLE", QObject::trUtf8("1/ Matrice de traçabilité"));
-		s_base.replace("REKKIX_SUMMARY_TABLE", __getReportSummaryTable(writer, delimiter));
+		this->lbl_impacts->setText(QObject::trUtf8("%1 exigence(s) impactée(s) par %2").arg(ids.count()).arg(__followedReqId)) ;
+	}
 
-		// Step 3 : build the error section
-		s_base.replace("REKKIX_ERRORS_TITLE", QObject::trUtf8("2/ Erreurs trouvées dans l'analyse des fichiers"));
-		s_base.replace("REKKIX_ERRORS_CONTENT", __getReportErrorsTable(writer, delimiter));
+	// Models data are up to date : request for refresh GUI
+	__impactedRequirementsModel.refresh() ;
+	this->tv_impactedReqs->resizeColumnsToContents() ;
+}
 
-		// Step 4 : build the report with data and replace the tag
-		s_base.replace("REKKIX_DETAILS_TITLE", QObject::trUtf8("3/ Détails de traçabilité des fichiers"));
-		s_base.replace("REKKIX_DETAILS_CONTENT", ModelSngReqMatrix::instance().getReportFileDetails(writer, delimiter));
+void Rekkix::slt_searchRequirements()
+{
+	__foundRequirementsModel.clear() ;
+	this->lbl_searchResults->clear() ;
 
-		// Step 5 : store file on disk
-		QString outFilePath(outFileDescription[ModelConfiguration::OUTPUT_ATTR_PATH]);
-		outFilePath.replace("REKKIXTIMESTAMP", reportTimestamp.toString("yyyyMMddhhmmss"));
+	QString text = this->le_searchReq->text().trimmed() ;
+	if (__snapshot && !text.isEmpty() && !__isAnalysisRunning)
+	{
+		static const AnalysisSearchIndex::Mode MODES[] = { AnalysisSearchIndex::PREFIX,
+		                                                   AnalysisSearchIndex::SUBSTRING,
+		                                                   AnalysisSearchIndex::REGEX } ;
+		AnalysisSearchIndex::Mode mode = MODES[qBound(0, this->cb_searchMode->currentIndex(), 2)] ;
+
+		bool isTruncated = false ;
+		QStringList ids = __snapshot->getSearchIndex().search(text, mode, MAX_DISPLAYED_SEARCH_RESULTS, &isTruncated) ;
+		QVector<Requirement*> v_r ;
+		foreach(QString id, ids)
+		{
+			RequirementPtr r = ModelSngReqMatrix::instance().getRequirement(id) ;
+			if (r) v_r.append(r) ;
+		}
+		__foundRequirementsModel.addRequirementsOfAFile(v_r) ;
 
-		qDebug() << "Rekkix::slt_generateReports : generating " << outFilePath;
-		QFile fout(outFilePath);
-		fout.open(QIODevice::WriteOnly | QIODevice::Text);
-		QTextStream out_stream(&fout);
-		out_stream.setCodec("UTF-8");
-		out_stream << s_base;
-		fout.close();
+		if (isTruncated)
+		{
+			this->lbl_searchResults->setText(QObject::trUtf8("%1 premières exigences trouvées").arg(ids.count())) ;
+		}
+		else
+		{
+			this->lbl_searchResults->setText(QObject::trUtf8("%1 exigence(s) trouvée(s)").arg(ids.count())) ;
+		}
 	}
 
-	if (__isBatchMode)
-	{
-		fprintf(stdout, "%s\n", QObject::trUtf8("Fin de génération des rapports").toStdString().c_str()) ;
-	}
-	else
-	{
-		QMessageBox::information(NULL,
-		                         QObject::trUtf8("Génération du rapport terminée"),
-		                         QObject::trUtf8("Fin de génération des rapports"),
-		                         QMessageBox::Ok);
-	}
+	// Models data are up to date : request for refresh GUI
+	__foundRequirementsModel.refresh() ;
+	this->tv_foundReqs->resizeColumnsToContents() ;
 }
 
-
-const QString Rekkix::__getReportSummaryTable(const QString& p_writer, const QString& p_delimiter) const
+void Rekkix::slt_generateReports()
 {
-	FactoryReportBaseString fact;
-	QString s_base(fact.getBaseString("summaryTable_base", p_writer, p_delimiter));
+	QDateTime reportTimestamp = QDateTime::currentDateTime();
+	ModelConfiguration::OutputFiles_t outputs = __cnfModel.getOutputFiles();
 
-	s_base.replace("REKKIX_SUMMARY_TABLE_FILE_ID_TITLE", QObject::trUtf8("ID Fichier"));
-	s_base.replace("REKKIX_SUMMARY_TABLE_FILE_NB_REQS_TITLE", QObject::trUtf8("Nb Exigences"));
-	s_base.replace("REKKIX_SUMMARY_TABLE_FILE_COVERAGE_TITLE", QObject::trUtf8("Couverture"));
-	s_base.replace("REKKIX_SUMMARY_TABLE_FILE_NB_ERRORS_TITLE", QObject::trUtf8("Nb Erreurs"));
-	s_base.replace("REKKIX_SUMMARY_TABLE_FILE_PATH_TITLE", QObject::trUtf8("Path Fichier"));
-	s_base.replace("REKKIX_SUMMARY_TABLE_LINES_CONTENT", ModelSngReqMatrix::instance().getReportFileSummaryTable(p_writer, p_delimiter));
+	// The reports are written from the results of a finished analysis, the ones already being generated are
+	// written again with the current date
+	if (__isAnalysisRunning) return ;
+	__stopBackgroundWork() ;
+	__nbReports = outputs.count() ;
+	__nbGeneratedReports.store(0) ;
 
-	return (s_base);
+	if (__isBatchMode)
+	{
+		// The reports are written before going on (eg to display the trace of the analysis)
+		ReportGenerationTask task(NULL, outputs, reportTimestamp, &__nbGeneratedReports, &__isBackgroundWorkCancelled) ;
+		task.setAutoDelete(false) ;
+		task.run() ;
+		slt_reportsGenerated(true, task.getErrors()) ;
+		return ;
+	}
+
+	__isGeneratingReports = true ;
+	this->pb_generateReports->setEnabled(false) ;
+	this->pb_cancelAnalysis->setEnabled(true) ;
+	__backgroundPool.start(new ReportGenerationTask(this, outputs, reportTimestamp, &__nbGeneratedReports, &__isBackgroundWorkCancelled)) ;
+	__progressTimer.start() ;
 }
 
-const QString Rekkix::__getReportErrorsTable(const QString& p_writer, const QString& p_delimiter) const
+void Rekkix::slt_reportsGenerated(bool p_isComplete, const QStringList& p_errors)
 {
-	FactoryReportBaseString fact;
-	QString s_base(fact.getBaseString("errors_base", p_writer, p_delimiter));
+	if (__isBatchMode)
+	{
+		foreach(QString errMsg, p_errors)
+		{
+			fprintf(stderr, "%s\n", errMsg.toStdString().c_str()) ;
+		}
+		fprintf(stdout, "%s\n", QObject::trUtf8("Fin de génération des rapports").toStdString().c_str()) ;
+		return ;
+	}
 
-	s_base.replace("REKKIX_ERRORS_SEVERITY_TITLE", QObject::trUtf8("Sévérité"));
-	s_base.replace("REKKIX_ERRORS_CATEGORY_TITLE", QObject::trUtf8("Catégorie"));
-	s_base.replace("REKKIX_ERRORS_LOCATION_ID_TITLE", QObject::trUtf8("Localisation"));
-	s_base.replace("REKKIX_ERRORS_DESCRIPTION_TITLE", QObject::trUtf8("Description"));
-	s_base.replace("REKKIX_ERRORS_LINES_CONTENT", ModelSngAnalysisErrors::instance().getReportErrorSummaryTable(p_writer, p_delimiter));
+	// The generation may have been cancelled since the end of the task
+	if (!__isGeneratingReports || !p_isComplete) return ;
+
+	__isGeneratingReports = false ;
+	if (!__isAnalysisRunning) __progressTimer.stop() ;
+	this->pb_generateReports->setEnabled(true) ;
+	this->pb_cancelAnalysis->setEnabled(__isAnalysisRunning) ;
+	this->progbar_analysis->setValue(100) ;
+	this->progbar_analysis->resetFormat() ;
+
+	if (!p_errors.isEmpty())
+	{
+		QMessageBox::warning(NULL,
+		                     QObject::trUtf8("Génération du rapport terminée"),
+		                     QObject::trUtf8("Fin de génération des rapports, avec des erreurs :\n%1").arg(p_errors.join("\n")),
+		                     QMessageBox::Ok);
+		return ;
+	}
 
-	return (s_base);
+	QMessageBox::information(NULL,
+	                         QObject::trUtf8("Génération du rapport terminée"),
+	                         QObject::trUtf8("Fin de génération des rapports"),
+	                         QMessageBox::Ok);
 }
 
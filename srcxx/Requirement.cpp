@@ -8,11 +8,11 @@
 #include <RequirementFileAbstract.h>
 
 #include <QDebug>
+#include <QObject>
 #include <limits>
 
 #include "Requirement.h"
 #include "AnalysisError.h"
-#include "ModelSngAnalysisErrors.h"
 
 /*!
  * \brief A coverage value must be >= 0, so lowest double can be used as invalid value
@@ -97,9 +97,10 @@ void Requirement::computeConsistency()
 			AnalysisError e(AnalysisError::WARNING,
 			                AnalysisError::CONSISTENCY,
 			                __expectedBy,
-			                QObject::trUtf8("Exigence attendue mais définie dans aucun fichier : %1").arg(__id));
+			                AnalysisError::REQ_EXPECTED_UNDEFINED,
+			                __id);
 
-			ModelSngAnalysisErrors::instance().addError(e);
+			__errors.append(e);
 			errLoc = true ;
 		}
 
@@ -113,9 +114,11 @@ void Requirement::computeConsistency()
 			AnalysisError e(AnalysisError::ERROR,
 			                AnalysisError::CONSISTENCY,
 			                __expectedBy,
-			                QObject::trUtf8("%1 : Rebouclage dans la *couverture* des exigences : %2").arg(__id).arg(chain));
+			                AnalysisError::COVERAGE_LOOP,
+			                __id,
+			                chain);
 
-			ModelSngAnalysisErrors::instance().addError(e);
+			__errors.append(e);
 		}
 
 		// 3. Check for infinite loop in composing requirements
@@ -127,9 +130,11 @@ void Requirement::computeConsistency()
 			AnalysisError e(AnalysisError::ERROR,
 			                AnalysisError::CONSISTENCY,
 			                __expectedBy,
-			                QObject::trUtf8("%1 : Rebouclage dans la *composition* des exigences : %2").arg(__id).arg(chain));
+			                AnalysisError::COMPOSITION_LOOP,
+			                __id,
+			                chain);
 
-			ModelSngAnalysisErrors::instance().addError(e);
+			__errors.append(e);
 		}
 		else
 		{
@@ -142,9 +147,11 @@ void Requirement::computeConsistency()
 				AnalysisError e(AnalysisError::ERROR,
 				                AnalysisError::CONSISTENCY,
 				                __expectedBy,
-				                QObject::trUtf8("%1 est composée d'exigences invalides : %2").arg(__id).arg(invalidReqs));
+				                AnalysisError::COMPOSED_OF_INVALID,
+				                __id,
+				                invalidReqs);
 
-				ModelSngAnalysisErrors::instance().addError(e);
+				__errors.append(e);
 			}
 		}
 
@@ -0,0 +1,62 @@
+/*!
+ * \file RequirementArena.cpp
+ * \brief Implementation of the class RequirementArena
+ * \date 2016-11-10
+ * \author f.souliers
+ */
+
+#include <algorithm>
+#include <new>
+
+#include "RequirementArena.h"
+
+const int RequirementArena::BLOCK_NB_REQUIREMENTS = 1024;
+
+RequirementArena::RequirementArena()
+	: __nbUsedSlots(0)
+{
+}
+
+RequirementArena::~RequirementArena()
+{
+	// Only the slots that are not free hold a requirement
+	std::sort(__freeSlots.begin(), __freeSlots.end());
+
+	for (int i = 0 ; i < __nbUsedSlots ; i++)
+	{
+		Requirement* r = __blocks[i / BLOCK_NB_REQUIREMENTS] + (i % BLOCK_NB_REQUIREMENTS);
+		if (!std::binary_search(__freeSlots.constBegin(), __freeSlots.constEnd(), r)) r->~Requirement();
+	}
+
+	foreach(Requirement* b, __blocks)
+	{
+		::operator delete(b);
+	}
+}
+
+Requirement* RequirementArena::create(const Requirement& p_r)
+{
+	Requirement* slot;
+	if (!__freeSlots.isEmpty())
+	{
+		slot = __freeSlots.takeLast();
+	}
+	else
+	{
+		if (__nbUsedSlots == __blocks.count() * BLOCK_NB_REQUIREMENTS)
+		{
+			__blocks.append(static_cast<Requirement*>(::operator new(BLOCK_NB_REQUIREMENTS * sizeof(Requirement))));
+		}
+
+		slot = __blocks.last() + (__nbUsedSlots % BLOCK_NB_REQUIREMENTS);
+		__nbUsedSlots++;
+	}
+
+	return (new (slot) Requirement(p_r));
+}
+
+void RequirementArena::destroy(Requirement* p_r)
+{
+	p_r->~Requirement();
+	__freeSlots.append(p_r);
+}
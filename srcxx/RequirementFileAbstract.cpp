@@ -8,33 +8,33 @@
 #include <RequirementFileAbstract.h>
 
 #include <QDebug>
+#include <QFileInfo>
 
-#include "ModelSngReqMatrix.h"
-#include "ModelSngAnalysisErrors.h"
+#include "AnalysisSngProgress.h"
+#include "AnalysisSngTextCache.h"
 
 RequirementFileAbstract::RequirementFileAbstract(const ModelConfiguration::CnfFileAttributesMap_t& p_cnfFile)
-		: QThread(), _avgCoverage(0.0), _cnfFile(p_cnfFile), _threadLaunched(false)
+		: QThread(), _avgCoverage(0.0), _cnfFile(p_cnfFile), _threadLaunched(false), _runId(0), _progressReportedBytes(0), _parsingDurationUs(0),
+		  _isTextExtracted(false)
 {
+	_fileSizeBytes = QFileInfo(_cnfFile[ModelConfiguration::REQFILE_ATTR_PATH]).size() ;
+
 	// regex validy is verified while reading the configuration file, see ModelConfiguration
-	_regexReq.setPattern(_cnfFile[ModelConfiguration::REQFILE_ATTR_REQREGEX]);
-	_regexReq.optimize() ;
+	_regexReq = ModelConfiguration::getCompiledRegex(_cnfFile[ModelConfiguration::REQFILE_ATTR_REQREGEX]);
 
 	if (hasCmpRegex())
 	{
-		_regexCmp.setPattern(_cnfFile[ModelConfiguration::REQFILE_ATTR_CMPREGEX]);
-		_regexCmp.optimize() ;
+		_regexCmp = ModelConfiguration::getCompiledRegex(_cnfFile[ModelConfiguration::REQFILE_ATTR_CMPREGEX]);
 	}
 
 	if (hasCovRegex())
 	{
-		_regexCov.setPattern(_cnfFile[ModelConfiguration::REQFILE_ATTR_COVREGEX]);
-		_regexCov.optimize() ;
+		_regexCov = ModelConfiguration::getCompiledRegex(_cnfFile[ModelConfiguration::REQFILE_ATTR_COVREGEX]);
 	}
 
 	if (hasStopAfterRegex())
 	{
-		_regexStopAfter.setPattern(_cnfFile[ModelConfiguration::REQFILE_ATTR_STOPAFTERREGEX]);
-		_regexStopAfter.optimize() ;
+		_regexStopAfter = ModelConfiguration::getCompiledRegex(_cnfFile[ModelConfiguration::REQFILE_ATTR_STOPAFTERREGEX]);
 	}
 }
 
@@ -71,6 +71,105 @@ void RequirementFileAbstract::computeCoverage()
 	}
 }
 
+void RequirementFileAbstract::parseFile()
+{
+	QStringList units ;
+	if (!loadTextUnits(units)) return ; // errors have been logged --> nothing to do
+
+	_matchTextUnits(units) ;
+}
+
+bool RequirementFileAbstract::loadTextUnits(QStringList& p_units)
+{
+	// Nothing is shared for the parsers without a format of units
+	QString format = getTextUnitsFormat() ;
+	if (format.isEmpty()) return (_extractTextUnits(p_units) && !_isCancelled()) ;
+
+	// Another analysis (or a previous run) may have extracted the same document, whatever its regular expressions
+	bool isCached ;
+	{
+		AnalysisTraceScope ts("text_cache", AnalysisTracer::CATEGORY_FILE, getFileId());
+		isCached = AnalysisSngTextCache::instance().acquire(getFilePath(), format, p_units) ;
+	}
+	if (isCached)
+	{
+		qDebug() << "RequirementFileAbstract::loadTextUnits : texte de " << getFilePath() << " déjà extrait" ;
+		_isTextExtracted = false ;
+		return (true) ;
+	}
+
+	// A failed or cancelled extraction is not shared : the next analysis will try again and record its own errors
+	bool isExtracted = _extractTextUnits(p_units) && !_isCancelled() ;
+	{
+		AnalysisTraceScope ts("text_cache", AnalysisTracer::CATEGORY_FILE, getFileId());
+		AnalysisSngTextCache::instance().release(getFilePath(), format, p_units, isExtracted) ;
+	}
+
+	return (isExtracted) ;
+}
+
+void RequirementFileAbstract::_matchTextUnits(const QStringList& p_units)
+{
+	AnalysisTraceScope ts("match", AnalysisTracer::CATEGORY_FILE, getFileId());
+	QString current_req = "";  // current detected requirement (used when regex compose or covers matches)
+	bool isCurrentReqAcceptable = false;  // just to avoid parsing parts of file if the current requirement isn't correct (eg already defined)
+
+	// Progress : the extraction of the text counted for the first half of the file, the units for the second one
+	int nbUnits = qMax(1, p_units.count()) ;
+	_reportProgress(1, 2) ;
+
+	for (int unitIndex = 0 ; unitIndex < p_units.count() ; unitIndex++)
+	{
+		if (((unitIndex + 1) % PROGRESS_STEP) == 0)
+		{
+			if (_isCancelled()) break ;
+			_reportProgress(nbUnits + unitIndex, 2 * nbUnits) ;
+		}
+
+		if (!_matchTextUnit(p_units[unitIndex], getFileId(), current_req, isCurrentReqAcceptable, _contributions)) break ;
+	}
+}
+
+bool RequirementFileAbstract::_matchTextUnit(const QString& p_unit, const QString& p_location, QString& p_currentReq,
+                                             bool& p_isCurrentReqAcceptable, QVector<contribution_t>& p_contributions) const
+{
+	// If the «requirement definition» regex matches, then nothing more to do with this unit
+	if (_hasStoredAnyRequirementDefinition(p_unit, p_currentReq, p_isCurrentReqAcceptable, p_contributions, p_location)) return (true) ;
+
+	// If the the «composed of several requirements» regex matches, then nothing more to do with this unit
+	if (p_isCurrentReqAcceptable && hasCmpRegex())
+	{
+		if (_hasStoredAnyExpectedCompositeRequirements(p_unit, p_currentReq, p_contributions, p_location)) return (true) ;
+	}
+
+	// If the the «covering several requirements» regex matches, then nothing more to do with this unit
+	if (p_isCurrentReqAcceptable && hasCovRegex())
+	{
+		if (_hasStoredAnyExpectedUpstreamRequirements(p_unit, p_currentReq, p_contributions, p_location)) return (true) ;
+	}
+
+	// if the stopAfter regex is reached, then stop parsing the document
+	if (hasStopAfterRegex())
+	{
+		if (_mustStopParsing(p_unit)) return (false) ;
+	}
+
+	return (true) ;
+}
+
+void RequirementFileAbstract::_reportProgress(qint64 p_done, qint64 p_total)
+{
+	// Bytes of a cancelled run would be counted in the next one
+	if (p_total <= 0 || _isCancelled()) return ;
+
+	qint64 bytes = static_cast<qint64>(static_cast<double>(_fileSizeBytes) * qBound(0LL, p_done, p_total) / p_total) ;
+	if (bytes > _progressReportedBytes)
+	{
+		AnalysisSngProgress::instance().addProcessedBytes(bytes - _progressReportedBytes) ;
+		_progressReportedBytes = bytes ;
+	}
+}
+
 void RequirementFileAbstract::addUpstreamDocument(const QString& p_fileId, RequirementFileAbstract* p_file)
 {
 	// If the document is already an upstream document, nothing to do
@@ -91,7 +190,9 @@ void RequirementFileAbstract::addDownstreamDocument(const QString& p_fileId, Req
 
 bool RequirementFileAbstract::_hasStoredAnyRequirementDefinition(const QString& p_text,
                                                  QString& p_reqfound,
-                                                 bool& p_reqAcceptable)
+                                                 bool& p_reqAcceptable,
+                                                 QVector<contribution_t>& p_contributions,
+                                                 const QString& p_location) const
 {
 	QRegularExpressionMatch req_m = _regexReq.match(p_text);
 	if (req_m.hasMatch())
@@ -100,13 +201,14 @@ bool RequirementFileAbstract::_hasStoredAnyRequirementDefinition(const QString&
 		// each requirement must be separated by ModelConfiguration::REQFILE_ATTR_CMPSEPARATOR
 		p_reqfound = req_m.captured(ModelConfiguration::REQFILE_GRPNAME_REQID);
 
-		// then it is possible to build a requirement object
-		Requirement r(p_reqfound, Requirement::Defined, this->getFileId());
-		r.setLocation(this);
-		r.setMustBeCovered(mustHaveDownstreamDocuments());
-
 		// If the requirement has already been defined, the global Matrix handles itself the error log
-		p_reqAcceptable = ModelSngReqMatrix::instance().addDefinedRequirement(_cnfFile[ModelConfiguration::REQFILE_ATTR_ID], r);
+		// when the file is merged
+		contribution_t c;
+		c.kind = Definition;
+		c.location = p_location;
+		c.reqId = p_reqfound;
+		p_contributions.append(c);
+		p_reqAcceptable = true;
 
 		return (true);
 	}
@@ -117,7 +219,9 @@ bool RequirementFileAbstract::_hasStoredAnyRequirementDefinition(const QString&
 	}
 }
 
-bool RequirementFileAbstract::_hasStoredAnyExpectedCompositeRequirements(const QString& p_text, const QString& p_parentReqId)
+bool RequirementFileAbstract::_hasStoredAnyExpectedCompositeRequirements(const QString& p_text, const QString& p_parentReqId,
+                                                                         QVector<contribution_t>& p_contributions,
+                                                                         const QString& p_location) const
 {
 	QRegularExpressionMatch cmp_m = _regexCmp.match(p_text);
 	if (cmp_m.hasMatch())
@@ -129,17 +233,21 @@ bool RequirementFileAbstract::_hasStoredAnyExpectedCompositeRequirements(const Q
 		QString loc_str ;
 		if (p_parentReqId.isEmpty())
 		{
-			loc_str = _cnfFile[ModelConfiguration::REQFILE_ATTR_ID] ;
+			loc_str = p_location ;
 		}
 		else
 		{
-			loc_str = _cnfFile[ModelConfiguration::REQFILE_ATTR_ID] + " / " + p_parentReqId ;
+			loc_str = p_location + " / " + p_parentReqId ;
 		}
 
 		foreach(QString s, tmp.split(_cnfFile[ModelConfiguration::REQFILE_ATTR_CMPSEPARATOR]))
 		{
-			Requirement r(s.trimmed(), Requirement::Expected, loc_str);
-			ModelSngReqMatrix::instance().addExpectedCompositeRequirement(loc_str, p_parentReqId, r);
+			contribution_t c;
+			c.kind = Composition;
+			c.location = loc_str;
+			c.reqId = p_parentReqId;
+			c.refId = s.trimmed();
+			p_contributions.append(c);
 		}
 
 		return(true) ;
@@ -150,7 +258,9 @@ bool RequirementFileAbstract::_hasStoredAnyExpectedCompositeRequirements(const Q
 	}
 }
 
-bool RequirementFileAbstract::_hasStoredAnyExpectedUpstreamRequirements(const QString& p_text, const QString& p_currentReqId)
+bool RequirementFileAbstract::_hasStoredAnyExpectedUpstreamRequirements(const QString& p_text, const QString& p_currentReqId,
+                                                                        QVector<contribution_t>& p_contributions,
+                                                                        const QString& p_location) const
 {
 	QRegularExpressionMatch cov_m = _regexCov.match(p_text);
 	if (cov_m.hasMatch())
@@ -162,17 +272,21 @@ bool RequirementFileAbstract::_hasStoredAnyExpectedUpstreamRequirements(const QS
 		QString loc_str ;
 		if (p_currentReqId.isEmpty())
 		{
-			loc_str = _cnfFile[ModelConfiguration::REQFILE_ATTR_ID] ;
+			loc_str = p_location ;
 		}
 		else
 		{
-			loc_str = _cnfFile[ModelConfiguration::REQFILE_ATTR_ID] + " / " + p_currentReqId ;
+			loc_str = p_location + " / " + p_currentReqId ;
 		}
 
 		foreach(QString s, tmp.split(_cnfFile[ModelConfiguration::REQFILE_ATTR_COVSEPARATOR]))
 		{
-			Requirement r(s.trimmed(), Requirement::Expected, loc_str);
-			ModelSngReqMatrix::instance().addExpectedCoveredRequirement(loc_str, p_currentReqId, r);
+			contribution_t c;
+			c.kind = Coverage;
+			c.location = loc_str;
+			c.reqId = p_currentReqId;
+			c.refId = s.trimmed();
+			p_contributions.append(c);
 		}
 
 		return(true) ;
@@ -183,7 +297,7 @@ bool RequirementFileAbstract::_hasStoredAnyExpectedUpstreamRequirements(const QS
 	}
 }
 
-bool RequirementFileAbstract::_mustStopParsing(const QString& p_text)
+bool RequirementFileAbstract::_mustStopParsing(const QString& p_text) const
 {
 	QRegularExpressionMatch sm_m = _regexStopAfter.match(p_text);
 	if (sm_m.hasMatch())
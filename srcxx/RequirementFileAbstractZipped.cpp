@@ -9,7 +9,6 @@
 
 #include "zip.h"
 
-#include "ModelSngAnalysisErrors.h"
 #include "RequirementFileAbstractZipped.h"
 
 
@@ -37,9 +36,11 @@ void RequirementFileAbstractZipped::_readTextDataFromZippedFormat(QString* p_tex
 		AnalysisError e(AnalysisError::ERROR,
 		                AnalysisError::PARSING,
 		                _cnfFile[ModelConfiguration::REQFILE_ATTR_ID],
-		                QObject::trUtf8("Erreur d'ouverture du fichier %1 (échec de zip_open, erreur %2)").arg(_cnfFile[ModelConfiguration::REQFILE_ATTR_PATH]).arg(err));
+		                AnalysisError::ZIP_OPEN_FAILED,
+		                _cnfFile[ModelConfiguration::REQFILE_ATTR_PATH],
+		                QString::number(err));
 
-		ModelSngAnalysisErrors::instance().addError(e);
+		_addParsingError(e);
 
 		p_textData->clear();
 		return;
@@ -51,9 +52,10 @@ void RequirementFileAbstractZipped::_readTextDataFromZippedFormat(QString* p_tex
 		AnalysisError e(AnalysisError::ERROR,
 		                AnalysisError::PARSING,
 		                _cnfFile[ModelConfiguration::REQFILE_ATTR_ID],
-		                QObject::trUtf8("Erreur de localisation de %1 (format de fichier invalide, échec de zip_name_locate)").arg(_documentFileName));
+		                AnalysisError::ZIP_LOCATE_FAILED,
+		                _documentFileName);
 
-		ModelSngAnalysisErrors::instance().addError(e);
+		_addParsingError(e);
 
 		p_textData->clear();
 		return;
@@ -65,9 +67,9 @@ void RequirementFileAbstractZipped::_readTextDataFromZippedFormat(QString* p_tex
 		AnalysisError e(AnalysisError::ERROR,
 		                AnalysisError::PARSING,
 		                _cnfFile[ModelConfiguration::REQFILE_ATTR_ID],
-		                QObject::trUtf8("Erreur de localisation de l'index (format de fichier invalide, échec de zip_fopen_index)"));
+		                AnalysisError::ZIP_OPEN_INDEX_FAILED);
 
-		ModelSngAnalysisErrors::instance().addError(e);
+		_addParsingError(e);
 
 		p_textData->clear();
 		return;
@@ -92,9 +94,12 @@ void RequirementFileAbstractZipped::_readTextDataFromZippedFormat(QString* p_tex
 				AnalysisError e(AnalysisError::ERROR,
 				                AnalysisError::PARSING,
 				                _cnfFile[ModelConfiguration::REQFILE_ATTR_ID],
-				                QObject::trUtf8("Erreur de lecture du fichier après %1 cycles (zip_fread retourne -1). zip_err %2 : %3").arg(nbCycles).arg(err->zip_err).arg(err->str));
+				                AnalysisError::ZIP_READ_FAILED,
+				                QString::number(nbCycles),
+				                QString::number(err->zip_err),
+				                QString(err->str));
 
-				ModelSngAnalysisErrors::instance().addError(e);
+				_addParsingError(e);
 			}
 			else
 			{
@@ -10,13 +10,14 @@
 
 #include "zip.h"
 
-#include "ModelSngAnalysisErrors.h"
+#include "AnalysisTracer.h"
 #include "RequirementFile_docx.h"
 #include "Requirement.h"
 
 static const QString DOCX_XML_BODY_NODE = "body";  //!< MS Word specific XML tag for body
 static const QString DOCX_XML_PARAGRAPH_NODE = "p";  //!< MS Word specific XML tag for paragraph
 static const QString DOCX_XML_DELETED_ELEMENT_NODE = "del";  //!< MS Word specific XML tag for deleted stuff
+static const QString TEXT_UNITS_FORMAT = "docx-1";  //!< Paragraphs without deleted stuff, to be incremented each time they change
 
 RequirementFile_docx::RequirementFile_docx(const ModelConfiguration::CnfFileAttributesMap_t& p_cnfFile)
 		: RequirementFileAbstractZipped(p_cnfFile)
@@ -28,15 +29,23 @@ RequirementFile_docx::~RequirementFile_docx()
 {
 }
 
-void RequirementFile_docx::parseFile()
+QString RequirementFile_docx::getTextUnitsFormat() const
+{
+	return (TEXT_UNITS_FORMAT) ;
+}
+
+bool RequirementFile_docx::_extractTextUnits(QStringList& p_units)
 {
 	// Read raw data from the document and store it into text_content
 	QString* text_content = new QString();
-	_readTextDataFromZippedFormat(text_content);
+	{
+		AnalysisTraceScope ts("read", AnalysisTracer::CATEGORY_FILE, getFileId());
+		_readTextDataFromZippedFormat(text_content);
+	}
 	if (text_content->isEmpty())
 	{
 		delete(text_content) ;
-		return ; // errors have been logged --> nothing to do
+		return (false) ; // errors have been logged --> nothing to do
 	}
 
 	// Now looking to the «text» tag containing the real data that must be analyzed
@@ -44,18 +53,26 @@ void RequirementFile_docx::parseFile()
 	QString errMsg = "" ;
 	int errLine = 0 ;
 	int errCol = 0 ;
-	if (!mainDoc->setContent(*text_content, true, &errMsg, &errLine, &errCol))
+	bool isXmlValid ;
+	{
+		AnalysisTraceScope ts("xml", AnalysisTracer::CATEGORY_FILE, getFileId());
+		isXmlValid = mainDoc->setContent(*text_content, true, &errMsg, &errLine, &errCol) ;
+	}
+	if (!isXmlValid)
 	{
 		AnalysisError e(AnalysisError::ERROR,
 		                AnalysisError::PARSING,
 		                _cnfFile[ModelConfiguration::REQFILE_ATTR_ID],
-		                QObject::trUtf8("Parser DOCX : erreur setContent ligne<%1> col<%2> msg<%3>").arg(errLine).arg(errCol).arg(errMsg));
+		                AnalysisError::DOCX_SET_CONTENT_FAILED,
+		                QString::number(errLine),
+		                QString::number(errCol),
+		                errMsg);
 
-		ModelSngAnalysisErrors::instance().addError(e);
+		_addParsingError(e);
 
 		delete(text_content) ;
 		delete(mainDoc) ;
-		return ;
+		return (false) ;
 	}
 
 	QDomElement* textRoot = new QDomElement() ;
@@ -65,22 +82,34 @@ void RequirementFile_docx::parseFile()
 		AnalysisError e(AnalysisError::ERROR,
 		                AnalysisError::PARSING,
 		                _cnfFile[ModelConfiguration::REQFILE_ATTR_ID],
-		                QObject::trUtf8("Parser DOCX : Impossible de trouver le nœud %1").arg(DOCX_XML_BODY_NODE));
+		                AnalysisError::DOCX_NODE_NOT_FOUND,
+		                DOCX_XML_BODY_NODE);
 
-		ModelSngAnalysisErrors::instance().addError(e);
+		_addParsingError(e);
 
 		delete (textRoot) ;
 		delete (text_content) ;
 		delete (mainDoc) ;
-		return ;
+		return (false) ;
 	}
 
-	// Now we can walk through every paragraph and check for requirement stuff in it
-	QString current_req = "";
-	bool isCurrentReqAcceptable = false;  // just to avoid parsing parts of file if the current requirement isn't correct (eg already defined)
+	// Now we can walk through every paragraph and keep its text
+	AnalysisTraceScope ts("paragraphs", AnalysisTracer::CATEGORY_FILE, getFileId());
 	QDomElement elt = textRoot->firstChildElement(DOCX_XML_PARAGRAPH_NODE);
+
+	// Progress : reading and decoding the XML count for the first quarter of the file, the paragraphs for the second one
+	int nbNodes = qMax(1, textRoot->childNodes().count()) ;
+	int paragraphIndex = 0 ;
+	_reportProgress(1, 4) ;
+
 	for (; !elt.isNull(); elt = elt.nextSiblingElement(DOCX_XML_PARAGRAPH_NODE))
 	{
+		if ((++paragraphIndex % PROGRESS_STEP) == 0)
+		{
+			if (_isCancelled()) break ;
+			_reportProgress(nbNodes + paragraphIndex, 4 * nbNodes) ;
+		}
+
 		/*
 		 * Data cannot be retrieved with a simple direct "QString data = elt.text() ;" as the paragraph node can
 		 * contains deleted stuff that would be recognized as normal text. --> Text data must be retrieved ignoring
@@ -100,32 +129,11 @@ void RequirementFile_docx::parseFile()
 		QString data = elt.text() ;
 
 		// If, after analysis, the data string is empty ... nothing to do ...
-		if (data.isEmpty()) continue ;
-
-		// If the «requirement definition» regex matches, then nothing more to do with this paragraph
-		if (_hasStoredAnyRequirementDefinition(data, current_req, isCurrentReqAcceptable)) continue ;
-
-		// If the the «composed of several requirements» regex matches, then nothing more to do with this paragraph
-		if (isCurrentReqAcceptable && hasCmpRegex())
-		{
-			if (_hasStoredAnyExpectedCompositeRequirements(data, current_req)) continue ;
-		}
-
-		// If the the «covering several requirements» regex matches, then nothing more to do with this line
-		if (isCurrentReqAcceptable && hasCovRegex())
-		{
-			if (_hasStoredAnyExpectedUpstreamRequirements(data, current_req)) continue ;
-		}
-
-		// if the stopAfter regex is reached, then stop parsing the file
-		if (hasStopAfterRegex())
-		{
-			if (_mustStopParsing(data)) break ;
-		}
+		if (!data.isEmpty()) p_units.append(data) ;
 	}
 
 	delete (textRoot) ;
 	delete(mainDoc) ;
 	delete(text_content) ;
+	return (true) ;
 }
-
@@ -9,7 +9,7 @@
 
 #include "zip.h"
 
-#include "ModelSngAnalysisErrors.h"
+#include "AnalysisTracer.h"
 #include "RequirementFile_odt.h"
 #include "Requirement.h"
 
@@ -18,6 +18,7 @@ static const QString ODT_XML_BODY_NODE = "body";  //!< OpenDocument specific XML
 static const QString ODT_XML_TEXT_NODE = "text";  //!< OpenDocument specific XML tag for text
 static const QString ODT_XML_PARAGRAPH_NODE = "p";  //!< OpenDocument specific XML tag for paragraph
 static const QString ODT_XML_ANNOTATION_NODE = "annotation";  //!< OpenDocument specific XML tag for annotation (side note inside a paragraph)
+static const QString TEXT_UNITS_FORMAT = "odt-1";  //!< Paragraphs without annotations, to be incremented each time they change
 
 
 RequirementFile_odt::RequirementFile_odt(const ModelConfiguration::CnfFileAttributesMap_t& p_cnfFile)
@@ -30,6 +31,11 @@ RequirementFile_odt::~RequirementFile_odt()
 {
 }
 
+QString RequirementFile_odt::getTextUnitsFormat() const
+{
+	return (TEXT_UNITS_FORMAT) ;
+}
+
 void RequirementFile_odt::__lookForFirstTextNode(const QDomElement& p_firstNode, QDomElement& p_textNode)
 {
 	p_textNode = QDomElement() ; // by default, the element is null and the method fails
@@ -40,9 +46,10 @@ void RequirementFile_odt::__lookForFirstTextNode(const QDomElement& p_firstNode,
 		AnalysisError e(AnalysisError::ERROR,
 		                AnalysisError::PARSING,
 		                _cnfFile[ModelConfiguration::REQFILE_ATTR_ID],
-		                QObject::trUtf8("Parser ODT : nœud %1 non trouvé").arg(ODT_XML_BODY_NODE));
+		                AnalysisError::ODT_NODE_NOT_FOUND,
+		                ODT_XML_BODY_NODE);
 
-		ModelSngAnalysisErrors::instance().addError(e);
+		_addParsingError(e);
 	}
 	else
 	{
@@ -52,9 +59,10 @@ void RequirementFile_odt::__lookForFirstTextNode(const QDomElement& p_firstNode,
 			AnalysisError e(AnalysisError::ERROR,
 			                AnalysisError::PARSING,
 			                _cnfFile[ModelConfiguration::REQFILE_ATTR_ID],
-			                QObject::trUtf8("Parser ODT : nœud %1 non trouvé").arg(ODT_XML_TEXT_NODE));
+			                AnalysisError::ODT_NODE_NOT_FOUND,
+			                ODT_XML_TEXT_NODE);
 
-			ModelSngAnalysisErrors::instance().addError(e);
+			_addParsingError(e);
 		}
 		else
 		{
@@ -64,15 +72,18 @@ void RequirementFile_odt::__lookForFirstTextNode(const QDomElement& p_firstNode,
 
 }
 
-void RequirementFile_odt::parseFile()
+bool RequirementFile_odt::_extractTextUnits(QStringList& p_units)
 {
 	// Read raw data from the document and store it into text_content
 	QString* text_content = new QString();
-	_readTextDataFromZippedFormat(text_content);
+	{
+		AnalysisTraceScope ts("read", AnalysisTracer::CATEGORY_FILE, getFileId());
+		_readTextDataFromZippedFormat(text_content);
+	}
 	if (text_content->isEmpty())
 	{
 		delete(text_content) ;
-		return ; // errors have been logged --> nothing to do
+		return (false) ; // errors have been logged --> nothing to do
 	}
 
 	// Now open the XML doc and look for the «text» tag containing the real data that must be analyzed
@@ -80,18 +91,26 @@ void RequirementFile_odt::parseFile()
 	QString errMsg = "" ;
 	int errLine = 0 ;
 	int errCol = 0 ;
-	if (!mainDoc->setContent(*text_content, true, &errMsg, &errLine, &errCol))
+	bool isXmlValid ;
+	{
+		AnalysisTraceScope ts("xml", AnalysisTracer::CATEGORY_FILE, getFileId());
+		isXmlValid = mainDoc->setContent(*text_content, true, &errMsg, &errLine, &errCol) ;
+	}
+	if (!isXmlValid)
 	{
 		AnalysisError e(AnalysisError::ERROR,
 		                AnalysisError::PARSING,
 		                _cnfFile[ModelConfiguration::REQFILE_ATTR_ID],
-		                QObject::trUtf8("Parser ODT : erreur setContent ligne<%1> col<%2> msg<%3>").arg(errLine).arg(errCol).arg(errMsg));
+		                AnalysisError::ODT_SET_CONTENT_FAILED,
+		                QString::number(errLine),
+		                QString::number(errCol),
+		                errMsg);
 
-		ModelSngAnalysisErrors::instance().addError(e);
+		_addParsingError(e);
 
 		delete(text_content) ;
 		delete(mainDoc) ;
-		return ;
+		return (false) ;
 	}
 
 	QDomElement* textRoot = new QDomElement();
@@ -101,15 +120,26 @@ void RequirementFile_odt::parseFile()
 		delete (textRoot) ;
 		delete(text_content) ;
 		delete(mainDoc) ;
-		return ;
+		return (false) ;
 	}
 
-	// Now we can walk through every paragraph and check for requirement stuff in it
-	QString current_req = "";
-	bool isCurrentReqAcceptable = false;  // just to avoid parsing parts of file if the current requirement isn't correct (eg already defined)
+	// Now we can walk through every paragraph and keep its text
+	AnalysisTraceScope ts("paragraphs", AnalysisTracer::CATEGORY_FILE, getFileId());
 	QDomElement elt = textRoot->firstChildElement(ODT_XML_PARAGRAPH_NODE);
+
+	// Progress : reading and decoding the XML count for the first quarter of the file, the paragraphs for the second one
+	int nbNodes = qMax(1, textRoot->childNodes().count()) ;
+	int paragraphIndex = 0 ;
+	_reportProgress(1, 4) ;
+
 	for (; !elt.isNull(); elt = elt.nextSiblingElement(ODT_XML_PARAGRAPH_NODE))
 	{
+		if ((++paragraphIndex % PROGRESS_STEP) == 0)
+		{
+			if (_isCancelled()) break ;
+			_reportProgress(nbNodes + paragraphIndex, 4 * nbNodes) ;
+		}
+
 		QDomElement eltAnnotation = elt.firstChildElement(ODT_XML_ANNOTATION_NODE) ;
 		QString data = elt.text() ;
 
@@ -118,32 +148,11 @@ void RequirementFile_odt::parseFile()
 		if (!eltAnnotation.isNull()) data.remove(eltAnnotation.text()) ;
 
 		// If there is no data ... no need to look for anything
-		if (data.isEmpty()) continue ;
-
-		// If the «requirement definition» regex matches, then nothing more to do with this paragraph
-		if (_hasStoredAnyRequirementDefinition(data, current_req, isCurrentReqAcceptable)) continue ;
-
-		// If the the «composed of several requirements» regex matches, then nothing more to do with this paragraph
-		if (isCurrentReqAcceptable && hasCmpRegex())
-		{
-			if (_hasStoredAnyExpectedCompositeRequirements(data, current_req)) continue ;
-		}
-
-		// If the the «covering several requirements» regex matches, then nothing more to do with this line
-		if (isCurrentReqAcceptable && hasCovRegex())
-		{
-			if (_hasStoredAnyExpectedUpstreamRequirements(data, current_req)) continue ;
-		}
-
-		// if the stopAfter regex is reached, then stop parsing the file
-		if (hasStopAfterRegex())
-		{
-			if (_mustStopParsing(data)) break ;
-		}
+		if (!data.isEmpty()) p_units.append(data) ;
 	}
 
 	delete (textRoot) ;
 	delete(mainDoc) ;
 	delete(text_content) ;
+	return (true) ;
 }
-
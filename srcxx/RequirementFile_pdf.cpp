@@ -13,80 +13,160 @@
 #include <poppler-global.h>
 
 #include "AnalysisError.h"
-#include "ModelSngAnalysisErrors.h"
+#include "AnalysisSngTextCache.h"
+#include "AnalysisTracer.h"
 #include "RequirementFile_pdf.h"
 #include "Requirement.h"
 
+static const QString TEXT_UNITS_FORMAT = "pdf-1";  //!< Lines of the pages, to be incremented each time they change
 
 RequirementFile_pdf::RequirementFile_pdf(const ModelConfiguration::CnfFileAttributesMap_t& p_cnfFile)
-		: RequirementFileAbstract(p_cnfFile)
+		: RequirementFileAbstract(p_cnfFile), __firstPage(1), __lastPage(-1)
 {
+	// The range has been checked while reading the configuration file, see ModelConfiguration
+	ModelConfiguration::parsePageRange(_cnfFile[ModelConfiguration::REQFILE_ATTR_PAGES], __firstPage, __lastPage) ;
 }
 
 RequirementFile_pdf::~RequirementFile_pdf()
 {
 }
 
+QString RequirementFile_pdf::getTextUnitsFormat() const
+{
+	if (__firstPage == 1 && __lastPage == -1) return (TEXT_UNITS_FORMAT) ;
+
+	return (QString("%1-p%2-%3").arg(TEXT_UNITS_FORMAT).arg(__firstPage).arg(__lastPage == -1 ? QString("end") : QString::number(__lastPage))) ;
+}
+
+bool RequirementFile_pdf::isExtractedIncrementally() const
+{
+	return (hasStopAfterRegex()) ;
+}
+
 void RequirementFile_pdf::parseFile()
+{
+	// Every page is needed : the whole text is extracted then matched
+	if (!hasStopAfterRegex())
+	{
+		RequirementFileAbstract::parseFile() ;
+		return ;
+	}
+
+	QString format = getTextUnitsFormat() ;
+	QStringList units ;
+	bool isCached ;
+	{
+		AnalysisTraceScope ts("text_cache", AnalysisTracer::CATEGORY_FILE, getFileId());
+		isCached = AnalysisSngTextCache::instance().acquire(getFilePath(), format, units) ;
+	}
+	if (isCached)
+	{
+		qDebug() << "RequirementFile_pdf::parseFile : texte de " << getFilePath() << " déjà extrait" ;
+		_matchTextUnits(units) ;
+		return ;
+	}
+
+	// The pages following the one where the stopafter_regex matches are never extracted
+	poppler::document* pdfDoc = __openDocument() ;
+	bool isComplete = (pdfDoc != NULL) && __extractPages(pdfDoc, units, true) && !_isCancelled() ;
+	delete (pdfDoc) ;
+
+	// Only the text of every page can be shared with the other analyses
+	{
+		AnalysisTraceScope ts("text_cache", AnalysisTracer::CATEGORY_FILE, getFileId());
+		AnalysisSngTextCache::instance().release(getFilePath(), format, units, isComplete) ;
+	}
+}
+
+bool RequirementFile_pdf::_extractTextUnits(QStringList& p_units)
+{
+	poppler::document* pdfDoc = __openDocument() ;
+	if (!pdfDoc) return (false) ;
+
+	__extractPages(pdfDoc, p_units, false) ;
+
+	delete(pdfDoc) ;
+	return (true) ;
+}
+
+poppler::document* RequirementFile_pdf::__openDocument()
 {
 	QString filePath = _cnfFile[ModelConfiguration::REQFILE_ATTR_PATH] ;
-	poppler::document* pdfDoc = poppler::document::load_from_file(filePath.toStdString()) ;
+	poppler::document* pdfDoc ;
+	{
+		AnalysisTraceScope ts("open", AnalysisTracer::CATEGORY_FILE, getFileId());
+		pdfDoc = poppler::document::load_from_file(filePath.toStdString()) ;
+	}
 	if (!pdfDoc)
 	{
 		AnalysisError e(AnalysisError::ERROR,
 			            AnalysisError::PARSING,
 			            filePath,
-			            QObject::trUtf8("Impossible d'ouvrir le fichier %1").arg(filePath));
-
-		ModelSngAnalysisErrors::instance().addError(e);
+			            AnalysisError::FILE_OPEN_FAILED,
+			            filePath);
 
-		delete(pdfDoc) ;
-		return;
+		_addParsingError(e);
 	}
 
-	QString current_req = "";  // current detected requirement (used when regex compose or covers matches)
-	bool isCurrentReqAcceptable = false;  // just to avoid parsing parts of file if the current requirement isn't correct (eg already defined)
-	QString txtDoc ;
-	QStringList* lst = new QStringList() ;
+	return (pdfDoc) ;
+}
 
-	for (int pgNum = 0 ; pgNum < pdfDoc->pages() ; ++pgNum)
-	{
-		txtDoc = "" ;
-		poppler::byte_array characters = pdfDoc->create_page(pgNum)->text().to_utf8() ;
-		for (poppler::byte_array::iterator c = characters.begin() ; c != characters.end() ; ++c)
-		{
-			txtDoc += *c ;
-		}
+bool RequirementFile_pdf::__extractPages(poppler::document* p_pdfDoc, QStringList& p_units, bool p_isMatching)
+{
+	AnalysisTraceScope ts(p_isMatching ? "extract_match_pages" : "extract_pages", AnalysisTracer::CATEGORY_FILE, getFileId());
 
-		lst->append(txtDoc.split('\n')) ;
+	int nbPages = p_pdfDoc->pages() ;
+	int firstIndex = __firstPage - 1 ;
+	int lastIndex = (__lastPage == -1) ? nbPages - 1 : qMin(__lastPage, nbPages) - 1 ;
+	if (firstIndex >= nbPages)
+	{
+		AnalysisError e(AnalysisError::WARNING,
+		                AnalysisError::PARSING,
+		                getFileId(),
+		                AnalysisError::PDF_NOT_ENOUGH_PAGES,
+		                getFilePath(),
+		                QString::number(nbPages));
+
+		_addParsingError(e);
+		return (true) ;
 	}
 
-	foreach(QString current_line, *lst)
+	// Progress : the extraction is the first half of the work, unless each page is matched once extracted
+	int nbPagesToParse = lastIndex - firstIndex + 1 ;
+	int progressTotal = p_isMatching ? nbPagesToParse : 2 * nbPagesToParse ;
+
+	QString current_req = "" ;
+	bool isCurrentReqAcceptable = false ;
+	for (int pgNum = firstIndex ; pgNum <= lastIndex ; ++pgNum)
 	{
-		// If the «requirement definition» regex matches, then nothing more to do with this line
-		if (_hasStoredAnyRequirementDefinition(current_line, current_req, isCurrentReqAcceptable)) continue ;
+		if (_isCancelled()) return (false) ;
 
-		// If the the «composed of several requirements» regex matches, then nothing more to do with this line
-		if (isCurrentReqAcceptable && hasCmpRegex())
-		{
-			if (_hasStoredAnyExpectedCompositeRequirements(current_line, current_req)) continue ;
-		}
+		poppler::page* pdfPage = p_pdfDoc->create_page(pgNum) ;
+		if (!pdfPage) continue ;
 
-		// If the the «covering several requirements» regex matches, then nothing more to do with this line
-		if (isCurrentReqAcceptable && hasCovRegex())
+		QString txtDoc ;
+		poppler::byte_array characters = pdfPage->text().to_utf8() ;
+		delete (pdfPage) ;
+		for (poppler::byte_array::iterator c = characters.begin() ; c != characters.end() ; ++c)
 		{
-			if (_hasStoredAnyExpectedUpstreamRequirements(current_line, current_req)) continue ;
+			txtDoc += *c ;
 		}
 
-		// if the stopAfter regex is reached, then stop parsing the file
-		if (hasStopAfterRegex())
+		int firstNewUnit = p_units.count() ;
+		p_units.append(txtDoc.split('\n')) ;
+		_reportProgress(pgNum - firstIndex + 1, progressTotal) ;
+
+		if (!p_isMatching) continue ;
+
+		for (int unitIndex = firstNewUnit ; unitIndex < p_units.count() ; unitIndex++)
 		{
-			if (_mustStopParsing(current_line)) break ;
+			if (!_matchTextUnit(p_units[unitIndex], getFileId(), current_req, isCurrentReqAcceptable, _contributions))
+			{
+				qDebug() << "RequirementFile_pdf::__extractPages : " << getFilePath() << " arrêté page " << (pgNum + 1) << " sur " << nbPages ;
+				return (false) ;
+			}
 		}
 	}
 
-
-	delete(lst) ;
-	delete(pdfDoc) ;
+	return (true) ;
 }
-
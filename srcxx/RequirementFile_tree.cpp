@@ -0,0 +1,478 @@
+/*!
+ * \file RequirementFile_tree.cpp
+ * \brief Implementation of the class RequirementFile_tree
+ * \date 2016-11-08
+ * \author f.souliers
+ */
+
+#include <algorithm>
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QRunnable>
+#include <QThreadPool>
+
+#include "AnalysisError.h"
+#include "AnalysisSngProgress.h"
+#include "AnalysisSngStarterThread.h"
+#include "AnalysisTracer.h"
+#include "RequirementFile_tree.h"
+#include "SngSettings.h"
+
+static const int BATCHES_BY_WORKER = 4;  //!< Several batches by worker, so that the workers end at about the same time
+static const int PROGRESS_POLLING_PERIOD_MS = 50;  //!< Period of the report of the progress of the batches
+static const QString GLOB_CHARACTERS = "*?[{";  //!< Characters starting the glob pattern of a tree
+
+/*!
+ * \brief Splits the path of a tree into its root directory and the glob pattern of its files, relative to the root
+ */
+static void splitTreePath(const QString& p_path, QString& p_rootDirectory, QString& p_glob)
+{
+	QString path = QDir::fromNativeSeparators(p_path);
+
+	// A directory is the tree of all its files
+	if (QFileInfo(path).isDir())
+	{
+		p_rootDirectory = QDir::cleanPath(path);
+		p_glob = "**";
+		return;
+	}
+
+	int firstGlobIndex = path.length();
+	foreach(QChar c, GLOB_CHARACTERS)
+	{
+		int i = path.indexOf(c);
+		if (i >= 0) firstGlobIndex = qMin(firstGlobIndex, i);
+	}
+
+	int rootLength = path.lastIndexOf('/', firstGlobIndex) + 1;
+	p_rootDirectory = QDir::cleanPath(path.left(rootLength));
+	p_glob = path.mid(rootLength);
+}
+
+/*!
+ * \brief Regular expression matching the relative paths of the files selected by a glob pattern
+ */
+static QRegularExpression globToRegex(const QString& p_glob)
+{
+	QString rx;
+	int nbOpenedBraces = 0;
+
+	for (int i = 0 ; i < p_glob.length() ; i++)
+	{
+		QChar c = p_glob[i];
+		if (c == '*' && i + 1 < p_glob.length() && p_glob[i + 1] == '*')
+		{
+			// "**/" is any number of directories (none included), "**" is anything
+			if (i + 2 < p_glob.length() && p_glob[i + 2] == '/')
+			{
+				rx += "(?:.*/)?";
+				i += 2;
+			}
+			else
+			{
+				rx += ".*";
+				i++;
+			}
+		}
+		else if (c == '*')
+		{
+			rx += "[^/]*";
+		}
+		else if (c == '?')
+		{
+			rx += "[^/]";
+		}
+		else if (c == '[' && p_glob.indexOf(']', i + 2) > 0)
+		{
+			// The first character of the set may be a ']', [!...] is the complement of the set
+			int end = p_glob.indexOf(']', i + 2);
+			QString set = p_glob.mid(i + 1, end - i - 1);
+			if (set.startsWith('!')) set[0] = '^';
+			rx += "[" + set.replace("\\", "\\\\") + "]";
+			i = end;
+		}
+		else if (c == '{')
+		{
+			rx += "(?:";
+			nbOpenedBraces++;
+		}
+		else if (c == ',' && nbOpenedBraces > 0)
+		{
+			rx += "|";
+		}
+		else if (c == '}' && nbOpenedBraces > 0)
+		{
+			rx += ")";
+			nbOpenedBraces--;
+		}
+		else
+		{
+			rx += QRegularExpression::escape(QString(c));
+		}
+	}
+
+	// An unclosed brace is closed at the end of the pattern
+	rx += QString(")").repeated(nbOpenedBraces);
+
+#ifdef Q_OS_WIN
+	QRegularExpression retVal("\\A" + rx + "\\z", QRegularExpression::CaseInsensitiveOption);
+#else
+	QRegularExpression retVal("\\A" + rx + "\\z");
+#endif
+	retVal.optimize();
+	return (retVal);
+}
+
+/*!
+ * \brief State of a walk through a tree, shared by its tasks
+ */
+typedef struct
+{
+	QString rootDirectory;  //!< Root of the tree
+	QRegularExpression regex;  //!< Matches the relative paths of the selected files
+	QThreadPool pool;  //!< Runs the tasks, each task starting the ones of its subdirectories
+	QMutex mutex;  //!< Protects relativePaths and sizes
+	QStringList relativePaths;  //!< Selected files, from the root
+	QVector<qint64> sizes;  //!< Sizes of the selected files
+} treeWalk_t;
+
+/*!
+ * \class TreeWalkTask
+ * \brief Lists one directory of a tree, then starts the listing of its subdirectories
+ */
+class TreeWalkTask : public QRunnable
+{
+public:
+	TreeWalkTask(const QString& p_relativeDirectory, treeWalk_t* p_walk)
+		: QRunnable(), __relativeDirectory(p_relativeDirectory), __walk(p_walk)
+	{
+		setAutoDelete(true);
+	}
+
+	void run()
+	{
+		QString prefix = (__relativeDirectory.isEmpty() ? QString() : __relativeDirectory + "/");
+		QDir dir(__walk->rootDirectory + "/" + __relativeDirectory);
+		QStringList relativePaths;
+		QVector<qint64> sizes;
+
+		// The sizes come with the listing, the files are never opened here
+		foreach(QFileInfo fi, dir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Readable))
+		{
+			QString relativePath = prefix + fi.fileName();
+			if (fi.isDir())
+			{
+				// A symbolic link may loop, and a directory that cannot hold any selected file is not walked
+				if (fi.isSymLink()) continue;
+				QRegularExpressionMatch m = __walk->regex.match(relativePath + "/", 0, QRegularExpression::PartialPreferFirstMatch);
+				if (!m.hasMatch() && !m.hasPartialMatch()) continue;
+
+				__walk->pool.start(new TreeWalkTask(relativePath, __walk));
+			}
+			else if (__walk->regex.match(relativePath).hasMatch())
+			{
+				relativePaths.append(relativePath);
+				sizes.append(fi.size());
+			}
+		}
+
+		if (relativePaths.isEmpty()) return;
+
+		QMutexLocker l(&__walk->mutex);
+		__walk->relativePaths.append(relativePaths);
+		__walk->sizes += sizes;
+	}
+
+private:
+	QString __relativeDirectory;  //!< Directory listed by the task, from the root of the tree
+	treeWalk_t* __walk;  //!< The walk, owned by RequirementFile_tree::__listFiles
+};
+
+/*!
+ * \class TreeBatchTask
+ * \brief Helps the parsing thread of a tree, taking its batches of files until there is none left (see
+ *        RequirementFile_tree::parseFile)
+ */
+class TreeBatchTask : public QRunnable
+{
+public:
+	TreeBatchTask(const RequirementFile_tree* p_tree, RequirementFile_tree::batches_t* p_batches)
+		: QRunnable(), __tree(p_tree), __batches(p_batches)
+	{
+		setAutoDelete(true);
+	}
+
+	void run()
+	{
+		while (__tree->__parseNextBatch(*__batches)) ;
+	}
+
+private:
+	const RequirementFile_tree* __tree;  //!< The tree, only read
+	RequirementFile_tree::batches_t* __batches;  //!< Batches of the tree, owned by the tree
+};
+
+RequirementFile_tree::RequirementFile_tree(const ModelConfiguration::CnfFileAttributesMap_t& p_cnfFile)
+		: RequirementFileAbstract(p_cnfFile), __nbWorkers(qMax(1, SngSettings::instance().getNbParsingThreads()))
+{
+}
+
+RequirementFile_tree::~RequirementFile_tree()
+{
+}
+
+QString RequirementFile_tree::getTextUnitsFormat() const
+{
+	return (QString());
+}
+
+bool RequirementFile_tree::isTreePath(const QString& p_path)
+{
+	// Some file names contain glob characters
+	QFileInfo fi(p_path);
+	if (fi.isDir()) return (true);
+	if (fi.exists()) return (false);
+
+	foreach(QChar c, GLOB_CHARACTERS)
+	{
+		if (p_path.contains(c)) return (true);
+	}
+	return (false);
+}
+
+QString RequirementFile_tree::getRootDirectory(const QString& p_path)
+{
+	QString rootDirectory;
+	QString glob;
+	splitTreePath(p_path, rootDirectory, glob);
+
+	return (rootDirectory);
+}
+
+QStringList RequirementFile_tree::listFiles(const QString& p_path)
+{
+	QStringList retVal;
+	foreach(file_t f, __listFiles(p_path))
+	{
+		retVal.append(f.path);
+	}
+	return (retVal);
+}
+
+QVector<RequirementFile_tree::file_t> RequirementFile_tree::__listFiles(const QString& p_path)
+{
+	treeWalk_t walk;
+	QString glob;
+	splitTreePath(p_path, walk.rootDirectory, glob);
+	walk.regex = globToRegex(glob);
+
+	walk.pool.start(new TreeWalkTask(QString(), &walk));
+	walk.pool.waitForDone();
+
+	// Sorted, so that the tree is parsed in the same order whatever the walk
+	QVector< QPair<QString, qint64> > sortedFiles;
+	sortedFiles.reserve(walk.relativePaths.count());
+	for (int i = 0 ; i < walk.relativePaths.count() ; i++)
+	{
+		sortedFiles.append(qMakePair(walk.relativePaths[i], walk.sizes[i]));
+	}
+	std::sort(sortedFiles.begin(), sortedFiles.end());
+
+	QVector<file_t> retVal;
+	retVal.reserve(sortedFiles.count());
+	for (int i = 0 ; i < sortedFiles.count() ; i++)
+	{
+		file_t f;
+		f.relativePath = sortedFiles[i].first;
+		f.path = walk.rootDirectory + "/" + f.relativePath;
+		f.size = sortedFiles[i].second;
+		retVal.append(f);
+	}
+
+	return (retVal);
+}
+
+void RequirementFile_tree::__walk()
+{
+	AnalysisTraceScope ts("walk", AnalysisTracer::CATEGORY_FILE, getFileId());
+	__files = __listFiles(getFilePath());
+
+	// The weight of the tree in the progress of the analysis is the size of its files, only known now
+	qint64 sizeBytes = 0;
+	foreach(file_t f, __files)
+	{
+		sizeBytes += f.size;
+	}
+	AnalysisSngProgress::instance().addTotalBytes(sizeBytes - _fileSizeBytes);
+	_fileSizeBytes = sizeBytes;
+
+	qDebug() << "RequirementFile_tree::__walk : " << getFilePath() << " --> " << __files.count() << " fichiers, " << _fileSizeBytes << " octets";
+}
+
+bool RequirementFile_tree::__readFile(const file_t& p_file, QString& p_text, QVector<AnalysisError>& p_errors) const
+{
+	QFile f(p_file.path);
+	if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		AnalysisError e(AnalysisError::ERROR,
+		                AnalysisError::PARSING,
+		                getFileId(),
+		                AnalysisError::FILE_OPEN_FAILED,
+		                p_file.path);
+
+		p_errors.append(e);
+		return (false);
+	}
+
+	// The files are small: read at once, then split into lines
+	p_text = QString::fromUtf8(f.readAll());
+	return (true);
+}
+
+bool RequirementFile_tree::_extractTextUnits(QStringList& p_units)
+{
+	__walk();
+
+	for (int i = 0 ; i < __files.count() ; i++)
+	{
+		if (_isCancelled()) break;
+
+		QString text;
+		if (!__readFile(__files[i], text, _parsingErrors)) continue;
+
+		// each line of each file is a unit, with its end of line as for the txt files
+		int begin = 0;
+		while (begin < text.length())
+		{
+			int end = text.indexOf('\n', begin);
+			end = (end < 0 ? text.length() : end + 1);
+			p_units.append(text.mid(begin, end - begin));
+			begin = end;
+		}
+		_reportProgress(i + 1, 2 * __files.count());
+	}
+
+	return (true);
+}
+
+void RequirementFile_tree::__parseBatch(int p_begin, int p_end, batchResult_t& p_result, QAtomicInteger<qint64>& p_parsedBytes) const
+{
+	for (int i = p_begin ; i < p_end ; i++)
+	{
+		if (_isCancelled()) return;
+
+		const file_t& f = __files[i];
+		QString text;
+		if (__readFile(f, text, p_result.errors))
+		{
+			// Each file is a document of its own : the current requirement and the stopafter_regex do not cross files
+			QString currentReq = "";
+			bool isCurrentReqAcceptable = false;
+			int firstContribution = p_result.contributions.count();
+
+			int begin = 0;
+			while (begin < text.length())
+			{
+				int end = text.indexOf('\n', begin);
+				end = (end < 0 ? text.length() : end + 1);
+				if (!_matchTextUnit(text.mid(begin, end - begin), getFileId(), currentReq, isCurrentReqAcceptable, p_result.contributions)) break;
+				begin = end;
+			}
+
+			// Merged as contributions of the tree, the errors they raise tell the file they come from
+			for (int c = firstContribution ; c < p_result.contributions.count() ; c++)
+			{
+				p_result.contributions[c].part = f.relativePath;
+			}
+		}
+
+		p_parsedBytes.fetchAndAddRelaxed(f.size);
+	}
+}
+
+bool RequirementFile_tree::__parseNextBatch(batches_t& p_batches) const
+{
+	int b = p_batches.nextBatch.fetchAndAddRelaxed(1);
+	if (b >= p_batches.results.count()) return (false);
+
+	__parseBatch(p_batches.bounds[b], p_batches.bounds[b + 1], p_batches.results[b], p_batches.parsedBytes);
+	return (true);
+}
+
+void RequirementFile_tree::parseFile()
+{
+	__walk();
+	if (_isCancelled()) return;
+
+	if (__files.isEmpty())
+	{
+		AnalysisError e(AnalysisError::WARNING,
+		                AnalysisError::PARSING,
+		                getFileId(),
+		                AnalysisError::TREE_NO_FILE,
+		                getFilePath());
+
+		_addParsingError(e);
+		return;
+	}
+
+	AnalysisTraceScope ts("match_batches", AnalysisTracer::CATEGORY_FILE, getFileId());
+
+	// Batches of consecutive files of about the same size
+	int nbBatches = qMin(__files.count(), __nbWorkers * BATCHES_BY_WORKER);
+	qint64 batchBytes = qMax(qint64(1), _fileSizeBytes / nbBatches);
+	batches_t batches;
+	batches.bounds.append(0);
+	qint64 bytes = 0;
+	for (int i = 0 ; i < __files.count() - 1 ; i++)
+	{
+		bytes += __files[i].size;
+		if (bytes >= batchBytes && batches.bounds.count() < nbBatches)
+		{
+			batches.bounds.append(i + 1);
+			bytes = 0;
+		}
+	}
+	batches.bounds.append(__files.count());
+
+	// The results are merged in the order of the files, whatever the order the batches end
+	batches.results.resize(batches.bounds.count() - 1);
+	batches.nextBatch.store(0);
+	batches.parsedBytes.store(0);
+
+	// The tree parses its batches in its own parsing slot, helped by the slots the analysis leaves idle: the
+	// parsing threads never exceed the configured number
+	int nbHelpers = AnalysisSngStarterThread::instance().borrowSlots(qMin(__nbWorkers, batches.results.count()) - 1, getRunId());
+	QThreadPool helpers;
+	helpers.setMaxThreadCount(qMax(1, nbHelpers));
+	for (int h = 0 ; h < nbHelpers ; h++)
+	{
+		helpers.start(new TreeBatchTask(this, &batches));
+	}
+
+	while (__parseNextBatch(batches))
+	{
+		_reportProgress(batches.parsedBytes.load(), qMax(qint64(1), _fileSizeBytes));
+	}
+	while (!helpers.waitForDone(PROGRESS_POLLING_PERIOD_MS))
+	{
+		_reportProgress(batches.parsedBytes.load(), qMax(qint64(1), _fileSizeBytes));
+	}
+	AnalysisSngStarterThread::instance().giveBackSlots(nbHelpers, getRunId());
+	if (_isCancelled()) return;
+
+	foreach(batchResult_t r, batches.results)
+	{
+		_contributions += r.contributions;
+		_parsingErrors += r.errors;
+	}
+
+	qDebug() << "RequirementFile_tree::parseFile : " << __files.count() << " fichiers en " << batches.results.count() << " lots, "
+	         << nbHelpers + 1 << " threads";
+}
@@ -10,10 +10,11 @@
 
 
 #include "AnalysisError.h"
-#include "ModelSngAnalysisErrors.h"
+#include "AnalysisTracer.h"
 #include "RequirementFile_txt.h"
 #include "Requirement.h"
 
+static const QString TEXT_UNITS_FORMAT = "txt-1";  //!< Lines with their end of line, to be incremented each time they change
 
 RequirementFile_txt::RequirementFile_txt(const ModelConfiguration::CnfFileAttributesMap_t& p_cnfFile)
 		: RequirementFileAbstract(p_cnfFile)
@@ -24,7 +25,12 @@ RequirementFile_txt::~RequirementFile_txt()
 {
 }
 
-void RequirementFile_txt::parseFile()
+QString RequirementFile_txt::getTextUnitsFormat() const
+{
+	return (TEXT_UNITS_FORMAT) ;
+}
+
+bool RequirementFile_txt::_extractTextUnits(QStringList& p_units)
 {
 	// Open the file. In case of error, just log it and return
 	QString filePath = _cnfFile[ModelConfiguration::REQFILE_ATTR_PATH] ;
@@ -34,39 +40,25 @@ void RequirementFile_txt::parseFile()
 		AnalysisError e(AnalysisError::ERROR,
 			            AnalysisError::PARSING,
 			            filePath,
-			            QObject::trUtf8("Impossible d'ouvrir le fichier %1").arg(filePath));
+			            AnalysisError::FILE_OPEN_FAILED,
+			            filePath);
 
-		ModelSngAnalysisErrors::instance().addError(e);
-		return;
+		_addParsingError(e);
+		return (false) ;
 	}
 
-	// for each line of the file, verify if any regex can detect something
-	QString current_req = "";  // current detected requirement (used when regex compose or covers matches)
-	bool isCurrentReqAcceptable = false;  // just to avoid parsing parts of file if the current requirement isn't correct (eg already defined)
+	// each line of the file is a unit (with its end of line, as matched by the regex since the beginning)
+	AnalysisTraceScope ts("read", AnalysisTracer::CATEGORY_FILE, getFileId());
+	int lineIndex = 0 ;
 	while (!f.atEnd())
 	{
-		QString current_line = f.readLine() ;
-
-		// If the «requirement definition» regex matches, then nothing more to do with this line
-		if (_hasStoredAnyRequirementDefinition(current_line, current_req, isCurrentReqAcceptable)) continue ;
-
-		// If the the «composed of several requirements» regex matches, then nothing more to do with this line
-		if (isCurrentReqAcceptable && hasCmpRegex())
+		p_units.append(QString(f.readLine())) ;
+		if ((++lineIndex % PROGRESS_STEP) == 0)
 		{
-			if (_hasStoredAnyExpectedCompositeRequirements(current_line, current_req)) continue ;
-		}
-
-		// If the the «covering several requirements» regex matches, then nothing more to do with this line
-		if (isCurrentReqAcceptable && hasCovRegex())
-		{
-			if (_hasStoredAnyExpectedUpstreamRequirements(current_line, current_req)) continue ;
-		}
-
-		// if the stopAfter regex is reached, then stop parsing the file
-		if (hasStopAfterRegex())
-		{
-			if (_mustStopParsing(current_line)) break ;
+			if (_isCancelled()) break ;
+			_reportProgress(f.pos(), 2 * f.size()) ;
 		}
 	}
-}
 
+	return (true) ;
+}
@@ -16,9 +16,13 @@ const QString SngSettings::section_general = "General" ;
 
 const QString SngSettings::key_version = "version" ;
 const QString SngSettings::key_parsingThreadsNum = "nbParsingThreads" ;
+const QString SngSettings::key_textCacheEnabled = "textCacheEnabled" ;
+const QString SngSettings::key_textCacheMaxSizeMB = "textCacheMaxSizeMB" ;
 
 const QString SngSettings::value_version = APP_VERSION ;
 const int SngSettings::value_nbParsingThreadsDefault = 10 ;
+const bool SngSettings::value_textCacheEnabledDefault = false ;
+const int SngSettings::value_textCacheMaxSizeMBDefault = 512 ;
 
 
 SngSettings::SngSettings()
@@ -34,6 +38,8 @@ SngSettings::SngSettings()
 		__settings.beginGroup(section_general) ;
 		__settings.setValue(key_version, value_version) ;
 		__settings.setValue(key_parsingThreadsNum, value_nbParsingThreadsDefault) ;
+		__settings.setValue(key_textCacheEnabled, value_textCacheEnabledDefault) ;
+		__settings.setValue(key_textCacheMaxSizeMB, value_textCacheMaxSizeMBDefault) ;
 
 		__settings.endGroup() ;
 	}
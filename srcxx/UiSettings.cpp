@@ -5,9 +5,11 @@
  * \author f.souliers
  */
 
+#include <QDir>
 #include <QMessageBox>
 #include "UiSettings.h"
 
+#include "AnalysisSngTextCache.h"
 #include "SngSettings.h"
 
 // Only for Eclipse colorisation --> APP_VERSION is defined in rekkix.pro
@@ -26,6 +28,12 @@ UiSettings::UiSettings(QWidget * parent, Qt::WindowFlags f)
 	this->lbl_version->setText(version_str) ;
 
 	this->sb_maxParsingThreads->setValue(SngSettings::instance().getNbParsingThreads()) ;
+	this->cb_textCache->setChecked(SngSettings::instance().isTextCacheEnabled()) ;
+
+	// The user can find (and delete) the text kept on disk
+	QString directory_str = this->lbl_textCacheDirectory->text() ;
+	directory_str.replace("TEXT_CACHE_DIRECTORY", QDir::toNativeSeparators(AnalysisSngTextCache::getDefaultDirectory())) ;
+	this->lbl_textCacheDirectory->setText(directory_str) ;
 }
 
 UiSettings::~UiSettings()
@@ -36,6 +44,8 @@ UiSettings::~UiSettings()
 void UiSettings::slt_OK()
 {
 	SngSettings::instance().setNbParsingThreads(sb_maxParsingThreads->value()) ;
+	SngSettings::instance().setTextCacheEnabled(cb_textCache->isChecked()) ;
+	AnalysisSngTextCache::instance().setPersistent(cb_textCache->isChecked(), SngSettings::instance().getTextCacheMaxSize()) ;
 	this->accept() ;
 }
 
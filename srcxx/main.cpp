@@ -7,8 +7,11 @@
 
 #include <QDebug>
 #include <QApplication>
+#include <QFileInfo>
 #include <QString>
 
+#include "AnalysisSnapshotDiff.h"
+#include "FactoryReport.h"
 #include "Rekkix.h"
 
 #ifndef APP_VERSION
@@ -16,6 +19,11 @@
 #endif
 
 static const QString BATCH_OPTION = "--batch" ;
+static const QString TRACE_OPTION = "--trace" ;
+static const QString WATCH_OPTION = "--watch" ;
+static const QString SERVE_OPTION = "--serve" ;
+static const QString DIFF_OPTION = "--diff" ;
+static const QString DIFF_CSV_DELIMITER = ";" ;
 
 static void usage()
 {
@@ -26,6 +34,62 @@ static void usage()
 	fprintf(stderr, "rekkix ./myConfigFile.ini\n") ;
 	fprintf(stderr, "%s\n", QObject::trUtf8("Utilisation #3, lancement en mode batch (console) : les messages d'erreurs seront affichés sur stderr").toStdString().c_str()) ;
 	fprintf(stderr, "rekkix --batch ./myConfigFile.ini\n") ;
+	fprintf(stderr, "%s\n", QObject::trUtf8("Utilisation #4, mode batch avec enregistrement des durées d'analyse (format Chrome trace, visible dans Perfetto)").toStdString().c_str()) ;
+	fprintf(stderr, "rekkix --batch ./myConfigFile.ini --trace ./trace.json\n") ;
+	fprintf(stderr, "%s\n", QObject::trUtf8("Utilisation #5, mode batch avec surveillance : l'analyse et les rapports sont mis à jour à chaque modification des fichiers").toStdString().c_str()) ;
+	fprintf(stderr, "rekkix --watch ./myConfigFile.ini\n") ;
+	fprintf(stderr, "%s\n", QObject::trUtf8("Utilisation #6, serveur de requêtes local (socket nommée, \"rekkix\" par défaut) sur l'analyse maintenue à jour").toStdString().c_str()) ;
+	fprintf(stderr, "rekkix --serve ./myConfigFile.ini [nom_du_serveur]\n") ;
+	fprintf(stderr, "%s\n", QObject::trUtf8("Utilisation #7, rapport d'évolution (html ou csv selon l'extension) entre deux analyses enregistrées (sortie de type snapshot)").toStdString().c_str()) ;
+	fprintf(stderr, "rekkix --diff ./reference.rkx ./analyse.rkx ./evolution.html\n") ;
+	fprintf(stderr, "%s\n", QObject::trUtf8("Utilisation #8, mode batch sur plusieurs configurations : les documents communs ne sont extraits qu'une fois, puis les configurations sont analysées l'une après l'autre").toStdString().c_str()) ;
+	fprintf(stderr, "rekkix --batch ./config1.ini ./config2.ini [./config3.ini ...]\n") ;
+}
+
+/*!
+ * \brief compares two saved analyses and writes the delta report (rekkix --diff)
+ * \param[in] p_baselinePath  path of the reference analysis
+ * \param[in] p_currentPath  path of the compared analysis
+ * \param[in] p_reportPath  path of the report, its extension giving the writer (html or csv)
+ * \return EXIT_SUCCESS if the report has been written, EXIT_FAILURE else
+ */
+static int diffAnalyses(const QString& p_baselinePath, const QString& p_currentPath, const QString& p_reportPath)
+{
+	ModelConfiguration::CnfFileAttributesMap_t outFileDescription ;
+	outFileDescription[ModelConfiguration::OUTPUT_ATTR_PATH] = p_reportPath ;
+	outFileDescription[ModelConfiguration::OUTPUT_ATTR_WRITER] = QFileInfo(p_reportPath).suffix().toLower() ;
+	outFileDescription[ModelConfiguration::OUTPUT_ATTR_DELIMITER] = DIFF_CSV_DELIMITER ;
+	if (outFileDescription[ModelConfiguration::OUTPUT_ATTR_WRITER] != ModelConfiguration::OUTPUT_ATTR_VALUE_HTML
+	    && outFileDescription[ModelConfiguration::OUTPUT_ATTR_WRITER] != ModelConfiguration::OUTPUT_ATTR_VALUE_CSV)
+	{
+		fprintf(stderr, "%s\n", QObject::trUtf8("Le rapport d'évolution doit être un fichier html ou csv : %1").arg(p_reportPath).toStdString().c_str()) ;
+		return (EXIT_FAILURE) ;
+	}
+
+	QString errMsg ;
+	AnalysisSnapshotPtr baseline = AnalysisSnapshot::load(p_baselinePath, errMsg) ;
+	AnalysisSnapshotPtr current ;
+	if (baseline) current = AnalysisSnapshot::load(p_currentPath, errMsg) ;
+	if (!current)
+	{
+		fprintf(stderr, "%s\n", errMsg.toStdString().c_str()) ;
+		return (EXIT_FAILURE) ;
+	}
+
+	AnalysisSnapshotDiff diff ;
+	diff.compute(*baseline, *current) ;
+	foreach(QString line, diff.getSummary())
+	{
+		fprintf(stdout, "%s\n", line.toStdString().c_str()) ;
+	}
+
+	if (!FactoryReport::writeDeltaReport(outFileDescription, diff, QDateTime::currentDateTime()))
+	{
+		fprintf(stderr, "%s\n", QObject::trUtf8("Impossible d'écrire le rapport d'évolution %1").arg(p_reportPath).toStdString().c_str()) ;
+		return (EXIT_FAILURE) ;
+	}
+
+	return (EXIT_SUCCESS) ;
 }
 
 
@@ -67,6 +131,66 @@ int main(int argc, char *argv[])
 			delete(oRekkix) ;
 			return (i);
 		}
+		else if (app.arguments().at(1) == WATCH_OPTION)
+		{
+			// batch mode, then the analysis is kept up to date until the application is stopped
+			oRekkix = new Rekkix(&app, false);
+			int i = oRekkix->loadFileAndWatch(argv[2]) ;
+			delete(oRekkix) ;
+			return (i);
+		}
+		else if (app.arguments().at(1) == SERVE_OPTION)
+		{
+			// batch mode, then the queries of local clients are answered until the application is stopped
+			oRekkix = new Rekkix(&app, false);
+			int i = oRekkix->loadFileAndServe(argv[2], AnalysisQueryServer::DEFAULT_SERVER_NAME) ;
+			delete(oRekkix) ;
+			return (i);
+		}
+		else
+		{
+			usage() ;
+			return(EXIT_FAILURE) ;
+		}
+	}
+	else if (argc >= 4 && app.arguments().at(1) == BATCH_OPTION && app.arguments().at(3) != TRACE_OPTION)
+	{
+		// running in batch mode on several configurations sharing their documents
+		oRekkix = new Rekkix(&app, false);
+		int i = oRekkix->loadFilesAndRunBatch(app.arguments().mid(2)) ;
+		delete(oRekkix) ;
+		return (i);
+	}
+	else if (argc == 4)
+	{
+		if (app.arguments().at(1) == SERVE_OPTION)
+		{
+			oRekkix = new Rekkix(&app, false);
+			int i = oRekkix->loadFileAndServe(argv[2], app.arguments().at(3)) ;
+			delete(oRekkix) ;
+			return (i);
+		}
+		else
+		{
+			usage() ;
+			return(EXIT_FAILURE) ;
+		}
+	}
+	else if (argc == 5)
+	{
+		if (app.arguments().at(1) == BATCH_OPTION && app.arguments().at(3) == TRACE_OPTION)
+		{
+			// running in batch mode with tracing enabled
+			oRekkix = new Rekkix(&app, false);
+			int i = oRekkix->loadFileAndRunBatch(argv[2], app.arguments().at(4)) ;
+			delete(oRekkix) ;
+			return (i);
+		}
+		else if (app.arguments().at(1) == DIFF_OPTION)
+		{
+			// no analysis at all, only the saved ones are compared
+			return (diffAnalyses(app.arguments().at(2), app.arguments().at(3), app.arguments().at(4))) ;
+		}
 		else
 		{
 			usage() ;